@@ -0,0 +1,336 @@
+#ifndef ALEPH_BENCHMARKS_BASE_HH__
+#define ALEPH_BENCHMARKS_BASE_HH__
+
+/*
+  Minimal benchmark harness. Every benchmark executable includes this file
+  exactly once, because it replaces the global allocation functions in
+  order to count allocations.
+
+  Each benchmark is repeated a number of times. The harness reports the
+  minimum, median, and mean run time, the number of allocations and the
+  number of allocated bytes of a single run, as well as the peak resident
+  set size of the process after the benchmark. All results are written
+  to STDOUT in JSON format, so that different runs may be compared by a
+  script.
+*/
+
+#include <aleph/config/Base.hh>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/resource.h>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+namespace aleph
+{
+
+namespace benchmarks
+{
+
+namespace detail
+{
+
+inline std::atomic<std::size_t>& allocations()
+{
+  static std::atomic<std::size_t> counter( 0 );
+  return counter;
+}
+
+inline std::atomic<std::size_t>& allocatedBytes()
+{
+  static std::atomic<std::size_t> counter( 0 );
+  return counter;
+}
+
+/** @returns Peak resident set size of the process in bytes */
+inline std::size_t peakRSS()
+{
+  rusage usage;
+  if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+    return 0;
+
+  // Linux reports kilobytes, whereas Mac OS X reports bytes
+#ifdef __APPLE__
+  return static_cast<std::size_t>( usage.ru_maxrss );
+#else
+  return static_cast<std::size_t>( usage.ru_maxrss ) * 1024;
+#endif
+}
+
+/** Escapes a string for use in JSON */
+inline std::string escape( const std::string& s )
+{
+  std::string result;
+  result.reserve( s.size() );
+
+  for( auto c : s )
+  {
+    if( c == '"' || c == '\\' )
+      result.push_back( '\\' );
+
+    result.push_back( c );
+  }
+
+  return result;
+}
+
+} // namespace detail
+
+/** Prevents the compiler from removing the calculation of a value */
+template <class T> void doNotOptimize( const T& value )
+{
+  asm volatile( "" : : "r"( &value ) : "memory" );
+}
+
+/** Parameters of a benchmark, e.g. the size of its input */
+using Parameters = std::map<std::string, std::string>;
+
+/** Converts a value to a benchmark parameter */
+template <class T> std::string parameter( const T& value )
+{
+  std::ostringstream stream;
+  stream << value;
+  return stream.str();
+}
+
+struct Result
+{
+  std::string name;
+  Parameters parameters;
+
+  std::vector<double> times;
+
+  std::size_t allocations;
+  std::size_t allocatedBytes;
+  std::size_t peakRSS;
+};
+
+/**
+  @class Runner
+  @brief Runs benchmarks and reports their results
+
+  Understands the following command-line arguments:
+
+    --filter=STRING  : only runs benchmarks whose name contains STRING
+    --repetitions=N  : repeats every benchmark N times (default: 5)
+    --scale=FACTOR   : scales the size of all inputs (default: 1.0)
+
+  The results are reported once the runner is destroyed.
+*/
+
+class Runner
+{
+public:
+  Runner( int argc, char** argv, std::string suite )
+    : _suite( std::move( suite ) )
+  {
+    for( int i = 1; i < argc; i++ )
+    {
+      std::string argument = argv[i];
+
+      auto value = [&argument] ( const std::string& prefix, std::string& result )
+      {
+        if( argument.compare( 0, prefix.size(), prefix ) != 0 )
+          return false;
+
+        result = argument.substr( prefix.size() );
+        return true;
+      };
+
+      std::string v;
+
+      if( value( "--filter=", v ) )
+        _filter = v;
+      else if( value( "--repetitions=", v ) )
+        _repetitions = static_cast<unsigned>( std::max( 1l, std::stol( v ) ) );
+      else if( value( "--scale=", v ) )
+        _scale = std::stod( v );
+      else
+      {
+        std::cerr << "Usage: " << argv[0] << " [--filter=STRING] [--repetitions=N] [--scale=FACTOR]\n";
+        std::exit( -1 );
+      }
+    }
+  }
+
+  ~Runner()
+  {
+    this->report( std::cout );
+  }
+
+  Runner( const Runner& )            = delete;
+  Runner& operator=( const Runner& ) = delete;
+
+  /** @returns Size of an input, scaled by the factor given by the client */
+  template <class T> T scale( T size ) const
+  {
+    return std::max( T(1), static_cast<T>( static_cast<double>( size ) * _scale ) );
+  }
+
+  /**
+    Runs a benchmark without any state. The functor is timed as a whole,
+    so it should only contain the calculation that is to be measured. It
+    has to return its result, which prevents the compiler from removing
+    the calculation.
+  */
+
+  template <class Functor> void run( const std::string& name, const Parameters& parameters, Functor f )
+  {
+    this->run( name, parameters, [] () { return 0; }, [&f] ( int ) { return f(); } );
+  }
+
+  /**
+    Runs a benchmark whose state has to be prepared before every run,
+    for example because the calculation modifies its input. Only the
+    second functor, which receives the state, is timed.
+  */
+
+  template <class Setup, class Functor> void run( const std::string& name, const Parameters& parameters, Setup setup, Functor f )
+  {
+    if( !_filter.empty() && name.find( _filter ) == std::string::npos )
+      return;
+
+    std::cerr << "* Running '" << name << "'...";
+
+    Result result;
+    result.name       = name;
+    result.parameters = parameters;
+
+    for( unsigned i = 0; i < _repetitions; i++ )
+    {
+      auto state = setup();
+
+      auto allocations    = detail::allocations().load();
+      auto allocatedBytes = detail::allocatedBytes().load();
+      auto start          = std::chrono::steady_clock::now();
+
+      doNotOptimize( f( state ) );
+
+      auto end = std::chrono::steady_clock::now();
+
+      result.times.push_back( std::chrono::duration<double>( end - start ).count() );
+      result.allocations    = detail::allocations().load()    - allocations;
+      result.allocatedBytes = detail::allocatedBytes().load() - allocatedBytes;
+    }
+
+    result.peakRSS = detail::peakRSS();
+
+    std::sort( result.times.begin(), result.times.end() );
+    std::cerr << "finished (" << result.times.front() << "s)\n";
+
+    _results.push_back( result );
+  }
+
+  void report( std::ostream& o ) const
+  {
+    unsigned threads = 1;
+
+#ifdef _OPENMP
+    threads = static_cast<unsigned>( omp_get_max_threads() );
+#endif
+
+    o << std::setprecision( 9 );
+
+    o << "{\n"
+      << "  \"suite\": \"" << detail::escape( _suite ) << "\",\n"
+      << "  \"context\": {\n"
+      << "    \"compiler\": \"" << detail::escape( __VERSION__ ) << "\",\n"
+      << "    \"repetitions\": " << _repetitions << ",\n"
+      << "    \"scale\": " << _scale << ",\n"
+      << "    \"threads\": " << threads << "\n"
+      << "  },\n"
+      << "  \"benchmarks\": [";
+
+    for( auto it = _results.begin(); it != _results.end(); ++it )
+    {
+      auto&& result = *it;
+      auto n        = result.times.size();
+      auto mean     = std::accumulate( result.times.begin(), result.times.end(), 0.0 ) / static_cast<double>( n );
+      auto median   = n % 2 == 1 ? result.times[n/2] : 0.5 * ( result.times[n/2-1] + result.times[n/2] );
+
+      o << ( it == _results.begin() ? "\n" : ",\n" )
+        << "    {\n"
+        << "      \"name\": \"" << detail::escape( result.name ) << "\",\n"
+        << "      \"parameters\": {";
+
+      for( auto itParameter = result.parameters.begin(); itParameter != result.parameters.end(); ++itParameter )
+      {
+        o << ( itParameter == result.parameters.begin() ? " " : ", " )
+          << "\"" << detail::escape( itParameter->first ) << "\": \"" << detail::escape( itParameter->second ) << "\"";
+      }
+
+      o << ( result.parameters.empty() ? "},\n" : " },\n" )
+        << "      \"time_min\": "        << result.times.front() << ",\n"
+        << "      \"time_median\": "     << median               << ",\n"
+        << "      \"time_mean\": "       << mean                 << ",\n"
+        << "      \"allocations\": "     << result.allocations    << ",\n"
+        << "      \"allocated_bytes\": " << result.allocatedBytes << ",\n"
+        << "      \"peak_rss\": "        << result.peakRSS        << "\n"
+        << "    }";
+    }
+
+    o << "\n  ]\n"
+      << "}\n";
+  }
+
+private:
+  std::string _suite;
+  std::string _filter;
+  unsigned _repetitions = 5;
+  double _scale         = 1.0;
+
+  std::vector<Result> _results;
+};
+
+} // namespace benchmarks
+
+} // namespace aleph
+
+// Allocation tracking -------------------------------------------------
+//
+// The replacement functions must not be inlined. Otherwise, compilers
+// may pair the calls to malloc() and free() with the wrong functions.
+
+__attribute__((noinline)) void* operator new( std::size_t size )
+{
+  aleph::benchmarks::detail::allocations()    += 1;
+  aleph::benchmarks::detail::allocatedBytes() += size;
+
+  if( auto pointer = std::malloc( size == 0 ? 1 : size ) )
+    return pointer;
+
+  throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new[]( std::size_t size )
+{
+  return operator new( size );
+}
+
+__attribute__((noinline)) void operator delete( void* pointer ) noexcept
+{
+  std::free( pointer );
+}
+
+__attribute__((noinline)) void operator delete[]( void* pointer ) noexcept
+{
+  std::free( pointer );
+}
+
+#endif
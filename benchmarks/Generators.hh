@@ -0,0 +1,138 @@
+#ifndef ALEPH_BENCHMARKS_GENERATORS_HH__
+#define ALEPH_BENCHMARKS_GENERATORS_HH__
+
+/*
+  Reproducible synthetic inputs for the benchmarks. All generators use a
+  fixed seed unless specified otherwise, so every run of a benchmark has
+  to process exactly the same data.
+*/
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/SphereSampling.hh>
+#include <aleph/geometry/TorusSampling.hh>
+#include <aleph/geometry/VietorisRipsComplex.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/topology/RandomGraph.hh>
+
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+namespace benchmarks
+{
+
+static const unsigned defaultSeed = 42;
+
+using DataType           = double;
+using PointCloud         = containers::PointCloud<DataType>;
+using Distance           = distances::Euclidean<DataType>;
+using NearestNeighbours  = geometry::BruteForce<PointCloud, Distance>;
+using PersistenceDiagram = aleph::PersistenceDiagram<DataType>;
+
+/** Samples n points from the unit sphere */
+inline PointCloud makeSphere( unsigned n, unsigned seed = defaultSeed )
+{
+  return geometry::makeSphere( geometry::sphereSampling<DataType>( n, seed ), DataType(1) );
+}
+
+/**
+  Samples at most n points from a torus with an inner radius of 3 and
+  an outer radius of 1. Rejection sampling keeps about half of them.
+*/
+
+inline PointCloud makeTorus( unsigned n, unsigned seed = defaultSeed )
+{
+  return geometry::makeTorus( geometry::torusRejectionSampling<DataType>( DataType(3), DataType(1), n, seed ), DataType(3), DataType(1) );
+}
+
+/** Builds the Vietoris--Rips complex of a point cloud up to the given dimension */
+inline auto makeVietorisRipsComplex( const PointCloud& pointCloud, DataType epsilon, unsigned dimension )
+  -> decltype( geometry::buildVietorisRipsComplex( std::declval<NearestNeighbours>(), epsilon, dimension ) )
+{
+  NearestNeighbours nn( pointCloud );
+  return geometry::buildVietorisRipsComplex( nn, epsilon, dimension );
+}
+
+/** Generates a weighted random graph with n vertices and link probability p */
+inline auto makeRandomGraph( unsigned n, double p, unsigned seed = defaultSeed )
+  -> decltype( topology::generateWeightedRandomGraph( n, p, seed ) )
+{
+  return topology::generateWeightedRandomGraph( n, p, seed );
+}
+
+/**
+  Generates the values of a structured grid, with the first axis varying
+  the fastest. The values are a sum of sine waves with uniform noise, so
+  the grid has many critical points at different scales.
+*/
+
+inline std::vector<DataType> makeGrid( const std::vector<std::size_t>& shape, unsigned seed = defaultSeed )
+{
+  auto n = std::accumulate( shape.begin(), shape.end(), std::size_t(1), std::multiplies<std::size_t>() );
+
+  std::vector<DataType> values( n );
+
+  std::mt19937 rng( seed );
+  std::uniform_real_distribution<DataType> noise( DataType(-0.1), DataType(0.1) );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    auto index = i;
+    auto value = DataType();
+
+    for( std::size_t d = 0; d < shape.size(); d++ )
+    {
+      auto x = static_cast<DataType>( index % shape[d] ) / static_cast<DataType>( shape[d] );
+      index /= shape[d];
+
+      value += std::sin( DataType( 2 * M_PI ) * DataType( d + 2 ) * x );
+    }
+
+    values[i] = value + noise( rng );
+  }
+
+  return values;
+}
+
+/**
+  Generates a persistence diagram with n points, whose creation values
+  are uniformly distributed in [0,1] and whose persistence values follow
+  an exponential distribution. This resembles typical diagrams with few
+  persistent features.
+*/
+
+inline PersistenceDiagram makePersistenceDiagram( unsigned n, unsigned seed = defaultSeed )
+{
+  std::mt19937 rng( seed );
+  std::uniform_real_distribution<DataType> creation( DataType(0), DataType(1) );
+  std::exponential_distribution<DataType> persistence( DataType(10) );
+
+  PersistenceDiagram D;
+
+  for( unsigned i = 0; i < n; i++ )
+  {
+    auto x = creation( rng );
+    D.add( x, x + persistence( rng ) );
+  }
+
+  return D;
+}
+
+} // namespace benchmarks
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,135 @@
+/*
+  Benchmarks distances between persistence diagrams of increasing size,
+  as well as the calculation of means of multiple persistence diagrams,
+  using either exact assignments or auctions, and of the multi-scale
+  kernel between all pairs of a set of diagrams.
+*/
+
+#include "Base.hh"
+#include "Generators.hh"
+
+#include <aleph/persistenceDiagrams/Mean.hh>
+#include <aleph/persistenceDiagrams/MultiScaleKernel.hh>
+
+#include <aleph/persistenceDiagrams/distances/Bottleneck.hh>
+#include <aleph/persistenceDiagrams/distances/Hausdorff.hh>
+#include <aleph/persistenceDiagrams/distances/Wasserstein.hh>
+
+using namespace aleph::benchmarks;
+using namespace aleph::distances;
+
+int main( int argc, char** argv )
+{
+  Runner runner( argc, argv, "distances" );
+
+  for( unsigned n : { 50u, 100u, 200u } )
+  {
+    n = runner.scale( n );
+
+    auto D1 = makePersistenceDiagram( n, defaultSeed     );
+    auto D2 = makePersistenceDiagram( n, defaultSeed + 1 );
+
+    Parameters parameters = {
+      { "points", parameter( n ) }
+    };
+
+    runner.run( "bottleneck", parameters,
+                [&D1, &D2] ()
+                {
+                  return bottleneckDistance( D1, D2 );
+                } );
+
+    runner.run( "hausdorff", parameters,
+                [&D1, &D2] ()
+                {
+                  return hausdorffDistance( D1, D2 );
+                } );
+
+    for( DataType power : { 1.0, 2.0 } )
+    {
+      parameters["power"] = parameter( power );
+
+      runner.run( "wasserstein", parameters,
+                  [&D1, &D2, &power] ()
+                  {
+                    return wassersteinDistance( D1, D2, power );
+                  } );
+    }
+  }
+
+  // Exact assignments are only feasible for small diagrams, so larger
+  // ones are only used for auctions.
+  for( unsigned n : { 20u, 300u } )
+  {
+    n      = runner.scale( n );
+    auto m = 16u;
+
+    std::vector< aleph::PersistenceDiagram<DataType> > diagrams;
+
+    for( unsigned i = 0; i < m; i++ )
+      diagrams.push_back( makePersistenceDiagram( n, defaultSeed + i ) );
+
+    Parameters parameters = {
+      { "points",   parameter( n ) },
+      { "diagrams", parameter( m ) }
+    };
+
+    if( n <= runner.scale( 20u ) )
+    {
+      runner.run( "mean/munkres", parameters,
+                  [&diagrams] ()
+                  {
+                    return aleph::mean( diagrams.begin(), diagrams.end() ).size();
+                  } );
+    }
+
+    runner.run( "mean/auction", parameters,
+                [&diagrams] ()
+                {
+                  aleph::FrechetMean<DataType> mean( diagrams.begin(), diagrams.end() );
+                  return mean( 1, defaultSeed ).size();
+                } );
+  }
+
+  {
+    auto n = runner.scale( 100u );
+    auto m = 32u;
+
+    std::vector< aleph::PersistenceDiagram<DataType> > diagrams;
+
+    for( unsigned i = 0; i < m; i++ )
+      diagrams.push_back( makePersistenceDiagram( n, defaultSeed + i ) );
+
+    Parameters parameters = {
+      { "points",   parameter( n ) },
+      { "diagrams", parameter( m ) }
+    };
+
+    runner.run( "multi_scale_kernel/pairwise", parameters,
+                [&diagrams] ()
+                {
+                  double sum = 0.0;
+
+                  for( std::size_t i = 0; i < diagrams.size(); i++ )
+                    for( std::size_t j = i + 1; j < diagrams.size(); j++ )
+                      sum += aleph::multiScalePseudoMetric( diagrams[i], diagrams[j], 1.0 );
+
+                  return sum;
+                } );
+
+    runner.run( "multi_scale_kernel/matrix", parameters,
+                [&diagrams] ()
+                {
+                  aleph::MultiScaleKernelMatrix matrix( diagrams.begin(), diagrams.end(), 1.0 );
+                  auto D = matrix.pseudoMetric();
+
+                  double sum = 0.0;
+
+                  for( std::size_t i = 0; i < diagrams.size(); i++ )
+                    for( std::size_t j = i + 1; j < diagrams.size(); j++ )
+                      sum += D( i, j );
+
+                  return sum;
+                } );
+  }
+}
@@ -0,0 +1,350 @@
+/*
+  Benchmarks the readers for meshes, volumes, filtrations, and persistence
+  diagrams. All input files are generated before the benchmarks run and
+  removed afterwards.
+*/
+
+#include "Base.hh"
+#include "Generators.hh"
+
+#include <aleph/persistenceDiagrams/io/Binary.hh>
+#include <aleph/persistenceDiagrams/io/Raw.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+#include <aleph/topology/CubicalComplex.hh>
+#include <aleph/topology/IndexedMesh.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/topology/io/BinaryFiltration.hh>
+#include <aleph/topology/io/PLY.hh>
+#include <aleph/topology/io/VTK.hh>
+#include <aleph/topology/io/Volume.hh>
+
+#include <aleph/topology/representations/Mapped.hh>
+#include <aleph/topology/representations/Vector.hh>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace aleph::benchmarks;
+using namespace aleph::topology;
+
+namespace
+{
+
+std::string makeFilename( const std::string& name )
+{
+  return CMAKE_CURRENT_BINARY_DIR + std::string( "/" ) + name;
+}
+
+std::ofstream makeStream( const std::string& filename )
+{
+  std::ofstream out( filename, std::ios::binary );
+  if( !out )
+    throw std::runtime_error( "Unable to open '" + filename + "' for writing" );
+
+  return out;
+}
+
+/** Writes a value in big-endian byte order */
+void writeBigEndian( std::ofstream& out, double value )
+{
+  std::uint64_t bits;
+  std::memcpy( &bits, &value, sizeof(bits) );
+
+  if( io::detail::isLittleEndian() )
+    bits = io::detail::swapBytes( bits );
+
+  out.write( reinterpret_cast<const char*>( &bits ), sizeof(bits) );
+}
+
+/**
+  Writes a triangulated grid with n x n vertices in PLY format, using the
+  values of a structured grid as the z coordinate.
+*/
+
+void writeMesh( const std::string& filename, std::size_t n, bool binary )
+{
+  auto values = makeGrid( { n, n } );
+  auto out    = makeStream( filename );
+
+  out << "ply\n"
+      << "format " << ( binary ? "binary_little_endian" : "ascii" ) << " 1.0\n"
+      << "element vertex " << n * n << "\n"
+      << "property float x\n"
+      << "property float y\n"
+      << "property float z\n"
+      << "element face " << 2 * ( n - 1 ) * ( n - 1 ) << "\n"
+      << "property list uchar int vertex_indices\n"
+      << "end_header\n";
+
+  for( std::size_t y = 0; y < n; y++ )
+  {
+    for( std::size_t x = 0; x < n; x++ )
+    {
+      float coordinates[3] = { static_cast<float>( x ), static_cast<float>( y ), static_cast<float>( values[y*n+x] ) };
+
+      if( binary )
+        out.write( reinterpret_cast<const char*>( coordinates ), sizeof(coordinates) );
+      else
+        out << coordinates[0] << " " << coordinates[1] << " " << coordinates[2] << "\n";
+    }
+  }
+
+  for( std::size_t y = 0; y + 1 < n; y++ )
+  {
+    for( std::size_t x = 0; x + 1 < n; x++ )
+    {
+      auto i = static_cast<std::int32_t>( y * n + x );
+      auto m = static_cast<std::int32_t>( n );
+
+      std::int32_t faces[2][3] = {
+        { i, i + 1, i + m     },
+        { i + 1, i + m + 1, i + m }
+      };
+
+      for( auto&& face : faces )
+      {
+        if( binary )
+        {
+          unsigned char size = 3;
+
+          out.write( reinterpret_cast<const char*>( &size ), sizeof(size) );
+          out.write( reinterpret_cast<const char*>( face ), sizeof(face) );
+        }
+        else
+          out << "3 " << face[0] << " " << face[1] << " " << face[2] << "\n";
+      }
+    }
+  }
+}
+
+/** Writes a structured grid with n^3 vertices as a binary VTK file */
+void writeVTKVolume( const std::string& filename, std::size_t n )
+{
+  auto values = makeGrid( { n, n, n } );
+  auto out    = makeStream( filename );
+
+  out << "# vtk DataFile Version 3.0\n"
+      << "Benchmark volume\n"
+      << "BINARY\n"
+      << "DATASET STRUCTURED_POINTS\n"
+      << "DIMENSIONS " << n << " " << n << " " << n << "\n"
+      << "ORIGIN 0 0 0\n"
+      << "SPACING 1 1 1\n"
+      << "POINT_DATA " << values.size() << "\n"
+      << "SCALARS values double 1\n"
+      << "LOOKUP_TABLE default\n";
+
+  for( auto&& value : values )
+    writeBigEndian( out, value );
+}
+
+/** Writes a structured grid with n^3 vertices in raw format */
+void writeRawVolume( const std::string& filename, std::size_t n )
+{
+  auto values = makeGrid( { n, n, n } );
+  auto out    = makeStream( filename );
+
+  out.write( reinterpret_cast<const char*>( values.data() ), static_cast<std::streamsize>( values.size() * sizeof(DataType) ) );
+}
+
+void benchmarkMeshes( Runner& runner, std::vector<std::string>& files )
+{
+  auto n = runner.scale( std::size_t(512) );
+
+  for( bool binary : { false, true } )
+  {
+    auto filename = makeFilename( binary ? "Mesh_binary.ply" : "Mesh_ascii.ply" );
+    writeMesh( filename, n, binary );
+    files.push_back( filename );
+
+    Parameters parameters = {
+      { "format",   binary ? "binary" : "ascii" },
+      { "vertices", parameter( n * n ) }
+    };
+
+    runner.run( "ply/indexed_mesh", parameters,
+                [&filename] ()
+                {
+                  IndexedMesh<float, float> M;
+
+                  io::PLYReader reader;
+                  reader( filename, M );
+
+                  return M.numVertices();
+                } );
+  }
+}
+
+void benchmarkVolumes( Runner& runner, std::vector<std::string>& files )
+{
+  auto n = runner.scale( std::size_t(96) );
+
+  Parameters parameters = {
+    { "vertices", parameter( n * n * n ) }
+  };
+
+  auto vtk = makeFilename( "Volume.vtk" );
+  auto raw = makeFilename( "Volume.raw" );
+
+  writeVTKVolume( vtk, n );
+  writeRawVolume( raw, n );
+
+  files.push_back( vtk );
+  files.push_back( raw );
+
+  runner.run( "volume/vtk", parameters,
+              [&vtk] ()
+              {
+                return io::loadVTKVolume<DataType>( vtk ).size();
+              } );
+
+  runner.run( "volume/vtk_cubical_complex", parameters,
+              [&vtk] ()
+              {
+                CubicalComplex<DataType> C;
+
+                io::VTKStructuredGridReader reader;
+                reader( vtk, C );
+
+                return C.size();
+              } );
+
+  runner.run( "volume/raw", parameters,
+              [&raw, &n] ()
+              {
+                return io::loadRawVolume<DataType>( raw, { n, n, n }, io::scalarTypeOf<DataType>(), false, 0 ).size();
+              } );
+}
+
+void benchmarkFiltrations( Runner& runner, std::vector<std::string>& files )
+{
+  auto n = runner.scale( 600u );
+  auto K = makeVietorisRipsComplex( makeSphere( n ), 0.35, 2 );
+
+  using SimplicialComplex = decltype(K);
+
+  for( bool compressed : { false, true } )
+  {
+    auto filename = makeFilename( compressed ? "Filtration_compressed.bf" : "Filtration.bf" );
+
+    io::BinaryFiltrationWriter writer;
+    writer.setCompression( compressed );
+    writer.setBoundaryMatrix( true );
+    writer( filename, K );
+
+    files.push_back( filename );
+
+    Parameters parameters = {
+      { "compressed", compressed ? "true" : "false" },
+      { "simplices",  parameter( K.size() ) }
+    };
+
+    runner.run( "binary_filtration/simplicial_complex", parameters,
+                [&filename] ()
+                {
+                  SimplicialComplex L;
+
+                  io::BinaryFiltrationReader reader;
+                  reader( filename, L );
+
+                  return L.size();
+                } );
+
+    runner.run( "binary_filtration/boundary_matrix/vector", parameters,
+                [&filename] ()
+                {
+                  BoundaryMatrix< representations::Vector<unsigned> > M;
+                  std::vector<DataType> values;
+
+                  io::BinaryFiltrationReader reader;
+                  reader( filename, M, values );
+
+                  return M.getNumColumns();
+                } );
+
+    runner.run( "binary_filtration/boundary_matrix/mapped", parameters,
+                [&filename] ()
+                {
+                  BoundaryMatrix< representations::Mapped<unsigned> > M;
+                  std::vector<DataType> values;
+
+                  io::BinaryFiltrationReader reader;
+                  reader( filename, M, values );
+
+                  return M.getNumColumns();
+                } );
+  }
+}
+
+void benchmarkPersistenceDiagrams( Runner& runner, std::vector<std::string>& files )
+{
+  auto m = runner.scale( 100u );
+  auto n = 1000u;
+
+  std::vector<PersistenceDiagram> diagrams;
+  std::vector<std::string> filenames;
+
+  for( unsigned i = 0; i < m; i++ )
+  {
+    diagrams.push_back( makePersistenceDiagram( n, defaultSeed + i ) );
+    filenames.push_back( makeFilename( "Diagram_" + parameter( i ) + ".txt" ) );
+
+    auto out = makeStream( filenames.back() );
+    out << std::setprecision( 17 ) << diagrams.back();
+  }
+
+  auto container = makeFilename( "Diagrams.bpd" );
+  aleph::io::writeBinary( container, diagrams );
+
+  files.insert( files.end(), filenames.begin(), filenames.end() );
+  files.push_back( container );
+
+  Parameters parameters = {
+    { "diagrams", parameter( m ) },
+    { "points",   parameter( n ) }
+  };
+
+  runner.run( "persistence_diagrams/raw", parameters,
+              [&filenames] ()
+              {
+                std::size_t points = 0;
+
+                for( auto&& filename : filenames )
+                  points += aleph::io::load<DataType>( filename ).size();
+
+                return points;
+              } );
+
+  runner.run( "persistence_diagrams/binary", parameters,
+              [&container] ()
+              {
+                return aleph::io::readBinary<DataType>( container ).size();
+              } );
+}
+
+} // namespace
+
+int main( int argc, char** argv )
+{
+  std::vector<std::string> files;
+
+  {
+    Runner runner( argc, argv, "io" );
+
+    benchmarkMeshes( runner, files );
+    benchmarkVolumes( runner, files );
+    benchmarkFiltrations( runner, files );
+    benchmarkPersistenceDiagrams( runner, files );
+  }
+
+  for( auto&& filename : files )
+    std::remove( filename.c_str() );
+}
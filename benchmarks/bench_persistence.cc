@@ -0,0 +1,510 @@
+/*
+  Benchmarks the construction of boundary matrices and their reduction,
+  using every combination of reduction algorithm and representation, as
+  well as the complete persistence calculation, the calculation of single
+  dimensions, and the persistence calculation for cubical complexes.
+  Merge trees are compared to the tracking of connected components, and
+  the dedicated calculation for 1D functions to the generic one, as is
+  the batched calculation for many functions on the same complex. The
+  vineyard is compared to recalculating the persistence diagrams of a
+  function that changes in small steps. Persistent intersection homology
+  is calculated for multiple perversities, both separately and with the
+  same precomputed strata.
+*/
+
+#include "Base.hh"
+#include "Generators.hh"
+
+#include <aleph/geometry/RipsExpander.hh>
+
+#include <aleph/persistentHomology/BatchedPersistence.hh>
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/ConnectedComponents.hh>
+#include <aleph/persistentHomology/CubicalPersistence.hh>
+#include <aleph/persistentHomology/FunctionPersistence.hh>
+#include <aleph/persistentHomology/PhiPersistence.hh>
+#include <aleph/persistentHomology/Vineyard.hh>
+
+#include <aleph/persistentHomology/algorithms/Standard.hh>
+#include <aleph/persistentHomology/algorithms/Twist.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+#include <aleph/topology/Conversions.hh>
+#include <aleph/topology/CubicalComplex.hh>
+#include <aleph/topology/MergeTree.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+#include <aleph/topology/filtrations/LowerStar.hh>
+
+#include <aleph/topology/representations/List.hh>
+#include <aleph/topology/representations/Mapped.hh>
+#include <aleph/topology/representations/Set.hh>
+#include <aleph/topology/representations/Vector.hh>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace aleph::benchmarks;
+using namespace aleph::topology;
+
+using Index = unsigned;
+
+/** Creates a boundary matrix that refers to the columns of another matrix */
+template <class Representation> BoundaryMatrix< representations::Mapped<Index> > makeMappedMatrix( const BoundaryMatrix<Representation>& M )
+{
+  auto n       = static_cast<std::size_t>( M.getNumColumns() );
+  auto offsets = std::make_shared< std::vector<std::uint64_t> >( n + 1 );
+  auto indices = std::make_shared< std::vector<Index> >();
+
+  for( std::size_t j = 0; j < n; j++ )
+  {
+    auto column = M.getColumn( Index( j ) );
+
+    indices->insert( indices->end(), column.begin(), column.end() );
+    ( *offsets )[j+1] = indices->size();
+  }
+
+  return BoundaryMatrix< representations::Mapped<Index> >(
+    representations::Mapped<Index>( std::shared_ptr<const std::uint64_t>( offsets, offsets->data() ),
+                                    std::shared_ptr<const Index>( indices, indices->data() ),
+                                    n ) );
+}
+
+template <class Algorithm, class Representation> void benchmarkReduction( Runner& runner,
+                                                                          const std::string& name,
+                                                                          Parameters parameters,
+                                                                          const BoundaryMatrix<Representation>& M )
+{
+  for( bool dualize : { false, true } )
+  {
+    auto B = dualize ? M.dualize() : M;
+
+    parameters["dualized"] = dualize ? "true" : "false";
+
+    runner.run( name, parameters,
+                [&B] ()
+                {
+                  return B;
+                },
+                [] ( BoundaryMatrix<Representation>& B )
+                {
+                  Algorithm algorithm;
+                  algorithm( B );
+
+                  return B.getNumColumns();
+                } );
+  }
+}
+
+template <class Representation, class SimplicialComplex> void benchmarkRepresentation( Runner& runner,
+                                                                                      const std::string& representation,
+                                                                                      Parameters parameters,
+                                                                                      const SimplicialComplex& K )
+{
+  using namespace aleph::persistentHomology::algorithms;
+
+  parameters["representation"] = representation;
+
+  runner.run( "boundary_matrix/" + representation, parameters,
+              [&K] ()
+              {
+                return makeBoundaryMatrix<Representation>( K );
+              } );
+
+  auto M = makeBoundaryMatrix<Representation>( K );
+
+  benchmarkReduction<Standard>( runner, "reduction/standard/" + representation, parameters, M );
+  benchmarkReduction<Twist>   ( runner, "reduction/twist/"    + representation, parameters, M );
+}
+
+template <class SimplicialComplex> void benchmarkComplex( Runner& runner, const std::string& input, const SimplicialComplex& K )
+{
+  using namespace aleph::persistentHomology::algorithms;
+
+  Parameters parameters = {
+    { "input",     input },
+    { "simplices", parameter( K.size() ) }
+  };
+
+  benchmarkRepresentation< representations::List<Index> >  ( runner, "list",   parameters, K );
+  benchmarkRepresentation< representations::Set<Index> >   ( runner, "set",    parameters, K );
+  benchmarkRepresentation< representations::Vector<Index> >( runner, "vector", parameters, K );
+
+  // The mapped representation is never created from a simplicial complex
+  // directly, so only its reduction is measured.
+  auto M = makeMappedMatrix( makeBoundaryMatrix< representations::Vector<Index> >( K ) );
+
+  parameters["representation"] = "mapped";
+
+  benchmarkReduction<Standard>( runner, "reduction/standard/mapped", parameters, M );
+  benchmarkReduction<Twist>   ( runner, "reduction/twist/mapped",    parameters, M );
+
+  // Complete calculation compared to the calculation of every single
+  // dimension, which only converts the simplices it requires.
+  parameters.erase( "representation" );
+
+  runner.run( "persistence_diagrams/all", parameters,
+              [&K] ()
+              {
+                return aleph::calculatePersistenceDiagrams( K, false ).size();
+              } );
+
+  for( std::size_t d : { 0, 1 } )
+  {
+    parameters["dimension"] = parameter( d );
+
+    runner.run( "persistence_diagrams/single", parameters,
+                [&K, &d] ()
+                {
+                  return aleph::calculatePersistenceDiagram( K, d ).size();
+                } );
+  }
+}
+
+/**
+  Creates the lower-star filtration of the 1-skeleton of a structured
+  grid in two dimensions, i.e. every edge is assigned the maximum value
+  of its vertices.
+*/
+
+SimplicialComplex<Simplex<DataType, Index> > makeGridGraph( std::size_t n )
+{
+  using Simplex = aleph::topology::Simplex<DataType, Index>;
+
+  auto values = makeGrid( { n, n } );
+
+  std::vector<Simplex> simplices;
+  simplices.reserve( 3 * n * n );
+
+  for( std::size_t i = 0; i < n * n; i++ )
+    simplices.push_back( Simplex( Index( i ), values[i] ) );
+
+  for( std::size_t y = 0; y < n; y++ )
+  {
+    for( std::size_t x = 0; x < n; x++ )
+    {
+      auto i = y * n + x;
+
+      if( x + 1 < n )
+        simplices.push_back( Simplex( { Index( i ), Index( i + 1 ) }, std::max( values[i], values[i+1] ) ) );
+
+      if( y + 1 < n )
+        simplices.push_back( Simplex( { Index( i ), Index( i + n ) }, std::max( values[i], values[i+n] ) ) );
+    }
+  }
+
+  SimplicialComplex<Simplex> K( simplices.begin(), simplices.end() );
+  K.sort( filtrations::Data<Simplex>() );
+
+  return K;
+}
+
+int main( int argc, char** argv )
+{
+  Runner runner( argc, argv, "persistence" );
+
+  {
+    auto n = runner.scale( 600u );
+    auto K = makeVietorisRipsComplex( makeSphere( n ), 0.35, 2 );
+
+    benchmarkComplex( runner, "sphere_" + parameter( n ), K );
+  }
+
+  {
+    auto n = runner.scale( 400u );
+    auto G = makeRandomGraph( n, 0.05 );
+
+    using SimplicialComplex = decltype(G);
+    using Simplex           = typename SimplicialComplex::ValueType;
+
+    aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
+
+    auto K = ripsExpander( G, 2 );
+    K      = ripsExpander.assignMaximumWeight( K );
+
+    K.sort( filtrations::Data<Simplex>() );
+
+    benchmarkComplex( runner, "random_graph_" + parameter( n ), K );
+  }
+
+  {
+    auto n = runner.scale( std::size_t(256) );
+    auto K = makeGridGraph( n );
+
+    Parameters parameters = {
+      { "input",     "grid_" + parameter( n ) + "^2" },
+      { "simplices", parameter( K.size() ) }
+    };
+
+    runner.run( "connected_components", parameters,
+                [&K] ()
+                {
+                  return std::get<0>( aleph::calculateZeroDimensionalPersistenceDiagram( K ) ).size();
+                } );
+
+    runner.run( "merge_tree", parameters,
+                [&K] ()
+                {
+                  std::vector<Index> vertices;
+                  return makeMergeTree( K, vertices ).persistenceDiagram().size();
+                } );
+  }
+
+  {
+    auto n = runner.scale( std::size_t(200) );
+    auto m = std::size_t(1000);
+
+    // Random walks of the same length, stored consecutively
+    std::vector<DataType> values;
+    std::vector<std::size_t> offsets( 1, 0 );
+
+    {
+      std::mt19937 rng( defaultSeed );
+      std::normal_distribution<DataType> distribution;
+
+      for( std::size_t i = 0; i < n; i++ )
+      {
+        auto value = DataType();
+
+        for( std::size_t j = 0; j < m; j++ )
+          values.push_back( value += distribution( rng ) );
+
+        offsets.push_back( values.size() );
+      }
+    }
+
+    Parameters parameters = {
+      { "input",  "random_walks_" + parameter( n ) + "x" + parameter( m ) }
+    };
+
+    runner.run( "functions/complex", parameters,
+                [&values, &offsets, &n] ()
+                {
+                  using Simplex = aleph::topology::Simplex<DataType, Index>;
+
+                  std::size_t numPoints = 0;
+
+                  for( std::size_t i = 0; i < n; i++ )
+                  {
+                    SimplicialComplex<Simplex> K;
+
+                    for( auto j = offsets[i]; j < offsets[i+1]; j++ )
+                      K.push_back( Simplex( Index( j - offsets[i] ), values[j] ) );
+
+                    for( auto j = offsets[i]; j + 1 < offsets[i+1]; j++ )
+                      K.push_back( Simplex( { Index( j - offsets[i] ), Index( j - offsets[i] + 1 ) }, std::max( values[j], values[j+1] ) ) );
+
+                    K.sort( filtrations::Data<Simplex>() );
+                    numPoints += aleph::calculatePersistenceDiagrams( K ).front().size();
+                  }
+
+                  return numPoints;
+                } );
+
+    runner.run( "functions/batch", parameters,
+                [&values, &offsets] ()
+                {
+                  std::vector<DataType> points;
+                  std::vector<std::size_t> pointOffsets;
+
+                  aleph::calculateFunctionPersistenceDiagrams( values, offsets, points, pointOffsets );
+                  return points.size();
+                } );
+  }
+
+  {
+    auto n = runner.scale( 300u );
+    auto m = std::size_t(32);
+    auto K = makeVietorisRipsComplex( makeSphere( n ), 0.35, 2 );
+
+    using SimplicialComplex = decltype(K);
+    using Simplex           = typename SimplicialComplex::ValueType;
+
+    // Random functions on the vertices, stored consecutively
+    std::vector<DataType> values( m * n );
+
+    {
+      std::mt19937 rng( defaultSeed );
+      std::uniform_real_distribution<DataType> distribution;
+
+      for( auto&& value : values )
+        value = distribution( rng );
+    }
+
+    Parameters parameters = {
+      { "input",     "sphere_" + parameter( n ) + "x" + parameter( m ) },
+      { "simplices", parameter( K.size() ) }
+    };
+
+    runner.run( "vertex_functions/complex", parameters,
+                [&K, &values, &n, &m] ()
+                {
+                  aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
+
+                  std::size_t numDiagrams = 0;
+
+                  for( std::size_t i = 0; i < m; i++ )
+                  {
+                    auto begin = values.begin() + static_cast<std::ptrdiff_t>( i * n );
+                    auto L     = ripsExpander.assignMaximumData( K, begin, begin + static_cast<std::ptrdiff_t>( n ) );
+
+                    L.sort( filtrations::Data<Simplex>() );
+                    numDiagrams += aleph::calculatePersistenceDiagrams( L ).size();
+                  }
+
+                  return numDiagrams;
+                } );
+
+    runner.run( "vertex_functions/batch", parameters,
+                [&K, &values] ()
+                {
+                  aleph::BatchedPersistence<Simplex> batchedPersistence( K );
+                  return batchedPersistence( values ).size();
+                } );
+  }
+
+  {
+    auto n = runner.scale( 300u );
+    auto m = std::size_t(32);
+    auto K = makeVietorisRipsComplex( makeSphere( n ), 0.35, 2 );
+
+    using SimplicialComplex = decltype(K);
+    using Simplex           = typename SimplicialComplex::ValueType;
+
+    // Function that changes in small steps; every step is stored as one
+    // vector of vertex values
+    std::vector< std::vector<DataType> > steps( m, std::vector<DataType>( n ) );
+
+    {
+      std::mt19937 rng( defaultSeed );
+      std::normal_distribution<DataType> distribution;
+
+      for( auto&& value : steps.front() )
+        value = distribution( rng );
+
+      for( std::size_t i = 1; i < m; i++ )
+        for( std::size_t j = 0; j < n; j++ )
+          steps[i][j] = steps[i-1][j] + 0.01 * distribution( rng );
+    }
+
+    Parameters parameters = {
+      { "input",     "sphere_" + parameter( n ) + "x" + parameter( m ) },
+      { "simplices", parameter( K.size() ) }
+    };
+
+    runner.run( "time_varying/recompute", parameters,
+                [&K, &steps] ()
+                {
+                  std::size_t numDiagrams = 0;
+
+                  for( auto&& values : steps )
+                  {
+                    filtrations::LowerStar<Simplex> functor( values.begin(), values.end() );
+
+                    auto L = K;
+                    L.sort( std::ref( functor ) );
+
+                    numDiagrams += aleph::calculatePersistenceDiagrams( L ).size();
+                  }
+
+                  return numDiagrams;
+                } );
+
+    runner.run( "time_varying/vineyard", parameters,
+                [&K, &steps] ()
+                {
+                  aleph::Vineyard<Simplex> vineyard( K, steps.front() );
+
+                  std::size_t numVines = 0;
+
+                  for( std::size_t i = 1; i < steps.size(); i++ )
+                    numVines += vineyard.update( steps[i] ).size();
+
+                  return numVines;
+                } );
+  }
+
+  {
+    auto n = runner.scale( 600u );
+    auto K = makeVietorisRipsComplex( makeSphere( n ), 0.35, 2 );
+
+    using SimplicialComplex = decltype(K);
+    using Simplex           = typename SimplicialComplex::ValueType;
+
+    // The singular strata consist of a few vertices and of the edges
+    // between a subset of the vertices, including their faces.
+    std::vector<SimplicialComplex> X( 3 );
+
+    {
+      std::vector<Simplex> X0;
+      std::vector<Simplex> X1;
+
+      for( auto&& s : K )
+      {
+        if( s.dimension() == 0 && *s.begin() % 10 == 0 )
+          X0.push_back( s );
+
+        if( s.dimension() <= 1 && *s.begin() < n / 3 )
+          X1.push_back( s );
+      }
+
+      X[0] = SimplicialComplex( X0.begin(), X0.end() );
+      X[1] = SimplicialComplex( X1.begin(), X1.end() );
+      X[2] = K;
+    }
+
+    std::vector<aleph::Perversity> perversities = {
+      aleph::Perversity( {-1, -1} ),
+      aleph::Perversity( {-1,  0} ),
+      aleph::Perversity( {-1,  1} ),
+      aleph::Perversity( { 0,  0} ),
+      aleph::Perversity( { 0,  1} )
+    };
+
+    Parameters parameters = {
+      { "input",        "sphere_" + parameter( n ) },
+      { "simplices",    parameter( K.size() ) },
+      { "perversities", parameter( perversities.size() ) }
+    };
+
+    runner.run( "intersection_homology/separate", parameters,
+                [&K, &X, &perversities] ()
+                {
+                  std::size_t numDiagrams = 0;
+
+                  for( auto&& p : perversities )
+                    numDiagrams += aleph::calculateIntersectionHomology( K, X, p ).size();
+
+                  return numDiagrams;
+                } );
+
+    runner.run( "intersection_homology/sweep", parameters,
+                [&K, &X, &perversities] ()
+                {
+                  aleph::PersistentIntersectionHomology<Simplex> intersectionHomology( K, X );
+                  return intersectionHomology( perversities ).size();
+                } );
+  }
+
+  {
+    auto n = runner.scale( std::size_t(48) );
+
+    CubicalComplex<DataType> C( { n, n, n }, makeGrid( { n, n, n } ) );
+
+    Parameters parameters = {
+      { "input", "grid_" + parameter( n ) + "^3" },
+      { "cells", parameter( C.size() ) }
+    };
+
+    runner.run( "cubical_persistence", parameters,
+                [&C] ()
+                {
+                  return aleph::calculatePersistenceDiagrams( C ).size();
+                } );
+  }
+}
@@ -0,0 +1,120 @@
+/*
+  Benchmarks the construction of Vietoris--Rips complexes, i.e. the
+  calculation of their 1-skeleton, the expansion to higher dimensions,
+  and the assignment of weights. Sorting the complex by the keys of the
+  filtration is compared to sorting it with comparisons. Finally, the
+  barycentric subdivision of the complex is calculated.
+*/
+
+#include "Base.hh"
+#include "Generators.hh"
+
+#include <aleph/geometry/RipsExpander.hh>
+#include <aleph/geometry/RipsExpanderTopDown.hh>
+#include <aleph/geometry/RipsSkeleton.hh>
+
+#include <aleph/topology/BarycentricSubdivision.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <string>
+
+using namespace aleph::benchmarks;
+
+void benchmarkPointCloud( Runner& runner, const std::string& input, const PointCloud& pointCloud, DataType epsilon, unsigned dimension )
+{
+  using RipsSkeleton      = aleph::geometry::RipsSkeleton<NearestNeighbours>;
+  using SimplicialComplex = typename RipsSkeleton::SimplicialComplex;
+  using Simplex           = typename SimplicialComplex::ValueType;
+
+  Parameters parameters = {
+    { "input",     input },
+    { "points",    parameter( pointCloud.size() ) },
+    { "epsilon",   parameter( epsilon ) },
+    { "dimension", parameter( dimension ) }
+  };
+
+  NearestNeighbours nn( pointCloud );
+  RipsSkeleton ripsSkeleton;
+
+  runner.run( "rips/skeleton", parameters,
+              [&nn, &ripsSkeleton, &epsilon] ()
+              {
+                return ripsSkeleton( nn, epsilon ).size();
+              } );
+
+  auto skeleton = ripsSkeleton( nn, epsilon );
+
+  parameters["edges"] = parameter( skeleton.size() - pointCloud.size() );
+
+  aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
+
+  runner.run( "rips/expansion", parameters,
+              [&skeleton, &ripsExpander, &dimension] ()
+              {
+                return ripsExpander( skeleton, dimension ).size();
+              } );
+
+  aleph::geometry::RipsExpanderTopDown<SimplicialComplex> ripsExpanderTopDown;
+
+  runner.run( "rips/expansion_top_down", parameters,
+              [&skeleton, &ripsExpanderTopDown, &dimension] ()
+              {
+                return ripsExpanderTopDown( skeleton, dimension ).size();
+              } );
+
+  auto K = ripsExpander( skeleton, dimension );
+
+  runner.run( "rips/weights", parameters,
+              [&K, &ripsExpander] ()
+              {
+                return ripsExpander.assignMaximumWeight( K ).size();
+              } );
+
+  K = ripsExpander.assignMaximumWeight( K );
+
+  runner.run( "rips/sort", parameters,
+              [&K] ()
+              {
+                return K;
+              },
+              [] ( SimplicialComplex& L )
+              {
+                L.sort( aleph::topology::filtrations::Data<Simplex>() );
+                return L.size();
+              } );
+
+  runner.run( "rips/sort_comparison", parameters,
+              [&K] ()
+              {
+                return K;
+              },
+              [] ( SimplicialComplex& L )
+              {
+                aleph::topology::filtrations::Data<Simplex> filtration;
+
+                L.sort( [&filtration] ( const Simplex& s, const Simplex& t ) { return filtration( s, t ); } );
+                return L.size();
+              } );
+
+  runner.run( "rips/barycentric_subdivision", parameters,
+              [&K] ()
+              {
+                return aleph::topology::BarycentricSubdivision()( K ).size();
+              } );
+}
+
+int main( int argc, char** argv )
+{
+  Runner runner( argc, argv, "rips" );
+
+  {
+    auto n = runner.scale( 1000u );
+    benchmarkPointCloud( runner, "sphere_" + parameter( n ), makeSphere( n ), 0.3, 2 );
+  }
+
+  {
+    auto n = runner.scale( 2000u );
+    benchmarkPointCloud( runner, "torus_" + parameter( n ), makeTorus( n ), 0.6, 2 );
+  }
+}
@@ -1,15 +1,161 @@
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 
+#include <aleph/geometry/RipsExpander.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistenceDiagrams/distances/Bottleneck.hh>
+#include <aleph/persistenceDiagrams/distances/Hausdorff.hh>
+#include <aleph/persistenceDiagrams/distances/Wasserstein.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace py = pybind11;
 
 using DataType   = double;
 using VertexType = unsigned;
 
-using Simplex           = aleph::topology::Simplex<DataType, VertexType>;
-using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+using Simplex            = aleph::topology::Simplex<DataType, VertexType>;
+using SimplicialComplex  = aleph::topology::SimplicialComplex<Simplex>;
+using PersistenceDiagram = aleph::PersistenceDiagram<DataType>;
+
+// Arrays are only copied by NumPy if their type or their memory layout
+// does not match; otherwise, the bindings operate on their buffers.
+using Array      = py::array_t<DataType,     py::array::c_style | py::array::forcecast>;
+using IndexArray = py::array_t<std::int64_t, py::array::c_style | py::array::forcecast>;
+
+/*
+  Flattened persistence diagram, i.e. the dimension of the diagram and
+  its points, stored as consecutive pairs of creation and destruction
+  values. This is what is handed over to NumPy.
+*/
+
+using FlatDiagram = std::pair<std::size_t, std::vector<DataType> >;
+
+/**
+  Creates an array with the given number of columns, e.g. of shape (n,2)
+  for a flattened diagram. The array takes ownership of the values, so
+  they are not copied again, and no Python object is created for any of
+  the values.
+*/
+
+py::array makeArray( std::vector<DataType>&& values, std::size_t columns = 2 )
+{
+  auto data = new std::vector<DataType>( std::move( values ) );
+
+  py::capsule owner( data, [] ( void* pointer )
+                           {
+                             delete reinterpret_cast< std::vector<DataType>* >( pointer );
+                           } );
+
+  return py::array_t<DataType>( { columns == 0 ? 0 : data->size() / columns, columns },
+                                data->data(),
+                                owner );
+}
+
+/** Converts flattened diagrams to a dictionary that maps dimensions to arrays */
+py::dict makeDictionary( std::vector<FlatDiagram>&& diagrams )
+{
+  py::dict result;
+
+  for( auto&& diagram : diagrams )
+    result[ py::int_( diagram.first ) ] = makeArray( std::move( diagram.second ) );
+
+  return result;
+}
+
+/**
+  Creates a persistence diagram from the buffer of an array of shape
+  (n,2). This does not require the global interpreter lock, as long as
+  the buffer has been requested beforehand.
+*/
+
+PersistenceDiagram makeDiagram( const py::buffer_info& buffer )
+{
+  if( buffer.ndim != 2 || buffer.shape[1] != 2 )
+    throw std::runtime_error( "Persistence diagrams must be arrays of shape (n,2)" );
+
+  auto n      = static_cast<std::size_t>( buffer.shape[0] );
+  auto points = static_cast<const DataType*>( buffer.ptr );
+
+  PersistenceDiagram D;
+
+  for( std::size_t i = 0; i < n; i++ )
+    D.add( points[2*i], points[2*i+1] );
+
+  return D;
+}
+
+/**
+  Expands a 1-skeleton, i.e. a set of vertices and weighted edges, to a
+  Vietoris--Rips complex, and calculates its persistence diagrams. Every
+  simplex is assigned the maximum weight of its edges.
+
+  @param skeleton  Vertices and edges of the complex
+  @param dimension Maximum dimension of simplices in the expansion
+*/
+
+std::vector<FlatDiagram> calculateVietorisRipsPersistence( const std::vector<Simplex>& skeleton, unsigned dimension )
+{
+  aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
+
+  auto K = ripsExpander( SimplicialComplex( skeleton.begin(), skeleton.end() ), dimension );
+  K      = ripsExpander.assignMaximumWeight( K );
+
+  K.sort( aleph::topology::filtrations::Data<Simplex>() );
+
+  auto diagrams = aleph::calculatePersistenceDiagrams( K );
+
+  std::vector<FlatDiagram> result;
+  result.reserve( diagrams.size() );
+
+  for( auto&& D : diagrams )
+  {
+    std::vector<DataType> points;
+    points.reserve( 2 * D.size() );
+
+    for( auto&& p : D )
+    {
+      points.push_back( p.x() );
+      points.push_back( p.y() );
+    }
+
+    result.emplace_back( D.dimension(), std::move( points ) );
+  }
+
+  return result;
+}
+
+/** Creates the vertices of a 1-skeleton, all of which have a weight of zero */
+std::vector<Simplex> makeVertices( std::size_t n )
+{
+  if( n > std::numeric_limits<VertexType>::max() )
+    throw std::runtime_error( "Too many vertices" );
+
+  std::vector<Simplex> simplices;
+  simplices.reserve( n );
+
+  for( std::size_t i = 0; i < n; i++ )
+    simplices.push_back( Simplex( VertexType( i ) ) );
+
+  return simplices;
+}
 
 void wrapSimplex( py::module& m )
 {
@@ -92,12 +238,244 @@ void wrapSimplicialComplex( py::module& m )
     );
 }
 
+/*
+  Entry points that operate on NumPy arrays directly. All of them release
+  the global interpreter lock while calculating, so they may be used from
+  multiple Python threads. Persistence diagrams are returned as arrays of
+  shape (n,2), with one row per point.
+*/
+
+void wrapNumPy( py::module& m )
+{
+  m.def( "vietoris_rips_persistence",
+         [] ( Array points, DataType epsilon, unsigned dimension )
+         {
+           auto buffer = points.request();
+
+           if( buffer.ndim != 2 )
+             throw std::runtime_error( "Point clouds must be arrays of shape (n,d)" );
+
+           std::vector<FlatDiagram> diagrams;
+
+           {
+             py::gil_scoped_release release;
+
+             auto n    = static_cast<std::size_t>( buffer.shape[0] );
+             auto d    = static_cast<std::size_t>( buffer.shape[1] );
+             auto data = static_cast<const DataType*>( buffer.ptr );
+
+             std::vector< std::vector<Simplex> > edges( n );
+
+             #pragma omp parallel for schedule(dynamic, 16)
+             for( std::size_t i = 0; i < n; i++ )
+             {
+               for( std::size_t j = i + 1; j < n; j++ )
+               {
+                 DataType distance = DataType();
+
+                 for( std::size_t k = 0; k < d; k++ )
+                   distance += ( data[i*d+k] - data[j*d+k] ) * ( data[i*d+k] - data[j*d+k] );
+
+                 distance = std::sqrt( distance );
+
+                 if( distance <= epsilon )
+                   edges[i].push_back( Simplex( { VertexType( i ), VertexType( j ) }, distance ) );
+               }
+             }
+
+             auto skeleton = makeVertices( n );
+
+             for( auto&& row : edges )
+               skeleton.insert( skeleton.end(), row.begin(), row.end() );
+
+             diagrams = calculateVietorisRipsPersistence( skeleton, dimension );
+           }
+
+           return makeDictionary( std::move( diagrams ) );
+         },
+         "Calculates persistence diagrams of the Vietoris--Rips complex of a point cloud of shape (n,d), using Euclidean distances",
+         py::arg( "points" ), py::arg( "epsilon" ) = std::numeric_limits<DataType>::infinity(), py::arg( "dimension" ) = 2u
+  );
+
+  m.def( "vietoris_rips_persistence_from_distances",
+         [] ( Array distances, DataType epsilon, unsigned dimension )
+         {
+           auto buffer = distances.request();
+
+           if( buffer.ndim != 1 )
+             throw std::runtime_error( "Distances must be stored in a condensed distance matrix" );
+
+           // The condensed matrix contains the upper triangle of the
+           // distance matrix in row-major order, as returned by SciPy
+           auto m = static_cast<std::size_t>( buffer.shape[0] );
+           auto n = static_cast<std::size_t>( ( 1.0 + std::sqrt( 1.0 + 8.0 * static_cast<double>( m ) ) ) / 2.0 );
+
+           if( n * ( n - 1 ) / 2 != m )
+             throw std::runtime_error( "Size of condensed distance matrix is invalid" );
+
+           std::vector<FlatDiagram> diagrams;
+
+           {
+             py::gil_scoped_release release;
+
+             auto data     = static_cast<const DataType*>( buffer.ptr );
+             auto skeleton = makeVertices( n );
+
+             for( std::size_t i = 0, k = 0; i < n; i++ )
+             {
+               for( std::size_t j = i + 1; j < n; j++, k++ )
+               {
+                 if( data[k] <= epsilon )
+                   skeleton.push_back( Simplex( { VertexType( i ), VertexType( j ) }, data[k] ) );
+               }
+             }
+
+             diagrams = calculateVietorisRipsPersistence( skeleton, dimension );
+           }
+
+           return makeDictionary( std::move( diagrams ) );
+         },
+         "Calculates persistence diagrams of the Vietoris--Rips complex of a condensed distance matrix",
+         py::arg( "distances" ), py::arg( "epsilon" ) = std::numeric_limits<DataType>::infinity(), py::arg( "dimension" ) = 2u
+  );
+
+  m.def( "vietoris_rips_persistence_from_edges",
+         [] ( IndexArray edges, Array weights, DataType epsilon, unsigned dimension, std::int64_t numVertices )
+         {
+           auto edgeBuffer   = edges.request();
+           auto weightBuffer = weights.request();
+
+           if( edgeBuffer.ndim != 2 || edgeBuffer.shape[1] != 2 )
+             throw std::runtime_error( "Edges must be arrays of shape (m,2)" );
+
+           if( weightBuffer.ndim != 1 || weightBuffer.shape[0] != edgeBuffer.shape[0] )
+             throw std::runtime_error( "Number of weights does not match number of edges" );
+
+           std::vector<FlatDiagram> diagrams;
+
+           {
+             py::gil_scoped_release release;
+
+             auto m = static_cast<std::size_t>( edgeBuffer.shape[0] );
+             auto e = static_cast<const std::int64_t*>( edgeBuffer.ptr );
+             auto w = static_cast<const DataType*>( weightBuffer.ptr );
+
+             // Unless specified otherwise, the largest vertex determines
+             // the number of vertices.
+             if( numVertices < 0 )
+             {
+               numVertices = 0;
+
+               for( std::size_t i = 0; i < 2 * m; i++ )
+                 numVertices = std::max( numVertices, e[i] + 1 );
+             }
+
+             auto skeleton = makeVertices( static_cast<std::size_t>( numVertices ) );
+
+             for( std::size_t i = 0; i < m; i++ )
+             {
+               auto u = e[2*i];
+               auto v = e[2*i+1];
+
+               if( u < 0 || v < 0 || u >= numVertices || v >= numVertices )
+                 throw std::runtime_error( "Edge refers to unknown vertex" );
+
+               if( u != v && w[i] <= epsilon )
+                 skeleton.push_back( Simplex( { VertexType( u ), VertexType( v ) }, w[i] ) );
+             }
+
+             diagrams = calculateVietorisRipsPersistence( skeleton, dimension );
+           }
+
+           return makeDictionary( std::move( diagrams ) );
+         },
+         "Calculates persistence diagrams of the Vietoris--Rips complex of a weighted edge list",
+         py::arg( "edges" ), py::arg( "weights" ), py::arg( "epsilon" ) = std::numeric_limits<DataType>::infinity(), py::arg( "dimension" ) = 2u, py::arg( "num_vertices" ) = -1
+  );
+
+  m.def( "bottleneck_distance",
+         [] ( Array D1, Array D2 )
+         {
+           auto buffer1 = D1.request();
+           auto buffer2 = D2.request();
+
+           py::gil_scoped_release release;
+           return aleph::distances::bottleneckDistance( makeDiagram( buffer1 ), makeDiagram( buffer2 ) );
+         },
+         "Calculates the bottleneck distance between two persistence diagrams of shape (n,2)"
+  );
+
+  m.def( "hausdorff_distance",
+         [] ( Array D1, Array D2 )
+         {
+           auto buffer1 = D1.request();
+           auto buffer2 = D2.request();
+
+           py::gil_scoped_release release;
+           return aleph::distances::hausdorffDistance( makeDiagram( buffer1 ), makeDiagram( buffer2 ) );
+         },
+         "Calculates the Hausdorff distance between two persistence diagrams of shape (n,2)"
+  );
+
+  m.def( "wasserstein_distance",
+         [] ( Array D1, Array D2, DataType power )
+         {
+           auto buffer1 = D1.request();
+           auto buffer2 = D2.request();
+
+           py::gil_scoped_release release;
+           return aleph::distances::wassersteinDistance( makeDiagram( buffer1 ), makeDiagram( buffer2 ), power );
+         },
+         "Calculates the Wasserstein distance between two persistence diagrams of shape (n,2)",
+         py::arg( "D1" ), py::arg( "D2" ), py::arg( "power" ) = 1.0
+  );
+
+  m.def( "wasserstein_distances",
+         [] ( py::list diagrams_, DataType power )
+         {
+           std::vector<py::buffer_info> buffers;
+           for( auto handle : diagrams_ )
+             buffers.push_back( py::cast<Array>( handle ).request() );
+
+           auto n = buffers.size();
+           std::vector<DataType> distances( n * n );
+
+           {
+             py::gil_scoped_release release;
+
+             std::vector<PersistenceDiagram> diagrams;
+             diagrams.reserve( n );
+
+             for( auto&& buffer : buffers )
+               diagrams.push_back( makeDiagram( buffer ) );
+
+             #pragma omp parallel for schedule(dynamic, 1)
+             for( std::size_t i = 0; i < n; i++ )
+             {
+               for( std::size_t j = i + 1; j < n; j++ )
+               {
+                 auto d = aleph::distances::wassersteinDistance( diagrams[i], diagrams[j], power );
+
+                 distances[i*n+j] = d;
+                 distances[j*n+i] = d;
+               }
+             }
+           }
+
+           return makeArray( std::move( distances ), n );
+         },
+         "Calculates the matrix of pairwise Wasserstein distances between persistence diagrams of shape (n,2)",
+         py::arg( "diagrams" ), py::arg( "power" ) = 1.0
+  );
+}
+
 PYBIND11_PLUGIN(aleph)
 {
   py::module m("aleph", "Python bindings for Aleph, a library for exploring persistent homology");
 
   wrapSimplex(m);
   wrapSimplicialComplex(m);
+  wrapNumPy(m);
 
   return m.ptr();
 }
@@ -2,16 +2,17 @@
 #define ALEPH_CONTAINERS_POINT_CLOUD_HH__
 
 #include <algorithm>
-#include <fstream>
 #include <initializer_list>
 #include <iterator>
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
+#include <cctype>
 #include <cstddef>
 
-#include <aleph/utilities/String.hh>
+#include <aleph/utilities/Tokenizer.hh>
 
 namespace aleph
 {
@@ -222,51 +223,55 @@ private:
   Loads a new point cloud from a file. The file is supposed to be in
   ASCII format. Each row must specify one item of the data set.  The
   different attributes of each item are assumed to be separated by a
-  comma or white-space characters.
+  comma or white-space characters. Empty rows are ignored.
+
+  @throws std::runtime_error if the file cannot be read
 */
 
 template<class T> PointCloud<T> load( const std::string& filename )
 {
-  std::ifstream in( filename );
-
-  if( !in )
-    return PointCloud<T>();
+  utilities::LineReader reader( filename );
+  utilities::StringView line;
 
-  auto lines = std::count( std::istreambuf_iterator<char>( in ),
-                           std::istreambuf_iterator<char>(),
-                           '\n' );
+  // Every line that contains at least one token describes an item of
+  // the data set. The first pass only counts them.
+  std::size_t n = 0;
 
-  in.clear();
-  in.seekg( 0 );
+  while( reader.next( line ) )
+  {
+    if( std::find_if_not( line.begin(), line.end(), [] ( char c ) { return std::isspace( static_cast<unsigned char>( c ) ); } ) != line.end() )
+      ++n;
+  }
 
-  if( lines <= 0 )
+  if( n == 0 )
     return PointCloud<T>();
 
   std::size_t i = 0;
   std::size_t d = 0;
-  std::size_t n = static_cast<std::size_t>( lines );
-
-  std::string line;
 
   PointCloud<T> pointCloud;
 
-  while( std::getline( in, line ) )
+  std::vector<T> coordinates;
+
+  reader.rewind();
+
+  while( reader.next( line ) )
   {
-    auto tokens = utilities::split( line, std::string( "[:;,[:space:]]+" ) );
+    utilities::Tokenizer tokenizer( line, ":;, \t\n\v\f\r" );
+    utilities::StringView token;
 
-    if( d == 0 )
-    {
-      d          = tokens.size();
-      pointCloud = PointCloud<T>( n, d );
-    }
+    coordinates.clear();
 
-    std::vector<T> coordinates;
-    coordinates.reserve( d );
+    while( tokenizer.next( token ) )
+      coordinates.push_back( utilities::convert<T>( token ) );
 
-    for( auto&& token : tokens )
+    if( coordinates.empty() )
+      continue;
+
+    if( d == 0 )
     {
-      T coordinate = utilities::convert<T>( token );
-      coordinates.push_back( coordinate );
+      d          = coordinates.size();
+      pointCloud = PointCloud<T>( n, d );
     }
 
     pointCloud.set( i,
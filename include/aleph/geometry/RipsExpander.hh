@@ -1,6 +1,8 @@
 #ifndef ALEPH_GEOMETRY_RIPS_EXPANDER_HH__
 #define ALEPH_GEOMETRY_RIPS_EXPANDER_HH__
 
+#include <aleph/utilities/Instrumentation.hh>
+
 #include <algorithm>
 #include <iterator>
 #include <list>
@@ -30,6 +32,8 @@ public:
 
   SimplicialComplex operator()( const SimplicialComplex& K, unsigned dimension )
   {
+    ALEPH_PHASE( "rips_expansion" );
+
     std::set<VertexType> vertices;
     K.vertices( std::inserter( vertices,
                                vertices.begin() ) );
@@ -73,6 +77,8 @@ public:
       }
     }
 
+    ALEPH_COUNT( SimplicesEmitted, simplices.size() );
+
     return SimplicialComplex( simplices.begin(), simplices.end() );
   }
 
@@ -80,6 +86,8 @@ public:
 
   SimplicialComplex assignMaximumWeight( const SimplicialComplex& K, unsigned minDimension = 1 )
   {
+    ALEPH_PHASE( "rips_weights" );
+
     SimplicialComplex S;
 
     for( auto it = K.begin_dimension(); it != K.end_dimension(); ++it )
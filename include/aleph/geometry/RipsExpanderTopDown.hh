@@ -8,6 +8,8 @@
 
 #include <aleph/topology/MaximalCliques.hh>
 
+#include <aleph/utilities/Instrumentation.hh>
+
 namespace aleph
 {
 
@@ -90,6 +92,8 @@ public:
 
   SimplicialComplex operator()( const SimplicialComplex& K, unsigned kMax, unsigned kMin )
   {
+    ALEPH_PHASE( "rips_expansion_top_down" );
+
     auto maximalCliques = aleph::topology::maximalCliquesKoch( K );
 
     std::list<Simplex> simplices;
@@ -108,6 +112,8 @@ public:
       }
     }
 
+    ALEPH_COUNT( SimplicesEmitted, simplices.size() );
+
     SimplicialComplex S;
     S.insert( simplices.begin(), simplices.end() );
     return S;
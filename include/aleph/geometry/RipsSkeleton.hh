@@ -4,6 +4,8 @@
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/utilities/Instrumentation.hh>
+
 #include <vector>
 
 namespace aleph
@@ -23,6 +25,8 @@ public:
 
   SimplicialComplex operator()( const NearestNeighbours& nn, ElementType epsilon ) const
   {
+    ALEPH_PHASE( "rips_skeleton" );
+
     auto numVertices = nn.size();
 
     std::vector<Simplex> simplices;
@@ -52,6 +56,8 @@ public:
       }
     }
 
+    ALEPH_COUNT( SimplicesEmitted, simplices.size() );
+
     return SimplicialComplex( simplices.begin(), simplices.end() );
   };
 };
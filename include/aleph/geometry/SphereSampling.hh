@@ -19,7 +19,8 @@ namespace geometry
   points per area of the sphere is uniform. Only the angular values of
   the sampled points (\f$\theta\f$, \f$\phi\f$) will be returned.
 
-  @param n Number of samples to draw
+  @param n    Number of samples to draw
+  @param seed Seed of the random number generator
 
   @returns Vector of angle values, i.e. \f$\theta\f$ and \f$\phi\f$,
            which are sufficient to describe the sphere. Please use
@@ -28,10 +29,9 @@ namespace geometry
 */
 
 template <class T>
-std::vector< std::pair<T, T> > sphereSampling( unsigned n )
+std::vector< std::pair<T, T> > sphereSampling( unsigned n, unsigned seed )
 {
-  std::random_device rd;
-  std::mt19937 rng( rd() );
+  std::mt19937 rng( seed );
 
   std::vector< std::pair<T, T> > angles;
   angles.reserve( n );
@@ -52,6 +52,18 @@ std::vector< std::pair<T, T> > sphereSampling( unsigned n )
   return angles;
 }
 
+/**
+  Samples a sphere with a randomly-seeded random number generator. See
+  the function above for more details.
+*/
+
+template <class T>
+std::vector< std::pair<T, T> > sphereSampling( unsigned n )
+{
+  std::random_device rd;
+  return sphereSampling<T>( n, rd() );
+}
+
 /**
   Converts a vector of angles into a point cloud that contains samples
   from a sphere of a given radius.
@@ -19,9 +19,10 @@ namespace geometry
   Diaconis et al., samples at most $n$ points from a torus with an inner
   radius of \f$R\f$ and an outer radius of \f$r\f$.
 
-  @param R Inner radius
-  @param r Outer radius
-  @param n Maximum number of samples to draw
+  @param R    Inner radius
+  @param r    Outer radius
+  @param n    Maximum number of samples to draw
+  @param seed Seed of the random number generators
 
   @returns Vector of angle values, i.e. \f$\theta\f$ and \f$\psi\f$,
            which are sufficient to describe a torus. Please use
@@ -32,13 +33,17 @@ namespace geometry
 template <class T>
 std::vector< std::pair<T, T> > torusRejectionSampling( T R,
                                                        T r,
-                                                       unsigned n )
+                                                       unsigned n,
+                                                       unsigned seed )
 {
-  std::random_device rd;
+  std::seed_seq seeds( { seed } );
 
-  std::mt19937 rngPsi( rd() );
-  std::mt19937 rngX( rd() );
-  std::mt19937 rngY( rd() );
+  std::vector<unsigned> rngSeeds( 3 );
+  seeds.generate( rngSeeds.begin(), rngSeeds.end() );
+
+  std::mt19937 rngPsi( rngSeeds[0] );
+  std::mt19937 rngX( rngSeeds[1] );
+  std::mt19937 rngY( rngSeeds[2] );
 
   // I do not store the values of theta directly, but instead report directly
   // those angles that are deemed to be "correct".
@@ -75,6 +80,20 @@ std::vector< std::pair<T, T> > torusRejectionSampling( T R,
 
 }
 
+/**
+  Samples a torus with randomly-seeded random number generators. See the
+  function above for more details.
+*/
+
+template <class T>
+std::vector< std::pair<T, T> > torusRejectionSampling( T R,
+                                                       T r,
+                                                       unsigned n )
+{
+  std::random_device rd;
+  return torusRejectionSampling<T>( R, r, n, rd() );
+}
+
 /**
   Converts a vector of angles into a point cloud that contains samples
   from a torus.
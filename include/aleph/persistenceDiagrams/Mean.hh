@@ -7,12 +7,17 @@
 
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 
+#include <aleph/persistenceDiagrams/distances/detail/Auction.hh>
 #include <aleph/persistenceDiagrams/distances/detail/Munkres.hh>
 #include <aleph/persistenceDiagrams/distances/detail/Orthogonal.hh>
 
+#include <aleph/utilities/Instrumentation.hh>
+
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <limits>
+#include <numeric>
 #include <random>
 #include <stdexcept>
 #include <vector>
@@ -288,6 +293,295 @@ template <class InputIterator> auto mean( InputIterator begin, InputIterator end
   return Y;
 }
 
+/**
+  @class FrechetMean
+  @brief Fréchet mean of persistence diagrams based on auctions
+
+  Calculates a mean of a set of persistence diagrams with the iteration
+  of Turner et al., just like mean(), which alternates between matching
+  the current mean to every diagram and moving every point of the mean
+  to the average of its partners. Instead of solving every assignment
+  problem exactly, the matchings are calculated by an auction algorithm
+  up to a relative error of their cost. Every diagram keeps its auction
+  between iterations, so matchings start from the previous assignment
+  and prices. The matchings of different diagrams are calculated in
+  parallel, and the iteration stops as soon as no assignment changes or
+  the cost of the mean does not decrease any more; in the latter case,
+  the previous mean is kept.
+
+  Since the iteration only converges to a local minimum of the Fréchet
+  function, multiple restarts with randomly chosen initial diagrams may
+  be used. They are processed concurrently, and the mean of the lowest
+  cost is kept.
+
+  Every auction searches for the best partners of the points of the mean
+  in a kd-tree of the points of the diagram, so a bid does not have to
+  look at all points of the diagram.
+*/
+
+template <
+  class DataType,
+  class Distance = aleph::distances::InfinityDistance<DataType>
+> class FrechetMean
+{
+public:
+  using PersistenceDiagram = aleph::PersistenceDiagram<DataType>;
+  using Point              = typename PersistenceDiagram::Point;
+
+  /**
+    Prepares the calculation of a mean of a range of persistence diagrams.
+
+    @param begin Iterator to begin of range of diagrams
+    @param end   Iterator to end of range of diagrams
+    @param power Power of the distances between points
+
+    @throws std::runtime_error if the diagrams are of different dimensions
+    or if they contain unpaired points
+  */
+
+  template <class InputIterator> FrechetMean( InputIterator begin, InputIterator end, DataType power = DataType( 2 ) )
+    : _power( double( power ) )
+  {
+    _offsets.push_back( 0 );
+
+    for( auto it = begin; it != end; ++it )
+    {
+      if( it != begin && it->dimension() != begin->dimension() )
+        throw std::runtime_error( "Dimensions do not coincide" );
+
+      for( auto&& p : *it )
+      {
+        if( p.isUnpaired() )
+          throw std::runtime_error( "Unable to calculate mean of unpaired points" );
+
+        _points.push_back( p );
+      }
+
+      _offsets.push_back( _points.size() );
+      _dimension = it->dimension();
+    }
+  }
+
+  /** Sets the relative error of the cost of every matching */
+  void setRelativeError( double relativeError ) noexcept
+  {
+    _relativeError = relativeError;
+  }
+
+  /** Sets the maximum number of iterations of every restart */
+  void setMaxIterations( unsigned maxIterations ) noexcept
+  {
+    _maxIterations = maxIterations;
+  }
+
+  /**
+    Calculates the mean of all persistence diagrams.
+
+    @param numRestarts Number of restarts with different initial diagrams
+    @param seed        Seed for choosing the initial diagrams
+
+    @returns Mean persistence diagram of the lowest cost
+  */
+
+  PersistenceDiagram operator()( unsigned numRestarts = 1, unsigned seed = std::random_device()() )
+  {
+    ALEPH_PHASE( "frechet_mean" );
+
+    auto numDiagrams = _offsets.size() - 1;
+
+    if( numDiagrams == 0 || numRestarts == 0 )
+      return {};
+
+    std::vector<std::size_t> initialDiagrams( numRestarts );
+
+    {
+      std::mt19937 rng( seed );
+      std::uniform_int_distribution<std::size_t> distribution( 0, numDiagrams - 1 );
+
+      for( auto&& index : initialDiagrams )
+        index = distribution( rng );
+    }
+
+    std::vector<Result> results( numRestarts );
+
+    // Every restart calculates its matchings in parallel if it is the
+    // only one; otherwise, the restarts are processed in parallel.
+    #pragma omp parallel for schedule(dynamic, 1) if( numRestarts > 1 )
+    for( std::size_t r = 0; r < numRestarts; r++ )
+      results[r] = this->calculate( initialDiagrams[r] );
+
+    auto&& best = *std::min_element( results.begin(), results.end(),
+                                     [] ( const Result& r1, const Result& r2 )
+                                     {
+                                       return r1.cost < r2.cost;
+                                     } );
+
+    _cost          = best.cost;
+    _costs         = best.costs;
+    _numIterations = best.numIterations;
+
+    PersistenceDiagram Y;
+    Y.setDimension( _dimension );
+
+    for( auto&& p : best.points )
+      Y.add( p.x(), p.y() );
+
+    Y.removeDiagonal();
+    return Y;
+  }
+
+  /**
+    @returns Cost of the last mean, i.e. the sum of the matching costs
+    between the mean and all diagrams
+  */
+
+  double cost() const noexcept
+  {
+    return _cost;
+  }
+
+  /**
+    @returns Costs of all iterations of the last mean. The cost of the
+    mean is the smallest one of them.
+  */
+
+  const std::vector<double>& costs() const noexcept
+  {
+    return _costs;
+  }
+
+  /** @returns Number of iterations of the last mean */
+  unsigned numIterations() const noexcept
+  {
+    return _numIterations;
+  }
+
+private:
+  using Auction = aleph::distances::detail::Auction<Point, Distance>;
+
+  struct Result
+  {
+    std::vector<Point> points;
+    std::vector<double> costs;
+    double cost                = 0.0;
+    unsigned numIterations     = 0;
+  };
+
+  Result calculate( std::size_t initialDiagram ) const
+  {
+    auto numDiagrams = _offsets.size() - 1;
+
+    Result result;
+
+    // The mean keeps all of its points during the iteration, even if they
+    // end up on the diagonal, so that every matching may be reused.
+    auto&& Y = result.points;
+
+    for( auto i = _offsets[initialDiagram]; i < _offsets[initialDiagram + 1]; i++ )
+    {
+      if( _points[i].x() != _points[i].y() )
+        Y.push_back( _points[i] );
+    }
+
+    std::vector<Auction> auctions( numDiagrams, Auction( _power, _relativeError ) );
+    std::vector< std::vector<std::size_t> > partners( numDiagrams, std::vector<std::size_t>( Y.size() ) );
+    std::vector<double> costs( numDiagrams );
+
+    // Mean of the previous iteration
+    std::vector<Point> previous;
+
+    for( unsigned iteration = 0; iteration < _maxIterations; iteration++ )
+    {
+      bool changed = false;
+
+      #pragma omp parallel for schedule(dynamic, 1) reduction(||: changed)
+      for( std::size_t d = 0; d < numDiagrams; d++ )
+      {
+        costs[d] = auctions[d]( Y.data(), Y.size(),
+                                _points.data() + _offsets[d], _offsets[d+1] - _offsets[d],
+                                iteration > 0 );
+
+        for( std::size_t i = 0; i < Y.size(); i++ )
+        {
+          auto partner = auctions[d].partner( i );
+
+          if( iteration == 0 || partner != partners[d][i] )
+            changed = true;
+
+          partners[d][i] = partner;
+        }
+      }
+
+      auto cost            = std::accumulate( costs.begin(), costs.end(), 0.0 );
+      result.numIterations = iteration + 1;
+
+      result.costs.push_back( cost );
+
+      // Since the matchings are only almost optimal, their assignments may
+      // oscillate without improving the mean. In this case, the previous
+      // mean is kept because it is the better one.
+      if( iteration > 0 && cost >= result.cost )
+      {
+        Y.swap( previous );
+        break;
+      }
+
+      result.cost = cost;
+
+      // The mean has been calculated from the same matchings before, so
+      // it would not change any more. Moving the points after the last
+      // iteration is not possible because their cost would be unknown.
+      if( !changed || iteration + 1 == _maxIterations )
+        break;
+
+      previous = Y;
+
+      // Every point moves to the average of its partners, where points
+      // that are matched to the diagonal use their own projection.
+      for( std::size_t i = 0; i < Y.size(); i++ )
+      {
+        aleph::math::KahanSummation<DataType> x = DataType();
+        aleph::math::KahanSummation<DataType> y = DataType();
+
+        auto projection = ( Y[i].x() + Y[i].y() ) / 2;
+
+        for( std::size_t d = 0; d < numDiagrams; d++ )
+        {
+          auto j = partners[d][i];
+
+          if( j != Auction::diagonal )
+          {
+            x += _points[ _offsets[d] + j ].x();
+            y += _points[ _offsets[d] + j ].y();
+          }
+          else
+          {
+            x += projection;
+            y += projection;
+          }
+        }
+
+        Y[i] = Point( x / DataType( numDiagrams ), y / DataType( numDiagrams ) );
+      }
+    }
+
+    return result;
+  }
+
+  double _power;
+  double _relativeError    = 0.01;
+  unsigned _maxIterations  = 100;
+
+  // Points of all diagrams, stored consecutively
+  std::vector<Point> _points;
+  std::vector<std::size_t> _offsets;
+
+  std::size_t _dimension = 0;
+
+  std::vector<double> _costs;
+  double _cost             = 0.0;
+  unsigned _numIterations  = 0;
+};
 
 } // namespace aleph
 
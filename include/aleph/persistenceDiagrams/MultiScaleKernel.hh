@@ -2,11 +2,20 @@
 #define ALEPH_MULTI_SCALE_KERNEL_HH__
 
 #include <aleph/math/KahanSummation.hh>
+#include <aleph/math/SymmetricMatrix.hh>
 
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 
+#include <aleph/utilities/Instrumentation.hh>
+
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 #include <cmath>
 
@@ -43,6 +52,64 @@ template <class Point> double squaredEuclideanDistance( const Point& p,
   return static_cast<double>( dx*dx + dy*dy );
 }
 
+/**
+  Approximates the exponential function for non-positive arguments. The
+  argument is split into an integral power of two and a small remainder,
+  whose exponential is given by its Taylor polynomial. Results that would
+  be subnormal are flushed to zero.
+
+  The function only uses arithmetic and bit operations, without branches,
+  comparisons, or calls, so loops using it can be vectorized. Its relative
+  error is about 1e-14.
+*/
+
+inline double negativeExp( double x ) noexcept
+{
+  // Adding this constant rounds a value to an integer, which is then
+  // stored in the lower bits of the result.
+  const double shift = 6755399441055744.0;
+
+  const double log2e = 1.4426950408889634;
+  const double ln2hi = 6.93147180369123816490e-01;
+  const double ln2lo = 1.90821492927058770002e-10;
+
+  std::uint64_t xBits;
+  std::memcpy( &xBits, &x, sizeof(double) );
+
+  // Arguments of magnitude 2^40 or more would exceed the range of the
+  // rounding, so they are replaced by zero and their result is masked.
+  // All checks use integers because floating point comparisons prevent
+  // vectorization unless traps are disabled.
+  auto large = ( std::uint64_t( 1023 + 39 ) - ( ( xBits >> 52 ) & 0x7FF ) ) >> 63;
+  xBits     &= large - 1;
+
+  std::memcpy( &x, &xBits, sizeof(double) );
+
+  auto t = x * log2e + shift;
+  auto n = t - shift;
+  auto r = ( x - n * ln2hi ) - n * ln2lo;
+
+  auto p = 1.0 + r * ( 1.0 + r * ( 1.0 / 2 + r * ( 1.0 / 6 + r * ( 1.0 / 24 + r * ( 1.0 / 120
+               + r * ( 1.0 / 720 + r * ( 1.0 / 5040 + r * ( 1.0 / 40320 + r * ( 1.0 / 362880
+               + r * ( 1.0 / 3628800 + r * ( 1.0 / 39916800 ) ) ) ) ) ) ) ) ) ) );
+
+  std::uint64_t tBits;
+  std::uint64_t shiftBits;
+
+  std::memcpy( &tBits,     &t,     sizeof(double) );
+  std::memcpy( &shiftBits, &shift, sizeof(double) );
+
+  // Biased exponent of 2^n, which is not positive for subnormal values
+  auto exponent  = tBits - shiftBits + 1023;
+  auto underflow = ( exponent - 1 ) >> 63;
+  auto scaleBits = ( exponent << 52 ) & ( underflow - 1 ) & ( large - 1 );
+
+  double scale;
+  std::memcpy( &scale, &scaleBits, sizeof(double) );
+
+  return p * scale;
+}
+
 } // namespace detail
 
 template <class T> double multiScaleKernel( const PersistenceDiagram<T>& D1,
@@ -97,6 +164,247 @@ template <class T> double multiScalePseudoMetric( const PersistenceDiagram<T>& D
   return std::sqrt( kxx + kyy - 2*kxy );
 }
 
+/**
+  @class MultiScaleKernelMatrix
+  @brief Gram matrix of the multi-scale kernel for many diagrams
+
+  Calculates the multi-scale kernel, as given by multiScaleKernel(), and
+  the corresponding pseudo-metric for all pairs of a set of persistence
+  diagrams. This is the Gram matrix that is required for training kernel
+  methods, e.g. support vector machines.
+
+  The points of all diagrams are stored once, as separate coordinate
+  arrays that are sorted by creation. Since the kernel is antisymmetric
+  under mirroring a point at the diagonal, points below the diagonal are
+  mirrored and negated, and points on the diagonal are dropped. For two
+  points above the diagonal, the mirrored term is always smaller than the
+  direct one, so pairs whose distance exceeds a cutoff contribute less
+  than a given tolerance and are skipped. The remaining pairs of points
+  form contiguous ranges, which are evaluated with an approximation of
+  the exponential function that permits vectorization.
+
+  The matrix is split into tiles of diagrams, which are processed in
+  parallel. The pseudo-metric reuses the self-similarity of every diagram
+  instead of calculating it for every pair.
+*/
+
+class MultiScaleKernelMatrix
+{
+public:
+
+  /**
+    Prepares the calculation of the kernel for a range of diagrams.
+
+    @param begin     Iterator to begin of range of diagrams
+    @param end       Iterator to end of range of diagrams
+    @param sigma     Scale parameter of the kernel
+    @param tolerance Maximum contribution of a pair of points that may be
+                     skipped, before scaling by sigma; use zero in order
+                     to evaluate all pairs
+
+    Unpaired points do not contribute to the kernel.
+  */
+
+  template <class InputIterator> MultiScaleKernelMatrix( InputIterator begin, InputIterator end,
+                                                         double sigma,
+                                                         double tolerance = 1e-16 )
+    : _sigma( sigma )
+  {
+    ALEPH_PHASE( "multi_scale_kernel/structure" );
+
+    // A pair of points at squared distance d contributes at most
+    // exp(-d/(8*pi)) to the sum of the kernel.
+    _cutoff = tolerance > 0.0 ? std::sqrt( -8.0 * M_PI * std::log( std::min( tolerance, 1.0 ) ) )
+                              : std::numeric_limits<double>::infinity();
+
+    _offsets.push_back( 0 );
+
+    std::vector<std::size_t> order;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> signs;
+
+    for( auto it = begin; it != end; ++it )
+    {
+      x.clear();
+      y.clear();
+      signs.clear();
+
+      for( auto&& p : *it )
+      {
+        auto px = static_cast<double>( p.x() );
+        auto py = static_cast<double>( p.y() );
+
+        if( px == py || !std::isfinite( px ) || !std::isfinite( py ) )
+          continue;
+
+        x.push_back( std::min( px, py ) );
+        y.push_back( std::max( px, py ) );
+        signs.push_back( px < py ? 1.0 : -1.0 );
+      }
+
+      order.resize( x.size() );
+      std::iota( order.begin(), order.end(), std::size_t(0) );
+
+      std::sort( order.begin(), order.end(),
+                 [&x] ( std::size_t i, std::size_t j )
+                 {
+                   return x[i] < x[j];
+                 } );
+
+      for( auto&& i : order )
+      {
+        _x.push_back( x[i] );
+        _y.push_back( y[i] );
+        _signs.push_back( signs[i] );
+      }
+
+      _offsets.push_back( _x.size() );
+    }
+  }
+
+  /** @returns Number of diagrams */
+  std::size_t size() const noexcept
+  {
+    return _offsets.size() - 1;
+  }
+
+  /**
+    Calculates the kernel between every pair of diagrams.
+
+    @returns Gram matrix of the kernel
+  */
+
+  math::SymmetricMatrix<double> kernel() const
+  {
+    ALEPH_PHASE( "multi_scale_kernel" );
+
+    // Number of diagrams per tile; the points of a tile should fit into
+    // the cache of a single core.
+    const std::size_t tileSize = 16;
+
+    auto n = this->size();
+
+    math::SymmetricMatrix<double> K( n );
+
+    auto numTiles = ( n + tileSize - 1 ) / tileSize;
+
+    // Tiles in the upper triangle of the matrix, including the diagonal
+    std::vector< std::pair<std::size_t, std::size_t> > tiles;
+
+    for( std::size_t I = 0; I < numTiles; I++ )
+      for( std::size_t J = I; J < numTiles; J++ )
+        tiles.push_back( std::make_pair( I, J ) );
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for( std::size_t t = 0; t < tiles.size(); t++ )
+    {
+      auto I = tiles[t].first;
+      auto J = tiles[t].second;
+
+      for( auto i = I * tileSize; i < std::min( n, ( I + 1 ) * tileSize ); i++ )
+        for( auto j = std::max( i, J * tileSize ); j < std::min( n, ( J + 1 ) * tileSize ); j++ )
+          K( i, j ) = this->kernel( i, j );
+    }
+
+    return K;
+  }
+
+  /**
+    Calculates the pseudo-metric that is induced by the kernel between
+    every pair of diagrams.
+
+    @returns Matrix of pairwise distances
+  */
+
+  math::SymmetricMatrix<double> pseudoMetric() const
+  {
+    auto n = this->size();
+    auto K = this->kernel();
+
+    math::SymmetricMatrix<double> D( n );
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      for( std::size_t j = i + 1; j < n; j++ )
+      {
+        // Truncation and rounding errors may result in small negative
+        // values for almost identical diagrams.
+        D( i, j ) = std::sqrt( std::max( K( i, i ) + K( j, j ) - 2 * K( i, j ), 0.0 ) );
+      }
+    }
+
+    return D;
+  }
+
+private:
+
+  /** Calculates the kernel between two diagrams */
+  double kernel( std::size_t a, std::size_t b ) const
+  {
+    auto c = 1.0 / ( 8.0 * M_PI );
+
+    auto begin = _offsets[b];
+    auto end   = _offsets[b+1];
+
+    auto lower = begin;
+    auto upper = begin;
+
+    aleph::math::KahanSummation<double> sum = 0.0;
+
+    auto X = _x.data();
+    auto Y = _y.data();
+    auto S = _signs.data();
+
+    for( auto i = _offsets[a]; i < _offsets[a+1]; i++ )
+    {
+      auto px = _x[i];
+      auto py = _y[i];
+
+      // Both diagrams are sorted by creation, so the range of points that
+      // are sufficiently close in their creation only moves forwards.
+      while( lower < end && X[lower] < px - _cutoff )
+        ++lower;
+
+      upper = std::max( upper, lower );
+
+      while( upper < end && X[upper] <= px + _cutoff )
+        ++upper;
+
+      double row = 0.0;
+
+      #pragma omp simd reduction(+:row)
+      for( auto j = lower; j < upper; j++ )
+      {
+        auto dx = px - X[j];
+        auto dy = py - Y[j];
+        auto ex = px - Y[j];
+        auto ey = py - X[j];
+
+        auto d1 = dx*dx + dy*dy;
+        auto d2 = ex*ex + ey*ey;
+
+        row += S[j] * ( detail::negativeExp( -d1 * c ) - detail::negativeExp( -d2 * c ) );
+      }
+
+      sum += _signs[i] * row;
+    }
+
+    return 1.0 / ( 8.0*M_PI*_sigma ) * sum;
+  }
+
+  double _sigma;
+  double _cutoff;
+
+  // Coordinates of the points of all diagrams, stored consecutively, and
+  // the signs of their contributions
+  std::vector<double> _x;
+  std::vector<double> _y;
+  std::vector<double> _signs;
+
+  std::vector<std::size_t> _offsets;
+};
+
 }
 
 #endif
@@ -6,6 +6,8 @@
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 #include <aleph/persistenceDiagrams/distances/detail/Orthogonal.hh>
 
+#include <aleph/utilities/Instrumentation.hh>
+
 #include <boost/iterator/counting_iterator.hpp>
 
 #include <boost/graph/adjacency_list.hpp>
@@ -84,6 +86,8 @@ template <class T> struct CheckMatchingCardinality
     boost::edmonds_maximum_cardinality_matching( _graph,
                                                  &_mates[0] );
 
+    ALEPH_COUNT( MatchingProbes, 1 );
+
     // Look out for _perfect matchings_ in the bipartite graph. Any other
     // maximum cardinality matching does not qualify for the Bottleneck
     // distance.
@@ -128,6 +132,8 @@ template <
 > DataType bottleneckDistance( const PersistenceDiagram<DataType>& D1,
                                const PersistenceDiagram<DataType>& D2 )
 {
+  ALEPH_PHASE( "bottleneck_distance" );
+
   auto n           = D1.size();
   auto m           = D2.size();
   auto maximumSize = n + m;
@@ -4,6 +4,8 @@
 #include <aleph/geometry/distances/Infinity.hh>
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 
+#include <aleph/utilities/Instrumentation.hh>
+
 #include <limits>
 
 namespace aleph
@@ -48,6 +50,8 @@ template <
       return std::numeric_limits<DataType>::max();
   }
 
+  ALEPH_PHASE( "hausdorff_distance" );
+
   using PersistenceDiagram = PersistenceDiagram<DataType>;
   using Point              = typename PersistenceDiagram::Point;
 
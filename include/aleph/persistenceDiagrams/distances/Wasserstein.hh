@@ -7,6 +7,8 @@
 #include <aleph/persistenceDiagrams/distances/detail/Munkres.hh>
 #include <aleph/persistenceDiagrams/distances/detail/Orthogonal.hh>
 
+#include <aleph/utilities/Instrumentation.hh>
+
 #include <algorithm>
 #include <limits>
 #include <stdexcept>
@@ -29,6 +31,8 @@ template <
   if( D1.dimension() != D2.dimension() )
     throw std::runtime_error( "Dimensions do not coincide" );
 
+  ALEPH_PHASE( "wasserstein_distance" );
+
   auto size = D1.size() + D2.size();
 
   detail::Matrix<DataType> costs( size );
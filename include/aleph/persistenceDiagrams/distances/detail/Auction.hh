@@ -0,0 +1,614 @@
+#ifndef ALEPH_PERSISTENCE_DIAGRAMS_DISTANCES_DETAIL_AUCTION_HH__
+#define ALEPH_PERSISTENCE_DIAGRAMS_DISTANCES_DETAIL_AUCTION_HH__
+
+#include <aleph/persistenceDiagrams/distances/detail/Orthogonal.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+namespace distances
+{
+
+namespace detail
+{
+
+/**
+  @class Auction
+  @brief Auction algorithm for matching the points of persistence diagrams
+
+  Calculates an approximately optimal matching between the points of two
+  persistence diagrams, where every point may also be matched to its
+  orthogonal projection onto the diagonal. This is the same assignment
+  problem that is solved by Munkres' algorithm for Wasserstein distances,
+  but the auction algorithm of Bertsekas does not require storing a dense
+  cost matrix, and it only ever looks at the edges of the problem that
+  may be part of a matching.
+
+  The matching is refined by \f$\epsilon\f$-scaling until its cost is
+  guaranteed to be within a relative error of the optimal cost. Prices
+  and assignments are kept between calls, so matching diagrams whose
+  points only move slightly, e.g. during the iterations of a Fréchet
+  mean, can start from the previous matching. Only those assignments
+  that are no longer almost optimal are dissolved.
+
+  Internally, the problem consists of two kinds of bidders: the points
+  of the first diagram and the diagonal projections of the points of the
+  second diagram. Likewise, the objects are the points of the second
+  diagram and the diagonal projections of the points of the first one.
+  All diagonal projections may be matched to each other at no cost, so
+  the diagonal objects are kept sorted by their prices; a diagonal bidder
+  thus only has to look at the two cheapest ones.
+
+  The remaining bidders search for their best objects in a kd-tree of the
+  points of the second diagram, following Kerber, Morozov, and Nigmetov.
+  Every node stores the bounding box of its subtree and the lowest price
+  of all of its objects, which bounds the value of all objects below the
+  node from above. Prices only ever increase, so a bid only updates the
+  ancestors of an object as long as their lowest price changes. This
+  requires the distance to be monotone in the differences of all
+  coordinates, which is the case for all L_p distances.
+
+  For more information, please refer to the paper
+
+    Geometry Helps to Compare Persistence Diagrams
+    Michael Kerber, Dmitriy Morozov, and Arnur Nigmetov
+    Journal of Experimental Algorithmics 22, 2017
+*/
+
+template <class Point, class Distance> class Auction
+{
+public:
+
+  /** Partner of all points that are matched to the diagonal */
+  static constexpr std::size_t diagonal = std::numeric_limits<std::size_t>::max();
+
+  /**
+    Creates a new auction.
+
+    @param power         Power of the distances between points
+    @param relativeError Relative error of the matching cost; this must
+                         be positive
+  */
+
+  explicit Auction( double power = 2.0, double relativeError = 0.01 )
+    : _power( power )
+    , _relativeError( relativeError )
+  {
+  }
+
+  /**
+    Matches the points of two persistence diagrams.
+
+    @param X         Points of the first diagram
+    @param n         Number of points of the first diagram
+    @param Y         Points of the second diagram
+    @param m         Number of points of the second diagram
+    @param warmStart Flag indicating whether the prices and assignments
+                     of the previous call should be reused; this is only
+                     possible if the sizes of the diagrams did not change
+
+    @returns Cost of the matching, i.e. the sum of the powers of all
+    distances between matched points
+  */
+
+  double operator()( const Point* X, std::size_t n, const Point* Y, std::size_t m, bool warmStart = false )
+  {
+    _X = X;
+    _Y = Y;
+
+    warmStart = warmStart && _n == n && _m == m && !_prices.empty();
+
+    _n = n;
+    _m = m;
+
+    auto N = n + m;
+
+    _diagonalX.resize( n );
+    _diagonalY.resize( m );
+
+    for( std::size_t i = 0; i < n; i++ )
+      _diagonalX[i] = this->power( double( orthogonalDistance<Distance>( X[i] ) ) );
+
+    for( std::size_t j = 0; j < m; j++ )
+      _diagonalY[j] = this->power( double( orthogonalDistance<Distance>( Y[j] ) ) );
+
+    // Every point may be matched to the diagonal, so the costs of these
+    // matches determine the scale of all prices.
+    auto maxCost = std::max( _diagonalX.empty() ? 0.0 : *std::max_element( _diagonalX.begin(), _diagonalX.end() ),
+                             _diagonalY.empty() ? 0.0 : *std::max_element( _diagonalY.begin(), _diagonalY.end() ) );
+
+    if( !warmStart )
+    {
+      _prices.assign( N, 0.0 );
+      _bidderToObject.assign( N, unassigned );
+      _objectToBidder.assign( N, unassigned );
+
+      _epsilon = maxCost > 0.0 ? maxCost / 4.0 : 1.0;
+    }
+    else
+    {
+      // The previous assignment is only almost optimal if the costs did
+      // not change too much. Increasing epsilon by the largest change of
+      // the cost of an assignment keeps most of the assignments, which
+      // are then refined by the subsequent phases.
+      double change = 0.0;
+
+      for( std::size_t bidder = 0; bidder < N; bidder++ )
+        change = std::max( change, std::abs( this->cost( bidder, _bidderToObject[bidder] ) - _costs[bidder] ) );
+
+      _epsilon = std::max( _epsilon, change );
+    }
+
+    _diagonalPrices.clear();
+
+    for( std::size_t object = m; object < N; object++ )
+      _diagonalPrices.insert( std::make_pair( _prices[object], object ) );
+
+    // The points of the second diagram may have changed even for a warm
+    // start, so the tree is always rebuilt. This is cheap in comparison
+    // to the auction itself.
+    _tree.resize( m );
+    _positions.resize( m );
+    _parents.assign( m, unassigned );
+    _children.assign( 2 * m, unassigned );
+    _lowerCorners.assign( m, Point( 0, 0 ) );
+    _upperCorners.assign( m, Point( 0, 0 ) );
+    _minPrices.assign( m, 0.0 );
+
+    for( std::size_t object = 0; object < m; object++ )
+      _tree[object] = object;
+
+    _root = m > 0 ? this->build( 0, m, 0 ) : unassigned;
+
+    // Smaller values of epsilon would not change the prices any more
+    auto minEpsilon = 1e3 * std::numeric_limits<double>::epsilon() * maxCost;
+
+    _numBids = 0;
+
+    if( N == 0 )
+      return 0.0;
+
+    while( true )
+    {
+      this->phase();
+
+      auto cost = this->cost();
+
+      // Every complete assignment that satisfies the complementary
+      // slackness conditions up to epsilon is at most N * epsilon more
+      // expensive than an optimal assignment.
+      if( cost <= 0.0 || double( N ) * _epsilon <= _relativeError * cost || _epsilon <= minEpsilon )
+      {
+        _costs.resize( N );
+
+        for( std::size_t bidder = 0; bidder < N; bidder++ )
+          _costs[bidder] = this->cost( bidder, _bidderToObject[bidder] );
+
+        return cost;
+      }
+
+      _epsilon /= 5.0;
+    }
+  }
+
+  /**
+    @returns Partner of a point of the first diagram in the second one,
+    or diagonal if the point is matched to its projection
+  */
+
+  std::size_t partner( std::size_t i ) const noexcept
+  {
+    auto j = _bidderToObject[i];
+    return j < _m ? j : diagonal;
+  }
+
+  /** @returns Number of bids of the last call */
+  std::size_t numBids() const noexcept
+  {
+    return _numBids;
+  }
+
+private:
+  static constexpr std::size_t unassigned = std::numeric_limits<std::size_t>::max();
+
+  /** Raises a distance to the power of the matching */
+  double power( double distance ) const
+  {
+    // Costs are calculated for every bid, so the common powers should not
+    // require a call to the generic function.
+    if( _power == 2.0 )
+      return distance * distance;
+    else if( _power == 1.0 )
+      return distance;
+    else
+      return std::pow( distance, _power );
+  }
+
+  /**
+    Calculates the cost of assigning an object to a bidder. The function
+    must only be called for edges of the problem.
+  */
+
+  double cost( std::size_t bidder, std::size_t object ) const
+  {
+    if( bidder < _n )
+    {
+      if( object < _m )
+        return this->power( double( Distance()( _X[bidder], _Y[object] ) ) );
+      else
+        return _diagonalX[bidder];
+    }
+    else
+    {
+      if( object < _m )
+        return _diagonalY[object];
+      else
+        return 0.0;
+    }
+  }
+
+  /** @returns Total cost of the current assignment */
+  double cost() const
+  {
+    double cost = 0.0;
+
+    for( std::size_t bidder = 0; bidder < _n + _m; bidder++ )
+      cost += this->cost( bidder, _bidderToObject[bidder] );
+
+    return cost;
+  }
+
+  /**
+    Determines the best and second best value of all objects for a bidder,
+    where the value of an object is its negative cost minus its price.
+
+    @returns Best object
+  */
+
+  std::size_t evaluate( std::size_t bidder, double& best, double& second ) const
+  {
+    best   = -std::numeric_limits<double>::infinity();
+    second = -std::numeric_limits<double>::infinity();
+
+    std::size_t object = unassigned;
+
+    auto consider = [&] ( std::size_t o, double value )
+    {
+      if( value > best )
+      {
+        second = best;
+        best   = value;
+        object = o;
+      }
+      else if( value > second )
+        second = value;
+    };
+
+    if( bidder < _n )
+    {
+      consider( _m + bidder, -_diagonalX[bidder] - _prices[ _m + bidder ] );
+
+      if( _root != unassigned )
+        this->search( _root, this->bound( _root, bidder ), bidder, consider, second );
+    }
+    else
+    {
+      auto j = bidder - _n;
+
+      consider( j, -_diagonalY[j] - _prices[j] );
+
+      auto it = _diagonalPrices.begin();
+
+      for( unsigned k = 0; k < 2 && it != _diagonalPrices.end(); k++, ++it )
+        consider( it->second, -it->first );
+    }
+
+    return object;
+  }
+
+  /**
+    Checks whether the object that is assigned to a bidder is at most
+    epsilon worse than its best object. For points of the first diagram,
+    the search stops as soon as a better object has been found.
+  */
+
+  bool isAlmostOptimal( std::size_t bidder, std::size_t object ) const
+  {
+    auto threshold = -this->cost( bidder, object ) - _prices[object] + _epsilon;
+
+    if( bidder >= _n )
+    {
+      double best   = 0.0;
+      double second = 0.0;
+
+      this->evaluate( bidder, best, second );
+      return best <= threshold;
+    }
+
+    if( -_diagonalX[bidder] - _prices[ _m + bidder ] > threshold )
+      return false;
+
+    bool found = false;
+
+    // Raising the threshold after the first better object has been found
+    // skips all remaining nodes of the tree.
+    auto consider = [&found, &threshold] ( std::size_t, double value )
+    {
+      if( value > threshold )
+      {
+        found     = true;
+        threshold = std::numeric_limits<double>::infinity();
+      }
+    };
+
+    if( _root != unassigned )
+      this->search( _root, this->bound( _root, bidder ), bidder, consider, threshold );
+
+    return !found;
+  }
+
+  /**
+    Builds the kd-tree for all objects in the range [begin, end) of the
+    tree, splitting alternatingly along the x-axis and the y-axis. The
+    median of the range becomes the node that stores the split.
+
+    @returns Position of the node in the tree
+  */
+
+  std::size_t build( std::size_t begin, std::size_t end, unsigned depth )
+  {
+    auto middle = begin + ( end - begin ) / 2;
+
+    std::nth_element( _tree.begin() + long( begin ),
+                      _tree.begin() + long( middle ),
+                      _tree.begin() + long( end ),
+                      [this, &depth] ( std::size_t o1, std::size_t o2 )
+                      {
+                        return depth % 2 == 0 ? _Y[o1].x() < _Y[o2].x() : _Y[o1].y() < _Y[o2].y();
+                      } );
+
+    auto object              = _tree[middle];
+    _positions[object]       = middle;
+    _lowerCorners[middle]    = _Y[object];
+    _upperCorners[middle]    = _Y[object];
+    _minPrices[middle]       = _prices[object];
+
+    std::size_t children[2] = {
+      begin < middle  ? this->build( begin, middle, depth + 1 ) : unassigned,
+      middle + 1 < end ? this->build( middle + 1, end, depth + 1 ) : unassigned
+    };
+
+    for( unsigned k = 0; k < 2; k++ )
+    {
+      auto child = children[k];
+
+      if( child == unassigned )
+        continue;
+
+      _parents[child]             = middle;
+      _children[ 2 * middle + k ] = child;
+
+      auto&& lower = _lowerCorners[child];
+      auto&& upper = _upperCorners[child];
+
+      _lowerCorners[middle] = Point( std::min( _lowerCorners[middle].x(), lower.x() ),
+                                     std::min( _lowerCorners[middle].y(), lower.y() ) );
+
+      _upperCorners[middle] = Point( std::max( _upperCorners[middle].x(), upper.x() ),
+                                     std::max( _upperCorners[middle].y(), upper.y() ) );
+
+      _minPrices[middle] = std::min( _minPrices[middle], _minPrices[child] );
+    }
+
+    return middle;
+  }
+
+  /**
+    Calculates an upper bound for the value of all objects in the subtree
+    of a node, i.e. the negative cost of the closest point of its bounding
+    box minus the lowest price of the subtree.
+  */
+
+  double bound( std::size_t position, std::size_t bidder ) const
+  {
+    auto&& p     = _X[bidder];
+    auto&& lower = _lowerCorners[position];
+    auto&& upper = _upperCorners[position];
+
+    Point q( std::min( std::max( p.x(), lower.x() ), upper.x() ),
+             std::min( std::max( p.y(), lower.y() ), upper.y() ) );
+
+    return -this->power( double( Distance()( p, q ) ) ) - _minPrices[position];
+  }
+
+  /**
+    Searches the subtree of a node for the best and second best object of
+    a bidder. Subtrees are skipped if their bound shows that they cannot
+    contain an object whose value exceeds the threshold, which is the
+    current second best value for bids.
+  */
+
+  template <class Functor> void search( std::size_t position, double bound, std::size_t bidder, Functor& consider, const double& threshold ) const
+  {
+    if( bound <= threshold )
+      return;
+
+    auto object = _tree[position];
+    consider( object, -this->cost( bidder, object ) - _prices[object] );
+
+    auto left  = _children[ 2 * position     ];
+    auto right = _children[ 2 * position + 1 ];
+
+    auto leftBound  = left  != unassigned ? this->bound( left,  bidder ) : -std::numeric_limits<double>::infinity();
+    auto rightBound = right != unassigned ? this->bound( right, bidder ) : -std::numeric_limits<double>::infinity();
+
+    // Searching the more promising child first results in a better second
+    // best value, which permits skipping more nodes of the other child.
+    if( rightBound > leftBound )
+    {
+      std::swap( left, right );
+      std::swap( leftBound, rightBound );
+    }
+
+    if( left != unassigned )
+      this->search( left, leftBound, bidder, consider, threshold );
+
+    if( right != unassigned )
+      this->search( right, rightBound, bidder, consider, threshold );
+  }
+
+  /**
+    Updates the lowest prices of all ancestors of an object after its
+    price has been raised. Since prices only increase, this stops at the
+    first node whose lowest price does not change.
+  */
+
+  void update( std::size_t object )
+  {
+    auto position = _positions[object];
+
+    while( position != unassigned )
+    {
+      auto minPrice = _prices[ _tree[position] ];
+
+      for( unsigned k = 0; k < 2; k++ )
+      {
+        auto child = _children[ 2 * position + k ];
+
+        if( child != unassigned )
+          minPrice = std::min( minPrice, _minPrices[child] );
+      }
+
+      if( minPrice == _minPrices[position] )
+        break;
+
+      _minPrices[position] = minPrice;
+      position             = _parents[position];
+    }
+  }
+
+  /**
+    Performs one phase of the auction with the current epsilon. All
+    assignments that do not satisfy the complementary slackness conditions
+    any more are dissolved, and the corresponding bidders take part in
+    the auction until every bidder has been assigned an object.
+  */
+
+  void phase()
+  {
+    auto N = _n + _m;
+
+    std::vector<std::size_t> bidders;
+
+    for( std::size_t bidder = 0; bidder < N; bidder++ )
+    {
+      auto object = _bidderToObject[bidder];
+
+      if( object != unassigned )
+      {
+        if( this->isAlmostOptimal( bidder, object ) )
+          continue;
+
+        _bidderToObject[bidder] = unassigned;
+        _objectToBidder[object] = unassigned;
+      }
+
+      bidders.push_back( bidder );
+    }
+
+    while( !bidders.empty() )
+    {
+      auto bidder = bidders.back();
+      bidders.pop_back();
+
+      double best   = 0.0;
+      double second = 0.0;
+
+      auto object = this->evaluate( bidder, best, second );
+
+      // A bidder with a single object only has to outbid the others by
+      // epsilon.
+      auto increment = std::isinf( second ) ? _epsilon : best - second + _epsilon;
+
+      if( object >= _m )
+      {
+        _diagonalPrices.erase( std::make_pair( _prices[object], object ) );
+        _diagonalPrices.insert( std::make_pair( _prices[object] + increment, object ) );
+      }
+
+      _prices[object] += increment;
+
+      if( object < _m )
+        this->update( object );
+
+      auto previous = _objectToBidder[object];
+
+      if( previous != unassigned )
+      {
+        _bidderToObject[previous] = unassigned;
+        bidders.push_back( previous );
+      }
+
+      _objectToBidder[object] = bidder;
+      _bidderToObject[bidder] = object;
+
+      ++_numBids;
+    }
+  }
+
+  double _power;
+  double _relativeError;
+  double _epsilon = 1.0;
+
+  const Point* _X = nullptr;
+  const Point* _Y = nullptr;
+
+  std::size_t _n = 0;
+  std::size_t _m = 0;
+
+  // Costs of matching points to the diagonal
+  std::vector<double> _diagonalX;
+  std::vector<double> _diagonalY;
+
+  // Costs of all assignments after the previous call
+  std::vector<double> _costs;
+
+  std::vector<double> _prices;
+
+  // Prices of all diagonal objects in ascending order
+  std::set< std::pair<double, std::size_t> > _diagonalPrices;
+  std::vector<std::size_t> _bidderToObject;
+  std::vector<std::size_t> _objectToBidder;
+
+  // kd-tree of the points of the second diagram. Nodes are identified by
+  // their position in the tree, and every node stores one object.
+  std::vector<std::size_t> _tree;        // object of every node
+  std::vector<std::size_t> _positions;   // node of every object
+  std::vector<std::size_t> _parents;
+  std::vector<std::size_t> _children;    // left and right child of every node
+  std::vector<Point> _lowerCorners;      // bounding box of every subtree
+  std::vector<Point> _upperCorners;
+  std::vector<double> _minPrices;        // lowest price of every subtree
+  std::size_t _root = unassigned;
+
+  std::size_t _numBids = 0;
+};
+
+template <class Point, class Distance> constexpr std::size_t Auction<Point, Distance>::diagonal;
+template <class Point, class Distance> constexpr std::size_t Auction<Point, Distance>::unassigned;
+
+} // namespace detail
+
+} // namespace distances
+
+} // namespace aleph
+
+#endif
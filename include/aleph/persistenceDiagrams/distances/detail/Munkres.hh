@@ -3,6 +3,8 @@
 
 #include <aleph/persistenceDiagrams/distances/detail/Matrix.hh>
 
+#include <aleph/utilities/Instrumentation.hh>
+
 #include <algorithm>
 #include <limits>
 #include <numeric>
@@ -99,8 +101,14 @@ public:
     std::size_t row = 0;
     std::size_t col = 0;
 
+    // Every step of the algorithm either covers zeros or searches for a
+    // new one; this is the equivalent of probing for a matching.
+    std::size_t numSteps = 0;
+
     while( step != 0 )
     {
+      ++numSteps;
+
       switch( step )
       {
       case 1:
@@ -121,6 +129,8 @@ public:
       }
     }
 
+    ALEPH_COUNT( MatchingProbes, numSteps );
+
     // Prepare reduced matrix ------------------------------------------
 
     auto n = _matrix.n();
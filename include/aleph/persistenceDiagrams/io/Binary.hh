@@ -0,0 +1,464 @@
+#ifndef ALEPH_PERSISTENCE_DIAGRAMS_IO_BINARY_HH__
+#define ALEPH_PERSISTENCE_DIAGRAMS_IO_BINARY_HH__
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistenceDiagrams/io/JSON.hh>
+#include <aleph/persistenceDiagrams/io/Raw.hh>
+
+#include <aleph/topology/io/Volume.hh>
+
+#include <aleph/utilities/Filesystem.hh>
+#include <aleph/utilities/Instrumentation.hh>
+#include <aleph/utilities/MemoryMappedFile.hh>
+#include <aleph/utilities/Tokenizer.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace aleph
+{
+
+namespace io
+{
+
+namespace detail
+{
+
+/*
+  Header of a binary persistence diagram container. The container stores
+  the points of all diagrams as pairs of 64-bit floating point values,
+  followed by the names of all diagrams and an index with one entry per
+  diagram. Fields are stored in the byte order of the machine that wrote
+  the file, which is detected by means of the byte order mark.
+*/
+
+struct BinaryPersistenceDiagramHeader
+{
+  char          magic[8];     // "ALEPHPD" followed by a null byte
+  std::uint32_t byteOrder;    // 0x01020304 in the byte order of the file
+  std::uint32_t version;      // Version of the format
+  std::uint64_t numDiagrams;  // Number of diagrams
+  std::uint64_t pointsOffset; // Offset of the points of all diagrams
+  std::uint64_t numPoints;    // Number of points of all diagrams
+  std::uint64_t namesOffset;  // Offset of the names of all diagrams
+  std::uint64_t namesSize;    // Size of all names in bytes
+  std::uint64_t indexOffset;  // Offset of the index
+};
+
+struct BinaryPersistenceDiagramEntry
+{
+  std::uint64_t pointOffset;  // Index of the first point of the diagram
+  std::uint64_t numPoints;    // Number of points of the diagram
+  std::uint64_t nameOffset;   // Offset of the name in the names section
+  std::uint32_t nameLength;   // Length of the name in bytes
+  std::uint32_t dimension;    // Dimension of the diagram
+};
+
+static_assert( sizeof(BinaryPersistenceDiagramHeader) == 64, "Unexpected padding in header" );
+static_assert( sizeof(BinaryPersistenceDiagramEntry)  == 32, "Unexpected padding in index" );
+
+static const char          BinaryPersistenceDiagramMagic[8]  = { 'A', 'L', 'E', 'P', 'H', 'P', 'D', '\0' };
+static const std::uint32_t BinaryPersistenceDiagramByteOrder = 0x01020304;
+static const std::uint32_t BinaryPersistenceDiagramVersion   = 1;
+
+} // namespace detail
+
+/**
+  @class BinaryPoint
+  @brief Point of a persistence diagram that is stored in a binary container
+*/
+
+struct BinaryPoint
+{
+  double birth;
+  double death;
+
+  double x() const noexcept { return birth; }
+  double y() const noexcept { return death; }
+};
+
+static_assert( sizeof(BinaryPoint) == 2 * sizeof(double), "Unexpected padding in point" );
+
+/**
+  @class PersistenceDiagramView
+  @brief Non-owning view of a persistence diagram in a binary container
+
+  A view refers to the points and the name of a diagram in a mapped file
+  without copying them. It is only valid as long as the reader that has
+  created it is valid.
+*/
+
+class PersistenceDiagramView
+{
+public:
+  using ConstIterator = const BinaryPoint*;
+
+  PersistenceDiagramView() = default;
+
+  PersistenceDiagramView( const BinaryPoint* begin, const BinaryPoint* end,
+                          utilities::StringView name,
+                          std::size_t dimension )
+    : _begin( begin )
+    , _end( end )
+    , _name( name )
+    , _dimension( dimension )
+  {
+  }
+
+  ConstIterator begin() const noexcept { return _begin; }
+  ConstIterator end()   const noexcept { return _end;   }
+
+  std::size_t size() const noexcept { return static_cast<std::size_t>( _end - _begin ); }
+  bool empty()       const noexcept { return _begin == _end; }
+
+  const BinaryPoint& operator[]( std::size_t i ) const noexcept { return _begin[i]; }
+
+  utilities::StringView name() const noexcept { return _name; }
+  std::size_t dimension() const noexcept      { return _dimension; }
+
+  /** @returns Copy of the view as a persistence diagram */
+  template <class T> PersistenceDiagram<T> toDiagram() const
+  {
+    PersistenceDiagram<T> D;
+    D.setDimension( _dimension );
+
+    for( auto&& p : *this )
+      D.add( static_cast<T>( p.x() ), static_cast<T>( p.y() ) );
+
+    return D;
+  }
+
+private:
+  const BinaryPoint*    _begin     = nullptr;
+  const BinaryPoint*    _end       = nullptr;
+  utilities::StringView _name;
+  std::size_t           _dimension = 0;
+};
+
+/**
+  @class BinaryPersistenceDiagramWriter
+  @brief Writes many persistence diagrams to a single binary container
+
+  Diagrams are streamed to the file as soon as they are added, so only
+  their names and the index are kept in memory. The container is only
+  complete once the writer has been closed, which happens automatically
+  upon its destruction.
+*/
+
+class BinaryPersistenceDiagramWriter
+{
+public:
+  explicit BinaryPersistenceDiagramWriter( const std::string& filename )
+    : _out( filename, std::ios::binary )
+  {
+    if( !_out )
+      throw std::runtime_error( "Unable to open output file" );
+
+    std::memset( &_header, 0, sizeof(_header) );
+    std::memcpy( _header.magic, detail::BinaryPersistenceDiagramMagic, sizeof(_header.magic) );
+
+    _header.byteOrder    = detail::BinaryPersistenceDiagramByteOrder;
+    _header.version      = detail::BinaryPersistenceDiagramVersion;
+    _header.pointsOffset = sizeof(_header);
+
+    // The header is written again once the container is closed
+    _out.write( reinterpret_cast<const char*>( &_header ), sizeof(_header) );
+  }
+
+  ~BinaryPersistenceDiagramWriter()
+  {
+    try
+    {
+      this->close();
+    }
+    catch( ... )
+    {
+    }
+  }
+
+  BinaryPersistenceDiagramWriter( const BinaryPersistenceDiagramWriter& )            = delete;
+  BinaryPersistenceDiagramWriter& operator=( const BinaryPersistenceDiagramWriter& ) = delete;
+
+  /** Adds a persistence diagram, or a view of one, to the container */
+  template <class Diagram> void add( const Diagram& D, const std::string& name = std::string() )
+  {
+    if( _closed )
+      throw std::runtime_error( "Unable to add diagram to closed container" );
+
+    std::vector<BinaryPoint> points;
+    points.reserve( D.size() );
+
+    for( auto&& p : D )
+      points.push_back( { static_cast<double>( p.x() ), static_cast<double>( p.y() ) } );
+
+    _out.write( reinterpret_cast<const char*>( points.data() ), static_cast<std::streamsize>( points.size() * sizeof(BinaryPoint) ) );
+
+    detail::BinaryPersistenceDiagramEntry entry;
+    entry.pointOffset = _header.numPoints;
+    entry.numPoints   = points.size();
+    entry.nameOffset  = _names.size();
+    entry.nameLength  = static_cast<std::uint32_t>( name.size() );
+    entry.dimension   = static_cast<std::uint32_t>( D.dimension() );
+
+    _names.append( name );
+    _index.push_back( entry );
+
+    _header.numPoints   += points.size();
+    _header.numDiagrams += 1;
+  }
+
+  /** Writes the names and the index of all diagrams and completes the container */
+  void close()
+  {
+    if( _closed )
+      return;
+
+    _closed = true;
+
+    _header.namesOffset = this->align();
+    _header.namesSize   = _names.size();
+
+    _out.write( _names.data(), static_cast<std::streamsize>( _names.size() ) );
+
+    _header.indexOffset = this->align();
+
+    _out.write( reinterpret_cast<const char*>( _index.data() ), static_cast<std::streamsize>( _index.size() * sizeof(detail::BinaryPersistenceDiagramEntry) ) );
+
+    _out.seekp( 0 );
+    _out.write( reinterpret_cast<const char*>( &_header ), sizeof(_header) );
+    _out.close();
+
+    if( !_out )
+      throw std::runtime_error( "Unable to write output file" );
+  }
+
+private:
+
+  /** Pads the file to a multiple of eight bytes and returns the current offset */
+  std::uint64_t align()
+  {
+    auto position = static_cast<std::uint64_t>( _out.tellp() );
+    auto padding  = ( 8 - position % 8 ) % 8;
+
+    static const char zeros[8] = { 0 };
+    _out.write( zeros, static_cast<std::streamsize>( padding ) );
+
+    return position + padding;
+  }
+
+  std::ofstream                                      _out;
+  detail::BinaryPersistenceDiagramHeader             _header;
+  std::string                                        _names;
+  std::vector<detail::BinaryPersistenceDiagramEntry> _index;
+  bool                                               _closed = false;
+};
+
+/**
+  @class BinaryPersistenceDiagramReader
+  @brief Provides random access to the diagrams in a binary container
+
+  The container is mapped into memory and only its header and its index
+  are checked for consistency, so opening a container is independent of
+  the number of points it contains. Every diagram is provided as a view
+  that refers to the mapping. Only containers of a different byte order
+  are copied, because their points have to be converted.
+*/
+
+class BinaryPersistenceDiagramReader
+{
+public:
+  explicit BinaryPersistenceDiagramReader( const std::string& filename )
+    : _file( std::make_shared<utilities::MemoryMappedFile>( filename ) )
+  {
+    using namespace aleph::topology::io::detail;
+
+    if( _file->size() < sizeof(detail::BinaryPersistenceDiagramHeader) )
+      throw std::runtime_error( "Format error: File too small for persistence diagram container" );
+
+    detail::BinaryPersistenceDiagramHeader header;
+    std::memcpy( &header, _file->data(), sizeof(header) );
+
+    if( std::memcmp( header.magic, detail::BinaryPersistenceDiagramMagic, sizeof(header.magic) ) != 0 )
+      throw std::runtime_error( "Format error: Expecting persistence diagram container" );
+
+    bool swap = false;
+
+    if( header.byteOrder == detail::BinaryPersistenceDiagramByteOrder )
+      swap = false;
+    else if( header.byteOrder == swapBytes( detail::BinaryPersistenceDiagramByteOrder ) )
+      swap = true;
+    else
+      throw std::runtime_error( "Format error: Unknown byte order" );
+
+    if( swap )
+    {
+      header.version      = swapBytes( header.version );
+      header.numDiagrams  = swapBytes( header.numDiagrams );
+      header.pointsOffset = swapBytes( header.pointsOffset );
+      header.numPoints    = swapBytes( header.numPoints );
+      header.namesOffset  = swapBytes( header.namesOffset );
+      header.namesSize    = swapBytes( header.namesSize );
+      header.indexOffset  = swapBytes( header.indexOffset );
+    }
+
+    if( header.version != detail::BinaryPersistenceDiagramVersion )
+      throw std::runtime_error( "Format error: Unsupported version of persistence diagram container" );
+
+    auto fits = [this] ( std::uint64_t offset, std::uint64_t n, std::size_t size )
+    {
+      return offset % 8 == 0 && offset <= _file->size() && n <= ( _file->size() - offset ) / size;
+    };
+
+    if(    !fits( header.pointsOffset, header.numPoints,   sizeof(BinaryPoint) )
+        || !fits( header.namesOffset,  header.namesSize,   1 )
+        || !fits( header.indexOffset,  header.numDiagrams, sizeof(detail::BinaryPersistenceDiagramEntry) ) )
+      throw std::runtime_error( "Format error: Section exceeds file" );
+
+    auto data = _file->data();
+
+    _points = reinterpret_cast<const BinaryPoint*>( data + header.pointsOffset );
+
+    // The mapping is read-only, so points of a different byte order have
+    // to be copied in order to convert them.
+    if( swap )
+    {
+      _swappedPoints.resize( static_cast<std::size_t>( header.numPoints ) );
+
+      if( !_swappedPoints.empty() )
+        std::memcpy( _swappedPoints.data(), _points, _swappedPoints.size() * sizeof(BinaryPoint) );
+
+      swapBytes( reinterpret_cast<std::uint64_t*>( _swappedPoints.data() ), 2 * _swappedPoints.size() );
+
+      _points = _swappedPoints.data();
+    }
+
+    _names  = reinterpret_cast<const char*>( data + header.namesOffset );
+
+    _index.resize( static_cast<std::size_t>( header.numDiagrams ) );
+
+    if( !_index.empty() )
+      std::memcpy( _index.data(), data + header.indexOffset, _index.size() * sizeof(detail::BinaryPersistenceDiagramEntry) );
+
+    for( auto&& entry : _index )
+    {
+      if( swap )
+      {
+        entry.pointOffset = swapBytes( entry.pointOffset );
+        entry.numPoints   = swapBytes( entry.numPoints );
+        entry.nameOffset  = swapBytes( entry.nameOffset );
+        entry.nameLength  = swapBytes( entry.nameLength );
+        entry.dimension   = swapBytes( entry.dimension );
+      }
+
+      if(    entry.pointOffset > header.numPoints || entry.numPoints > header.numPoints - entry.pointOffset
+          || entry.nameOffset  > header.namesSize || entry.nameLength > header.namesSize - entry.nameOffset )
+        throw std::runtime_error( "Format error: Index entry exceeds container" );
+    }
+  }
+
+  /** @returns Number of diagrams in the container */
+  std::size_t size() const noexcept
+  {
+    return _index.size();
+  }
+
+  bool empty() const noexcept
+  {
+    return _index.empty();
+  }
+
+  /** @returns View of the diagram with the given index */
+  PersistenceDiagramView operator[]( std::size_t i ) const
+  {
+    auto&& entry = _index.at( i );
+    auto name    = _names + entry.nameOffset;
+
+    return PersistenceDiagramView( _points + entry.pointOffset,
+                                   _points + entry.pointOffset + entry.numPoints,
+                                   utilities::StringView( name, name + entry.nameLength ),
+                                   entry.dimension );
+  }
+
+private:
+  std::shared_ptr<utilities::MemoryMappedFile>       _file;
+  const BinaryPoint*                                 _points = nullptr;
+  const char*                                        _names  = nullptr;
+  std::vector<BinaryPoint>                           _swappedPoints;
+  std::vector<detail::BinaryPersistenceDiagramEntry> _index;
+};
+
+/**
+  Writes multiple persistence diagrams to a binary container. If names
+  are specified, there must be one name per diagram.
+*/
+
+template <class Diagram> void writeBinary( const std::string& filename,
+                                           const std::vector<Diagram>& diagrams,
+                                           const std::vector<std::string>& names = {} )
+{
+  if( !names.empty() && names.size() != diagrams.size() )
+    throw std::runtime_error( "Number of names does not match number of diagrams" );
+
+  BinaryPersistenceDiagramWriter writer( filename );
+
+  for( std::size_t i = 0; i < diagrams.size(); i++ )
+    writer.add( diagrams[i], names.empty() ? std::string() : names[i] );
+
+  writer.close();
+}
+
+/** Reads all persistence diagrams from a binary container */
+template <class T> std::vector< PersistenceDiagram<T> > readBinary( const std::string& filename )
+{
+  ALEPH_PHASE( "read_persistence_diagrams" );
+
+  BinaryPersistenceDiagramReader reader( filename );
+
+  std::vector< PersistenceDiagram<T> > diagrams;
+  diagrams.reserve( reader.size() );
+
+  for( std::size_t i = 0; i < reader.size(); i++ )
+    diagrams.push_back( reader[i].toDiagram<T>() );
+
+  return diagrams;
+}
+
+/**
+  Converts persistence diagrams in text or JSON format to a binary
+  container. Files ending in ".json" may contain multiple diagrams,
+  which are named after the file and their dimension, e.g. "foo_d1".
+  All other files are read as raw diagrams and named after the file.
+*/
+
+inline void convertToBinary( const std::vector<std::string>& inputs, const std::string& output )
+{
+  BinaryPersistenceDiagramWriter writer( output );
+
+  for( auto&& input : inputs )
+  {
+    auto name = utilities::stem( input );
+
+    if( utilities::extension( input ) == ".json" )
+    {
+      for( auto&& diagram : readJSON<double>( input ) )
+        writer.add( diagram, name + "_d" + std::to_string( diagram.dimension() ) );
+    }
+    else
+      writer.add( load<double>( input ), name );
+  }
+
+  writer.close();
+}
+
+} // namespace io
+
+} // namespace aleph
+
+#endif
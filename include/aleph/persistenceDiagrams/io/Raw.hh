@@ -2,7 +2,9 @@
 #define ALEPH_PERSISTENCE_DIAGRAMS_IO_RAW_HH__
 
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+#include <aleph/utilities/Instrumentation.hh>
 #include <aleph/utilities/String.hh>
+#include <aleph/utilities/Tokenizer.hh>
 
 #include <fstream>
 #include <string>
@@ -24,37 +26,31 @@ namespace io
   by spaces, and adds them to the persistence diagram in the order
   in which they appear.
 
-  Any errors will result in exceptions.
+  The file is mapped into memory and tokenized without copying any of
+  its lines. Any errors will result in exceptions.
 */
 
 template <class T> PersistenceDiagram<T> load( const std::string& filename )
 {
-  std::ifstream in( filename );
-
-  if( !in )
-    throw std::runtime_error( "Unable to open filename for reading" );
-
   using namespace aleph::utilities;
 
+  ALEPH_PHASE( "read_persistence_diagram" );
+
   PersistenceDiagram<T> persistenceDiagram;
 
-  std::string line;
-  while( std::getline( in, line ) )
+  LineReader reader( filename );
+  StringView line;
+
+  while( reader.next( line ) )
   {
-    line = trim( line );
+    Tokenizer tokenizer( line );
+    StringView a, b;
 
-    if( line.empty() || line.front() == '#' )
+    if( !tokenizer.next( a ) || a.front() == '#' )
       continue;
 
-    auto tokens = split( line );
-
-    if( tokens.size() >= 2 )
-    {
-      T a = convert<T>( tokens[0] );
-      T b = convert<T>( tokens[1] );
-
-      persistenceDiagram.add( a, b );
-    }
+    if( tokenizer.next( b ) )
+      persistenceDiagram.add( convert<T>( a ), convert<T>( b ) );
   }
 
   return persistenceDiagram;
@@ -0,0 +1,328 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_BATCHED_PERSISTENCE_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_BATCHED_PERSISTENCE_HH__
+
+#include <aleph/config/Defaults.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/utilities/Instrumentation.hh>
+#include <aleph/utilities/RadixSort.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace aleph
+{
+
+/**
+  @class BatchedPersistence
+  @brief Persistent homology of many vertex functions on the same complex
+
+  Calculates the persistence diagrams of the lower-star (or upper-star)
+  filtrations that are induced by multiple functions on the vertices of
+  a fixed simplicial complex. This is the same as assigning the maximum
+  (minimum) of the vertex values to every simplex, sorting the complex
+  with a data-based filtration, and calculating its persistence diagrams,
+  which is what RipsExpander::assignMaximumData() is typically used for.
+
+  The structure of the complex, i.e. the vertices of every simplex and
+  the facets of every simplex, is extracted only once. Every function
+  then only requires calculating the values of all simplices, sorting
+  them with a radix sort on precomputed keys, and reducing the permuted
+  boundary matrix. Independent functions are processed in parallel.
+
+  Ties in function values are broken by dimension, so that faces always
+  precede their cofaces, and subsequently by the order of the simplices
+  in the complex.
+*/
+
+template <
+  class Simplex,
+  class ReductionAlgorithm = defaults::ReductionAlgorithm,
+  class Representation     = defaults::Representation
+> class BatchedPersistence
+{
+public:
+  using DataType           = typename Simplex::DataType;
+  using Vertex             = typename Simplex::VertexType;
+  using Index              = typename Representation::Index;
+  using SimplicialComplex  = topology::SimplicialComplex<Simplex>;
+  using PersistenceDiagram = aleph::PersistenceDiagram<DataType>;
+
+  /**
+    Extracts the structure of a simplicial complex. The order and the
+    data of its simplices are irrelevant.
+
+    @throws std::runtime_error if the complex is not closed under taking
+    faces, or if it is too large for the index type of the representation
+  */
+
+  explicit BatchedPersistence( const SimplicialComplex& K )
+  {
+    ALEPH_PHASE( "batched_persistence/structure" );
+
+    auto n = K.size();
+
+    if( n >= static_cast<std::size_t>( std::numeric_limits<Index>::max() ) )
+      throw std::runtime_error( "Simplicial complex is too large for index type" );
+
+    K.vertices( std::back_inserter( _vertices ) );
+
+    std::sort( _vertices.begin(), _vertices.end() );
+    _vertices.erase( std::unique( _vertices.begin(), _vertices.end() ), _vertices.end() );
+
+    _vertexOffsets.reserve( n + 1 );
+    _facetOffsets.reserve( n + 1 );
+
+    _vertexOffsets.push_back( 0 );
+    _facetOffsets.push_back( 0 );
+
+    std::vector<std::size_t> dimensions;
+    dimensions.reserve( n );
+
+    for( auto&& s : K )
+    {
+      for( auto&& v : s )
+        _vertexIndices.push_back( static_cast<Index>( std::lower_bound( _vertices.begin(), _vertices.end(), v ) - _vertices.begin() ) );
+
+      if( s.dimension() > 0 )
+      {
+        for( auto it = s.begin_boundary(); it != s.end_boundary(); ++it )
+        {
+          auto itFacet = K.find( *it );
+
+          if( itFacet == K.end() )
+            throw std::runtime_error( "Simplicial complex is missing a face" );
+
+          _facetIndices.push_back( static_cast<Index>( K.index( *itFacet ) ) );
+        }
+      }
+
+      _vertexOffsets.push_back( _vertexIndices.size() );
+      _facetOffsets.push_back( _facetIndices.size() );
+
+      dimensions.push_back( s.dimension() );
+    }
+
+    // Every function only sorts by value, so the tie-breaking order by
+    // dimension is calculated once by a stable counting sort.
+    {
+      auto maxDimension = dimensions.empty() ? 0 : *std::max_element( dimensions.begin(), dimensions.end() );
+
+      std::vector<std::size_t> offsets( maxDimension + 2 );
+
+      for( auto&& d : dimensions )
+        ++offsets[d + 1];
+
+      std::partial_sum( offsets.begin(), offsets.end(), offsets.begin() );
+
+      _order.resize( n );
+
+      for( std::size_t i = 0; i < n; i++ )
+        _order[ offsets[ dimensions[i] ]++ ] = Index( i );
+    }
+  }
+
+  /** @returns Number of vertices, i.e. the number of values per function */
+  std::size_t numVertices() const noexcept
+  {
+    return _vertices.size();
+  }
+
+  /**
+    @returns Vertices of the complex in sorted order; the i-th value of a
+    function is assigned to the i-th vertex.
+  */
+
+  const std::vector<Vertex>& vertices() const noexcept
+  {
+    return _vertices;
+  }
+
+  /**
+    Calculates the persistence diagrams of multiple functions.
+
+    @param values     Values of all functions, stored consecutively, i.e.
+                      value i of function f is stored at f * numVertices() + i
+    @param superlevel Flag indicating whether superlevel sets are used, i.e.
+                      the minimum of the vertex values is assigned to every
+                      simplex instead of the maximum
+    @param dualize    Flag indicating whether the boundary matrix is to be
+                      dualized before its reduction
+
+    @returns Persistence diagrams of every function, in the same format as
+    calculatePersistenceDiagrams(), i.e. sorted by dimension, omitting the
+    dimensions without any persistence pairs
+
+    @throws std::runtime_error if the number of values is not a multiple
+    of the number of vertices
+  */
+
+  std::vector< std::vector<PersistenceDiagram> > operator()( const std::vector<DataType>& values,
+                                                             bool superlevel = false,
+                                                             bool dualize    = true ) const
+  {
+    ALEPH_PHASE( "batched_persistence" );
+
+    auto m = _vertices.size();
+
+    if( m == 0 || values.size() % m != 0 )
+      throw std::runtime_error( "Number of values does not match number of vertices" );
+
+    auto numFunctions = values.size() / m;
+
+    std::vector< std::vector<PersistenceDiagram> > result( numFunctions );
+
+    #pragma omp parallel
+    {
+      Workspace workspace;
+
+      #pragma omp for schedule(dynamic, 1)
+      for( std::size_t f = 0; f < numFunctions; f++ )
+        result[f] = this->calculate( values.data() + f * m, superlevel, dualize, workspace );
+    }
+
+    return result;
+  }
+
+private:
+
+  /** Memory that is reused between the functions of a single thread */
+  struct Workspace
+  {
+    std::vector<DataType> values;
+    std::vector<std::uint64_t> keys;
+    std::vector<Index> order;
+    std::vector<Index> buffer;
+    std::vector<Index> ranks;
+    std::vector<Index> column;
+  };
+
+  std::vector<PersistenceDiagram> calculate( const DataType* vertexValues, bool superlevel, bool dualize, Workspace& workspace ) const
+  {
+    using namespace topology;
+
+    auto n = _order.size();
+
+    auto&& values = workspace.values;
+    auto&& keys   = workspace.keys;
+    auto&& order  = workspace.order;
+    auto&& ranks  = workspace.ranks;
+    auto&& column = workspace.column;
+
+    // Filtration ------------------------------------------------------
+
+    values.resize( n );
+    keys.resize( n );
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      auto value = vertexValues[ _vertexIndices[ _vertexOffsets[i] ] ];
+
+      for( auto j = _vertexOffsets[i] + 1; j < _vertexOffsets[i+1]; j++ )
+      {
+        auto other = vertexValues[ _vertexIndices[j] ];
+        value      = superlevel ? std::min( value, other ) : std::max( value, other );
+      }
+
+      values[i] = value;
+      keys[i]   = utilities::radixKey( value );
+
+      if( superlevel )
+        keys[i] = ~keys[i];
+    }
+
+    order = _order;
+    utilities::radixSort( order, keys, workspace.buffer );
+
+    ranks.resize( n );
+
+    for( std::size_t j = 0; j < n; j++ )
+      ranks[ static_cast<std::size_t>( order[j] ) ] = Index( j );
+
+    // Boundary matrix -------------------------------------------------
+
+    BoundaryMatrix<Representation> M;
+    M.setNumColumns( Index( n ) );
+
+    for( std::size_t j = 0; j < n; j++ )
+    {
+      auto i = static_cast<std::size_t>( order[j] );
+
+      column.clear();
+
+      for( auto k = _facetOffsets[i]; k < _facetOffsets[i+1]; k++ )
+        column.push_back( ranks[ static_cast<std::size_t>( _facetIndices[k] ) ] );
+
+      M.setColumn( Index( j ), column.begin(), column.end() );
+    }
+
+    // Persistence diagrams --------------------------------------------
+
+    auto pairing = calculatePersistencePairing<ReductionAlgorithm>( dualize ? M.dualize() : M );
+
+    auto dimension = [this, &order] ( Index j )
+    {
+      auto i = static_cast<std::size_t>( order[ static_cast<std::size_t>( j ) ] );
+      return _vertexOffsets[i+1] - _vertexOffsets[i] - 1;
+    };
+
+    auto value = [&values, &order] ( Index j )
+    {
+      return values[ static_cast<std::size_t>( order[ static_cast<std::size_t>( j ) ] ) ];
+    };
+
+    std::map<std::size_t, PersistenceDiagram> diagrams;
+
+    for( auto&& pair : pairing )
+    {
+      auto&& D = diagrams[ dimension( pair.first ) ];
+
+      if( static_cast<std::size_t>( pair.second ) < n )
+        D.add( value( pair.first ), value( pair.second ) );
+      else
+        D.add( value( pair.first ) );
+    }
+
+    std::vector<PersistenceDiagram> result;
+    result.reserve( diagrams.size() );
+
+    for( auto&& pair : diagrams )
+    {
+      pair.second.setDimension( pair.first );
+      result.push_back( pair.second );
+    }
+
+    return result;
+  }
+
+  std::vector<Vertex> _vertices;
+
+  // Vertices of every simplex, stored as indices into the sorted list of
+  // vertices
+  std::vector<std::size_t> _vertexOffsets;
+  std::vector<Index> _vertexIndices;
+
+  // Facets of every simplex, stored as indices of the complex
+  std::vector<std::size_t> _facetOffsets;
+  std::vector<Index> _facetIndices;
+
+  // Indices of all simplices, sorted by dimension
+  std::vector<Index> _order;
+};
+
+} // namespace aleph
+
+#endif
@@ -7,10 +7,13 @@
 #include <aleph/persistenceDiagrams/Calculation.hh>
 
 #include <aleph/persistentHomology/PersistencePairing.hh>
+#include <aleph/persistentHomology/ReductionControl.hh>
 
 #include <aleph/topology/Conversions.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/utilities/Instrumentation.hh>
+
 #include <algorithm>
 #include <tuple>
 #include <unordered_set>
@@ -51,12 +54,23 @@ namespace aleph
                              determined from the input data.
 */
 
+namespace detail
+{
+
+/**
+  Reduces a copy of a boundary matrix using the given control object and
+  reads off the resulting persistence pairing. Please refer to the public
+  overloads below for a description of the parameters.
+*/
+
 template <
-  class ReductionAlgorithm = aleph::defaults::ReductionAlgorithm,
-  class Representation
+  class ReductionAlgorithm,
+  class Representation,
+  class Control
 > PersistencePairing<typename Representation::Index> calculatePersistencePairing( const topology::BoundaryMatrix<Representation>& M,
-                                                                                  bool includeAllUnpairedCreators    = false,
-                                                                                  typename Representation::Index max = typename Representation::Index() )
+                                                                                  Control& control,
+                                                                                  bool includeAllUnpairedCreators,
+                                                                                  typename Representation::Index max )
 {
   using namespace topology;
 
@@ -66,7 +80,7 @@ template <
   BoundaryMatrix<Representation> B = M;
 
   ReductionAlgorithm reductionAlgorithm;
-  reductionAlgorithm( B );
+  reductionAlgorithm( B, control );
 
   PersistencePairing pairing;
 
@@ -76,6 +90,11 @@ template <
 
   for( Index j = Index(0); j < numColumns; j++ )
   {
+    // Columns that have not been reduced neither create nor destroy
+    // any features.
+    if( !control.isReduced( j ) )
+      continue;
+
     Index i;
     bool valid;
 
@@ -96,7 +115,7 @@ template <
         v  = numColumns - 1 - w; // Yes, this is correct!
       }
 
-      if( !max || i < max )
+      if( ( !max || i < max ) && control.acceptPair( B, i, j ) )
         pairing.add( u, v );
     }
 
@@ -109,9 +128,10 @@ template <
       // of the boundary matrix. Else, there will be a lot of spurious
       // features that cannot be destroyed due to their dimensions. If
       // the client wants to have them, however, we let them.
-      if(    ( !B.isDualized() && B.getDimension(j) != B.getDimension() )
-          || (  B.isDualized() && B.getDimension(j) != Index(0) )
-          || includeAllUnpairedCreators )
+      if(    (    ( !B.isDualized() && B.getDimension(j) != B.getDimension() )
+               || (  B.isDualized() && B.getDimension(j) != Index(0) )
+               || includeAllUnpairedCreators )
+          && control.acceptCreator( B, j ) )
       {
         creators.insert( j );
       }
@@ -130,6 +150,75 @@ template <
   return pairing;
 }
 
+} // namespace detail
+
+/**
+  Given a boundary matrix, reduces it and reads off the resulting
+  persistence pairing. An optional parameter can be used to force
+  the algorithm to stop processing a part of the pairing. This is
+  especially relevant for intersection homology, which sets upper
+  limits for the validity of an index in the matrix.
+
+  @param M                          Boundary matrix to reduce
+
+  @param includeAllUnpairedCreators Flag indicating whether all unpaired creators should
+                                    be included (regardless of their dimension). If set,
+                                    this increases the size of the resulting pairing, as
+                                    the highest-dimensional columns of the matrix cannot
+                                    be reduced any more. The flag is useful, however, in
+                                    case one wants to calculate ordinary homology, where
+                                    high-dimensional simplices are used for Betti number
+                                    calculations.
+
+  @param max                        Optional maximum index after which simplices are not
+                                    considered any more. If the pairing of a simplex has
+                                    an index larger than the maximum one, such simplices
+                                    will not be considered in the pairing.
+
+  @tparam ReductionAlgorithm Specifies a reduction algorithm to use for reducing
+                             the input matrix. Aleph provides a default value in
+                             order to simplify the usage of this function.
+
+  @tparam Representation     The representation of the boundary matrix, i.e. how
+                             columns are stored. This parameter is automatically
+                             determined from the input data.
+*/
+
+template <
+  class ReductionAlgorithm = aleph::defaults::ReductionAlgorithm,
+  class Representation
+> PersistencePairing<typename Representation::Index> calculatePersistencePairing( const topology::BoundaryMatrix<Representation>& M,
+                                                                                  bool includeAllUnpairedCreators    = false,
+                                                                                  typename Representation::Index max = typename Representation::Index() )
+{
+  persistentHomology::NoReductionControl control;
+  return detail::calculatePersistencePairing<ReductionAlgorithm>( M, control, includeAllUnpairedCreators, max );
+}
+
+/**
+  Reduces a boundary matrix under the supervision of a control object
+  and reads off the resulting persistence pairing. The pairing omits
+  all columns that have not been reduced, all pairs whose persistence
+  does not exceed the threshold of the control object, and all classes
+  above its maximum dimension. Afterwards, the control object provides
+  statistics about the reduction.
+
+  @param M                          Boundary matrix to reduce
+  @param control                    Control object that limits the reduction
+  @param includeAllUnpairedCreators Flag indicating whether all unpaired creators should
+                                    be included; see above
+*/
+
+template <
+  class ReductionAlgorithm = aleph::defaults::ReductionAlgorithm,
+  class Representation
+> PersistencePairing<typename Representation::Index> calculatePersistencePairing( const topology::BoundaryMatrix<Representation>& M,
+                                                                                  persistentHomology::ReductionControl& control,
+                                                                                  bool includeAllUnpairedCreators = false )
+{
+  return detail::calculatePersistencePairing<ReductionAlgorithm>( M, control, includeAllUnpairedCreators, typename Representation::Index() );
+}
+
 template <
   class ReductionAlgorithm = defaults::ReductionAlgorithm,
   class Representation     = defaults::Representation,
@@ -138,12 +227,73 @@ template <
 {
   using namespace topology;
 
+  ALEPH_PHASE( "persistent_homology" );
+
   auto boundaryMatrix = makeBoundaryMatrix<Representation>( K );
   auto pairing        = calculatePersistencePairing<ReductionAlgorithm>( dualize ? boundaryMatrix.dualize() : boundaryMatrix, includeAllUnpairedCreators );
 
   return makePersistenceDiagrams( pairing, K );
 }
 
+/**
+  Calculates the persistence diagram of a single dimension of a simplicial
+  complex. Only the simplices of this dimension and the dimension above
+  are converted into columns of a boundary matrix; the simplices of the
+  dimension below only serve as rows. This is considerably cheaper than
+  calculating all persistence diagrams if the simplicial complex has a
+  large number of simplices in other dimensions, e.g. the triangles of a
+  Vietoris--Rips complex when only zero-dimensional features are needed.
+
+  The default reduction algorithm processes the columns of the dimension
+  above first, so it does not reduce the columns that they destroy.
+
+  @param K                          Simplicial complex
+  @param dimension                  Dimension of the persistence diagram
+  @param includeAllUnpairedCreators Flag indicating whether unpaired creators should be
+                                    included if the dimension is the largest dimension
+                                    of the simplicial complex; see above
+
+  @returns Persistence diagram of the given dimension, which may be empty
+*/
+
+template <
+  class ReductionAlgorithm = defaults::ReductionAlgorithm,
+  class Representation     = defaults::Representation,
+  class Simplex
+> PersistenceDiagram<typename Simplex::DataType> calculatePersistenceDiagram( const topology::SimplicialComplex<Simplex>& K,
+                                                                             std::size_t dimension,
+                                                                             bool includeAllUnpairedCreators = false )
+{
+  using namespace topology;
+
+  ALEPH_PHASE( "persistent_homology" );
+
+  std::vector<std::size_t> indices;
+
+  auto boundaryMatrix = makeBoundaryMatrix<Representation>( K, { dimension, dimension + 1 }, indices );
+  auto pairing        = calculatePersistencePairing<ReductionAlgorithm>( boundaryMatrix, includeAllUnpairedCreators );
+
+  PersistenceDiagram<typename Simplex::DataType> D;
+  D.setDimension( dimension );
+
+  for( auto&& pair : pairing )
+  {
+    auto&& s = K.at( indices.at( pair.first ) );
+
+    // The pairing also contains creators of other dimensions, which are
+    // only partially reduced.
+    if( s.dimension() != dimension )
+      continue;
+
+    if( pair.second < indices.size() )
+      D.add( s.data(), K.at( indices[ pair.second ] ).data() );
+    else
+      D.add( s.data() );
+  }
+
+  return D;
+}
+
 template <
   class ReductionAlgorithm = defaults::ReductionAlgorithm,
   class Representation     = defaults::Representation,
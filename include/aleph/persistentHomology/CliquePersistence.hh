@@ -0,0 +1,128 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_CLIQUE_PERSISTENCE_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_CLIQUE_PERSISTENCE_HH__
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistentHomology/ConnectedComponents.hh>
+#include <aleph/persistentHomology/PersistencePairing.hh>
+
+#include <aleph/topology/CliqueGraph.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <exception>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace aleph
+{
+
+/**
+  @class CliquePersistence
+  @brief Result of the clique community persistence calculation for one k
+
+  Stores the persistence diagram and the persistence pairing of the
+  k-clique graph, along with the size of the graph. Indices in the
+  pairing follow the conventions of the zero-dimensional persistence
+  calculation for clique graphs in compressed sparse row layout.
+*/
+
+template <class DataType, class Index> struct CliquePersistence
+{
+  unsigned k             = 0;
+  std::size_t numNodes   = 0;
+  std::size_t numEdges   = 0;
+
+  PersistenceDiagram<DataType> diagram;
+  PersistencePairing<Index> pairing;
+};
+
+/**
+  Calculates clique community persistence for all k in a given range in
+  a single sweep. All clique graphs are derived from a shared index for
+  the simplicial complex, which is built only once. Subsequently, the
+  zero-dimensional persistence calculations run concurrently.
+
+  Since the calculations for different k are independent of each other,
+  every k requires its own functor. The functors are indexed by k, i.e.
+  the vector needs to contain at least maxK + 1 functors. Functors whose
+  index is not in the range are not used.
+
+  @param K         Simplicial complex; needs to contain all faces of its
+                   simplices and be sorted according to its weights
+  @param minK      Minimum clique order
+  @param maxK      Maximum clique order
+  @param functors  Functors for all clique orders, indexed by k
+
+  @returns Results for all clique orders in the range, in ascending order
+  of k
+*/
+
+template <
+  class Index                    = unsigned,
+  class PairingCalculationTraits = traits::NoPersistencePairingCalculation< PersistencePairing<Index> >,
+  class ElementCalculationTraits = traits::NoDiagonalElementCalculation,
+  class Simplex,
+  class Functor
+>
+std::vector< CliquePersistence<typename Simplex::DataType, Index> > calculateCliquePersistence( const topology::SimplicialComplex<Simplex>& K,
+                                                                                                 unsigned minK,
+                                                                                                 unsigned maxK,
+                                                                                                 std::vector<Functor>& functors )
+{
+  using DataType = typename Simplex::DataType;
+
+  if( minK > maxK )
+    return {};
+
+  if( functors.size() <= maxK )
+    throw std::runtime_error( "Insufficient number of functors for clique orders" );
+
+  topology::CliqueGraphIndex<Simplex, Index> index( K, maxK );
+
+  std::vector< CliquePersistence<DataType, Index> > result( maxK - minK + 1 );
+
+  // Exceptions must not escape from a parallel region, so the first one
+  // is stored and re-thrown once all threads are finished.
+  std::exception_ptr exception;
+
+  // Larger clique orders typically result in smaller graphs, so dynamic
+  // scheduling is required to balance the load among all threads.
+  #pragma omp parallel for schedule(dynamic)
+  for( std::size_t i = 0; i < result.size(); i++ )
+  {
+    try
+    {
+      auto k = minK + unsigned( i );
+      auto C = index( k );
+
+      auto&& tuple = calculateZeroDimensionalPersistenceDiagram<DataType,
+                                                                Index,
+                                                                PairingCalculationTraits,
+                                                                ElementCalculationTraits>( C, functors[k] );
+
+      result[i].k        = k;
+      result[i].numNodes = C.size();
+      result[i].numEdges = C.numEdges();
+      result[i].diagram  = std::move( std::get<0>( tuple ) );
+      result[i].pairing  = std::move( std::get<1>( tuple ) );
+    }
+    catch( ... )
+    {
+      #pragma omp critical
+      {
+        if( !exception )
+          exception = std::current_exception();
+      }
+    }
+  }
+
+  if( exception )
+    std::rethrow_exception( exception );
+
+  return result;
+}
+
+} // namespace aleph
+
+#endif
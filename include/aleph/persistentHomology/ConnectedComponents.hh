@@ -5,6 +5,7 @@
 
 #include <aleph/persistentHomology/PersistencePairing.hh>
 
+#include <aleph/topology/CliqueGraph.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 #include <aleph/topology/UnionFind.hh>
 
@@ -201,6 +202,133 @@ calculateZeroDimensionalPersistenceDiagram( const topology::SimplicialComplex<Si
   return std::make_tuple( pd, pp );
 }
 
+/**
+  Calculates zero-dimensional persistent homology of a clique graph that
+  is given in compressed sparse row layout. The result is the same as for
+  the clique graph in simplicial complex form, sorted according to the
+  weights of the simplices, but neither the complex nor a boundary matrix
+  are required.
+
+  The functor is called with the indices of the k-simplices of the nodes,
+  i.e. the same indices that are used as vertices by getCliqueGraph(). A
+  creator in the pairing is also reported using this index. A destroyer,
+  however, is reported as the index of the edge in the filtration order
+  of all edges of the graph.
+*/
+
+template <
+  class DataType,
+  class Index,
+  class PairingCalculationTraits = traits::NoPersistencePairingCalculation< PersistencePairing<Index> >,
+  class ElementCalculationTraits = traits::NoDiagonalElementCalculation,
+  class Functor = aleph::utilities::EmptyFunctor
+>
+  std::tuple<
+    PersistenceDiagram<DataType>,
+    PersistencePairing<Index>
+  >
+calculateZeroDimensionalPersistenceDiagram( const topology::CliqueGraphAdjacency<DataType, Index>& G, Functor&& functor = Functor() )
+{
+  using namespace topology;
+
+  struct Edge
+  {
+    DataType weight;
+    Index u;
+    Index v;
+  };
+
+  // Edges -------------------------------------------------------------
+  //
+  // Every edge is stored twice in the graph, so only the copy with the
+  // smaller source node is used. The order of edges with equal weights
+  // is lexicographical, just as for a simplicial complex.
+
+  std::vector<Edge> edges;
+  edges.reserve( G.numEdges() );
+
+  for( std::size_t i = 0; i < G.size(); i++ )
+  {
+    auto u        = Index( i );
+    auto itWeight = G.begin_weights( u );
+
+    for( auto itNeighbour = G.begin_neighbours( u ); itNeighbour != G.end_neighbours( u ); ++itNeighbour, ++itWeight )
+    {
+      if( u < *itNeighbour )
+        edges.push_back( { *itWeight, *itNeighbour, u } );
+    }
+  }
+
+  std::sort( edges.begin(), edges.end(),
+             [] ( const Edge& e, const Edge& f )
+             {
+               if( e.weight == f.weight )
+                 return std::make_pair( e.u, e.v ) < std::make_pair( f.u, f.v );
+               else
+                 return e.weight < f.weight;
+             } );
+
+  DenseUnionFind<Index> uf( G.size() );
+  PersistenceDiagram<DataType> pd;
+  PersistencePairing<Index> pp;
+
+  PairingCalculationTraits ct( pp );
+  ElementCalculationTraits et;
+
+  for( std::size_t i = 0; i < G.size(); i++ )
+    functor.initialize( G.simplex( Index( i ) ) );
+
+  for( std::size_t i = 0; i < edges.size(); i++ )
+  {
+    auto&& edge = edges[i];
+
+    auto youngerComponent = uf.find( edge.u );
+    auto olderComponent   = uf.find( edge.v );
+
+    if( youngerComponent == olderComponent )
+      continue;
+
+    // The younger component is the one whose creator appears later in
+    // the filtration. Ties are broken by index, as for vertices of the
+    // clique graph in simplicial complex form.
+    if(    std::make_pair( G.data( youngerComponent ), youngerComponent )
+         < std::make_pair( G.data( olderComponent   ), olderComponent   ) )
+    {
+      std::swap( youngerComponent, olderComponent );
+    }
+
+    auto creation    = G.data( youngerComponent );
+    auto destruction = edge.weight;
+
+    uf.merge( youngerComponent, olderComponent );
+
+    functor( G.simplex( youngerComponent ),
+             G.simplex( olderComponent ),
+             creation,
+             destruction );
+
+    if( et( creation, destruction ) )
+    {
+      pd.add( creation, destruction );
+      ct.add( G.simplex( youngerComponent ), Index( i ) );
+    }
+  }
+
+  std::vector<Index> roots;
+  uf.roots( std::back_inserter( roots ) );
+
+  for( auto&& root : roots )
+  {
+    pd.add( G.data( root ) );
+    ct.add( G.simplex( root ) );
+
+    functor( G.simplex( root ),
+             G.data( root ) );
+  }
+
+  return std::make_tuple( pd, pp );
+}
+
 } // namespace aleph
 
 #endif
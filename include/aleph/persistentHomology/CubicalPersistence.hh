@@ -0,0 +1,342 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_CUBICAL_PERSISTENCE_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_CUBICAL_PERSISTENCE_HH__
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/topology/CubicalComplex.hh>
+
+#include <aleph/utilities/Instrumentation.hh>
+#include <aleph/utilities/ParallelSort.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+namespace detail
+{
+
+/**
+  @class CubicalCellIndex
+  @brief Enumerates the cells of a cubical complex by dimension
+
+  Assigns every cell of a given dimension a contiguous rank, which
+  permits storing information about the cells of one dimension in an
+  array of their size instead of one that covers all cells. Cells are
+  grouped by the axes along which they extend; within a group, their
+  ranks follow the grid order.
+*/
+
+template <class T> class CubicalCellIndex
+{
+public:
+  using Index = typename topology::CubicalComplex<T>::Index;
+
+  explicit CubicalCellIndex( const topology::CubicalComplex<T>& C )
+    : _shape( C.shape() )
+  {
+    Index stride = 1;
+
+    for( auto&& n : _shape )
+    {
+      _cellStrides.push_back( stride );
+      stride *= 2 * n - 1;
+
+      if( n > 1 )
+        _axes.push_back( _cellStrides.size() - 1 );
+    }
+
+    auto D        = _axes.size();
+    auto numMasks = std::size_t(1) << D;
+
+    _offsets.resize( numMasks );
+    _masks.resize( D + 1 );
+    _sizes.assign( D + 1, 0 );
+
+    // The masks of every dimension are visited in ascending order, so the
+    // offsets of their groups are sorted as well.
+    for( std::size_t mask = 0; mask < numMasks; mask++ )
+    {
+      std::size_t d  = 0;
+      Index numCells = 1;
+
+      for( std::size_t j = 0; j < D; j++ )
+      {
+        auto n    = _shape[ _axes[j] ];
+        auto odd  = ( mask >> j ) & 1;
+        d        += odd;
+        numCells *= odd ? n - 1 : n;
+      }
+
+      _offsets[mask] = _sizes[d];
+      _sizes[d]     += numCells;
+
+      _masks[d].push_back( mask );
+    }
+  }
+
+  /** @returns Number of cells of a given dimension */
+  Index size( std::size_t d ) const noexcept
+  {
+    return _sizes[d];
+  }
+
+  /** @returns Rank of a cell among all cells of its dimension */
+  Index rank( Index cell ) const noexcept
+  {
+    std::size_t mask = 0;
+    Index rank       = 0;
+    Index stride     = 1;
+
+    for( std::size_t j = 0; j < _axes.size(); j++ )
+    {
+      auto i = _axes[j];
+      auto n = _shape[i];
+      auto x = ( cell / _cellStrides[i] ) % ( 2 * n - 1 );
+
+      mask   |= std::size_t( x % 2 ) << j;
+      rank   += ( x / 2 ) * stride;
+      stride *= x % 2 ? n - 1 : n;
+    }
+
+    return _offsets[mask] + rank;
+  }
+
+  /** @returns Cell of a given dimension and rank */
+  Index cell( std::size_t d, Index rank ) const noexcept
+  {
+    auto&& masks = _masks[d];
+
+    auto it = std::upper_bound( masks.begin(), masks.end(), rank,
+                                [this] ( Index r, std::size_t mask )
+                                {
+                                  return r < _offsets[mask];
+                                } );
+
+    auto mask = *std::prev( it );
+    rank     -= _offsets[mask];
+
+    Index cell = 0;
+
+    for( std::size_t j = 0; j < _axes.size(); j++ )
+    {
+      auto i     = _axes[j];
+      auto odd   = ( mask >> j ) & 1;
+      auto radix = odd ? _shape[i] - 1 : _shape[i];
+
+      cell += ( 2 * ( rank % radix ) + odd ) * _cellStrides[i];
+      rank /= radix;
+    }
+
+    return cell;
+  }
+
+private:
+  std::vector<std::size_t> _shape;
+  std::vector<Index> _cellStrides;
+
+  // Axes with more than one vertex, i.e. the ones cells may extend along
+  std::vector<std::size_t> _axes;
+
+  // Offset of every group of cells, indexed by the mask of their axes
+  std::vector<Index> _offsets;
+
+  // Masks of all groups of every dimension, and the number of cells of
+  // every dimension
+  std::vector< std::vector<std::size_t> > _masks;
+  std::vector<Index> _sizes;
+};
+
+} // namespace detail
+
+/**
+  Calculates the persistence diagrams of the lower-star or upper-star
+  filtration of a cubical complex. Cells are never materialized: their
+  values, dimensions, and boundaries are derived from their indices.
+
+  The reduction processes dimensions from the top down and clears the
+  columns of all cells that have been paired in the previous dimension,
+  following the 'twist' algorithm. Only the cells of the current
+  dimension are sorted, and pairing information is only kept for the
+  cells of the current dimension and the one below, indexed by their
+  rank within their dimension. A reduced column is only stored if it
+  differs from the boundary of its cell. Every other column is restored
+  from the grid whenever it is required.
+
+  Ties in the filtration are broken by dimension, such that faces always
+  precede their co-faces, and subsequently by the index of a cell.
+
+  @param C         Cubical complex
+  @param upperStar Flag indicating whether the upper-star filtration, i.e.
+                   the one of superlevel sets, is to be used. By default,
+                   the lower-star filtration is used.
+
+  @returns Persistence diagrams of all dimensions, from 0 to the dimension
+  of the complex. Pairs of zero persistence are not reported.
+*/
+
+template <class T> std::vector< PersistenceDiagram<T> > calculatePersistenceDiagrams( const topology::CubicalComplex<T>& C, bool upperStar = false )
+{
+  using Index = typename topology::CubicalComplex<T>::Index;
+  using Cell  = std::pair<T, Index>;
+
+  ALEPH_PHASE( "cubical_persistence" );
+
+  auto n = C.size();
+  auto D = C.dimension();
+
+  std::vector< PersistenceDiagram<T> > diagrams( D + 1 );
+
+  for( std::size_t d = 0; d <= D; d++ )
+    diagrams[d].setDimension( d );
+
+  if( n == 0 )
+    return diagrams;
+
+  detail::CubicalCellIndex<T> index( C );
+
+  // Filtration order of cells of the same dimension. Cells are stored
+  // along with their values, so no values need to be recalculated.
+  auto precedes = [&upperStar] ( const Cell& a, const Cell& b )
+  {
+    if( a.first != b.first )
+      return upperStar ? a.first > b.first : a.first < b.first;
+    else
+      return a.second < b.second;
+  };
+
+  std::vector<Index> faces;
+
+  auto makeColumn = [&C, &upperStar, &precedes, &faces] ( Index cell, std::vector<Cell>& column )
+  {
+    faces.clear();
+    column.clear();
+
+    C.boundary( cell, std::back_inserter( faces ) );
+
+    for( auto&& face : faces )
+      column.push_back( std::make_pair( C.value( face, upperStar ), face ) );
+
+    std::sort( column.begin(), column.end(), precedes );
+  };
+
+  auto none = std::numeric_limits<Index>::max();
+
+  // Stores, for every cell of the current dimension, whether it has been
+  // paired with a cell of the next higher dimension. This is the only
+  // information that is required for the clearing optimization.
+  std::vector<bool> paired;
+
+  std::vector<Cell> cells;
+
+  std::vector<Cell> column;
+  std::vector<Cell> other;
+  std::vector<Cell> result;
+
+  std::size_t numColumnAdditions = 0;
+
+  for( std::size_t d = D; ; d-- )
+  {
+    auto numCells = index.size( d );
+
+    cells.resize( numCells );
+
+    #pragma omp parallel for
+    for( std::size_t r = 0; r < numCells; r++ )
+    {
+      auto cell = index.cell( d, r );
+      cells[r]  = std::make_pair( C.value( cell, upperStar ), cell );
+    }
+
+    utilities::parallelSort( cells.begin(), cells.end(), precedes );
+
+    // For a creator of dimension d-1, stores the cell whose column has it
+    // as its lowest entry
+    std::vector<Index> pivots( d >= 1 ? index.size( d-1 ) : 0, none );
+
+    // Reduced columns that differ from the boundary of their cells. Every
+    // other column can be restored from the cubical complex.
+    std::unordered_map<Index, std::vector<Cell> > reducedColumns;
+
+    for( auto&& cell : cells )
+    {
+      auto j = cell.second;
+
+      // Columns of cells that have been paired already are zero after
+      // their reduction. This is the clearing optimization.
+      if( !paired.empty() && paired[ index.rank( j ) ] )
+        continue;
+
+      column.clear();
+
+      if( d >= 1 )
+        makeColumn( j, column );
+
+      bool modified = false;
+
+      while( !column.empty() && pivots[ index.rank( column.back().second ) ] != none )
+      {
+        auto k  = pivots[ index.rank( column.back().second ) ];
+        auto it = reducedColumns.find( k );
+
+        if( it != reducedColumns.end() )
+          other = it->second;
+        else
+          makeColumn( k, other );
+
+        result.clear();
+
+        std::set_symmetric_difference( column.begin(), column.end(),
+                                       other.begin(), other.end(),
+                                       std::back_inserter( result ),
+                                       precedes );
+
+        column.swap( result );
+        modified = true;
+
+        ++numColumnAdditions;
+      }
+
+      // Every cell that has neither been paired with a cell of the next
+      // higher dimension nor with one of the next lower dimension creates
+      // a feature of infinite persistence.
+      if( column.empty() )
+      {
+        diagrams[d].add( cell.first );
+        continue;
+      }
+
+      auto&& i = column.back();
+      pivots[ index.rank( i.second ) ] = j;
+
+      if( modified )
+        reducedColumns[j] = column;
+
+      if( i.first != cell.first )
+        diagrams[d-1].add( i.first, cell.first );
+    }
+
+    paired.assign( pivots.size(), false );
+
+    for( std::size_t r = 0; r < pivots.size(); r++ )
+      paired[r] = pivots[r] != none;
+
+    if( d == 0 )
+      break;
+  }
+
+  ALEPH_COUNT( ColumnAdditions, numColumnAdditions );
+
+  return diagrams;
+}
+
+} // namespace aleph
+
+#endif
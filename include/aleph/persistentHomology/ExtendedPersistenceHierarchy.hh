@@ -2,16 +2,13 @@
 #define ALEPH_PERSISTENT_HOMOLOGY_EXTENDED_PERSISTENCE_HIERARCHY__
 
 #include <algorithm>
-#include <map>
+#include <cstddef>
+#include <iterator>
 #include <stdexcept>
-#include <set>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
-#include <boost/bimap.hpp>
-
-#include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/breadth_first_search.hpp>
-
 #include <aleph/persistentHomology/PersistencePairing.hh>
 
 #include <aleph/topology/SimplicialComplex.hh>
@@ -23,63 +20,146 @@ namespace aleph
 namespace detail
 {
 
-using AdjacencyGraph = boost::adjacency_list<
-  boost::vecS,
-  boost::vecS,
-  boost::undirectedS,
-  boost::no_property,
-  boost::no_property>;
-
 using SizeType = std::size_t;
 
-/** Extracts the adjacency graph of a simplicial complex */
-template <class Simplex>
-std::pair<boost::bimap<typename Simplex::VertexType, SizeType>, AdjacencyGraph> extractZeroDimensionalAdjacencyGraph( const topology::SimplicialComplex<Simplex>& S )
+/**
+  @class InterlevelSetConnectivity
+  @brief Answers connectivity queries in interlevel sets of two regions
+
+  The edges of the 1-skeleton of a simplicial complex are partitioned
+  into regions, each of which is identified by the critical point the
+  region belongs to. Given two critical points, the class checks whether
+  they are connected in an interlevel set by a path that only uses the
+  edges of their respective regions.
+
+  Edges are stored in one contiguous array, grouped by their region, so
+  every query only visits the edges of the two regions involved. Queries
+  use a Union--Find data structure over all vertices. Instead of being
+  reset for every query, vertices are lazily re-initialized whenever a
+  query encounters them for the first time. A query thus requires time
+  that is linear in the size of the two regions.
+*/
+
+template <class DataType> class InterlevelSetConnectivity
 {
-  AdjacencyGraph adjacencyGraph;
+public:
 
-  using Vertex           = typename Simplex::VertexType;
-  using VertexDescriptor = boost::graph_traits<AdjacencyGraph>::vertex_descriptor;
-  using bimap_type       = boost::bimap<Vertex, SizeType>;
+  /**
+    @param vertexValues Function values of all vertices
+    @param sources      First vertex of every edge
+    @param targets      Second vertex of every edge
+    @param edgeValues   Function values of all edges
+    @param regions      Region, i.e. critical point, of every edge
+  */
 
-  bimap_type indices;
-  std::map<Vertex, VertexDescriptor> vdm;
+  InterlevelSetConnectivity( std::vector<DataType> vertexValues,
+                             const std::vector<SizeType>& sources,
+                             const std::vector<SizeType>& targets,
+                             const std::vector<DataType>& edgeValues,
+                             const std::vector<SizeType>& regions )
+    : _vertexValues( std::move( vertexValues ) )
+    , _offsets( _vertexValues.size() + 1, 0 )
+    , _sources( sources.size() )
+    , _targets( targets.size() )
+    , _edgeValues( edgeValues.size() )
+    , _parents( _vertexValues.size() )
+    , _stamps( _vertexValues.size(), 0 )
+    , _stamp( 0 )
+  {
+    for( auto&& region : regions )
+      ++_offsets[ region + 1 ];
 
-  SizeType vertexIndex = 0;
+    for( SizeType i = 1; i < _offsets.size(); i++ )
+      _offsets[i] += _offsets[i-1];
 
-  for( auto it = S.begin_dimension(); it != S.end_dimension(); ++it )
-  {
-    // Vertices
-    if( it->dimension() == 0 )
-    {
-      indices.insert( typename bimap_type::value_type( *it->begin(), vertexIndex++ ) );
+    auto positions = _offsets;
 
-      auto vertex         = boost::add_vertex( adjacencyGraph );
-      vdm[ *it->begin() ] = vertex;
+    for( SizeType i = 0; i < regions.size(); i++ )
+    {
+      auto position          = positions[ regions[i] ]++;
+      _sources[position]     = sources[i];
+      _targets[position]     = targets[i];
+      _edgeValues[position]  = edgeValues[i];
     }
+  }
 
-    // Edges
-    else if( it->dimension() == 1 )
+  /**
+    Checks whether two critical points are connected in the interlevel
+    set between the lower and the upper value, using only edges of the
+    regions of both critical points. An edge belongs to the interlevel
+    set if its value and the values of both of its vertices lie between
+    the lower and the upper value.
+  */
+
+  bool connected( SizeType a, SizeType b, DataType lower, DataType upper )
+  {
+    if( lower > upper )
+      std::swap( lower, upper );
+
+    auto contains = [&lower, &upper] ( DataType x )
     {
-      auto&& edge = *it;
+      return x >= lower && x <= upper;
+    };
+
+    if( a == b || !contains( _vertexValues[a] ) || !contains( _vertexValues[b] ) )
+      return false;
 
-      auto u = *( edge.begin()     );
-      auto v = *( edge.begin() + 1 );
+    ++_stamp;
 
-      // It is possible that the simplicial complex, being a _part_ of
-      // a larger filtration, contains edges for which no vertices are
-      // available.
-      if( S.contains(u) && S.contains(v) )
+    for( auto&& region : { a, b } )
+    {
+      for( SizeType i = _offsets[region]; i < _offsets[region+1]; i++ )
       {
-        boost::add_edge( vdm.at(u),
-                         vdm.at(v),
-                         adjacencyGraph );
+        auto u = _sources[i];
+        auto v = _targets[i];
+
+        if( contains( _edgeValues[i] ) && contains( _vertexValues[u] ) && contains( _vertexValues[v] ) )
+          _parents[ this->find( u ) ] = this->find( v );
       }
     }
+
+    return this->find( a ) == this->find( b );
+  }
+
+private:
+
+  /**
+    Finds the parent of a vertex in the current query. Vertices that have
+    not been encountered by the current query are re-initialized first.
+    All parents that are set during a query refer to vertices that have
+    been encountered, so this is only necessary for the initial vertex.
+  */
+
+  SizeType find( SizeType u )
+  {
+    if( _stamps[u] != _stamp )
+    {
+      _stamps[u]  = _stamp;
+      _parents[u] = u;
+    }
+
+    while( _parents[u] != u )
+    {
+      _parents[u] = _parents[ _parents[u] ];
+      u           = _parents[u];
+    }
+
+    return u;
   }
 
-  return std::make_pair( indices, adjacencyGraph );
-}
+  std::vector<DataType> _vertexValues;
+
+  // Edges, grouped by their region; the edges of region i are stored in
+  // the range [_offsets[i], _offsets[i+1]).
+  std::vector<SizeType> _offsets;
+  std::vector<SizeType> _sources;
+  std::vector<SizeType> _targets;
+  std::vector<DataType> _edgeValues;
+
+  std::vector<SizeType> _parents;
+  std::vector<SizeType> _stamps;
+  SizeType _stamp;
+};
 
 } // namespace detail
 
@@ -92,6 +172,14 @@ std::pair<boost::bimap<typename Simplex::VertexType, SizeType>, AdjacencyGraph>
   to be in filtration order. Currently, only features in dimension
   zero are supported by this functor.
 
+  Whenever two connected components merge, the hierarchy checks whether
+  their youngest critical points are connected in the interlevel set
+  between the older critical point and the merging edge by a path that
+  passes only through the regions of these two critical points. Since
+  every critical point is involved in at most two such checks, the edges
+  of every region are only visited a constant number of times. Hence,
+  the calculation requires almost linear time for any 1-skeleton.
+
   For more information, please refer to the paper
 
     Hierarchies and Ranks for Persistence Pairs
@@ -109,165 +197,115 @@ public:
   using EdgeType          = std::pair<Vertex, Vertex>;
   using Edges             = std::vector<EdgeType>;
 
-private:
-
   /**
-    Helper function for 'tagging' all edges in the simplicial complex
-    with the next critical point. This is a very slow---but simple---
-    way of decomposing the domain.
+    Given a simplicial complex, calculates its 0-dimensional persistent
+    homology and the corresponding extended persistence hierarchy. As a
+    result, this will return a simplex pairing and all the edges of the
+    pairing. Edges refer to indices in the original simplicial complex.
   */
 
-  std::map<Simplex, Vertex> tagEdges( const SimplicialComplex& S )
+  std::pair<SimplexPairing, Edges> operator()( const SimplicialComplex& simplicialComplex )
   {
-    std::set<Vertex> vertices;
-    S.vertices( std::inserter( vertices, vertices.begin() ) );
-
-    std::map<Vertex, Vertex>  criticalPointMapVertices;  // critical point map kept along with Union--Find structure
-    std::map<Simplex, Vertex> criticalPointMapSimplices; // critical point map on edge (simplex) basis (return value)
+    using namespace detail;
 
-    for( auto&& vertex : vertices )
-      criticalPointMapVertices[vertex] = vertex;
+    using DataType = typename Simplex::DataType;
 
-    for( auto&& simplex : S )
-    {
-      if( simplex.dimension() != 1 )
-        continue;
+    // Vertices and edges ----------------------------------------------
+    //
+    // Indices refer to the filtration of all {0,1}-simplices of the
+    // complex; higher-dimensional simplices are ignored.
 
-      Vertex u = *( simplex.begin() );
-      Vertex v = *( simplex.begin() + 1 );
+    std::unordered_map<Vertex, SizeType> ids;
+    std::vector<Vertex> vertices;
+    std::vector<SizeType> vertexIndices;     // index of every vertex in the filtration
+    std::vector<DataType> vertexValues;
 
-      auto youngerComponent = u;
-      auto olderComponent   = v;
+    {
+      SizeType index = 0;
 
-      if( youngerComponent != olderComponent )
+      for( auto&& simplex : simplicialComplex )
       {
-        auto index1 = S.index( Simplex(youngerComponent) );
-        auto index2 = S.index( Simplex(olderComponent)   );
-
-        if( index1 < index2 )
-          std::swap( youngerComponent, olderComponent );
+        if( simplex.dimension() > 1 )
+          continue;
 
-        Simplex creator = *( S.find( Simplex( youngerComponent ) ) );
+        if( simplex.dimension() == 0 )
+        {
+          ids[ *simplex.begin() ] = vertices.size();
+          vertices.push_back( *simplex.begin() );
+          vertexIndices.push_back( index );
+          vertexValues.push_back( simplex.data() );
+        }
 
-        if( creator.data() == simplex.data() )
-          criticalPointMapVertices[ youngerComponent ] = criticalPointMapVertices[ olderComponent ];
+        ++index;
       }
-
-      criticalPointMapSimplices[ simplex ] = criticalPointMapVertices[ olderComponent ];
     }
 
-    return criticalPointMapSimplices;
-  }
-
-  /**
-    Calculates the interlevel set of a given simplicial complex. This
-    means extracting a subset in which the assigned weight of  _each_
-    simplex lies between the upper and lower value.
-
-    The function will return the interlevel set as a simplicial complex,
-    as well as a Union--Find data structure for connectivity queries.
-  */
-
-  std::pair< SimplicialComplex, topology::UnionFind<Vertex> >
-    makeInterlevelSet( typename Simplex::DataType lower, typename Simplex::DataType upper,
-                       const SimplicialComplex& S )
-  {
-    if( lower > upper )
-      std::swap( lower, upper );
-
-    std::vector<Simplex> simplices;
-
-    std::copy_if( S.begin(), S.end(),
-                  std::back_inserter( simplices ),
-                  [&lower, &upper] ( const Simplex& s )
-                  {
-                    return s.data() >= lower && s.data() <= upper && s.dimension() <= 1;
-                  } );
-
-    SimplicialComplex K = SimplicialComplex( simplices.begin(),
-                                             simplices.end() );
+    std::vector<SizeType> sources;
+    std::vector<SizeType> targets;
+    std::vector<SizeType> edgeIndices;       // index of every edge in the filtration
+    std::vector<DataType> edgeValues;
 
-    // -----------------------------------------------------------------
-    //
-    // Find all 'proper' vertices in the simplicial complex. It is
-    // possible that not all of them exist as 0-simplices, though.
-
-    std::set<Vertex> vertices;
-
-    for( auto&& simplex : simplices )
     {
-      if( simplex.dimension() == 0 )
-        vertices.insert( *simplex.begin() );
-    }
+      SizeType index = 0;
 
-    // Traversal -------------------------------------------------------
-
-    topology::UnionFind<Vertex> uf( vertices.begin(), vertices.end()  );
-
-    for( auto&& simplex : K )
-    {
-      if( simplex.dimension() == 1 )
+      for( auto&& simplex : simplicialComplex )
       {
-        Vertex u = *( simplex.begin() );
-        Vertex v = *( simplex.begin() + 1 );
-
-        if( !uf.contains( u ) || !uf.contains( v ) )
+        if( simplex.dimension() > 1 )
           continue;
 
-        auto youngerComponent = uf.find( u );
-        auto olderComponent   = uf.find( v );
-
-        if( youngerComponent == olderComponent )
-          continue;
+        if( simplex.dimension() == 1 )
+        {
+          auto itU = ids.find( *( simplex.begin() ) );
+          auto itV = ids.find( *( simplex.begin() + 1 ) );
 
-        auto index1 = S.index( Simplex( youngerComponent ) );
-        auto index2 = S.index( Simplex( olderComponent ) );
+          if( itU == ids.end() || itV == ids.end() )
+            throw std::runtime_error( "Edge refers to a vertex that is not part of the simplicial complex" );
 
-        if( index1 < index2 )
-          std::swap( youngerComponent, olderComponent );
+          sources.push_back( itU->second );
+          targets.push_back( itV->second );
+          edgeIndices.push_back( index );
+          edgeValues.push_back( simplex.data() );
+        }
 
-        uf.merge( youngerComponent, olderComponent );
+        ++index;
       }
     }
 
-    return std::make_pair( K, uf );
-  }
+    auto n = vertices.size();
+    auto m = sources.size();
 
-public:
+    // Critical point regions ------------------------------------------
+    //
+    // Every edge is tagged with the next critical point by propagating
+    // critical points along edges whose value coincides with the value
+    // of their younger vertex.
 
-  /**
-    Given a simplicial complex, calculates its 0-dimensional persistent
-    homology and the corresponding extended persistence hierarchy. As a
-    result, this will return a simplex pairing and all the edges of the
-    pairing. Edges refer to indices in the original simplicial complex.
-  */
+    std::vector<SizeType> regions( m );
 
-  std::pair<SimplexPairing, Edges> operator()( const SimplicialComplex& simplicialComplex )
-  {
-    using namespace detail;
+    {
+      std::vector<SizeType> criticalPoints( n );
+      for( SizeType i = 0; i < n; i++ )
+        criticalPoints[i] = i;
 
-    // Extract {0,1}-simplices -----------------------------------------
+      for( SizeType i = 0; i < m; i++ )
+      {
+        auto younger = sources[i];
+        auto older   = targets[i];
 
-    // Note that there is a range predicate for the simplicial complex class
-    // that does essentially the same. However, the predicate is not stable
-    // with respect to the filtration of the simplicial complex. Thus, to
-    // extract the desired simplices, the internal function cannot be used.
+        if( vertexIndices[younger] < vertexIndices[older] )
+          std::swap( younger, older );
 
-    std::vector<Simplex> simplices;
+        if( vertexValues[younger] == edgeValues[i] )
+          criticalPoints[younger] = criticalPoints[older];
 
-    std::copy_if( simplicialComplex.begin(), simplicialComplex.end(),
-                  std::back_inserter( simplices ),
-                  [] ( const Simplex& s ) { return s.dimension() <= 1; } );
+        regions[i] = criticalPoints[older];
+      }
+    }
 
-    SimplicialComplex S = SimplicialComplex( simplices.begin(),
-                                             simplices.end() );
+    InterlevelSetConnectivity<DataType> interlevelSets( vertexValues, sources, targets, edgeValues, regions );
 
     // Persistence calculation -----------------------------------------
 
-    std::set<Vertex> vertices;
-    S.vertices( std::inserter( vertices,
-                               vertices.begin() ) );
-
     Edges edges;
 
     // Pairs indices of critical vertices. This may be used later on to
@@ -275,179 +313,84 @@ public:
     // it does not operate on weights but on indices, which are unique.
     SimplexPairing pairing;
 
-    // This map contains a simple decomposition of the domain in terms
-    // of the 'next' critical point.
-    //
-    // In a proper---and faster---implementation, Morse--Smale complex
-    // calculations could be used.
-    auto edgeToCriticalPoint = tagEdges( S );
-
     // Keeps track of the critical points that are created along with
     // hierarchy. This is the key difference to the regular hierarchy
     // and permits the hierarchy to distinguish data sets even though
     // their persistence diagram coincides.
-    std::map<Vertex, Vertex> vertexToCriticalPoint;
-    for( auto&& vertex : vertices )
-      vertexToCriticalPoint[vertex] = vertex;
+    std::vector<SizeType> vertexToCriticalPoint( n );
+    for( SizeType i = 0; i < n; i++ )
+      vertexToCriticalPoint[i] = i;
 
-    // Required in order to obtain persistence pairs along with the
-    // edges of the persistence hierarchy.
-    topology::UnionFind<Vertex> uf( vertices.begin(), vertices.end() );
+    topology::DenseUnionFind<SizeType> uf( n );
 
-    for( auto&& simplex : S )
+    for( SizeType i = 0; i < m; i++ )
     {
-      // Only edges can destroy a component
-      if( simplex.dimension() != 1 )
-        continue;
-
-      auto u = *( simplex.begin() );
-      auto v = *( simplex.begin() + 1 );
-
-      // ---------------------------------------------------------------
-      //
       // Ensure that the younger component is _always_ the first
       // component. A component is younger if its representative
-      // vertex precedes the other vertex in the filtration.
-      auto youngerComponent = uf.find( u );
-      auto olderComponent   = uf.find( v );
+      // vertex succeeds the other vertex in the filtration.
+      auto youngerComponent = uf.find( sources[i] );
+      auto olderComponent   = uf.find( targets[i] );
 
-      // If the component has already been merged by some other edge, we are
-      // not interested in it any longer.
       if( youngerComponent == olderComponent )
         continue;
 
-      {
-        auto index1 = S.index( Simplex(youngerComponent) );
-        auto index2 = S.index( Simplex(olderComponent)   );
-
-        // The younger component has the _larger_ index as it is born _later_
-        // in the filtration.
-        if( index1 < index2 )
-          std::swap( youngerComponent, olderComponent );
-      }
+      if( vertexIndices[youngerComponent] < vertexIndices[olderComponent] )
+        std::swap( youngerComponent, olderComponent );
 
-      // Prepare information about creators ----------------------------
-      //
-      // Creator simplex for the simplex pairing below. I know that this
-      // simplex must exist in the complex so I don't check for iterator
-      // validity here.
-      auto youngerCreator         = *( S.find( Simplex( youngerComponent ) ) );
-      auto olderCreator           = *( S.find( Simplex( olderComponent ) ) );
-      auto youngerCriticalSimplex = *( S.find( Simplex( vertexToCriticalPoint[youngerComponent] ) ) );
-      auto olderCriticalSimplex   = *( S.find( Simplex( vertexToCriticalPoint[olderComponent]   ) ) );
+      auto youngerCriticalPoint = vertexToCriticalPoint[youngerComponent];
+      auto olderCriticalPoint   = vertexToCriticalPoint[olderComponent];
 
       // Zero-persistence information; assign critical point of the
       // older component directly. This ensures that we are able to
       // obtain a proper decomposition.
-      if( youngerCreator.data() == simplex.data() )
+      if( vertexValues[youngerComponent] == edgeValues[i] )
         vertexToCriticalPoint[youngerComponent] = olderComponent;
       else
       {
-        // Ensures that the oldest, highest/lowest critical simplex is
+        // Ensures that the oldest, highest/lowest critical point is
         // being used to calculate the interlevel set. Else, it may be
         // impossible for a critical point to be reached.
-        if( S.index( youngerCriticalSimplex ) < S.index( olderCriticalSimplex ) )
-          std::swap( youngerCriticalSimplex, olderCriticalSimplex );
-
-        auto clsPair
-          = makeInterlevelSet(
-              olderCriticalSimplex.data(), simplex.data(),
-              S );
-
-        bool inSameComponent
-          =   ( clsPair.second.contains( *olderCriticalSimplex.begin() ) && clsPair.second.contains( *youngerCriticalSimplex.begin() ) )
-           && ( clsPair.second.find( *olderCriticalSimplex.begin() ) == clsPair.second.find( *youngerCriticalSimplex.begin() ) );
-
-        if( inSameComponent )
+        if( vertexIndices[youngerCriticalPoint] < vertexIndices[olderCriticalPoint] )
+          std::swap( youngerCriticalPoint, olderCriticalPoint );
+
+        // Both critical points are adjacent in the interlevel set;
+        // hence, insert younger component as a child of the youngest
+        // critical point.
+        if( interlevelSets.connected( olderCriticalPoint, youngerCriticalPoint,
+                                      vertexValues[olderCriticalPoint], edgeValues[i] ) )
         {
-          using V = boost::graph_traits<AdjacencyGraph>::vertex_descriptor;
-
-          boost::bimap<Vertex, SizeType> vim;
-          AdjacencyGraph G;
-
-          std::tie( vim, G )
-            = extractZeroDimensionalAdjacencyGraph( clsPair.first );
-
-          std::vector<V> p( boost::num_vertices( G ) );
-
-          auto u = vim.left.at( *olderCriticalSimplex.begin() );
-          auto v = vim.left.at( *youngerCriticalSimplex.begin() );
-          p[u]   = u;
-
-          boost::breadth_first_search( G,
-                                       boost::vertex( u, G ),
-                                       boost::visitor(
-                                        boost::make_bfs_visitor(
-                                          boost::record_predecessors( &p[0], boost::on_tree_edge() ) ) ) );
-
-          std::set<Vertex> criticalPoints;
-
-          while( true )
-          {
-            auto parent = p.at( v );
-            auto s      = *S.find( Simplex( {vim.right.at(v),vim.right.at(parent)} ) );
-
-            if( parent == v )
-              break;
-
-            v = parent;
-
-            // Find out which critical point the identified edge
-            // belongs to.
-            criticalPoints.insert( edgeToCriticalPoint.at( s ) );
-          }
-
-          // Exactly two critical points (i.e. the ones we were
-          // looking for); hence, insert younger component as a
-          // child of the youngest critical point.
-          if( criticalPoints.size() == 2 )
-          {
-            edges.push_back( std::make_pair(
-              vertexToCriticalPoint[olderComponent],
-              youngerComponent )
-            );
-          }
-
-          // More critical points; connect the critical points
-          // according to the usual persistence hierarchy.
-          else
-          {
-            edges.push_back( std::make_pair(
-              olderComponent,
-              youngerComponent )
-            );
-          }
+          edges.push_back( std::make_pair( vertices[ vertexToCriticalPoint[olderComponent] ], vertices[youngerComponent] ) );
         }
 
-        // Not in the same component; connect the critical points
-        // according to the usual persistence hierarchy.
+        // Connect the critical points according to the usual
+        // persistence hierarchy.
         else
-        {
-          edges.push_back( std::make_pair(
-            olderComponent,
-            youngerComponent )
-          );
-        }
+          edges.push_back( std::make_pair( vertices[olderComponent], vertices[youngerComponent] ) );
 
         // The youngest critical point along the current connected
         // component has been changed.
         vertexToCriticalPoint[olderComponent] = youngerComponent;
       }
 
-      pairing.add( Vertex( S.index( Simplex( youngerCreator ) ) ),
-                   Vertex( S.index( simplex ) ) );
+      pairing.add( Vertex( vertexIndices[youngerComponent] ),
+                   Vertex( edgeIndices[i] ) );
 
-      uf.merge( youngerComponent,
-                olderComponent );
+      uf.merge( youngerComponent, olderComponent );
     }
 
     // Add features of infinite persistence to the pairing -------------
 
-    std::set<Vertex> roots;
-    uf.roots( std::inserter( roots, roots.begin() ) );
+    std::vector<SizeType> roots;
+    uf.roots( std::back_inserter( roots ) );
+
+    std::sort( roots.begin(), roots.end(),
+               [&vertices] ( SizeType u, SizeType v )
+               {
+                 return vertices[u] < vertices[v];
+               } );
 
     for( auto&& root : roots )
-      pairing.add( Vertex( S.index( root ) ) );
+      pairing.add( Vertex( vertexIndices[root] ) );
 
     return std::make_pair( pairing, edges );
   }
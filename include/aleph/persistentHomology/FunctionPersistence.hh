@@ -0,0 +1,244 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_FUNCTION_PERSISTENCE_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_FUNCTION_PERSISTENCE_HH__
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/utilities/Instrumentation.hh>
+#include <aleph/utilities/ParallelSort.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace aleph
+{
+
+namespace detail
+{
+
+/**
+  @class FunctionPersistence
+  @brief Calculates persistence pairs of 1D functions
+
+  Sweeps over the samples of a function in sorted order and tracks the
+  connected components of its sublevel (or superlevel) sets. Since the
+  domain is a path, every sample may only be connected to its immediate
+  neighbours, so no complex needs to be created. All memory is reused
+  between calls, which permits processing many functions with a single
+  instance.
+
+  Ties in function values are resolved by the index of a sample.
+*/
+
+template <class T> class FunctionPersistence
+{
+public:
+  static_assert( std::numeric_limits<T>::has_infinity, "Function values must support infinite values" );
+
+  /**
+    Calculates all persistence pairs of a function and reports them to a
+    functor, which is called with the creation and destruction value of
+    every pair. The destruction value of the essential class is infinite.
+    Pairs of zero persistence are not reported.
+
+    @param values     Function values
+    @param n          Number of function values
+    @param superlevel Flag indicating whether superlevel sets are used
+    @param parallel   Flag indicating whether the sort may use multiple
+                      threads
+    @param functor    Functor for reporting the pairs
+  */
+
+  template <class Functor> void operator()( const T* values, std::size_t n, bool superlevel, bool parallel, Functor&& functor )
+  {
+    if( n == 0 )
+      return;
+
+    _order.resize( n );
+    std::iota( _order.begin(), _order.end(), std::size_t(0) );
+
+    auto precedes = [&values, &superlevel] ( std::size_t i, std::size_t j )
+    {
+      if( superlevel )
+        return values[j] < values[i] || ( !( values[i] < values[j] ) && i < j );
+      else
+        return values[i] < values[j] || ( !( values[j] < values[i] ) && i < j );
+    };
+
+    if( parallel )
+      utilities::parallelSort( _order.begin(), _order.end(), precedes );
+    else
+      std::sort( _order.begin(), _order.end(), precedes );
+
+    // Every root of the Union--Find forest stores the creator of its
+    // component. Samples that have not been visited yet do not have a
+    // parent.
+    auto unvisited = std::numeric_limits<std::size_t>::max();
+
+    _parents.assign( n, unvisited );
+    _creators.resize( n );
+
+    auto find = [this] ( std::size_t i )
+    {
+      while( _parents[i] != i )
+      {
+        _parents[i] = _parents[ _parents[i] ];
+        i           = _parents[i];
+      }
+
+      return i;
+    };
+
+    for( auto&& i : _order )
+    {
+      _parents[i]  = i;
+      _creators[i] = i;
+
+      for( auto j : { i - 1, i + 1 } )
+      {
+        // Underflows are caught by this check as well
+        if( j >= n || _parents[j] == unvisited )
+          continue;
+
+        auto u = find( i );
+        auto v = find( j );
+
+        // The younger component is destroyed by the current sample; its
+        // creator is preceded by the creator of the older component.
+        auto younger = precedes( _creators[u], _creators[v] ) ? v : u;
+        auto older   = younger == u ? v : u;
+
+        auto creation    = values[ _creators[younger] ];
+        auto destruction = values[i];
+
+        if( creation != destruction )
+          functor( creation, destruction );
+
+        _parents[younger] = older;
+      }
+    }
+
+    functor( values[ _order.front() ], std::numeric_limits<T>::infinity() );
+  }
+
+private:
+  std::vector<std::size_t> _order;
+  std::vector<std::size_t> _parents;
+  std::vector<std::size_t> _creators;
+};
+
+} // namespace detail
+
+/**
+  Calculates the persistence diagram of the sublevel or superlevel sets
+  of a 1D function. This is equivalent to calculating the persistence
+  diagram of a path whose edges are assigned the maximum (minimum) value
+  of their vertices, as created by topology::io::loadFunctions, but it
+  does not require a simplicial complex or a boundary matrix. The sort
+  of the function values uses multiple threads.
+
+  @param values     Function values, i.e. samples of the function
+  @param superlevel Flag indicating whether superlevel sets are used
+
+  @returns Zero-dimensional persistence diagram. Pairs of zero persistence
+  are not reported.
+*/
+
+template <class T> PersistenceDiagram<T> calculateFunctionPersistenceDiagram( const std::vector<T>& values, bool superlevel = false )
+{
+  ALEPH_PHASE( "function_persistence" );
+
+  PersistenceDiagram<T> D;
+
+  detail::FunctionPersistence<T> calculation;
+  calculation( values.data(), values.size(), superlevel, true,
+               [&D] ( T creation, T destruction )
+               {
+                 if( destruction == std::numeric_limits<T>::infinity() )
+                   D.add( creation );
+                 else
+                   D.add( creation, destruction );
+               } );
+
+  return D;
+}
+
+/**
+  Calculates the persistence diagrams of many 1D functions in parallel.
+  Functions are stored consecutively in a flat buffer, and so are their
+  persistence diagrams. This avoids creating any objects per function.
+
+  @param values       Function values of all functions
+  @param offsets      Offsets of all functions in the function values,
+                      followed by the total number of function values
+  @param points       Output parameter for the points of all persistence
+                      diagrams, stored as pairs of creation and destruction
+                      values; essential classes have an infinite
+                      destruction value.
+  @param pointOffsets Output parameter for the offsets of all persistence
+                      diagrams in the points, counted in points, followed
+                      by the total number of points
+  @param superlevel   Flag indicating whether superlevel sets are used
+
+  @throws std::runtime_error if the offsets are inconsistent
+*/
+
+template <class T> void calculateFunctionPersistenceDiagrams( const std::vector<T>& values,
+                                                              const std::vector<std::size_t>& offsets,
+                                                              std::vector<T>& points,
+                                                              std::vector<std::size_t>& pointOffsets,
+                                                              bool superlevel = false )
+{
+  ALEPH_PHASE( "function_persistence" );
+
+  if( offsets.empty() || offsets.front() != 0 || offsets.back() != values.size() || !std::is_sorted( offsets.begin(), offsets.end() ) )
+    throw std::runtime_error( "Offsets do not match function values" );
+
+  auto numFunctions = offsets.size() - 1;
+
+  // The number of pairs of a function is only known after calculating
+  // them, so every function stores its pairs separately until they can
+  // be copied into the output buffer.
+  std::vector< std::vector<T> > diagrams( numFunctions );
+
+  #pragma omp parallel
+  {
+    detail::FunctionPersistence<T> calculation;
+
+    #pragma omp for schedule(dynamic, 16)
+    for( std::size_t i = 0; i < numFunctions; i++ )
+    {
+      auto&& diagram = diagrams[i];
+
+      calculation( values.data() + offsets[i], offsets[i+1] - offsets[i], superlevel, false,
+                   [&diagram] ( T creation, T destruction )
+                   {
+                     diagram.push_back( creation );
+                     diagram.push_back( destruction );
+                   } );
+    }
+  }
+
+  pointOffsets.assign( numFunctions + 1, 0 );
+
+  for( std::size_t i = 0; i < numFunctions; i++ )
+    pointOffsets[i+1] = pointOffsets[i] + diagrams[i].size() / 2;
+
+  points.resize( 2 * pointOffsets.back() );
+
+  #pragma omp parallel for schedule(dynamic, 16)
+  for( std::size_t i = 0; i < numFunctions; i++ )
+  {
+    std::copy( diagrams[i].begin(), diagrams[i].end(), points.begin() + static_cast<std::ptrdiff_t>( 2 * pointOffsets[i] ) );
+
+    // Release memory as early as possible
+    std::vector<T>().swap( diagrams[i] );
+  }
+}
+
+} // namespace aleph
+
+#endif
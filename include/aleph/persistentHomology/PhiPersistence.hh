@@ -1,16 +1,26 @@
 #ifndef ALEPH_PERSISTENT_HOMOLOGY_PHI_PERSISTENCE_HH__
 #define ALEPH_PERSISTENT_HOMOLOGY_PHI_PERSISTENCE_HH__
 
+#include <aleph/config/Defaults.hh>
+
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 
 #include <aleph/persistentHomology/Calculation.hh>
 
+#include <aleph/topology/BoundaryMatrix.hh>
 #include <aleph/topology/Conversions.hh>
 #include <aleph/topology/Intersections.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/utilities/Instrumentation.hh>
+
+#include <algorithm>
+#include <cstddef>
 #include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <numeric>
 #include <ostream>
 #include <stdexcept>
 #include <utility>
@@ -135,83 +145,324 @@ std::ostream& operator<<( std::ostream& o, const Perversity p )
   return o;
 }
 
-template <class Simplex> auto calculateIntersectionHomology( const aleph::topology::SimplicialComplex<Simplex>& K,
-                                                             const std::vector< aleph::topology::SimplicialComplex<Simplex> >& X,
-                                                             const Perversity& p ) -> std::vector< PersistenceDiagram<typename Simplex::DataType> >
+/**
+  @class PersistentIntersectionHomology
+  @brief Persistent intersection homology of a fixed stratification
+
+  Calculates persistent intersection homology of a simplicial complex
+  and its strata for multiple perversities. Everything that does not
+  depend on the perversity is calculated only once, namely the facets
+  of every simplex and, for every stratum, the dimension of the largest
+  face of every simplex that is contained in the stratum. Deciding the
+  allowability of a simplex thus only requires a single look-up for
+  every stratum.
+
+  Allowable simplices precede all other simplices in the boundary
+  matrix. This is only stored as a permutation of the indices of the
+  original complex, so no copies of the complex are required.
+
+  The results are the same as the ones of calculateIntersectionHomology(),
+  but multiple perversities are handled in parallel.
+*/
+
+template <
+  class Simplex,
+  class ReductionAlgorithm = defaults::ReductionAlgorithm,
+  class Representation     = defaults::Representation
+> class PersistentIntersectionHomology
 {
-  // 0. Check consistency of strata
-  // 1. Create allowability function based on the dimensionality of the
-  //    intersection of simplices with individual strata.
-  // 2. Calculate $phi$-persistence
-  // 3. Convert the result into a persistence diagram.
+public:
+  using DataType           = typename Simplex::DataType;
+  using Index              = typename Representation::Index;
+  using SimplicialComplex  = topology::SimplicialComplex<Simplex>;
+  using PersistenceDiagram = aleph::PersistenceDiagram<DataType>;
+
+  /**
+    Extracts the structure of a simplicial complex and determines its
+    intersections with all strata.
 
-  // Check consistency of filtration -----------------------------------
-  //
-  // The maximum dimension of each complex in the filtration has to
-  // match the dimension of the simplicial complex.
+    @param K Simplicial complex, sorted according to its filtration
+    @param X Strata, i.e. the filtration of the complex by skeletons; the
+             dimension of the last stratum has to match the dimension of
+             the complex
 
+    @throws std::runtime_error if the strata are inconsistent, if the
+    complex is not closed under taking faces, or if it is too large for
+    the index type of the representation
+  */
+
+  PersistentIntersectionHomology( const SimplicialComplex& K,
+                                  const std::vector<SimplicialComplex>& X )
+    : _dimension( K.dimension() )
   {
-    std::size_t minDimension = K.dimension();
-    std::size_t maxDimension = 0;
+    ALEPH_PHASE( "intersection_homology/structure" );
+
+    // Check consistency of filtration ---------------------------------
+    //
+    // The maximum dimension of each complex in the filtration has to
+    // match the dimension of the simplicial complex.
 
-    for( auto&& x : X )
     {
-      if( !K.empty() )
+      std::size_t maxDimension = 0;
+
+      for( auto&& x : X )
       {
-        minDimension = std::min( minDimension, x.dimension() );
-        maxDimension = std::max( maxDimension, x.dimension() );
+        if( !K.empty() )
+          maxDimension = std::max( maxDimension, x.dimension() );
       }
+
+      if( maxDimension != K.dimension() )
+        throw std::runtime_error( "Invalid filtration" );
+
+      if( !K.empty() && X.size() < _dimension )
+        throw std::runtime_error( "Number of strata does not match dimension" );
     }
 
-    if( maxDimension != K.dimension() )
-      throw std::runtime_error( "Invalid filtration" );
-  }
+    auto n = K.size();
 
-  // Check whether simplex is allowable --------------------------------
+    if( n >= static_cast<std::size_t>( std::numeric_limits<Index>::max() ) )
+      throw std::runtime_error( "Simplicial complex is too large for index type" );
 
-  std::map<Simplex, bool> phi;
+    // Structure -------------------------------------------------------
 
-  {
-    auto d = K.dimension();
+    _dimensions.reserve( n );
+    _data.reserve( n );
+    _facetOffsets.reserve( n + 1 );
+    _facetOffsets.push_back( 0 );
 
     for( auto&& s : K )
     {
-      bool admissible = true;
+      _dimensions.push_back( s.dimension() );
+      _data.push_back( s.data() );
+
+      for( auto it = s.begin_boundary(); it != s.end_boundary(); ++it )
+        _facetIndices.push_back( static_cast<Index>( K.index( *it ) ) );
+
+      _facetOffsets.push_back( _facetIndices.size() );
+    }
+
+    // Intersections ---------------------------------------------------
+    //
+    // The largest face of a simplex that is contained in a stratum is
+    // either the simplex itself or the largest face of one of its facets,
+    // so it is calculated in the order of dimensions. Only the strata
+    // that are required for the allowability of simplices are stored.
+
+    std::vector<std::size_t> order( n );
+    std::iota( order.begin(), order.end(), std::size_t(0) );
+
+    std::stable_sort( order.begin(), order.end(),
+                      [this] ( std::size_t i, std::size_t j )
+                      {
+                        return _dimensions[i] < _dimensions[j];
+                      } );
+
+    _intersections.resize( _dimension, std::vector<int>( n, -1 ) );
+
+    #pragma omp parallel for if( _dimension > 1 )
+    for( std::size_t k = 0; k < _dimension; k++ )
+    {
+      auto&& intersections = _intersections[k];
 
-      for( std::size_t k = 1; k <= d; k++ )
+      std::vector<bool> contained( n );
+
+      for( auto&& s : X[k] )
       {
-        // The notation follows Bendich and Harer, so $i$ is actually
-        // referring to a dimension instead of an index. Beware!
-        auto i            = s.dimension();
-        auto intersection = aleph::topology::lastLexicographicalIntersection( X.at( d - k ), s );
-        auto dimension    = intersection.empty() ? -1 : static_cast<long>( intersection.dimension() );
-        admissible        = admissible && intersection.empty() ? true : static_cast<long>( dimension ) <= ( long(i) - long(k) + long( p(k) ) );
+        auto it = K.find( s );
+
+        if( it != K.end() )
+          contained[ static_cast<std::size_t>( std::distance( K.begin(), it ) ) ] = true;
       }
 
-      phi[s] = admissible;
+      for( auto&& i : order )
+      {
+        if( contained[i] )
+          intersections[i] = static_cast<int>( _dimensions[i] );
+        else
+        {
+          for( auto j = _facetOffsets[i]; j < _facetOffsets[i+1]; j++ )
+            intersections[i] = std::max( intersections[i], intersections[ static_cast<std::size_t>( _facetIndices[j] ) ] );
+        }
+      }
     }
   }
 
-  // Partition according to allowable simplices ------------------------
+  /**
+    Calculates persistent intersection homology for a single perversity.
+
+    @returns Persistence diagrams, sorted by dimension
+  */
+
+  std::vector<PersistenceDiagram> operator()( const Perversity& p ) const
+  {
+    ALEPH_PHASE( "intersection_homology" );
 
-  aleph::topology::SimplicialComplex<Simplex> L;
-  std::size_t s = 0;
+    return this->calculate( p );
+  }
 
-  std::tie( L, s ) =
-    aleph::partition( K, [&phi] ( const Simplex& s )
-                         {
-                           return phi.at(s);
-                         } );
+  /**
+    Calculates persistent intersection homology for multiple perversities
+    in parallel.
 
-  // Calculate persistent intersection homology ------------------------
+    @returns Persistence diagrams of every perversity, sorted by dimension
+  */
+
+  std::vector< std::vector<PersistenceDiagram> > operator()( const std::vector<Perversity>& perversities ) const
+  {
+    ALEPH_PHASE( "intersection_homology" );
 
-  auto boundaryMatrix             = aleph::topology::makeBoundaryMatrix( L, s );
-  using IndexType                 = typename decltype(boundaryMatrix)::Index;
-  bool includeAllUnpairedCreators = true;
-  auto pairing                    = aleph::calculatePersistencePairing( boundaryMatrix, includeAllUnpairedCreators, static_cast<IndexType>(s) );
-  auto persistenceDiagrams        = aleph::makePersistenceDiagrams( pairing, L );
+    std::vector< std::vector<PersistenceDiagram> > result( perversities.size() );
 
-  return persistenceDiagrams;
+    #pragma omp parallel for schedule(dynamic, 1)
+    for( std::size_t i = 0; i < perversities.size(); i++ )
+      result[i] = this->calculate( perversities[i] );
+
+    return result;
+  }
+
+  /**
+    Checks whether a simplex is allowable with respect to a perversity.
+
+    @param i Index of the simplex in the original complex
+    @param p Perversity
+  */
+
+  bool allowable( std::size_t i, const Perversity& p ) const
+  {
+    bool admissible = true;
+
+    for( std::size_t k = 1; k <= _dimension; k++ )
+    {
+      // The notation follows Bendich and Harer, so $d$ is actually
+      // referring to a dimension instead of an index. Beware!
+      auto d         = static_cast<long>( _dimensions[i] );
+      auto dimension = static_cast<long>( _intersections[ _dimension - k ][i] );
+      admissible     = admissible && dimension < 0 ? true : dimension <= ( d - long(k) + long( p(k) ) );
+    }
+
+    return admissible;
+  }
+
+private:
+
+  std::vector<PersistenceDiagram> calculate( const Perversity& p ) const
+  {
+    using namespace topology;
+
+    auto n = _dimensions.size();
+
+    // Partition according to allowable simplices ----------------------
+
+    std::vector<bool> allowable( n );
+
+    for( std::size_t i = 0; i < n; i++ )
+      allowable[i] = this->allowable( i, p );
+
+    std::vector<std::size_t> order;
+    order.reserve( n );
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      if( allowable[i] )
+        order.push_back( i );
+    }
+
+    auto s = order.size();
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      if( !allowable[i] )
+        order.push_back( i );
+    }
+
+    std::vector<Index> ranks( n );
+
+    for( std::size_t j = 0; j < n; j++ )
+      ranks[ order[j] ] = Index( j );
+
+    // Boundary matrix -------------------------------------------------
+    //
+    // Only the allowable simplices are stored; if there are none, the
+    // matrix contains all simplices.
+
+    BoundaryMatrix<Representation> M;
+    M.setNumColumns( Index( n ) );
+
+    std::vector<Index> column;
+
+    for( std::size_t j = 0; j < ( s ? s : n ); j++ )
+    {
+      auto i = order[j];
+
+      column.clear();
+
+      for( auto k = _facetOffsets[i]; k < _facetOffsets[i+1]; k++ )
+        column.push_back( ranks[ static_cast<std::size_t>( _facetIndices[k] ) ] );
+
+      M.setColumn( Index( j ), column.begin(), column.end() );
+    }
+
+    // Persistence diagrams --------------------------------------------
+
+    bool includeAllUnpairedCreators = true;
+    auto pairing                    = calculatePersistencePairing<ReductionAlgorithm>( M, includeAllUnpairedCreators, Index( s ) );
+
+    std::map<std::size_t, PersistenceDiagram> diagrams;
+
+    for( auto&& pair : pairing )
+    {
+      auto i = order[ static_cast<std::size_t>( pair.first ) ];
+      auto j = static_cast<std::size_t>( pair.second );
+
+      auto&& D = diagrams[ _dimensions[i] ];
+
+      if( j < n )
+        D.add( _data[i], _data[ order[j] ] );
+      else
+        D.add( _data[i] );
+    }
+
+    std::vector<PersistenceDiagram> result;
+    result.reserve( diagrams.size() );
+
+    for( auto&& pair : diagrams )
+    {
+      pair.second.setDimension( pair.first );
+      result.push_back( pair.second );
+    }
+
+    return result;
+  }
+
+  // Dimension of the simplicial complex
+  std::size_t _dimension;
+
+  // Dimension and data of every simplex
+  std::vector<std::size_t> _dimensions;
+  std::vector<DataType> _data;
+
+  // Facets of every simplex, stored as indices of the complex
+  std::vector<std::size_t> _facetOffsets;
+  std::vector<Index> _facetIndices;
+
+  // Dimension of the largest face of every simplex that is contained in
+  // a stratum, or -1 if the intersection is empty
+  std::vector< std::vector<int> > _intersections;
+};
+
+/**
+  Calculates persistent intersection homology of a simplicial complex
+  with respect to a stratification and a perversity. For sweeping over
+  multiple perversities, PersistentIntersectionHomology should be used
+  directly.
+*/
+
+template <class Simplex> auto calculateIntersectionHomology( const aleph::topology::SimplicialComplex<Simplex>& K,
+                                                             const std::vector< aleph::topology::SimplicialComplex<Simplex> >& X,
+                                                             const Perversity& p ) -> std::vector< PersistenceDiagram<typename Simplex::DataType> >
+{
+  PersistentIntersectionHomology<Simplex> intersectionHomology( K, X );
+  return intersectionHomology( p );
 }
 
 } // namespace aleph
@@ -0,0 +1,431 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_REDUCTION_CONTROL_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_REDUCTION_CONTROL_HH__
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace aleph
+{
+
+namespace persistentHomology
+{
+
+/**
+  Statistics of the reduction of all columns of a boundary matrix that
+  have the same dimension. Dimensions refer to the matrix, so they are
+  reversed for dualized matrices.
+*/
+
+struct ReductionStatistics
+{
+  std::size_t columns         = 0; ///< Columns that have been reduced
+  std::size_t skippedColumns  = 0; ///< Columns skipped because of a dimension or budget limit
+  std::size_t deferredColumns = 0; ///< Columns skipped because of the persistence threshold
+  std::size_t columnAdditions = 0; ///< Column additions performed during the reduction
+  std::size_t pairs           = 0; ///< Reduced columns that are non-zero, i.e. destroyers
+  std::size_t entriesBefore   = 0; ///< Non-zero entries prior to the reduction
+  std::size_t entriesAfter    = 0; ///< Non-zero entries after the reduction
+  std::size_t longestColumn   = 0; ///< Number of entries of the longest column afterwards
+  double seconds              = 0.0;
+
+  /** @returns Number of entries created by the reduction; may be negative */
+  long fillIn() const
+  {
+    return static_cast<long>( entriesAfter ) - static_cast<long>( entriesBefore );
+  }
+};
+
+/**
+  @class NoReductionControl
+  @brief Control object that lets a reduction algorithm process every column
+
+  This is the default control object of all reduction algorithms. Its
+  functions are trivial, so the compiler removes them altogether.
+*/
+
+class NoReductionControl
+{
+public:
+  template <class Matrix> void begin( const Matrix& ) {}
+  template <class Matrix> void end( const Matrix& )   {}
+
+  template <class Matrix, class Index> bool skip( const Matrix&, Index )  { return false; }
+  template <class Matrix, class Index> bool defer( const Matrix&, Index ) { return false; }
+
+  template <class Matrix, class Index> bool requiresDeferred( const Matrix&, Index, Index ) { return false; }
+  template <class Matrix, class Index> std::vector<Index> takeDeferred( const Matrix&, Index ) { return {}; }
+
+  template <class Matrix, class Index> void added( const Matrix&, Index )          {}
+  template <class Matrix, class Index> void reduced( const Matrix&, Index, bool ) {}
+
+  // Queries used when reading off a pairing ---------------------------
+
+  template <class Index> bool isReduced( Index ) const { return true; }
+
+  template <class Matrix, class Index> bool acceptPair( const Matrix&, Index, Index ) const { return true; }
+  template <class Matrix, class Index> bool acceptCreator( const Matrix&, Index ) const     { return true; }
+};
+
+/**
+  @class ReductionControl
+  @brief Bounds the work of a reduction algorithm and reports statistics
+
+  A control object is passed to the reduction algorithm, which consults
+  it before reducing a column and informs it about every column addition.
+  This permits the following limits:
+
+  - A maximum dimension: only the columns that are required to obtain
+    the homology up to this dimension are reduced.
+
+  - A time or an operation budget: once the budget is exhausted, all
+    remaining columns are skipped. Budgets are checked between columns,
+    so a reduction may exceed them by the work required for one column.
+
+  - A persistence threshold: columns whose filtration values are close
+    enough to the smallest value of the preceding dimension to rule out
+    pairs above the threshold are deferred. A deferred column is reduced
+    only once another column reaches a row that the deferred column may
+    claim, so every pair above the threshold remains correct. This needs
+    function values that are sorted in filtration order.
+
+  Skipped and deferred columns remain unreduced, so pairs that involve
+  them are missing. Reading off a pairing with the same control object,
+  via `calculatePersistencePairing()`, takes this into account: it only
+  reports pairs above the threshold and classes up to the maximum
+  dimension. If columns remain deferred, it cannot decide whether some
+  classes are essential, i.e. the ones created by a deferred column or
+  by a row that a deferred column may claim. Such classes are omitted;
+  all other classes are reported correctly. The statistics show whether
+  this happened.
+
+  Statistics are collected for every dimension of the matrix and reset
+  whenever the control object is used for another reduction.
+*/
+
+class ReductionControl
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // Limits ------------------------------------------------------------
+
+  /**
+    Restricts the reduction to the columns required for calculating the
+    homology up to and including the given dimension.
+  */
+
+  void setMaximumDimension( std::size_t dimension )
+  {
+    _maximumDimension = dimension;
+  }
+
+  /** Stops the reduction after the given number of seconds */
+  void setTimeLimit( double seconds )
+  {
+    if( seconds < 0.0 )
+      throw std::runtime_error( "Time limit must be non-negative" );
+
+    _timeLimit = seconds;
+  }
+
+  /** Stops the reduction after the given number of column additions */
+  void setOperationLimit( std::size_t columnAdditions )
+  {
+    _operationLimit = columnAdditions;
+  }
+
+  /**
+    Sets a persistence threshold for the reduction. Pairs whose
+    persistence does not exceed the threshold are not reported.
+
+    @param threshold Persistence threshold
+    @param values    Function values of the simplices in filtration
+                     order, i.e. the order of the non-dualized matrix
+  */
+
+  template <class T> void setPersistenceThreshold( T threshold, const std::vector<T>& values )
+  {
+    if( threshold < T() )
+      throw std::runtime_error( "Persistence threshold must be non-negative" );
+
+    _threshold = static_cast<double>( threshold );
+    _values.assign( values.begin(), values.end() );
+  }
+
+  std::size_t maximumDimension() const noexcept { return _maximumDimension; }
+  double timeLimit() const noexcept             { return _timeLimit; }
+  std::size_t operationLimit() const noexcept   { return _operationLimit; }
+  double persistenceThreshold() const noexcept  { return _threshold; }
+
+  // Results -----------------------------------------------------------
+
+  /** @returns Statistics of the last reduction, indexed by dimension */
+  const std::vector<ReductionStatistics>& statistics() const noexcept
+  {
+    return _statistics;
+  }
+
+  /** @returns Statistics of the last reduction, summed over all dimensions */
+  ReductionStatistics total() const
+  {
+    ReductionStatistics result;
+
+    for( auto&& s : _statistics )
+    {
+      result.columns         += s.columns;
+      result.skippedColumns  += s.skippedColumns;
+      result.deferredColumns += s.deferredColumns;
+      result.columnAdditions += s.columnAdditions;
+      result.pairs           += s.pairs;
+      result.entriesBefore   += s.entriesBefore;
+      result.entriesAfter    += s.entriesAfter;
+      result.longestColumn    = std::max( result.longestColumn, s.longestColumn );
+      result.seconds         += s.seconds;
+    }
+
+    return result;
+  }
+
+  /** @returns true if the time or the operation budget has been exhausted */
+  bool exhausted() const noexcept
+  {
+    return _exhausted;
+  }
+
+  // Interface for reduction algorithms --------------------------------
+
+  template <class Matrix> void begin( const Matrix& M )
+  {
+    using Index = typename Matrix::Index;
+
+    auto n = static_cast<std::size_t>( M.getNumColumns() );
+
+    if( !_values.empty() && _values.size() != n )
+      throw std::runtime_error( "Number of function values does not match number of columns" );
+
+    _statistics.assign( static_cast<std::size_t>( M.getDimension() ) + 1, ReductionStatistics() );
+    _deferred.assign( _statistics.size(), std::vector<std::size_t>() );
+    _unreduced.assign( n, false );
+    _exhausted  = false;
+    _operations = 0;
+
+    for( std::size_t j = 0; j < n; j++ )
+      _statistics[ dimension( M, j ) ].entriesBefore += M.getColumn( Index( j ) ).size();
+
+    // Keys increase with the index of a column, such that the persistence
+    // of a pair is the difference of the keys of its column and its row;
+    // dualization reverses the order of the function values.
+    if( !_values.empty() )
+    {
+      _keys.resize( n );
+      _cutoffs.assign( _statistics.size(), std::numeric_limits<double>::infinity() );
+
+      for( std::size_t j = 0; j < n; j++ )
+      {
+        _keys[j] = M.isDualized() ? -_values[n - 1 - j] : _values[j];
+
+        auto&& cutoff = _cutoffs[ dimension( M, j ) ];
+        cutoff        = std::min( cutoff, _keys[j] + _threshold );
+      }
+    }
+
+    _start = Clock::now();
+    _last  = _start;
+  }
+
+  template <class Matrix> void end( const Matrix& M )
+  {
+    using Index = typename Matrix::Index;
+
+    for( auto&& columns : _deferred )
+    {
+      for( auto&& j : columns )
+        ++_statistics[ dimension( M, j ) ].deferredColumns;
+    }
+
+    for( std::size_t j = 0; j < _unreduced.size(); j++ )
+    {
+      auto size = M.getColumn( Index( j ) ).size();
+      auto&& s  = _statistics[ dimension( M, j ) ];
+
+      s.entriesAfter  += size;
+      s.longestColumn  = std::max( s.longestColumn, size );
+    }
+  }
+
+  /**
+    Checks whether a column is to be skipped because of the dimension or
+    the budget limits. This is called once per column, before any other
+    function.
+  */
+
+  template <class Matrix, class Index> bool skip( const Matrix& M, Index column )
+  {
+    auto j = static_cast<std::size_t>( column );
+    _last  = Clock::now();
+
+    if( !_exhausted )
+    {
+      _exhausted =    _operations >= _operationLimit
+                   || std::chrono::duration<double>( _last - _start ).count() >= _timeLimit;
+    }
+
+    if( _exhausted || homologyDimension( M, j ) > _maximumDimension )
+    {
+      _unreduced[j] = true;
+      ++_statistics[ dimension( M, j ) ].skippedColumns;
+      return true;
+    }
+
+    return false;
+  }
+
+  /** Checks whether a column may be deferred because of the persistence threshold */
+  template <class Matrix, class Index> bool defer( const Matrix& M, Index column )
+  {
+    auto j = static_cast<std::size_t>( column );
+    auto d = dimension( M, j );
+
+    if( _values.empty() || d == 0 || _keys[j] > _cutoffs[d - 1] )
+      return false;
+
+    _unreduced[j] = true;
+    _deferred[d].push_back( j );
+    return true;
+  }
+
+  /**
+    Checks whether the current pivot of a column may be claimed by one of
+    the deferred columns, which then need to be reduced first.
+  */
+
+  template <class Matrix, class Index> bool requiresDeferred( const Matrix& M, Index column, Index row ) const
+  {
+    auto d = dimension( M, static_cast<std::size_t>( column ) );
+
+    return    !_values.empty()
+           && !_deferred[d].empty()
+           && _keys[ static_cast<std::size_t>( row ) ] <= _cutoffs[d - 1];
+  }
+
+  /** @returns Deferred columns of the dimension of a column, in order */
+  template <class Matrix, class Index> std::vector<Index> takeDeferred( const Matrix& M, Index column )
+  {
+    std::vector<Index> result;
+
+    auto&& deferred = _deferred[ dimension( M, static_cast<std::size_t>( column ) ) ];
+
+    for( auto&& j : deferred )
+    {
+      _unreduced[j] = false;
+      result.push_back( Index( j ) );
+    }
+
+    deferred.clear();
+    return result;
+  }
+
+  template <class Matrix, class Index> void added( const Matrix& M, Index column )
+  {
+    ++_operations;
+    ++_statistics[ dimension( M, static_cast<std::size_t>( column ) ) ].columnAdditions;
+  }
+
+  template <class Matrix, class Index> void reduced( const Matrix& M, Index column, bool paired )
+  {
+    auto now = Clock::now();
+    auto&& s = _statistics[ dimension( M, static_cast<std::size_t>( column ) ) ];
+
+    s.columns += 1;
+    s.pairs   += paired ? 1 : 0;
+    s.seconds += std::chrono::duration<double>( now - _last ).count();
+
+    _last = now;
+  }
+
+  // Queries used when reading off a pairing ---------------------------
+
+  template <class Index> bool isReduced( Index column ) const
+  {
+    return !_unreduced.at( static_cast<std::size_t>( column ) );
+  }
+
+  template <class Matrix, class Index> bool acceptPair( const Matrix&, Index row, Index column ) const
+  {
+    if( _values.empty() )
+      return true;
+
+    return _keys.at( static_cast<std::size_t>( column ) ) - _keys.at( static_cast<std::size_t>( row ) ) > _threshold;
+  }
+
+  template <class Matrix, class Index> bool acceptCreator( const Matrix& M, Index column ) const
+  {
+    auto j = static_cast<std::size_t>( column );
+
+    // An empty column of a non-dualized matrix creates a class of its
+    // own dimension instead of destroying one of the dimension below.
+    auto h = M.isDualized() ? homologyDimension( M, j ) : dimension( M, j );
+    if( h > _maximumDimension )
+      return false;
+
+    // A deferred column of the next dimension may claim this one, so it
+    // is not necessarily unpaired.
+    auto d = dimension( M, j );
+
+    return    _values.empty()
+           || d + 1 >= _deferred.size()
+           || _deferred[d + 1].empty()
+           || _keys[j] > _cutoffs[d];
+  }
+
+private:
+  template <class Matrix> static std::size_t dimension( const Matrix& M, std::size_t j )
+  {
+    return static_cast<std::size_t>( M.getDimension( typename Matrix::Index( j ) ) );
+  }
+
+  /**
+    @returns Dimension of the homology classes destroyed by a column of
+    a non-dualized matrix, or of the classes created by a column of a
+    dualized matrix, respectively. Columns of vertices report zero.
+  */
+
+  template <class Matrix> static std::size_t homologyDimension( const Matrix& M, std::size_t j )
+  {
+    auto d = dimension( M, j );
+
+    if( M.isDualized() )
+      return static_cast<std::size_t>( M.getDimension() ) - d;
+    else
+      return d > 0 ? d - 1 : 0;
+  }
+
+  std::size_t _maximumDimension = std::numeric_limits<std::size_t>::max();
+  double _timeLimit             = std::numeric_limits<double>::infinity();
+  std::size_t _operationLimit   = std::numeric_limits<std::size_t>::max();
+  double _threshold             = 0.0;
+
+  std::vector<double> _values;
+  std::vector<double> _keys;
+  std::vector<double> _cutoffs;
+
+  std::vector<ReductionStatistics> _statistics;
+  std::vector< std::vector<std::size_t> > _deferred;
+  std::vector<bool> _unreduced;
+
+  bool _exhausted          = false;
+  std::size_t _operations  = 0;
+
+  Clock::time_point _start;
+  Clock::time_point _last;
+};
+
+} // namespace persistentHomology
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,589 @@
+#ifndef ALEPH_PERSISTENT_HOMOLOGY_VINEYARD_HH__
+#define ALEPH_PERSISTENT_HOMOLOGY_VINEYARD_HH__
+
+#include <aleph/config/Defaults.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistentHomology/PersistencePairing.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+#include <aleph/topology/Conversions.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/LowerStar.hh>
+
+#include <aleph/utilities/Instrumentation.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+/**
+  @class Vineyard
+  @brief Persistent homology of a time-varying lower-star filtration
+
+  Maintains the decomposition R = DV of the boundary matrix D of
+  a lower-star filtration, where R is reduced and V is upper triangular,
+  following the vineyard algorithm of Cohen-Steiner, Edelsbrunner, and
+  Morozov. When the function on the vertices changes, the filtration is
+  not rebuilt. Instead, the values of all simplices are interpolated
+  linearly between the previous and the new function, and the order of
+  simplices is updated by swapping adjacent simplices whenever their
+  values cross. Every swap only requires updating a constant number of
+  columns of R and V.
+
+  Every persistence pair moves continuously during this interpolation,
+  tracing out a vine. The vines are reported for every update, so that
+  the points of consecutive persistence diagrams can be matched.
+
+  The order of simplices is the same as the one used by the lower-star
+  filtration functor, i.e. ties in function values are broken by the
+  lexicographical order of the simplices.
+*/
+
+template <
+  class Simplex,
+  class Representation = defaults::Representation
+> class Vineyard
+{
+public:
+  using DataType           = typename Simplex::DataType;
+  using Index              = typename Representation::Index;
+  using SimplicialComplex  = topology::SimplicialComplex<Simplex>;
+  using PersistenceDiagram = aleph::PersistenceDiagram<DataType>;
+  using PersistencePairing = aleph::PersistencePairing<Index>;
+  using Point              = typename PersistenceDiagram::Point;
+
+  /** Describes how a persistence pair moved during an update */
+  struct Vine
+  {
+    std::size_t dimension;
+    Point from;
+    Point to;
+  };
+
+  /**
+    Creates the lower-star filtration of a simplicial complex and reduces
+    its boundary matrix.
+
+    @param K      Simplicial complex; the order and data of its simplices
+                  are irrelevant
+    @param values Function values of all vertices, indexed by vertex
+
+    @throws std::runtime_error if a vertex does not have a function value,
+    or if the complex is too large for the index type of the representation
+  */
+
+  Vineyard( const SimplicialComplex& K, const std::vector<DataType>& values )
+  {
+    ALEPH_PHASE( "vineyard" );
+
+    if( K.size() >= static_cast<std::size_t>( std::numeric_limits<Index>::max() ) )
+      throw std::runtime_error( "Simplicial complex is too large for index type" );
+
+    this->checkValues( K.begin(), K.end(), values );
+
+    auto L = K;
+
+    {
+      topology::filtrations::LowerStar<Simplex> functor( values.begin(), values.end() );
+      L.sort( std::ref( functor ) );
+
+      for( auto&& s : L )
+      {
+        _simplices.push_back( s );
+        _values.push_back( functor.maximumValue( s ) );
+      }
+    }
+
+    auto n = _simplices.size();
+
+    // Initially, every simplex is identified by its position in the
+    // filtration. Identifiers do not change upon swapping simplices.
+    _order.resize( n );
+    _position.resize( n );
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      _order[i]    = Index( i );
+      _position[i] = Index( i );
+    }
+
+    _maxDimension = 0;
+
+    for( auto&& s : _simplices )
+      _maxDimension = std::max( _maxDimension, s.dimension() );
+
+    auto M = topology::makeBoundaryMatrix<Representation>( L );
+
+    _R.resize( n );
+    _V.resize( n );
+    _low.assign( n, invalid() );
+    _pivot.assign( n, invalid() );
+    _vines.assign( n, invalid() );
+
+    // Standard reduction that additionally keeps track of V. Since the
+    // identifiers coincide with the positions at this point, all columns
+    // are sorted by position as well.
+    for( std::size_t j = 0; j < n; j++ )
+    {
+      _R[j] = M.getColumn( Index( j ) );
+      _V[j] = { Index( j ) };
+
+      std::sort( _R[j].begin(), _R[j].end() );
+
+      _low[j] = this->low( _R[j] );
+
+      while( _low[j] != invalid() && _pivot[ _low[j] ] != invalid() )
+        this->addColumn( _pivot[ _low[j] ], Index( j ) );
+
+      if( _low[j] != invalid() )
+        _pivot[ _low[j] ] = Index( j );
+    }
+
+    Index numVines = 0;
+
+    for( std::size_t j = 0; j < n; j++ )
+    {
+      if( _R[j].empty() )
+        _vines[j] = numVines++;
+    }
+  }
+
+  /**
+    Updates the function values of all vertices and transforms the
+    filtration into the lower-star filtration of the new values.
+
+    @param values Function values of all vertices, indexed by vertex
+
+    @returns Vines of all persistence pairs, i.e. the point of every pair
+    in the previous persistence diagram, and the corresponding point in
+    the new persistence diagram. As for calculatePersistenceDiagrams(),
+    unpaired simplices of the highest dimension are not reported.
+
+    @throws std::runtime_error if a vertex does not have a function value
+  */
+
+  std::vector<Vine> update( const std::vector<DataType>& values )
+  {
+    ALEPH_PHASE( "vineyard/update" );
+
+    this->checkValues( _simplices.begin(), _simplices.end(), values );
+
+    auto n = _simplices.size();
+
+    std::vector<DataType> targetValues;
+    targetValues.reserve( n );
+
+    {
+      topology::filtrations::LowerStar<Simplex> functor( values.begin(), values.end() );
+
+      for( auto&& s : _simplices )
+        targetValues.push_back( functor.maximumValue( s ) );
+    }
+
+    // Points of all vines before the update, indexed by their identifier
+    std::vector<Point> from( n, Point( DataType() ) );
+
+    for( std::size_t c = 0; c < n; c++ )
+    {
+      if( _vines[c] != invalid() )
+        from[ _vines[c] ] = this->point( Index( c ) );
+    }
+
+    // Order of simplices after the update, as used by the lower-star
+    // filtration functor
+    auto precedes = [this, &targetValues] ( Index s, Index t )
+    {
+      return    targetValues[s] < targetValues[t]
+             || ( targetValues[s] == targetValues[t] && _simplices[s] < _simplices[t] );
+    };
+
+    // Calculates the time at which the interpolated values of two
+    // simplices cross; simplices with the same target value are only
+    // swapped at the end of the interpolation.
+    auto crossing = [this, &targetValues] ( Index s, Index t, double current )
+    {
+      auto d0 = static_cast<double>( _values[t] ) - static_cast<double>( _values[s] );
+      auto d1 = static_cast<double>( targetValues[s] ) - static_cast<double>( targetValues[t] );
+
+      auto time = d0 + d1 > 0.0 ? d0 / ( d0 + d1 ) : 1.0;
+      return std::max( current, std::min( time, 1.0 ) );
+    };
+
+    using Event = std::tuple<double, Index, Index>;
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event> > events;
+
+    auto enqueue = [&] ( std::size_t i, double current )
+    {
+      if( i + 1 >= n )
+        return;
+
+      auto s = _order[i];
+      auto t = _order[i+1];
+
+      if( precedes( t, s ) )
+        events.push( std::make_tuple( crossing( s, t, current ), s, t ) );
+    };
+
+    for( std::size_t i = 0; i + 1 < n; i++ )
+      enqueue( i, 0.0 );
+
+    // Kinetic sort: only pairs of adjacent simplices whose order differs
+    // from the target order are swapped, so faces always precede their
+    // cofaces.
+    while( !events.empty() )
+    {
+      double time;
+      Index s, t;
+
+      std::tie( time, s, t ) = events.top();
+      events.pop();
+
+      // Skip events that are obsolete because one of the simplices has
+      // been swapped with another simplex in the meantime
+      if( _position[s] + 1 != _position[t] )
+        continue;
+
+      auto i = static_cast<std::size_t>( _position[s] );
+
+      this->transpose( i );
+
+      if( i > 0 )
+        enqueue( i - 1, time );
+
+      enqueue( i + 1, time );
+    }
+
+    _values.swap( targetValues );
+
+    std::vector<Vine> vines;
+
+    for( std::size_t c = 0; c < n; c++ )
+    {
+      if( _vines[c] == invalid() || !this->isReported( Index( c ) ) )
+        continue;
+
+      vines.push_back( { _simplices[c].dimension(), from[ _vines[c] ], this->point( Index( c ) ) } );
+    }
+
+    return vines;
+  }
+
+  /**
+    @returns Persistence diagrams of the current filtration, sorted by
+    dimension. As for calculatePersistenceDiagrams(), unpaired simplices
+    of the highest dimension are not reported.
+  */
+
+  std::vector<PersistenceDiagram> diagrams() const
+  {
+    std::map<std::size_t, PersistenceDiagram> diagrams;
+
+    for( auto&& c : _order )
+    {
+      if( !_R[c].empty() || !this->isReported( c ) )
+        continue;
+
+      auto&& D = diagrams[ _simplices[c].dimension() ];
+      auto p   = this->point( c );
+
+      if( _pivot[c] != invalid() )
+        D.add( p.x(), p.y() );
+      else
+        D.add( p.x() );
+    }
+
+    std::vector<PersistenceDiagram> result;
+    result.reserve( diagrams.size() );
+
+    for( auto&& pair : diagrams )
+    {
+      pair.second.setDimension( pair.first );
+      result.push_back( pair.second );
+    }
+
+    return result;
+  }
+
+  /**
+    @returns Persistence pairing of the current filtration, using the
+    positions of simplices in the filtration
+  */
+
+  PersistencePairing pairing() const
+  {
+    PersistencePairing pairing;
+
+    for( auto&& c : _order )
+    {
+      if( !_R[c].empty() || !this->isReported( c ) )
+        continue;
+
+      if( _pivot[c] != invalid() )
+        pairing.add( _position[c], _position[ _pivot[c] ] );
+      else
+        pairing.add( _position[c] );
+    }
+
+    std::sort( pairing.begin(), pairing.end() );
+    return pairing;
+  }
+
+  /** @returns Current filtration, i.e. all simplices and their values */
+  SimplicialComplex filtration() const
+  {
+    std::vector<Simplex> simplices;
+    simplices.reserve( _order.size() );
+
+    for( auto&& c : _order )
+    {
+      simplices.push_back( _simplices[c] );
+      simplices.back().setData( _values[c] );
+    }
+
+    return SimplicialComplex( simplices.begin(), simplices.end() );
+  }
+
+  /** @returns Total number of transpositions of adjacent simplices */
+  std::size_t numTranspositions() const noexcept
+  {
+    return _numTranspositions;
+  }
+
+  /** @returns Total number of transpositions that changed the pairing */
+  std::size_t numSwitches() const noexcept
+  {
+    return _numSwitches;
+  }
+
+private:
+
+  static constexpr Index invalid() noexcept
+  {
+    return std::numeric_limits<Index>::max();
+  }
+
+  template <class InputIterator> static void checkValues( InputIterator begin, InputIterator end, const std::vector<DataType>& values )
+  {
+    for( auto it = begin; it != end; ++it )
+    {
+      for( auto&& v : *it )
+      {
+        if( static_cast<std::size_t>( v ) >= values.size() )
+          throw std::runtime_error( "Vertex does not have a function value" );
+      }
+    }
+  }
+
+  /** @returns Entry of a column with the largest position in the filtration */
+  Index low( const std::vector<Index>& column ) const
+  {
+    auto result = invalid();
+
+    for( auto&& i : column )
+    {
+      if( result == invalid() || _position[i] > _position[result] )
+        result = i;
+    }
+
+    return result;
+  }
+
+  /**
+    Adds a column to another column in R and V. Columns are sorted by
+    identifier, not by position, so they remain valid upon swapping
+    simplices.
+  */
+
+  void addColumn( Index source, Index target )
+  {
+    auto add = [] ( const std::vector<Index>& s, std::vector<Index>& t )
+    {
+      std::vector<Index> result;
+      result.reserve( s.size() + t.size() );
+
+      std::set_symmetric_difference( s.begin(), s.end(),
+                                     t.begin(), t.end(),
+                                     std::back_inserter( result ) );
+
+      t.swap( result );
+    };
+
+    add( _R[source], _R[target] );
+    add( _V[source], _V[target] );
+
+    _low[target] = this->low( _R[target] );
+  }
+
+  static bool contains( const std::vector<Index>& column, Index i )
+  {
+    return std::binary_search( column.begin(), column.end(), i );
+  }
+
+  /** @returns Simplex that is paired with a simplex, if any */
+  Index partner( Index c ) const
+  {
+    return _R[c].empty() ? _pivot[c] : _low[c];
+  }
+
+  /**
+    Checks whether the pair of a simplex is reported in diagrams; only
+    unpaired simplices of the highest dimension are left out.
+  */
+
+  bool isReported( Index c ) const
+  {
+    return _pivot[c] != invalid() || _simplices[c].dimension() != _maxDimension;
+  }
+
+  /** @returns Point of a simplex that creates a persistence pair */
+  Point point( Index c ) const
+  {
+    if( _pivot[c] != invalid() )
+      return Point( _values[c], _values[ _pivot[c] ] );
+    else
+      return Point( _values[c] );
+  }
+
+  /**
+    Swaps the simplices at positions i and i+1 of the filtration and
+    restores the decomposition. Only the columns of the two simplices
+    and the columns of the simplices that destroy them are changed.
+  */
+
+  void transpose( std::size_t i )
+  {
+    ++_numTranspositions;
+
+    auto a = _order[i];
+    auto b = _order[i+1];
+
+    auto swap = [&] ()
+    {
+      std::swap( _order[i], _order[i+1] );
+      _position[a] = Index( i + 1 );
+      _position[b] = Index( i );
+    };
+
+    // Simplices of different dimensions never appear in the same column
+    // of R or V, so the decomposition remains valid.
+    if( _simplices[a].dimension() != _simplices[b].dimension() )
+    {
+      swap();
+      return;
+    }
+
+    auto k = _pivot[a];
+    auto l = _pivot[b];
+
+    // Partners and vines before the swap, which are used to follow the
+    // vines afterwards
+    Index partners[2] = { this->partner( a ), this->partner( b ) };
+    Index vines[2]    = { this->vine( a ), this->vine( b ) };
+
+    Index columns[4] = { a, b, k, l };
+
+    for( auto&& c : columns )
+    {
+      if( c != invalid() && _low[c] != invalid() && _pivot[ _low[c] ] == c )
+        _pivot[ _low[c] ] = invalid();
+    }
+
+    // V would not be upper triangular any more after the swap
+    if( contains( _V[b], a ) )
+      this->addColumn( a, b );
+
+    swap();
+
+    // The columns of the two simplices may have the same lowest entry
+    // now, in which case the simplices exchange their partners, or the
+    // negative simplex becomes positive and vice versa.
+    if( _low[b] != invalid() && _low[b] == _low[a] )
+      this->addColumn( b, a );
+
+    // The lowest entry of the column that destroys b may be a now
+    if( l != invalid() && contains( _R[l], a ) )
+    {
+      if( k != invalid() )
+      {
+        if( _position[k] < _position[l] )
+          this->addColumn( k, l );
+        else
+          this->addColumn( l, k );
+      }
+
+      _low[l] = this->low( _R[l] );
+    }
+
+    for( auto&& c : columns )
+    {
+      if( c != invalid() && _low[c] != invalid() )
+        _pivot[ _low[c] ] = c;
+    }
+
+    // A vine follows the partner of a simplex, because the values of
+    // the two simplices coincide at the time of the swap.
+    if( this->partner( a ) == partners[0] && this->partner( b ) == partners[1] )
+      return;
+
+    ++_numSwitches;
+
+    for( auto&& c : { a, b } )
+    {
+      auto p = this->partner( c );
+      auto j = p == partners[0] ? 0 : p == partners[1] ? 1 : ( c == a ? 0 : 1 );
+
+      if( _R[c].empty() )
+        _vines[c] = vines[j];
+      else
+      {
+        _vines[c] = invalid();
+        _vines[p] = vines[j];
+      }
+    }
+  }
+
+  /** @returns Identifier of the vine of the pair that contains a simplex */
+  Index vine( Index c ) const
+  {
+    return _R[c].empty() ? _vines[c] : _vines[ _low[c] ];
+  }
+
+  // Simplices and their current values, indexed by identifier
+  std::vector<Simplex> _simplices;
+  std::vector<DataType> _values;
+
+  std::vector<Index> _order;    // identifiers in filtration order
+  std::vector<Index> _position; // position of every identifier
+
+  // Columns of R and V, indexed by identifier, whose entries are sorted
+  // by identifier as well
+  std::vector< std::vector<Index> > _R;
+  std::vector< std::vector<Index> > _V;
+
+  std::vector<Index> _low;   // lowest entry of every column of R
+  std::vector<Index> _pivot; // column whose lowest entry is a simplex
+  std::vector<Index> _vines; // vine of every positive simplex
+
+  std::size_t _maxDimension      = 0;
+  std::size_t _numTranspositions = 0;
+  std::size_t _numSwitches       = 0;
+};
+
+} // namespace aleph
+
+#endif
@@ -1,8 +1,13 @@
 #ifndef ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_STANDARD_HH__
 #define ALEPH_PERSISTENT_HOMOLOGY_ALGORITHMS_STANDARD_HH__
 
+#include <aleph/persistentHomology/ReductionControl.hh>
+
 #include <aleph/topology/BoundaryMatrix.hh>
 
+#include <aleph/utilities/Instrumentation.hh>
+
+#include <cstddef>
 #include <tuple>
 #include <vector>
 
@@ -19,29 +24,81 @@ class Standard
 {
 public:
   template <class Representation> void operator()( topology::BoundaryMatrix<Representation>& M )
+  {
+    NoReductionControl control;
+    this->operator()( M, control );
+  }
+
+  /**
+    Reduces a boundary matrix under the supervision of a control object,
+    which may skip or defer columns and collects statistics. Please refer
+    to @ref ReductionControl for more details.
+  */
+
+  template <class Representation, class Control> void operator()( topology::BoundaryMatrix<Representation>& M, Control& control )
   {
     using Index = typename Representation::Index;
 
+    ALEPH_PHASE( "reduction" );
+
     auto numColumns = M.getNumColumns();
 
     std::vector< std::pair<Index, bool> > lut( static_cast<std::size_t>( numColumns ),
                                                std::make_pair(0, false) );
 
+    std::size_t numColumnAdditions = 0;
+
+    control.begin( M );
+
     for( Index j = 0; j < numColumns; j++ )
     {
-      Index i;
-      bool valid = false;
+      if( control.skip( M, j ) || control.defer( M, j ) )
+        continue;
 
-      std::tie( i, valid ) = M.getMaximumIndex( j );
-      while( valid && lut[ static_cast<std::size_t>(i) ].second )
+      reduce( M, j, lut, control, numColumnAdditions );
+    }
+
+    control.end( M );
+
+    ALEPH_COUNT( ColumnAdditions, numColumnAdditions );
+  }
+
+private:
+  template <class Representation, class Control> static void reduce( topology::BoundaryMatrix<Representation>& M,
+                                                                     typename Representation::Index j,
+                                                                     std::vector< std::pair<typename Representation::Index, bool> >& lut,
+                                                                     Control& control,
+                                                                     std::size_t& numColumnAdditions )
+  {
+    using Index = typename Representation::Index;
+
+    Index i;
+    bool valid = false;
+
+    std::tie( i, valid ) = M.getMaximumIndex( j );
+    while( valid )
+    {
+      // Deferred columns may claim the current pivot, so they have to be
+      // reduced before the pivot can be looked up.
+      if( control.requiresDeferred( M, j, i ) )
       {
-        M.addColumns( lut[ static_cast<std::size_t>(i) ].first, j );
-        std::tie( i, valid ) = M.getMaximumIndex( j );
+        for( auto&& k : control.takeDeferred( M, j ) )
+          reduce( M, k, lut, control, numColumnAdditions );
       }
 
-      if( valid )
-        lut[ static_cast<std::size_t>(i) ] = std::make_pair( j, true );
+      if( !lut[ static_cast<std::size_t>(i) ].second )
+        break;
+
+      M.addColumns( lut[ static_cast<std::size_t>(i) ].first, j );
+      control.added( M, j );
+      ++numColumnAdditions;
+      std::tie( i, valid ) = M.getMaximumIndex( j );
     }
+
+    if( valid )
+      lut[ static_cast<std::size_t>(i) ] = std::make_pair( j, true );
+
+    control.reduced( M, j, valid );
   }
 };
 
@@ -3,11 +3,12 @@
 
 #include <aleph/utilities/EmptyFunctor.hh>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
-#include <set>
+#include <limits>
 #include <stdexcept>
-#include <type_traits>
-#include <unordered_map>
 #include <vector>
 
 // Since the data type of the simplex class is allowed to be a boolean
@@ -45,6 +46,13 @@ namespace topology
   auto M = f( f(K) ); // second barycentric subdivision
 
   \endcode
+
+  Every simplex of the subdivision corresponds to a flag, i.e. a chain
+  of faces, of the original complex. Its vertices are the barycentres
+  of the faces in the chain. The number of flags whose largest face is
+  a given simplex only depends on the dimension of the simplex, so the
+  subdivision is written into buffers whose size is known in advance,
+  with every simplex being subdivided in parallel.
 */
 
 class BarycentricSubdivision
@@ -53,7 +61,19 @@ public:
 
   /**
     Performs a barycentric subdivision of the given simplicial complex
-    and returns the result.
+    and returns the result. The vertices of the original complex are
+    kept, while the barycentres of the other simplices are numbered
+    consecutively in the order of their dimension, starting after the
+    largest vertex.
+
+    The functor is used to assign data to new simplices: a simplex is
+    assigned the data of the largest face in its flag, multiplied by
+    the value of the functor for its number of vertices. Barycentres
+    use the value of the functor for zero instead. The functor is only
+    evaluated once for every number of vertices.
+
+    @throws std::runtime_error if a face of a simplex is missing, or if
+    the dimension of the complex is too large for being subdivided
   */
 
   template <class SimplicialComplex, class Functor = aleph::utilities::EmptyFunctor> SimplicialComplex operator()( const SimplicialComplex& K, Functor&& functor = Functor() ) const
@@ -62,171 +82,333 @@ public:
     using VertexType = typename Simplex::VertexType;
     using DataType   = typename Simplex::DataType;
 
-    // Stores the new vertex index of the next barycentre vertex that
-    // is to be added to the subdivided complex. Initially, this uses
-    // the largest vertex index stored in the input data.
-    VertexType barycentreVertex = VertexType();
+    if( K.empty() )
+      return {};
+
+    // Face table ------------------------------------------------------
+    //
+    // Simplices are identified by their position in the order of their
+    // dimension. This order also determines the barycentre vertices.
+
+    std::vector<const Simplex*> simplices;
+    simplices.reserve( K.size() );
+
+    for( auto it = K.begin_dimension(); it != K.end_dimension(); ++it )
+      simplices.push_back( &( *it ) );
+
+    auto n = simplices.size();
+
+    if( simplices.back()->dimension() >= maxDimension )
+      throw std::runtime_error( "Dimension of simplicial complex is too large for subdivision" );
+
+    std::size_t numVertices = 0;
+    VertexType maxVertex    = *simplices.front()->begin();
+
+    for( auto&& s : simplices )
+    {
+      if( s->dimension() != 0 )
+        break;
+
+      maxVertex = std::max( maxVertex, *s->begin() );
+      ++numVertices;
+    }
 
+    auto barycentre = [&] ( std::size_t id )
     {
-      std::set<VertexType> vertices;
-      K.vertices( std::inserter( vertices, vertices.begin() ) );
+      if( id < numVertices )
+        return *simplices[id]->begin();
+      else
+        return static_cast<VertexType>( maxVertex + 1 + ( id - numVertices ) );
+    };
+
+    // Maps the filtration index of every simplex to its identifier
+    std::vector<std::size_t> ids( n );
 
-      if( vertices.empty() )
-        return {};
+    // Offsets of the facets of every simplex; a simplex with k vertices
+    // has k facets
+    std::vector<std::size_t> facetOffsets( n + 1 );
 
-      barycentreVertex = static_cast<VertexType>( *vertices.rbegin() + 1 );
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      auto k              = simplices[i]->size();
+      facetOffsets[i + 1] = facetOffsets[i] + ( k > 1 ? k : 0 );
     }
 
-    // Stores the barycentric subdivision of a given simplex. This map
-    // contains copies of the 0-simplices. For the other simplices, we
-    // store the resulting subdivision as an (unordered) vector.
-    std::unordered_map<Simplex, std::vector<Simplex> > subdivision;
+    std::vector<std::size_t> facets( facetOffsets.back() );
+
+    bool missingFaces = false;
 
-    // Stores the subdivided simplicial complex. Initially, this complex
-    // only contains the new barycentre vertices. Later on, it will also
-    // contain the subdivided skeletons.
-    SimplicialComplex L;
+    #pragma omp parallel for
+    for( std::size_t i = 0; i < n; i++ )
+      ids[ K.index( *simplices[i] ) ] = i;
 
-    for( auto itDimension = K.begin_dimension(); itDimension != K.end_dimension(); ++itDimension )
+    #pragma omp parallel for reduction(||: missingFaces)
+    for( std::size_t i = 0; i < n; i++ )
     {
-      auto&& s = *itDimension;
+      auto&& s = *simplices[i];
 
       if( s.dimension() == 0 )
-        subdivision[s] = { s };
-      else
+        continue;
+
+      auto j = facetOffsets[i];
+
+      for( auto it = s.begin_boundary(); it != s.end_boundary(); ++it )
       {
-        // Copy the data of the old simplex for its barycentric
-        // subdivision. Since the subdivision is a _refinement_
-        // of the original complex, this makes sense.
+        auto itFacet = K.find( *it );
+
+        if( itFacet == K.end() )
         {
-          auto data = s.data() * DataType( functor( 0 ) );
-          L.push_back( Simplex( barycentreVertex, data ) );
+          missingFaces = true;
+          break;
         }
 
-        // Contains all subdivided simplices of the boundary of
-        // the current simplex.
-        std::vector<Simplex> subdividedBoundary;
+        facets[j++] = ids[ static_cast<std::size_t>( std::distance( K.begin(), itFacet ) ) ];
+      }
+    }
 
-        for( auto itBoundary = s.begin_boundary(); itBoundary != s.end_boundary(); ++itBoundary )
-        {
-          auto pos = K.find( *itBoundary );
+    if( missingFaces )
+      throw std::runtime_error( "Unable to find boundary simplex" );
 
-          if( pos == K.end() )
-            throw std::runtime_error( "Unable to find boundary simplex" );
+    // Sizes -----------------------------------------------------------
+    //
+    // The number of flags of a simplex only depends on its number of
+    // vertices and on the length of the flag.
 
-          auto&& t = *pos;
+    std::size_t maxSize = simplices.back()->size();
 
-          subdividedBoundary.insert( subdividedBoundary.end(),
-                                     subdivision.at(t).begin(), subdivision.at(t).end() );
-        }
+    auto flags = countFlags( maxSize );
 
-        // Cone over the new barycentre vertex and the subdivided
-        // boundary of the current simplex. This cone will become
-        // the new subdivision of the current simplex.
-        std::vector<Simplex> cone;
+    // Offsets of the simplices of every length, i.e. of every dimension
+    // of the subdivision, in the order of the original simplices
+    std::vector< std::vector<std::size_t> > offsets( maxSize + 1, std::vector<std::size_t>( n + 1 ) );
 
-        for( auto&& t : subdividedBoundary )
-        {
-          std::vector<VertexType> vertices( t.begin(), t.end() );
-          vertices.push_back( barycentreVertex );
+    for( std::size_t length = 1; length <= maxSize; length++ )
+    {
+      auto&& o = offsets[length];
 
-          // The new cone simplex needs to use the same weight as the
-          // barycentre simplex.
-          cone.emplace_back( Simplex( vertices.begin(), vertices.end(),
-                                      s.data() * DataType( functor( vertices.size() ) ) ) );
-        }
+      for( std::size_t i = 0; i < n; i++ )
+        o[i + 1] = o[i] + flags[ simplices[i]->size() ][length];
+    }
+
+    // Multipliers for the data of all simplices; these are evaluated
+    // only once because the functor is not required to be thread-safe.
+    std::vector<DataType> multipliers( maxSize + 1 );
+
+    multipliers[0] = DataType( functor( 0 ) );
+
+    for( std::size_t length = 2; length <= maxSize; length++ )
+      multipliers[length] = DataType( functor( length ) );
 
-       // Cone boundaries; required in order to ensure consistency of
-       // the resulting simplicial complex.
-        std::vector<Simplex> boundaries
-          = collectBoundaries( subdividedBoundary.begin(), subdividedBoundary.end() );
+    // Subdivision -----------------------------------------------------
 
-        for( auto&& t : boundaries )
+    std::vector< std::vector<VertexType> > vertices( maxSize + 1 );
+    std::vector< std::vector<DataType> > data( maxSize + 1 );
+
+    for( std::size_t length = 1; length <= maxSize; length++ )
+    {
+      vertices[length].resize( offsets[length].back() * length );
+      data[length].resize( offsets[length].back() );
+    }
+
+    #pragma omp parallel
+    {
+      // Identifiers of all faces of the current simplex, indexed by the
+      // subset of its vertices that they contain
+      std::vector<std::size_t> faces;
+      std::vector<std::size_t> stack;
+
+      // Current flag, given as subsets of the vertices of the simplex
+      std::vector<std::uint64_t> flag;
+      std::vector<std::uint64_t> candidates;
+      std::vector<std::size_t> cursors( maxSize + 1 );
+
+      #pragma omp for schedule(dynamic, 64)
+      for( std::size_t i = 0; i < n; i++ )
+      {
+        auto&& s  = *simplices[i];
+        auto size = s.size();
+        auto full = ( std::uint64_t(1) << size ) - 1;
+
+        if( size == 1 )
         {
-          std::vector<VertexType> vertices( t.begin(), t.end() );
-          vertices.push_back( barycentreVertex );
-
-          // The new simplex is directly inserted into the boundary of
-          // the resulting simplicial complex---it will not be used by
-          // any other simplex during the subdivision.
-          L.push_back( Simplex( vertices.begin(), vertices.end(),
-                                s.data() * DataType( functor( vertices.size() ) ) ) );
+          vertices[1][ offsets[1][i] ] = *s.begin();
+          data[1][ offsets[1][i] ]     = s.data();
+          continue;
         }
 
-        subdivision[s] = cone;
+        this->collectFaces( i, simplices, facetOffsets, facets, faces, stack );
+
+        for( std::size_t length = 1; length <= size; length++ )
+          cursors[length] = offsets[length][i];
+
+        // Enumerates all flags that end with the current simplex. Every
+        // flag is extended by all non-empty proper subsets of its last
+        // face; candidates stores the next subset to try for each face
+        // of the flag.
+        flag.assign( 1, full );
+        candidates.assign( 1, full );
 
-        // Choose new barycentre vertex for the next simplex. All
-        // barycentres will thus be numbered sequentially.
-        ++barycentreVertex;
+        while( !flag.empty() )
+        {
+          auto length = flag.size();
+
+          if( candidates.back() == flag.back() )
+          {
+            // Write the flag once, upon visiting it for the first time
+            auto j = cursors[length]++;
+
+            for( std::size_t k = 0; k < length; k++ )
+              vertices[length][ j * length + k ] = barycentre( faces[ flag[k] ] );
+
+            data[length][j] = DataType( s.data() * multipliers[ length == 1 ? 0 : length ] );
+          }
+
+          auto&& candidate = candidates.back();
+          candidate        = ( candidate - 1 ) & flag.back();
+
+          if( candidate == 0 )
+          {
+            flag.pop_back();
+            candidates.pop_back();
+          }
+          else
+          {
+            flag.push_back( candidate );
+            candidates.push_back( candidate );
+          }
+        }
       }
     }
 
-    for( auto&& pair : subdivision )
-      L.insert( pair.second.begin(), pair.second.end() );
+    // Simplicial complex ----------------------------------------------
+
+    std::size_t total = 0;
+
+    for( std::size_t length = 1; length <= maxSize; length++ )
+      total += offsets[length].back();
+
+    std::vector<Simplex> result( total );
+    std::size_t offset = 0;
 
-    return L;
+    for( std::size_t length = 1; length <= maxSize; length++ )
+    {
+      auto m = offsets[length].back();
+
+      #pragma omp parallel for
+      for( std::size_t j = 0; j < m; j++ )
+      {
+        auto begin = vertices[length].begin() + static_cast<std::ptrdiff_t>( j * length );
+        auto end   = begin + static_cast<std::ptrdiff_t>( length );
+
+        result[offset + j] = Simplex( begin, end, data[length][j] );
+      }
+
+      offset += m;
+    }
+
+    return SimplicialComplex( result.begin(), result.end() );
   }
+
 private:
 
   /**
-    Collects all boundaries of the given simplex and returns them. This
-    is required in order to update lower-dimensional simplices of cones
-    correctly.
+    Maximum dimension of simplices that can be subdivided; the faces of
+    a simplex are indexed by subsets of its vertices.
+  */
+  static constexpr std::size_t maxDimension = 16;
 
-    Note that the algorithm is rather stupid and slow; it iterates over
-    all faces until the set of all simplices remains fixed.
+  /**
+    Counts the flags of a simplex, i.e. the chains of non-empty subsets
+    of its vertices that end with the simplex itself.
+
+    @param maxSize Maximum number of vertices
+
+    @returns Table whose entry (k, l) contains the number of flags of
+    length l of a simplex with k vertices
   */
 
-  template <class Simplex> static std::vector<Simplex> collectBoundaries( const Simplex& s )
+  static std::vector< std::vector<std::size_t> > countFlags( std::size_t maxSize )
   {
-    std::set<Simplex> simplices;
+    std::vector< std::vector<std::size_t> > binomials( maxSize + 1, std::vector<std::size_t>( maxSize + 1 ) );
+    std::vector< std::vector<std::size_t> > flags( maxSize + 1, std::vector<std::size_t>( maxSize + 1 ) );
+
+    for( std::size_t k = 0; k <= maxSize; k++ )
+    {
+      binomials[k][0] = 1;
 
-    for( auto itBoundary = s.begin_boundary(); itBoundary != s.end_boundary(); ++itBoundary )
-      simplices.insert( *itBoundary );
+      for( std::size_t j = 1; j <= k; j++ )
+        binomials[k][j] = binomials[k-1][j-1] + ( j < k ? binomials[k-1][j] : 0 );
+    }
 
-    bool newSimplices = false;
-    do
+    for( std::size_t k = 1; k <= maxSize; k++ )
     {
-      std::set<Simplex> boundaries;
+      flags[k][1] = 1;
 
-      for( auto&& s : simplices )
+      for( std::size_t l = 2; l <= k; l++ )
       {
-        for( auto itBoundary = s.begin_boundary(); itBoundary != s.end_boundary(); ++itBoundary )
-          boundaries.insert( *itBoundary );
+        for( std::size_t j = 1; j < k; j++ )
+          flags[k][l] += binomials[k][j] * flags[j][l-1];
       }
-
-      auto oldSize = simplices.size();
-
-      simplices.insert( boundaries.begin(),
-                        boundaries.end() );
-
-      auto newSize = simplices.size();
-      newSimplices = newSize != oldSize;
     }
-    while( newSimplices );
 
-    return { simplices.begin(), simplices.end() };
+    return flags;
   }
 
   /**
-    Overloaded variant of the function above. It permits the collection
-    of all boundaries of a range of simplices.
+    Collects the identifiers of all faces of a simplex by traversing its
+    facets recursively. Faces are indexed by the subset of the vertices
+    of the simplex that they contain.
   */
 
-  template <class InputIterator> static auto collectBoundaries( InputIterator begin, InputIterator end ) -> std::vector<typename std::iterator_traits<InputIterator>::value_type>
+  template <class Simplex> static void collectFaces( std::size_t i,
+                                                     const std::vector<const Simplex*>& simplices,
+                                                     const std::vector<std::size_t>& facetOffsets,
+                                                     const std::vector<std::size_t>& facets,
+                                                     std::vector<std::size_t>& faces,
+                                                     std::vector<std::size_t>& stack )
   {
-    using Simplex = typename std::iterator_traits<InputIterator>::value_type;
-    std::set<Simplex> simplices;
+    auto&& s = *simplices[i];
 
-    for( auto it = begin; it != end; ++it )
+    auto invalid = std::numeric_limits<std::size_t>::max();
+    auto full    = ( std::uint64_t(1) << s.size() ) - 1;
+
+    faces.assign( static_cast<std::size_t>( full + 1 ), invalid );
+    faces[ full ] = i;
+
+    stack.assign( 1, i );
+
+    while( !stack.empty() )
     {
-      auto&& boundaries = collectBoundaries( *it );
+      auto j = stack.back();
+      stack.pop_back();
 
-      simplices.insert( boundaries.begin(),
-                        boundaries.end() );
-    }
+      for( auto k = facetOffsets[j]; k < facetOffsets[j + 1]; k++ )
+      {
+        auto&& f = *simplices[ facets[k] ];
 
-    return { simplices.begin(), simplices.end() };
+        // Both simplices store their vertices in the same order, so the
+        // subset of the face is determined by a single pass.
+        std::uint64_t subset = 0;
+        std::size_t position = 0;
+
+        auto itFace = f.begin();
+
+        for( auto it = s.begin(); it != s.end() && itFace != f.end(); ++it, ++position )
+        {
+          if( *it == *itFace )
+          {
+            subset |= std::uint64_t(1) << position;
+            ++itFace;
+          }
+        }
+
+        if( faces[ subset ] == invalid )
+        {
+          faces[ subset ] = facets[k];
+          stack.push_back( facets[k] );
+        }
+      }
+    }
   }
 };
 
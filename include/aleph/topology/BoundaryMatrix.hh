@@ -9,6 +9,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 // FIXME: This is only a temporary workaround. Depending on the index
@@ -28,6 +29,18 @@ template <class Representation> class BoundaryMatrix
 public:
   using Index = typename Representation::Index;
 
+  BoundaryMatrix() = default;
+
+  /**
+    Creates a boundary matrix from an existing representation, e.g. one
+    that refers to a matrix stored in a file.
+  */
+
+  explicit BoundaryMatrix( Representation representation )
+    : _representation( std::move( representation ) )
+  {
+  }
+
   void setNumColumns( Index numColumns )
   {
     _representation.setNumColumns( numColumns );
@@ -3,10 +3,16 @@
 
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
 #include <iterator>
+#include <limits>
 #include <list>
 #include <map>
+#include <numeric>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace aleph
@@ -111,6 +117,680 @@ template <class Simplex> SimplicialComplex<Simplex> getCliqueGraph( const Simpli
   return L;
 }
 
+/**
+  @class CliqueGraphAdjacency
+  @brief Compressed sparse row representation of a clique graph
+
+  This class stores the same graph as getCliqueGraph() but does not use
+  a simplicial complex for this purpose. Nodes are numbered contiguously
+  from $0$ to $n-1$ in ascending order of the index of their k-simplex
+  in the original simplicial complex. The adjacency of every node, along
+  with the weight of every edge, is stored in one contiguous array. Each
+  edge is hence stored twice, i.e. once for each of its endpoints.
+
+  Node and edge weights follow the conventions of getCliqueGraph(): each
+  node has the weight of its k-simplex, while an edge has the maximum of
+  the weights of its endpoints.
+*/
+
+template <class DataType, class Index = unsigned> class CliqueGraphAdjacency
+{
+public:
+  using IndexType             = Index;
+  using const_index_iterator  = typename std::vector<Index>::const_iterator;
+  using const_weight_iterator = typename std::vector<DataType>::const_iterator;
+
+  /** Creates an empty clique graph */
+  CliqueGraphAdjacency()
+    : _offsets( 1, 0 )
+  {
+  }
+
+  /**
+    Creates a new clique graph from its compressed sparse row layout. The
+    offsets need to contain one more entry than there are nodes, whereas
+    the neighbours and weights need to be stored with respect to these
+    offsets.
+
+    @param simplices  Index of the k-simplex of every node
+    @param data       Weight of every node
+    @param offsets    Offsets of the adjacency of every node
+    @param neighbours Neighbours of all nodes
+    @param weights    Weights of all edges
+  */
+
+  CliqueGraphAdjacency( std::vector<Index> simplices,
+                        std::vector<DataType> data,
+                        std::vector<std::size_t> offsets,
+                        std::vector<Index> neighbours,
+                        std::vector<DataType> weights )
+    : _simplices( std::move( simplices ) )
+    , _data( std::move( data ) )
+    , _offsets( std::move( offsets ) )
+    , _neighbours( std::move( neighbours ) )
+    , _weights( std::move( weights ) )
+  {
+    if( _offsets.size() != _simplices.size() + 1 || _data.size() != _simplices.size() )
+      throw std::runtime_error( "Number of offsets and number of nodes do not match" );
+
+    if( _neighbours.size() != _weights.size() || _offsets.back() != _neighbours.size() )
+      throw std::runtime_error( "Number of neighbours and number of weights do not match" );
+  }
+
+  /** @returns Number of nodes of the clique graph */
+  std::size_t size() const noexcept
+  {
+    return _simplices.size();
+  }
+
+  /** @returns true if the clique graph does not contain any nodes */
+  bool empty() const noexcept
+  {
+    return _simplices.empty();
+  }
+
+  /** @returns Number of (undirected) edges of the clique graph */
+  std::size_t numEdges() const noexcept
+  {
+    return _neighbours.size() / 2;
+  }
+
+  /** @returns Index of the k-simplex that corresponds to a node */
+  Index simplex( Index node ) const
+  {
+    return _simplices.at( static_cast<std::size_t>( node ) );
+  }
+
+  /** @returns Weight of a node */
+  DataType data( Index node ) const
+  {
+    return _data.at( static_cast<std::size_t>( node ) );
+  }
+
+  /** @returns Number of neighbours of a node */
+  std::size_t degree( Index node ) const
+  {
+    auto i = static_cast<std::size_t>( node );
+    return _offsets.at( i+1 ) - _offsets.at( i );
+  }
+
+  /** @returns Iterator to begin of the neighbours of a node */
+  const_index_iterator begin_neighbours( Index node ) const
+  {
+    return _neighbours.begin() + static_cast<std::ptrdiff_t>( _offsets.at( static_cast<std::size_t>( node ) ) );
+  }
+
+  /** @returns Iterator to end of the neighbours of a node */
+  const_index_iterator end_neighbours( Index node ) const
+  {
+    return _neighbours.begin() + static_cast<std::ptrdiff_t>( _offsets.at( static_cast<std::size_t>( node ) + 1 ) );
+  }
+
+  /**
+    @returns Iterator to begin of the edge weights of a node. The weights
+    are stored in the same order as the neighbours.
+  */
+
+  const_weight_iterator begin_weights( Index node ) const
+  {
+    return _weights.begin() + static_cast<std::ptrdiff_t>( _offsets.at( static_cast<std::size_t>( node ) ) );
+  }
+
+  /** @returns Iterator to end of the edge weights of a node */
+  const_weight_iterator end_weights( Index node ) const
+  {
+    return _weights.begin() + static_cast<std::ptrdiff_t>( _offsets.at( static_cast<std::size_t>( node ) + 1 ) );
+  }
+
+private:
+  std::vector<Index>       _simplices;  // k-simplex index of each node
+  std::vector<DataType>    _data;       // weight of each node
+  std::vector<std::size_t> _offsets;    // adjacency offsets; one more than nodes
+  std::vector<Index>       _neighbours; // concatenated adjacencies
+  std::vector<DataType>    _weights;    // concatenated edge weights
+};
+
+namespace detail
+{
+
+/**
+  Hashes the vertices of a simplex that is stored in a flat array while
+  skipping one of them. This permits hashing the faces of a simplex
+  without materializing them. Use a value of $n$ for skip in order to
+  hash all vertices.
+*/
+
+template <class VertexType> std::size_t hashVertices( const VertexType* vertices, std::size_t n, std::size_t skip )
+{
+  std::size_t seed = 0;
+
+  for( std::size_t i = 0; i < n; i++ )
+    if( i != skip )
+      boost::hash_combine( seed, vertices[i] );
+
+  return seed;
+}
+
+/**
+  Checks two simplices that are stored in flat arrays for equality while
+  skipping one vertex of each of them. Both simplices have to consist of
+  the same number of vertices after skipping.
+*/
+
+template <class VertexType> bool equalVertices( const VertexType* vertices1, std::size_t n1, std::size_t skip1,
+                                                const VertexType* vertices2, std::size_t n2, std::size_t skip2 )
+{
+  std::size_t i = 0;
+  std::size_t j = 0;
+
+  while( true )
+  {
+    if( i == skip1 )
+      ++i;
+
+    if( j == skip2 )
+      ++j;
+
+    // Both simplices have the same number of vertices, so they are being
+    // exhausted at the same time.
+    if( i >= n1 || j >= n2 )
+      break;
+
+    if( vertices1[i] != vertices2[j] )
+      return false;
+
+    ++i;
+    ++j;
+  }
+
+  return true;
+}
+
+/**
+  @class FaceTable
+  @brief Open-addressing hash table for the faces of a set of simplices
+
+  Stores all k-simplices of a simplicial complex as one flat array of
+  vertices and assigns every one of their $(k-1)$-faces a contiguous
+  identifier. Faces are never materialized: a face is represented by
+  the simplex it was first encountered in and the position of the
+  vertex that has to be skipped.
+*/
+
+template <class VertexType, class Index> class FaceTable
+{
+public:
+
+  /**
+    Creates a new face table from a flat array of vertices. Each simplex
+    is required to consist of exactly the same number of vertices, and
+    its vertices need to be sorted.
+
+    @param vertices    Flat array of vertices of all simplices
+    @param numVertices Number of vertices of a single simplex
+  */
+
+  FaceTable( const std::vector<VertexType>& vertices, std::size_t numVertices )
+  {
+    auto numSimplices = numVertices ? vertices.size() / numVertices : 0;
+    auto numSlots     = numVertices > 1 ? numSimplices * numVertices : 0;
+
+    _faces.resize( numSlots );
+
+    if( numSlots == 0 )
+      return;
+
+    // Hashing is independent for every face, so it is done up front in
+    // parallel. Only the insertion into the table has to be serialized.
+
+    std::vector<std::size_t> hashes( numSlots );
+
+    #pragma omp parallel for
+    for( std::size_t slot = 0; slot < numSlots; slot++ )
+      hashes[slot] = hashVertices( vertices.data() + ( slot - slot % numVertices ), numVertices, slot % numVertices );
+
+    std::size_t capacity = 1;
+    while( capacity < 2 * numSlots )
+      capacity *= 2;
+
+    std::vector<std::size_t> table( capacity, std::numeric_limits<std::size_t>::max() );
+
+    for( std::size_t slot = 0; slot < numSlots; slot++ )
+    {
+      auto position = hashes[slot] & ( capacity - 1 );
+
+      while( true )
+      {
+        auto other = table[position];
+
+        if( other == std::numeric_limits<std::size_t>::max() )
+        {
+          table[position] = slot;
+          _faces[slot]    = Index( _size++ );
+          break;
+        }
+        else if(    hashes[other] == hashes[slot]
+                 && equalVertices( vertices.data() + ( other - other % numVertices ), numVertices, other % numVertices,
+                                   vertices.data() + ( slot  - slot  % numVertices ), numVertices, slot  % numVertices ) )
+        {
+          _faces[slot] = _faces[other];
+          break;
+        }
+
+        position = ( position + 1 ) & ( capacity - 1 );
+      }
+    }
+  }
+
+  /** @returns Number of distinct faces */
+  std::size_t size() const noexcept
+  {
+    return _size;
+  }
+
+  /**
+    @returns Face identifier of a given slot, i.e. the face of simplex
+    $i$ that is obtained by skipping vertex $j$ is stored in the slot
+    $i \cdot n + j$, with $n$ being the number of vertices.
+  */
+
+  Index face( std::size_t slot ) const
+  {
+    return _faces[slot];
+  }
+
+private:
+  std::vector<Index> _faces; // face identifier of every slot
+  std::size_t _size = 0;     // number of distinct faces
+};
+
+/**
+  @class SimplexTable
+  @brief Open-addressing hash table for simplices of a fixed dimension
+
+  Stores simplices of one dimension as a flat array of vertices and
+  permits looking up the rank of a simplex in this array. The query
+  may skip one of its vertices, so the faces of a simplex of a higher
+  dimension can be looked up without materializing them.
+*/
+
+template <class VertexType, class Index> class SimplexTable
+{
+public:
+  SimplexTable() = default;
+
+  /**
+    Creates a new simplex table from a flat array of vertices. Each of
+    the simplices has to consist of the same number of vertices.
+  */
+
+  SimplexTable( std::vector<VertexType> vertices, std::size_t numVertices )
+    : _vertices( std::move( vertices ) )
+    , _numVertices( numVertices )
+  {
+    auto n = this->size();
+
+    std::size_t capacity = 1;
+    while( capacity < 2 * n )
+      capacity *= 2;
+
+    _table.assign( capacity, std::numeric_limits<Index>::max() );
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      auto position = hashVertices( this->vertices( i ), _numVertices, _numVertices ) & ( capacity - 1 );
+
+      while( _table[position] != std::numeric_limits<Index>::max() )
+        position = ( position + 1 ) & ( capacity - 1 );
+
+      _table[position] = Index( i );
+    }
+  }
+
+  /** @returns Number of simplices stored in the table */
+  std::size_t size() const noexcept
+  {
+    return _numVertices ? _vertices.size() / _numVertices : 0;
+  }
+
+  /** @returns Flat array of the vertices of all simplices */
+  const std::vector<VertexType>& vertices() const noexcept
+  {
+    return _vertices;
+  }
+
+  /** @returns Pointer to the vertices of the simplex with a given rank */
+  const VertexType* vertices( std::size_t rank ) const
+  {
+    return _vertices.data() + rank * _numVertices;
+  }
+
+  /**
+    Looks up a simplex whose vertices are given by a flat array of $n$
+    vertices of which the one at position skip is ignored.
+
+    @returns Rank of the simplex in the table, or the largest possible
+    index if the simplex cannot be found.
+  */
+
+  Index find( const VertexType* vertices, std::size_t n, std::size_t skip ) const
+  {
+    if( _table.empty() )
+      return std::numeric_limits<Index>::max();
+
+    auto capacity = _table.size();
+    auto position = hashVertices( vertices, n, skip ) & ( capacity - 1 );
+
+    while( _table[position] != std::numeric_limits<Index>::max() )
+    {
+      auto rank = std::size_t( _table[position] );
+
+      if( equalVertices( this->vertices( rank ), _numVertices, _numVertices,
+                         vertices, n, skip ) )
+      {
+        return _table[position];
+      }
+
+      position = ( position + 1 ) & ( capacity - 1 );
+    }
+
+    return std::numeric_limits<Index>::max();
+  }
+
+private:
+  std::vector<VertexType> _vertices;
+  std::size_t _numVertices = 0;
+
+  std::vector<Index> _table;
+};
+
+/**
+  Creates a clique graph in compressed sparse row layout from the face
+  identifiers of all k-simplices. The face of the i-th simplex obtained
+  by skipping its j-th vertex is expected at position $i \cdot n + j$,
+  with $n$ being the number of vertices of a simplex.
+*/
+
+template <class DataType, class Index, class FaceFunctor>
+CliqueGraphAdjacency<DataType, Index> makeCliqueGraphAdjacency( std::vector<Index> simplices,
+                                                                std::vector<DataType> data,
+                                                                std::size_t numVertices,
+                                                                std::size_t numFaces,
+                                                                FaceFunctor face )
+{
+  auto n        = simplices.size();
+  auto numSlots = numVertices > 1 ? n * numVertices : 0;
+
+  // Co-faces of every face --------------------------------------------
+  //
+  // This uses counting sort, so the co-faces of every face are sorted in
+  // ascending order of their node index.
+
+  std::vector<std::size_t> cofaceOffsets( numFaces + 1 );
+
+  for( std::size_t slot = 0; slot < numSlots; slot++ )
+    ++cofaceOffsets[ std::size_t( face( slot ) ) + 1 ];
+
+  std::partial_sum( cofaceOffsets.begin(), cofaceOffsets.end(), cofaceOffsets.begin() );
+
+  std::vector<Index> cofaces( cofaceOffsets.back() );
+
+  {
+    std::vector<std::size_t> positions( cofaceOffsets.begin(), cofaceOffsets.end() - 1 );
+
+    for( std::size_t slot = 0; slot < numSlots; slot++ )
+      cofaces[ positions[ std::size_t( face( slot ) ) ]++ ] = Index( slot / numVertices );
+  }
+
+  // Adjacencies -------------------------------------------------------
+  //
+  // Every node collects the co-faces of its faces. Degrees are counted
+  // in a first pass so that all adjacencies may be written in parallel
+  // afterwards.
+
+  std::vector<std::size_t> offsets( n + 1 );
+
+  if( numSlots != 0 )
+  {
+    #pragma omp parallel for
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      std::size_t degree = 0;
+
+      for( std::size_t j = 0; j < numVertices; j++ )
+      {
+        auto f  = std::size_t( face( i * numVertices + j ) );
+        degree += cofaceOffsets[f+1] - cofaceOffsets[f] - 1;
+      }
+
+      offsets[i+1] = degree;
+    }
+  }
+
+  std::partial_sum( offsets.begin(), offsets.end(), offsets.begin() );
+
+  std::vector<Index> neighbours( offsets.back() );
+  std::vector<DataType> weights( offsets.back() );
+
+  if( numSlots != 0 )
+  {
+    #pragma omp parallel for
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      auto position = offsets[i];
+
+      for( std::size_t j = 0; j < numVertices; j++ )
+      {
+        auto f = std::size_t( face( i * numVertices + j ) );
+
+        for( auto l = cofaceOffsets[f]; l < cofaceOffsets[f+1]; l++ )
+        {
+          auto m = std::size_t( cofaces[l] );
+          if( m == i )
+            continue;
+
+          neighbours[position] = Index( m );
+          weights[position]    = std::max( data[i], data[m] );
+
+          ++position;
+        }
+      }
+    }
+  }
+
+  return CliqueGraphAdjacency<DataType, Index>( std::move( simplices ),
+                                                std::move( data ),
+                                                std::move( offsets ),
+                                                std::move( neighbours ),
+                                                std::move( weights ) );
+}
+
+} // namespace detail
+
+/**
+  Given a simplicial complex, extracts its clique graph as a compressed
+  sparse row adjacency structure. The graph is identical to the one that
+  is created by getCliqueGraph(), but no simplicial complex and no maps
+  of simplices are required.
+
+  The $(k-1)$-faces of all k-simplices are hashed into a flat table, and
+  the adjacencies of all nodes are subsequently filled in parallel. Edges
+  are unique by construction: two distinct k-simplices share at most one
+  $(k-1)$-face.
+
+  @param K Simplicial complex
+  @param k Dimension of the simplices that make up the nodes of the graph
+
+  @returns Clique graph in compressed sparse row layout
+*/
+
+template <class Index = unsigned, class Simplex>
+CliqueGraphAdjacency<typename Simplex::DataType, Index> getCliqueGraphAdjacency( const SimplicialComplex<Simplex>& K, unsigned k )
+{
+  using DataType   = typename Simplex::DataType;
+  using VertexType = typename Simplex::VertexType;
+
+  std::vector< std::pair<Index, const Simplex*> > nodes;
+
+  for( auto itPair = K.range(k); itPair.first != itPair.second; ++itPair.first )
+    nodes.push_back( std::make_pair( Index( K.index( *itPair.first ) ), &( *itPair.first ) ) );
+
+  std::sort( nodes.begin(), nodes.end(),
+             [] ( const std::pair<Index, const Simplex*>& a, const std::pair<Index, const Simplex*>& b )
+             {
+               return a.first < b.first;
+             } );
+
+  auto n           = nodes.size();
+  auto numVertices = std::size_t( k ) + 1;
+
+  std::vector<Index> simplices( n );
+  std::vector<DataType> data( n );
+  std::vector<VertexType> vertices( n * numVertices );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    simplices[i] = nodes[i].first;
+    data[i]      = nodes[i].second->data();
+
+    std::copy( nodes[i].second->begin(), nodes[i].second->end(), vertices.begin() + static_cast<std::ptrdiff_t>( i * numVertices ) );
+  }
+
+  nodes.clear();
+
+  detail::FaceTable<VertexType, Index> faces( vertices, numVertices );
+
+  return detail::makeCliqueGraphAdjacency( std::move( simplices ),
+                                           std::move( data ),
+                                           numVertices,
+                                           faces.size(),
+                                           [&faces] ( std::size_t slot ) { return faces.face( slot ); } );
+}
+
+/**
+  @class CliqueGraphIndex
+  @brief Shared face index for extracting clique graphs of multiple orders
+
+  Indexes all simplices of a simplicial complex up to a maximum dimension
+  in one pass. Afterwards, the clique graph for every k up to the maximum
+  dimension can be extracted without having to traverse the complex or
+  to hash any faces again: the $(k-1)$-faces of the k-simplices are just
+  looked up in the index.
+
+  If the complex does not contain all $(k-1)$-faces of its k-simplices,
+  e.g. because it was created by a top-down Rips expansion with a given
+  minimum dimension, the faces of the k-simplices are hashed instead, as
+  in getCliqueGraphAdjacency().
+*/
+
+template <class Simplex, class Index = unsigned> class CliqueGraphIndex
+{
+public:
+  using DataType   = typename Simplex::DataType;
+  using VertexType = typename Simplex::VertexType;
+
+  /**
+    Creates a new index for all simplices of the given simplicial complex
+    whose dimension does not exceed the specified maximum dimension.
+  */
+
+  CliqueGraphIndex( const SimplicialComplex<Simplex>& K, unsigned maxK )
+    : _simplices( maxK + 1 )
+    , _data( maxK + 1 )
+    , _tables( maxK + 1 )
+  {
+    std::vector< std::vector<VertexType> > vertices( maxK + 1 );
+
+    // Traversing the simplicial complex in filtration order ensures that
+    // the simplices of every dimension are sorted by their index.
+
+    std::size_t index = 0;
+    for( auto&& simplex : K )
+    {
+      auto d = simplex.dimension();
+
+      if( d <= maxK )
+      {
+        _simplices[d].push_back( Index( index ) );
+        _data[d].push_back( simplex.data() );
+
+        vertices[d].insert( vertices[d].end(), simplex.begin(), simplex.end() );
+      }
+
+      ++index;
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for( std::size_t d = 0; d < vertices.size(); d++ )
+      _tables[d] = detail::SimplexTable<VertexType, Index>( std::move( vertices[d] ), d + 1 );
+  }
+
+  /** @returns Maximum dimension of simplices stored in the index */
+  unsigned maxK() const noexcept
+  {
+    return unsigned( _tables.size() - 1 );
+  }
+
+  /**
+    Extracts the k-clique graph from the index. The result is identical
+    to the one of getCliqueGraphAdjacency().
+
+    @throws std::runtime_error if k exceeds the maximum dimension of the
+    index
+  */
+
+  CliqueGraphAdjacency<DataType, Index> operator()( unsigned k ) const
+  {
+    if( k > this->maxK() )
+      throw std::runtime_error( "Clique graph order exceeds maximum dimension of index" );
+
+    auto&& table     = _tables[k];
+    auto numVertices = std::size_t( k ) + 1;
+    auto numSlots    = k >= 1 ? table.size() * numVertices : 0;
+
+    // Face look-ups are read-only, so they can be performed in parallel
+    // for all slots. The faces are identified by their rank.
+    std::vector<Index> faces( numSlots );
+
+    if( k >= 1 )
+    {
+      bool missingFace = false;
+
+      #pragma omp parallel for reduction(||:missingFace)
+      for( std::size_t slot = 0; slot < numSlots; slot++ )
+      {
+        faces[slot]  = _tables[k-1].find( table.vertices( slot / numVertices ), numVertices, slot % numVertices );
+        missingFace  = missingFace || faces[slot] == std::numeric_limits<Index>::max();
+      }
+
+      // The faces are only required to identify adjacent simplices, so
+      // they may be derived from the k-simplices themselves.
+      if( missingFace )
+      {
+        detail::FaceTable<VertexType, Index> faceTable( table.vertices(), numVertices );
+
+        return detail::makeCliqueGraphAdjacency( _simplices[k],
+                                                 _data[k],
+                                                 numVertices,
+                                                 faceTable.size(),
+                                                 [&faceTable] ( std::size_t slot ) { return faceTable.face( slot ); } );
+      }
+    }
+
+    return detail::makeCliqueGraphAdjacency( _simplices[k],
+                                             _data[k],
+                                             numVertices,
+                                             k >= 1 ? _tables[k-1].size() : 0,
+                                             [&faces] ( std::size_t slot ) { return faces[slot]; } );
+  }
+
+private:
+  std::vector< std::vector<Index> >    _simplices; // simplex indices per dimension
+  std::vector< std::vector<DataType> > _data;      // simplex weights per dimension
+
+  std::vector< detail::SimplexTable<VertexType, Index> > _tables;
+};
+
 } // namespace topology
 
 } // namespace aleph
@@ -5,7 +5,12 @@
 
 #include <aleph/topology/BoundaryMatrix.hh>
 
+#include <aleph/utilities/Instrumentation.hh>
+
 #include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <vector>
 
 namespace aleph
 {
@@ -31,11 +36,15 @@ template <
 {
   using Index = typename BoundaryMatrix<Representation>::Index;
 
+  ALEPH_PHASE( "boundary_matrix" );
+
   BoundaryMatrix<Representation> M;
   M.setNumColumns( static_cast<Index>( K.size() ) );
 
   Index j = Index(0);
 
+  std::size_t numFacetLookups = 0;
+
   for( auto&& itSimplex = K.begin(); itSimplex != K.end(); ++itSimplex )
   {
     std::vector<Index> column;
@@ -53,6 +62,8 @@ template <
       column.push_back( static_cast<Index>( index ) );
     }
 
+    numFacetLookups += column.size();
+
     M.setColumn( j, column.begin(), column.end() );
 
     ++j;
@@ -61,6 +72,100 @@ template <
       break;
   }
 
+  ALEPH_COUNT( FacetLookups, numFacetLookups );
+
+  return M;
+}
+
+/**
+  Converts the simplices of selected dimensions of a simplicial complex
+  into a boundary matrix. Every simplex of a selected dimension yields a
+  column. Faces of these simplices that are not selected themselves are
+  only required as rows, so they yield empty columns of their dimension.
+  All other simplices are ignored, and the order of the filtration does
+  not change.
+
+  @param K          Simplicial complex to convert
+  @param dimensions Dimensions of simplices whose columns are required
+  @param indices    Output parameter for the index of every column of
+                    the boundary matrix in the simplicial complex; the
+                    indices are sorted in ascending order.
+*/
+
+template <
+  class Representation = aleph::defaults::Representation,
+  class SimplicialComplex
+> BoundaryMatrix<Representation> makeBoundaryMatrix( const SimplicialComplex& K,
+                                                     const std::vector<std::size_t>& dimensions,
+                                                     std::vector<std::size_t>& indices )
+{
+  using Index = typename BoundaryMatrix<Representation>::Index;
+
+  ALEPH_PHASE( "boundary_matrix" );
+
+  auto isSelected = [&dimensions] ( std::size_t dimension )
+  {
+    return std::find( dimensions.begin(), dimensions.end(), dimension ) != dimensions.end();
+  };
+
+  auto isRequired = [&isSelected] ( std::size_t dimension )
+  {
+    return isSelected( dimension ) || isSelected( dimension + 1 );
+  };
+
+  indices.clear();
+
+  {
+    std::size_t i = 0;
+
+    for( auto&& s : K )
+    {
+      if( isRequired( s.dimension() ) )
+        indices.push_back( i );
+
+      ++i;
+    }
+  }
+
+  BoundaryMatrix<Representation> M;
+  M.setNumColumns( static_cast<Index>( indices.size() ) );
+
+  std::size_t numFacetLookups = 0;
+
+  for( std::size_t j = 0; j < indices.size(); j++ )
+  {
+    auto&& simplex = K.at( indices[j] );
+    auto dimension = simplex.dimension();
+
+    if( !isSelected( dimension ) )
+    {
+      M.setDimension( static_cast<Index>( j ), static_cast<Index>( dimension ) );
+      continue;
+    }
+
+    std::vector<Index> column;
+    column.reserve( simplex.size() );
+
+    for( auto&& itBoundary = simplex.begin_boundary();
+         itBoundary != simplex.end_boundary();
+         ++itBoundary )
+    {
+      // Faces precede their simplex in the filtration, and the indices
+      // are sorted, so a binary search suffices for mapping them to the
+      // columns of the matrix.
+      auto index = K.index( *itBoundary );
+      auto it    = std::lower_bound( indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>( j ), index );
+
+      column.push_back( static_cast<Index>( std::distance( indices.begin(), it ) ) );
+    }
+
+    numFacetLookups += column.size();
+
+    M.setColumn( static_cast<Index>( j ), column.begin(), column.end() );
+  }
+
+  ALEPH_COUNT( FacetLookups, numFacetLookups );
+
   return M;
 }
 
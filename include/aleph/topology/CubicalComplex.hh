@@ -0,0 +1,264 @@
+#ifndef ALEPH_TOPOLOGY_CUBICAL_COMPLEX_HH__
+#define ALEPH_TOPOLOGY_CUBICAL_COMPLEX_HH__
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+/**
+  @class CubicalComplex
+  @brief Implicit cubical complex of a structured grid
+
+  This class represents the cubical complex of a structured grid with
+  an arbitrary number of axes. Only the scalar values of the vertices
+  of the grid are stored, in a flat array whose first axis varies the
+  fastest. All other cells are implicit. The array may be shared with
+  other objects, so that no values need to be copied.
+
+  Cells are identified by their index in the 'doubled' grid, in which
+  an axis with $n$ vertices has $2n-1$ coordinates. Even coordinates
+  refer to vertices, whereas odd coordinates refer to the extent of a
+  cell along the axis. Hence, the dimension of a cell is the number of
+  its odd coordinates, and the boundary of a cell can be calculated by
+  simple arithmetic on its index.
+
+  The value of a cell is determined by the values of its vertices: the
+  lower-star filtration uses their maximum, while the upper-star one
+  uses their minimum.
+*/
+
+template <class T> class CubicalComplex
+{
+public:
+  using DataType = T;
+  using Index    = std::size_t;
+
+  /** Creates an empty cubical complex */
+  CubicalComplex() = default;
+
+  /**
+    Creates a new cubical complex from the shape of a grid, i.e. the
+    number of vertices along every axis, and the values at all of its
+    vertices.
+
+    @param shape  Number of vertices along every axis; the first axis
+                  varies the fastest in the array of values
+
+    @param values Values at all vertices
+
+    @throws std::runtime_error if the number of values does not match
+    the shape of the grid
+  */
+
+  CubicalComplex( std::vector<std::size_t> shape, std::vector<T> values )
+    : _shape( std::move( shape ) )
+  {
+    auto numValues = values.size();
+    auto storage   = std::make_shared< std::vector<T> >( std::move( values ) );
+
+    // Aliasing constructor: the pointer refers to the values, while the
+    // vector itself is owned.
+    _values = std::shared_ptr<const T>( storage, storage->data() );
+
+    this->initialize();
+
+    if( numValues != _numVertices )
+      throw std::runtime_error( "Number of values does not match shape of grid" );
+  }
+
+  /**
+    Creates a new cubical complex from the shape of a grid and a shared
+    array of values, which must contain as many values as the grid has
+    vertices. The array is not copied.
+  */
+
+  CubicalComplex( std::vector<std::size_t> shape, std::shared_ptr<const T> values )
+    : _shape( std::move( shape ) )
+    , _values( std::move( values ) )
+  {
+    this->initialize();
+  }
+
+  /** @returns Number of vertices along every axis */
+  const std::vector<std::size_t>& shape() const noexcept
+  {
+    return _shape;
+  }
+
+  /** @returns Number of vertices of the grid */
+  std::size_t numVertices() const noexcept
+  {
+    return _numVertices;
+  }
+
+  /** @returns Values at all vertices of the grid */
+  const T* values() const noexcept
+  {
+    return _values.get();
+  }
+
+  /** @returns Number of cells of all dimensions */
+  std::size_t size() const noexcept
+  {
+    return _numCells;
+  }
+
+  /** @returns true if the complex does not contain any cells */
+  bool empty() const noexcept
+  {
+    return _numCells == 0;
+  }
+
+  /**
+    @returns Maximum dimension of a cell, i.e. the number of axes with
+    more than one vertex
+  */
+
+  std::size_t dimension() const noexcept
+  {
+    return static_cast<std::size_t>( std::count_if( _shape.begin(), _shape.end(), [] ( std::size_t n ) { return n > 1; } ) );
+  }
+
+  /** @returns Dimension of a cell, i.e. the number of its odd coordinates */
+  std::size_t dimension( Index cell ) const noexcept
+  {
+    std::size_t d = 0;
+
+    for( std::size_t i = 0; i < _shape.size(); i++ )
+    {
+      d    += ( cell % ( 2 * _shape[i] - 1 ) ) % 2;
+      cell /= 2 * _shape[i] - 1;
+    }
+
+    return d;
+  }
+
+  /**
+    Enumerates the boundary of a cell. Every odd coordinate results in
+    two faces, namely the ones with the preceding and with the following
+    even coordinate. Faces are reported in ascending order of their axes
+    but are not sorted otherwise.
+
+    @param cell   Cell whose boundary is enumerated
+    @param result Output iterator for storing the faces
+  */
+
+  template <class OutputIterator> void boundary( Index cell, OutputIterator result ) const
+  {
+    auto c = cell;
+
+    for( std::size_t i = 0; i < _shape.size(); i++ )
+    {
+      if( ( c % ( 2 * _shape[i] - 1 ) ) % 2 == 1 )
+      {
+        *result++ = cell - _cellStrides[i];
+        *result++ = cell + _cellStrides[i];
+      }
+
+      c /= 2 * _shape[i] - 1;
+    }
+  }
+
+  /**
+    Calculates the value of a cell in the lower-star filtration (maximum
+    of vertex values) or the upper-star filtration (minimum of vertex
+    values).
+  */
+
+  T value( Index cell, bool upperStar = false ) const
+  {
+    // Base vertex of the cell, i.e. the vertex with the smallest index,
+    // plus the axes along which the cell extends.
+    std::size_t base = 0;
+    std::size_t axes[64];
+    std::size_t numAxes = 0;
+
+    for( std::size_t i = 0; i < _shape.size(); i++ )
+    {
+      auto n = 2 * _shape[i] - 1;
+      auto x = cell % n;
+
+      base += ( x / 2 ) * _vertexStrides[i];
+
+      if( x % 2 == 1 )
+        axes[numAxes++] = _vertexStrides[i];
+
+      cell /= n;
+    }
+
+    auto values = _values.get();
+    T result    = values[base];
+
+    for( std::size_t mask = 1; mask < ( std::size_t(1) << numAxes ); mask++ )
+    {
+      auto vertex = base;
+
+      for( std::size_t j = 0; j < numAxes; j++ )
+        if( mask & ( std::size_t(1) << j ) )
+          vertex += axes[j];
+
+      result = upperStar ? std::min( result, values[vertex] )
+                         : std::max( result, values[vertex] );
+    }
+
+    return result;
+  }
+
+private:
+
+  /** Calculates strides and checks whether the shape is valid */
+  void initialize()
+  {
+    if( _shape.empty() || !_values )
+      throw std::runtime_error( "Number of values does not match shape of grid" );
+
+    if( _shape.size() > 64 )
+      throw std::runtime_error( "Grid must not have more than 64 axes" );
+
+    _vertexStrides.resize( _shape.size() );
+    _cellStrides.resize( _shape.size() );
+
+    std::size_t vertexStride = 1;
+    std::size_t cellStride   = 1;
+
+    for( std::size_t i = 0; i < _shape.size(); i++ )
+    {
+      if( _shape[i] == 0 )
+        throw std::runtime_error( "Grid must not contain empty axes" );
+
+      _vertexStrides[i] = vertexStride;
+      _cellStrides[i]   = cellStride;
+
+      vertexStride     *= _shape[i];
+      cellStride       *= 2 * _shape[i] - 1;
+    }
+
+    _numVertices = vertexStride;
+    _numCells    = cellStride;
+  }
+
+  std::vector<std::size_t> _shape;         // number of vertices per axis
+  std::shared_ptr<const T> _values;        // values at all vertices
+
+  std::vector<std::size_t> _vertexStrides; // strides in the array of vertices
+  std::vector<std::size_t> _cellStrides;   // strides in the doubled grid
+
+  std::size_t _numVertices = 0;
+  std::size_t _numCells    = 0;
+};
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
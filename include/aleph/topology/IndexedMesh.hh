@@ -0,0 +1,463 @@
+#ifndef ALEPH_TOPOLOGY_INDEXED_MESH_HH__
+#define ALEPH_TOPOLOGY_INDEXED_MESH_HH__
+
+#include <aleph/topology/UnionFind.hh>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+/**
+  @class IndexedMesh
+  @brief Compact half-edge mesh for large two-dimensional manifolds
+
+  This class represents the same meshes as Mesh, i.e. two-dimensional
+  piecewise linear manifolds, but stores vertices, half-edges, and faces
+  in contiguous arrays that refer to each other by 32-bit indices. There
+  are no pointers and no reference counts, so traversals are cheap, and
+  all queries may be used concurrently.
+
+  The half-edges of a face are stored consecutively, in the order of the
+  vertices of the face. Half-edges on the boundary of the mesh do not have
+  a twin. Every vertex stores an outgoing half-edge; for vertices on the
+  boundary, this is the half-edge whose twin is missing, so that all of
+  the incident faces can be visited by rotating around the vertex.
+
+  A mesh is created in bulk from a list of faces, e.g. as read from a PLY
+  file. The vertices of every face must be sorted consistently, i.e. the
+  mesh must be oriented.
+*/
+
+template <class Position = float, class Data = float> class IndexedMesh
+{
+public:
+  using Index = std::uint32_t;
+
+  /** Indicates a missing element, e.g. the twin of a boundary half-edge */
+  static constexpr Index invalid() noexcept
+  {
+    return std::numeric_limits<Index>::max();
+  }
+
+  IndexedMesh() = default;
+
+  /**
+    Creates a new mesh from a list of faces of arbitrary size.
+
+    @param coordinates Coordinates of all vertices, stored as x, y, and z
+                       for every vertex; may be empty if the positions of
+                       vertices are irrelevant
+    @param data        Data stored for every vertex
+    @param offsets     Offsets of all faces in the list of face vertices,
+                       followed by the total number of face vertices
+    @param vertices    Vertices of all faces
+
+    @throws std::runtime_error if the mesh is too large for 32-bit indices,
+    if the input is inconsistent, or if the faces do not describe an
+    oriented manifold
+  */
+
+  template <class FaceIndex> IndexedMesh( std::vector<Position> coordinates,
+                                          std::vector<Data> data,
+                                          const std::vector<std::size_t>& offsets,
+                                          const std::vector<FaceIndex>& vertices )
+    : _coordinates( std::move( coordinates ) )
+    , _data( std::move( data ) )
+  {
+    this->build( offsets, vertices );
+  }
+
+  /**
+    Creates a new mesh from a list of triangles, i.e. three vertices per
+    face. This is the most common layout for meshes stored in PLY files.
+  */
+
+  template <class FaceIndex> IndexedMesh( std::vector<Position> coordinates,
+                                          std::vector<Data> data,
+                                          const std::vector<FaceIndex>& triangles )
+    : _coordinates( std::move( coordinates ) )
+    , _data( std::move( data ) )
+  {
+    if( triangles.size() % 3 != 0 )
+      throw std::runtime_error( "Number of triangle vertices must be a multiple of three" );
+
+    std::vector<std::size_t> offsets( triangles.size() / 3 + 1 );
+
+    for( std::size_t i = 0; i < offsets.size(); i++ )
+      offsets[i] = 3 * i;
+
+    this->build( offsets, triangles );
+  }
+
+  // Mesh attributes ---------------------------------------------------
+
+  std::size_t numVertices()  const noexcept { return _data.size();        }
+  std::size_t numFaces()     const noexcept { return _faceEdge.size();    }
+  std::size_t numHalfEdges() const noexcept { return _target.size();      }
+
+  /** @returns IDs of all vertices, i.e. all indices in ascending order */
+  std::vector<Index> vertices() const
+  {
+    std::vector<Index> result( this->numVertices() );
+
+    for( std::size_t i = 0; i < result.size(); i++ )
+      result[i] = static_cast<Index>( i );
+
+    return result;
+  }
+
+  /** @returns Vertices of all faces, in the order of their half-edges */
+  std::vector< std::vector<Index> > faces() const
+  {
+    std::vector< std::vector<Index> > result( this->numFaces() );
+
+    for( std::size_t f = 0; f < result.size(); f++ )
+    {
+      auto begin = _faceEdge[f];
+      auto end   = f + 1 < result.size() ? _faceEdge[f+1] : static_cast<Index>( this->numHalfEdges() );
+
+      for( auto h = begin; h != end; h++ )
+        result[f].push_back( this->source( h ) );
+    }
+
+    return result;
+  }
+
+  // Half-edge queries -------------------------------------------------
+
+  Index target( Index h ) const noexcept { return _target[h]; }
+  Index source( Index h ) const noexcept { return _target[ _prev[h] ]; }
+  Index next( Index h )   const noexcept { return _next[h];   }
+  Index prev( Index h )   const noexcept { return _prev[h];   }
+  Index twin( Index h )   const noexcept { return _twin[h];   }
+  Index face( Index h )   const noexcept { return _face[h];   }
+
+  /** @returns Outgoing half-edge of a vertex, or invalid() for isolated vertices */
+  Index edge( Index v ) const noexcept { return _vertexEdge[v]; }
+
+  // Vertex queries ----------------------------------------------------
+
+  /** Returns data stored at a certain vertex */
+  Data data( Index v ) const noexcept
+  {
+    return _data[v];
+  }
+
+  /** Returns the position of a vertex, or the origin if no positions are known */
+  std::array<Position, 3> position( Index v ) const noexcept
+  {
+    if( _coordinates.empty() )
+      return {{ Position(), Position(), Position() }};
+
+    return {{ _coordinates[3*v], _coordinates[3*v+1], _coordinates[3*v+2] }};
+  }
+
+  /** @returns true if the vertex is on the boundary of the mesh */
+  bool isBoundary( Index v ) const noexcept
+  {
+    auto h = _vertexEdge[v];
+    return h != invalid() && _twin[h] == invalid();
+  }
+
+  /**
+    Visits all neighbours of a vertex, i.e. the vertices of its link, in
+    an order that is consistent with the orientation of the mesh. For a
+    vertex on the boundary, the traversal starts and ends at the boundary.
+    No memory is allocated.
+
+    @param v       Vertex
+    @param functor Functor that is called with the index of every neighbour
+  */
+
+  template <class Functor> void forEachNeighbour( Index v, Functor&& functor ) const
+  {
+    auto start = _vertexEdge[v];
+    if( start == invalid() )
+      return;
+
+    auto h = start;
+
+    do
+    {
+      functor( _target[h] );
+
+      auto p = _prev[h];
+
+      // Reached the boundary: the source of the previous half-edge is the
+      // last neighbour, since there is no face beyond it.
+      if( _twin[p] == invalid() )
+      {
+        functor( this->source( p ) );
+        break;
+      }
+
+      h = _twin[p];
+    }
+    while( h != start );
+  }
+
+  /**
+    The link of a vertex is defined as all simplices in the closed star
+    that are disjoint from the vertex. For 2-manifolds, this will yield
+    a cycle of edges and vertices.
+
+    This function will represent the cycle by returning all vertex IDs,
+    in an order that is consistent with the orientation of the mesh.
+  */
+
+  std::vector<Index> link( Index v ) const
+  {
+    std::vector<Index> result;
+    this->forEachNeighbour( v, [&result] ( Index u ) { result.push_back( u ); } );
+
+    return result;
+  }
+
+  std::vector<Index> getLowerNeighbours( Index v ) const
+  {
+    std::vector<Index> result;
+    auto&& data = _data[v];
+
+    this->forEachNeighbour( v, [&result, &data, this] ( Index u )
+                               {
+                                 if( _data[u] < data )
+                                   result.push_back( u );
+                               } );
+
+    return result;
+  }
+
+  std::vector<Index> getHigherNeighbours( Index v ) const
+  {
+    std::vector<Index> result;
+    auto&& data = _data[v];
+
+    this->forEachNeighbour( v, [&result, &data, this] ( Index u )
+                               {
+                                 if( _data[u] > data )
+                                   result.push_back( u );
+                               } );
+
+    return result;
+  }
+
+  /**
+    Checks whether an edge between two vertices that are identified by
+    their index exists.
+  */
+
+  bool hasEdge( Index u, Index v ) const
+  {
+    bool found = false;
+
+    this->forEachNeighbour( u, [&found, &v] ( Index w )
+                               {
+                                 found = found || w == v;
+                               } );
+
+    return found;
+  }
+
+  /** Counts the number of connected components */
+  std::size_t numConnectedComponents() const
+  {
+    DenseUnionFind<Index> uf( this->numVertices() );
+
+    for( std::size_t h = 0; h < this->numHalfEdges(); h++ )
+      uf.merge( this->source( static_cast<Index>( h ) ), _target[h] );
+
+    std::vector<Index> roots;
+    uf.roots( std::back_inserter( roots ) );
+
+    return roots.size();
+  }
+
+private:
+
+  /**
+    Creates all half-edges of the mesh. Twins are matched by bucketing
+    all half-edges according to their smaller vertex, followed by a
+    parallel pass over all buckets, each of which is tiny.
+  */
+
+  template <class FaceIndex> void build( const std::vector<std::size_t>& offsets, const std::vector<FaceIndex>& vertices )
+  {
+    auto n = _data.size();
+
+    if( !_coordinates.empty() && _coordinates.size() != 3 * n )
+      throw std::runtime_error( "Number of coordinates does not match number of vertices" );
+
+    if( offsets.empty() || offsets.back() != vertices.size() )
+      throw std::runtime_error( "Face offsets do not match number of face vertices" );
+
+    if( n >= invalid() || vertices.size() >= invalid() || offsets.size() > invalid() )
+      throw std::runtime_error( "Mesh is too large for 32-bit indices" );
+
+    auto numFaces     = offsets.size() - 1;
+    auto numHalfEdges = vertices.size();
+
+    _target.resize( numHalfEdges );
+    _next.resize( numHalfEdges );
+    _prev.resize( numHalfEdges );
+    _face.resize( numHalfEdges );
+    _twin.assign( numHalfEdges, invalid() );
+    _faceEdge.resize( numFaces );
+
+    bool invalidFace = false;
+
+    // Faces -----------------------------------------------------------
+
+    #pragma omp parallel for reduction(||:invalidFace)
+    for( std::size_t f = 0; f < numFaces; f++ )
+    {
+      auto begin = offsets[f];
+      auto end   = offsets[f+1];
+
+      if( end < begin + 3 || end > numHalfEdges )
+      {
+        invalidFace = true;
+        continue;
+      }
+
+      _faceEdge[f] = static_cast<Index>( begin );
+
+      for( auto h = begin; h < end; h++ )
+      {
+        auto next = h + 1 < end ? h + 1 : begin;
+        auto prev = h > begin   ? h - 1 : end - 1;
+        auto v    = static_cast<std::size_t>( vertices[next] );
+
+        if( v >= n )
+          invalidFace = true;
+
+        _target[h] = static_cast<Index>( v );
+        _next[h]   = static_cast<Index>( next );
+        _prev[h]   = static_cast<Index>( prev );
+        _face[h]   = static_cast<Index>( f );
+      }
+    }
+
+    if( invalidFace )
+      throw std::runtime_error( "Faces must consist of at least three valid vertices" );
+
+    // Twins -----------------------------------------------------------
+    //
+    // Counting sort of all half-edges by their smaller vertex. Only the
+    // half-edges within a bucket need to be compared afterwards.
+
+    std::vector<Index> bucketOffsets( n + 1 );
+
+    for( std::size_t h = 0; h < numHalfEdges; h++ )
+    {
+      auto u = this->source( static_cast<Index>( h ) );
+      auto v = _target[h];
+
+      ++bucketOffsets[ std::min( u, v ) + 1 ];
+    }
+
+    std::partial_sum( bucketOffsets.begin(), bucketOffsets.end(), bucketOffsets.begin() );
+
+    std::vector<Index> buckets( numHalfEdges );
+
+    {
+      std::vector<Index> positions( bucketOffsets.begin(), bucketOffsets.end() - 1 );
+
+      for( std::size_t h = 0; h < numHalfEdges; h++ )
+      {
+        auto u = this->source( static_cast<Index>( h ) );
+        auto v = _target[h];
+
+        buckets[ positions[ std::min( u, v ) ]++ ] = static_cast<Index>( h );
+      }
+    }
+
+    bool nonManifold = false;
+
+    #pragma omp parallel for schedule(dynamic, 1024) reduction(||:nonManifold)
+    for( std::size_t u = 0; u < n; u++ )
+    {
+      auto begin = buckets.begin() + bucketOffsets[u];
+      auto end   = buckets.begin() + bucketOffsets[u+1];
+
+      auto other = [this] ( Index h )
+      {
+        return std::max( this->source( h ), _target[h] );
+      };
+
+      std::sort( begin, end, [&other] ( Index g, Index h )
+                             {
+                               return other(g) < other(h) || ( other(g) == other(h) && g < h );
+                             } );
+
+      for( auto it = begin; it != end; )
+      {
+        auto jt = std::next( it );
+        while( jt != end && other( *jt ) == other( *it ) )
+          ++jt;
+
+        auto count = std::distance( it, jt );
+
+        // An edge is shared by at most two faces, which need to traverse
+        // it in opposite directions.
+        if( count > 2 || ( count == 2 && _target[ *it ] == _target[ *std::next( it ) ] ) )
+          nonManifold = true;
+        else if( count == 2 )
+        {
+          _twin[ *it ]            = *std::next( it );
+          _twin[ *std::next( it ) ] = *it;
+        }
+
+        it = jt;
+      }
+    }
+
+    if( nonManifold )
+      throw std::runtime_error( "Faces do not describe an oriented manifold" );
+
+    // Vertices --------------------------------------------------------
+    //
+    // Prefer outgoing half-edges without a twin, such that a rotation
+    // around a boundary vertex visits all of its faces.
+
+    _vertexEdge.assign( n, invalid() );
+
+    for( std::size_t h = 0; h < numHalfEdges; h++ )
+    {
+      auto v = this->source( static_cast<Index>( h ) );
+
+      if( _vertexEdge[v] == invalid() || _twin[h] == invalid() )
+        _vertexEdge[v] = static_cast<Index>( h );
+    }
+  }
+
+  std::vector<Position> _coordinates; // x, y, z for every vertex
+  std::vector<Data>     _data;        // data for every vertex
+  std::vector<Index>    _vertexEdge;  // outgoing half-edge for every vertex
+
+  std::vector<Index> _target;         // target vertex of every half-edge
+  std::vector<Index> _next;           // next half-edge in the same face
+  std::vector<Index> _prev;           // previous half-edge in the same face
+  std::vector<Index> _twin;           // opposite half-edge, if any
+  std::vector<Index> _face;           // face of every half-edge
+
+  std::vector<Index> _faceEdge;       // first half-edge of every face
+};
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
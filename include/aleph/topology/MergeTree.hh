@@ -0,0 +1,673 @@
+#ifndef ALEPH_TOPOLOGY_MERGE_TREE_HH__
+#define ALEPH_TOPOLOGY_MERGE_TREE_HH__
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/topology/MorseSmaleComplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+#include <aleph/topology/UnionFind.hh>
+
+#include <aleph/utilities/ParallelSort.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+/**
+  @class MergeTree
+  @brief Merge tree of a scalar function on the vertices of a graph
+
+  Tracks the connected components of the sublevel sets (or superlevel
+  sets) of a function that is defined on the vertices of a graph, e.g.
+  the 1-skeleton of a simplicial complex or of a mesh. The tree is built
+  by a single sweep over the vertices in sorted order, using a dense
+  Union--Find data structure, so its calculation requires O(n log n).
+
+  In the literature on contour trees, the merge tree of the sublevel sets
+  is known as the split tree, while the merge tree of the superlevel sets
+  is known as the join tree.
+
+  The tree is augmented, i.e. it contains all vertices, and every vertex
+  stores its parent, which is the vertex at which its component is next
+  extended. Ties in function values are resolved by vertex index, as in
+  MorseSmaleComplex, so the sweep for superlevel sets visits vertices in
+  the opposite order of the sweep for sublevel sets.
+
+  Since components are merged according to the elder rule, the sweep
+  also yields the branch decomposition of the tree. This is equivalent
+  to the 0-dimensional persistent homology of the lower-star (or upper-
+  star) filtration and its persistence hierarchy.
+*/
+
+template <class Data, class Index = std::uint32_t> class MergeTree
+{
+public:
+
+  /**
+    A branch of the tree, i.e. a persistence pair. Every branch starts at
+    a leaf, i.e. an extremum of the function, and ends at the vertex at
+    which it merges into an older branch.
+  */
+
+  struct Branch
+  {
+    Index creator;   // Extremum that creates the branch
+    Index destroyer; // Vertex at which the branch merges, or invalid() for essential branches
+    Index parent;    // Branch into which the branch merges, or invalid() for essential branches
+  };
+
+  /** Indicates a missing element, e.g. the parent of a root */
+  static constexpr Index invalid() noexcept
+  {
+    return std::numeric_limits<Index>::max();
+  }
+
+  /**
+    Creates a new merge tree of a graph that is given by its adjacency
+    lists in compressed form, i.e. the neighbours of vertex i are stored
+    in the range [offsets[i], offsets[i+1]) of the neighbours.
+
+    @param values     Function values of all vertices
+    @param offsets    Offsets of all adjacency lists, followed by the total
+                      number of neighbours
+    @param neighbours Concatenated adjacency lists of all vertices
+    @param sublevel   Flag indicating whether the merge tree of sublevel
+                      sets (default) or superlevel sets is calculated
+
+    @throws std::runtime_error if the adjacency lists are inconsistent
+  */
+
+  MergeTree( std::vector<Data> values,
+             const std::vector<std::size_t>& offsets,
+             const std::vector<Index>& neighbours,
+             bool sublevel = true )
+    : _values( std::move( values ) )
+    , _sublevel( sublevel )
+  {
+    auto n = _values.size();
+
+    if( offsets.size() != n + 1 || offsets.back() != neighbours.size() )
+      throw std::runtime_error( "Adjacency lists do not match the number of vertices" );
+
+    if( n >= static_cast<std::size_t>( invalid() ) )
+      throw std::runtime_error( "Number of vertices exceeds index type" );
+
+    // Sweep order -----------------------------------------------------
+
+    _order.resize( n );
+    std::iota( _order.begin(), _order.end(), Index(0) );
+
+    utilities::parallelSort( _order.begin(), _order.end(),
+                             [this] ( Index u, Index v )
+                             {
+                               return this->precedes( u, v );
+                             } );
+
+    _ranks.resize( n );
+
+    #pragma omp parallel for
+    for( std::size_t i = 0; i < n; i++ )
+      _ranks[ static_cast<std::size_t>( _order[i] ) ] = Index( i );
+
+    // Sweep -----------------------------------------------------------
+    //
+    // Every vertex becomes the root of the component it extends, so the
+    // roots of the Union--Find data structure are always the vertices
+    // that have been added last to their component. They also store the
+    // branch that is represented by the component.
+
+    _parents.assign( n, invalid() );
+
+    std::vector<Index> branches( n, invalid() );
+    std::vector<Index> components;
+
+    DenseUnionFind<Index> uf( n );
+
+    for( auto&& v : _order )
+    {
+      auto i = static_cast<std::size_t>( v );
+
+      components.clear();
+
+      for( std::size_t j = offsets[i]; j < offsets[i+1]; j++ )
+      {
+        auto u = neighbours[j];
+
+        if( static_cast<std::size_t>( u ) >= n )
+          throw std::runtime_error( "Invalid neighbour in adjacency list" );
+
+        if( _ranks[ static_cast<std::size_t>( u ) ] >= _ranks[i] )
+          continue;
+
+        auto root = uf.find( u );
+
+        if( std::find( components.begin(), components.end(), root ) == components.end() )
+          components.push_back( root );
+      }
+
+      if( components.empty() )
+      {
+        branches[i] = Index( _branches.size() );
+        _branches.push_back( { v, invalid(), invalid() } );
+
+        continue;
+      }
+
+      // The branch with the oldest creator survives; all others end at
+      // the current vertex.
+      auto survivor = *std::min_element( components.begin(), components.end(),
+                                         [this, &branches] ( Index c, Index d )
+                                         {
+                                           auto&& b = _branches[ static_cast<std::size_t>( branches[ static_cast<std::size_t>( c ) ] ) ];
+                                           auto&& e = _branches[ static_cast<std::size_t>( branches[ static_cast<std::size_t>( d ) ] ) ];
+
+                                           return _ranks[ static_cast<std::size_t>( b.creator ) ] < _ranks[ static_cast<std::size_t>( e.creator ) ];
+                                         } );
+
+      auto survivingBranch = branches[ static_cast<std::size_t>( survivor ) ];
+
+      for( auto&& c : components )
+      {
+        auto&& branch = branches[ static_cast<std::size_t>( c ) ];
+
+        if( c != survivor )
+        {
+          _branches[ static_cast<std::size_t>( branch ) ].destroyer = v;
+          _branches[ static_cast<std::size_t>( branch ) ].parent    = survivingBranch;
+        }
+
+        _parents[ static_cast<std::size_t>( c ) ] = v;
+        uf.merge( c, v );
+      }
+
+      branches[i] = survivingBranch;
+    }
+  }
+
+  /** @returns Number of vertices */
+  std::size_t size() const noexcept
+  {
+    return _values.size();
+  }
+
+  /** @returns true if the tree describes sublevel sets */
+  bool isSublevel() const noexcept
+  {
+    return _sublevel;
+  }
+
+  /** @returns Function value of a vertex */
+  Data value( Index v ) const noexcept
+  {
+    return _values[ static_cast<std::size_t>( v ) ];
+  }
+
+  /**
+    @returns Parent of a vertex in the augmented tree, or invalid() if
+    the vertex is the root of its connected component
+  */
+
+  Index parent( Index v ) const noexcept
+  {
+    return _parents[ static_cast<std::size_t>( v ) ];
+  }
+
+  /** @returns Position of a vertex in the sweep order */
+  Index rank( Index v ) const noexcept
+  {
+    return _ranks[ static_cast<std::size_t>( v ) ];
+  }
+
+  /** @returns Vertices in sweep order */
+  const std::vector<Index>& order() const noexcept
+  {
+    return _order;
+  }
+
+  /**
+    @returns Branch decomposition of the tree. Branches are stored in the
+    order of their creators, so parents precede their children.
+  */
+
+  const std::vector<Branch>& branches() const noexcept
+  {
+    return _branches;
+  }
+
+  /**
+    @returns Nodes of the tree, i.e. all leaves, all vertices at which
+    components merge, and all roots, in sweep order
+  */
+
+  std::vector<Index> nodes() const
+  {
+    auto children = this->numChildren();
+
+    std::vector<Index> result;
+
+    for( auto&& v : _order )
+    {
+      auto i = static_cast<std::size_t>( v );
+
+      if( children[i] != 1 || _parents[i] == invalid() )
+        result.push_back( v );
+    }
+
+    return result;
+  }
+
+  /**
+    @returns Arcs of the tree without augmentation, i.e. pairs of nodes,
+    where the second node is the parent of the first one. Vertices with a
+    single child are skipped.
+  */
+
+  std::vector< std::pair<Index, Index> > arcs() const
+  {
+    auto children = this->numChildren();
+
+    auto isNode = [this, &children] ( Index v )
+    {
+      auto i = static_cast<std::size_t>( v );
+      return children[i] != 1 || _parents[i] == invalid();
+    };
+
+    std::vector< std::pair<Index, Index> > result;
+
+    for( auto&& v : _order )
+    {
+      if( !isNode( v ) || _parents[ static_cast<std::size_t>( v ) ] == invalid() )
+        continue;
+
+      auto u = _parents[ static_cast<std::size_t>( v ) ];
+
+      while( !isNode( u ) )
+        u = _parents[ static_cast<std::size_t>( u ) ];
+
+      result.push_back( std::make_pair( v, u ) );
+    }
+
+    return result;
+  }
+
+  /**
+    Calculates the persistence diagram of the tree. Branches whose
+    creator and destroyer have the same function value are omitted.
+  */
+
+  PersistenceDiagram<Data> persistenceDiagram() const
+  {
+    PersistenceDiagram<Data> D;
+
+    for( auto&& branch : _branches )
+    {
+      auto creation = this->value( branch.creator );
+
+      if( branch.destroyer == invalid() )
+        D.add( creation );
+      else
+      {
+        auto destruction = this->value( branch.destroyer );
+
+        if( creation != destruction )
+          D.add( creation, destruction );
+      }
+    }
+
+    return D;
+  }
+
+private:
+
+  /**
+    Order of the sweep, using vertex indices to resolve ties. The order
+    for superlevel sets is the reverse of the order for sublevel sets,
+    which is required for calculating contour trees.
+  */
+  bool precedes( Index u, Index v ) const noexcept
+  {
+    auto a = _values[ static_cast<std::size_t>( u ) ];
+    auto b = _values[ static_cast<std::size_t>( v ) ];
+
+    if( _sublevel )
+      return a < b || ( !( b < a ) && u < v );
+    else
+      return b < a || ( !( a < b ) && v < u );
+  }
+
+  std::vector<Index> numChildren() const
+  {
+    std::vector<Index> children( _values.size() );
+
+    for( auto&& p : _parents )
+      if( p != invalid() )
+        ++children[ static_cast<std::size_t>( p ) ];
+
+    return children;
+  }
+
+  std::vector<Data>   _values;
+  std::vector<Index>  _order;
+  std::vector<Index>  _ranks;
+  std::vector<Index>  _parents;
+  std::vector<Branch> _branches;
+
+  bool _sublevel;
+};
+
+namespace detail
+{
+
+/**
+  Extracts the function values and the compressed adjacency lists of the
+  vertices of a mesh. Vertices are processed in parallel, so the mesh must
+  support concurrent queries.
+*/
+
+template <class Mesh, class Data> void extractGraph( const Mesh& M,
+                                                     std::vector<Data>& values,
+                                                     std::vector<std::size_t>& offsets,
+                                                     std::vector<typename Mesh::Index>& neighbours )
+{
+  using Index = typename Mesh::Index;
+
+  auto n = M.numVertices();
+
+  for( auto&& v : M.vertices() )
+    if( static_cast<std::size_t>( v ) >= n )
+      throw std::runtime_error( "Vertex indices must be contiguous" );
+
+  values.resize( n );
+  offsets.assign( n + 1, 0 );
+
+  #pragma omp parallel for schedule(dynamic, 1024)
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    auto v = Index( i );
+
+    std::size_t degree = 0;
+    forEachNeighbour( M, v, [&degree] ( Index ) { ++degree; } );
+
+    values[i]    = M.data( v );
+    offsets[i+1] = degree;
+  }
+
+  std::partial_sum( offsets.begin(), offsets.end(), offsets.begin() );
+  neighbours.resize( offsets.back() );
+
+  #pragma omp parallel for schedule(dynamic, 1024)
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    auto j = offsets[i];
+    forEachNeighbour( M, Index( i ), [&neighbours, &j] ( Index u ) { neighbours[j++] = u; } );
+  }
+}
+
+} // namespace detail
+
+/**
+  Calculates the merge tree of the function on the vertices of a mesh.
+  Vertices must be indexed contiguously, starting from zero.
+
+  @param M        Mesh
+  @param sublevel Flag indicating whether sublevel sets (default) or
+                  superlevel sets are tracked
+*/
+
+template <class Mesh>
+  MergeTree<typename std::decay<decltype( std::declval<const Mesh&>().data( typename Mesh::Index() ) )>::type, typename Mesh::Index>
+makeMergeTree( const Mesh& M, bool sublevel = true )
+{
+  using Index = typename Mesh::Index;
+  using Data  = typename std::decay<decltype( std::declval<const Mesh&>().data( Index() ) )>::type;
+
+  std::vector<Data> values;
+  std::vector<std::size_t> offsets;
+  std::vector<Index> neighbours;
+
+  detail::extractGraph( M, values, offsets, neighbours );
+
+  return MergeTree<Data, Index>( std::move( values ), offsets, neighbours, sublevel );
+}
+
+/**
+  Calculates the merge tree of the function on the 1-skeleton of a
+  simplicial complex. The function values are given by the data of the
+  vertices; the data of all other simplices is ignored. Vertices of the
+  tree are indexed by the position of their vertex in the sorted list of
+  all vertices of the complex.
+
+  @param K        Simplicial complex
+  @param vertices Output parameter for the sorted list of all vertices,
+                  i.e. the vertex that corresponds to an index of the tree
+  @param sublevel Flag indicating whether sublevel sets (default) or
+                  superlevel sets are tracked
+
+  @throws std::runtime_error if an edge refers to a vertex that is not
+  part of the simplicial complex
+*/
+
+template <class Simplex>
+  MergeTree<typename Simplex::DataType, typename Simplex::VertexType>
+makeMergeTree( const SimplicialComplex<Simplex>& K,
+               std::vector<typename Simplex::VertexType>& vertices,
+               bool sublevel = true )
+{
+  using Data   = typename Simplex::DataType;
+  using Index  = typename Simplex::VertexType;
+  using Vertex = typename Simplex::VertexType;
+
+  std::vector< std::pair<Vertex, Data> > pairs;
+
+  for( auto&& s : K )
+    if( s.dimension() == 0 )
+      pairs.push_back( std::make_pair( *s.begin(), s.data() ) );
+
+  std::sort( pairs.begin(), pairs.end(),
+             [] ( const std::pair<Vertex, Data>& a, const std::pair<Vertex, Data>& b )
+             {
+               return a.first < b.first;
+             } );
+
+  auto n = pairs.size();
+
+  std::vector<Data> values( n );
+  vertices.resize( n );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    vertices[i] = pairs[i].first;
+    values[i]   = pairs[i].second;
+  }
+
+  auto lookup = [&vertices] ( Vertex v )
+  {
+    auto it = std::lower_bound( vertices.begin(), vertices.end(), v );
+
+    if( it == vertices.end() || *it != v )
+      throw std::runtime_error( "Edge refers to an unknown vertex" );
+
+    return Index( std::distance( vertices.begin(), it ) );
+  };
+
+  std::vector< std::pair<Index, Index> > edges;
+
+  for( auto&& s : K )
+  {
+    if( s.dimension() == 1 )
+    {
+      auto u = lookup( *( s.begin() ) );
+      auto v = lookup( *( s.begin() + 1 ) );
+
+      edges.push_back( std::make_pair( u, v ) );
+    }
+  }
+
+  std::vector<std::size_t> offsets( n + 1 );
+
+  for( auto&& edge : edges )
+  {
+    ++offsets[ static_cast<std::size_t>( edge.first )  + 1 ];
+    ++offsets[ static_cast<std::size_t>( edge.second ) + 1 ];
+  }
+
+  std::partial_sum( offsets.begin(), offsets.end(), offsets.begin() );
+
+  std::vector<Index> neighbours( offsets.back() );
+
+  {
+    auto positions = offsets;
+
+    for( auto&& edge : edges )
+    {
+      neighbours[ positions[ static_cast<std::size_t>( edge.first ) ]++ ]  = edge.second;
+      neighbours[ positions[ static_cast<std::size_t>( edge.second ) ]++ ] = edge.first;
+    }
+  }
+
+  return MergeTree<Data, Index>( std::move( values ), offsets, neighbours, sublevel );
+}
+
+/**
+  Calculates the augmented contour tree from the merge trees of the
+  sublevel and the superlevel sets of the same function, following
+
+    Computing Contour Trees in All Dimensions
+    Hamish Carr, Jack Snoeyink, and Ulrike Axen
+    Computational Geometry, Volume 24, Number 2, pp. 75--94, 2003
+
+  Leaves of either tree are removed repeatedly, and every removal adds
+  an arc to the contour tree. The result is only a tree if the domain
+  is simply connected; for other domains, the function still returns a
+  spanning forest of the vertices, but loops of the Reeb graph are lost.
+
+  @param split Merge tree of the sublevel sets
+  @param join  Merge tree of the superlevel sets
+
+  @returns Arcs of the contour tree, i.e. pairs of adjacent vertices,
+  where the first vertex of every arc is the removed leaf
+
+  @throws std::runtime_error if the trees do not describe the same
+  function
+*/
+
+template <class Data, class Index> std::vector< std::pair<Index, Index> > makeContourTree( const MergeTree<Data, Index>& split,
+                                                                                          const MergeTree<Data, Index>& join )
+{
+  auto n       = split.size();
+  auto invalid = MergeTree<Data, Index>::invalid();
+
+  if( !split.isSublevel() || join.isSublevel() || join.size() != n )
+    throw std::runtime_error( "Contour tree requires merge trees of sublevel and superlevel sets of the same function" );
+
+  // Every vertex stores the number of its remaining children in both of
+  // the trees, as well as the sum of their indices. Since leaves are only
+  // removed from a tree if they have a single child, the sum yields this
+  // child directly, without having to store any adjacency lists.
+  std::vector<Index> splitParents( n ), joinParents( n );
+  std::vector<Index> splitChildren( n ), joinChildren( n );
+  std::vector<std::size_t> splitSums( n ), joinSums( n );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    splitParents[i] = split.parent( Index( i ) );
+    joinParents[i]  = join.parent( Index( i ) );
+
+    if( splitParents[i] != invalid )
+    {
+      ++splitChildren[ static_cast<std::size_t>( splitParents[i] ) ];
+      splitSums[ static_cast<std::size_t>( splitParents[i] ) ] += i;
+    }
+
+    if( joinParents[i] != invalid )
+    {
+      ++joinChildren[ static_cast<std::size_t>( joinParents[i] ) ];
+      joinSums[ static_cast<std::size_t>( joinParents[i] ) ] += i;
+    }
+  }
+
+  // Removes a vertex with a single child from a tree by connecting the
+  // child to the parent of the vertex
+  auto splice = [&invalid] ( std::size_t v, std::vector<Index>& parents, std::vector<std::size_t>& sums )
+  {
+    auto child  = sums[v];
+    auto parent = parents[v];
+
+    parents[child] = parent;
+
+    if( parent != invalid )
+      sums[ static_cast<std::size_t>( parent ) ] += child - v;
+  };
+
+  std::vector<Index> leaves;
+
+  for( std::size_t i = 0; i < n; i++ )
+    if( splitChildren[i] + joinChildren[i] == 1 )
+      leaves.push_back( Index( i ) );
+
+  std::vector< std::pair<Index, Index> > arcs;
+  arcs.reserve( n );
+
+  while( !leaves.empty() )
+  {
+    auto x = static_cast<std::size_t>( leaves.back() );
+    leaves.pop_back();
+
+    // The vertex may have lost its last neighbour in the meantime
+    if( splitChildren[x] + joinChildren[x] != 1 )
+      continue;
+
+    std::size_t y = 0;
+
+    // Upper leaf, i.e. a maximum of the remaining tree: it is a leaf of
+    // the join tree and has a single child in the split tree.
+    if( joinChildren[x] == 0 )
+    {
+      y = static_cast<std::size_t>( joinParents[x] );
+
+      --joinChildren[y];
+      joinSums[y] -= x;
+
+      splice( x, splitParents, splitSums );
+    }
+
+    // Lower leaf
+    else
+    {
+      y = static_cast<std::size_t>( splitParents[x] );
+
+      --splitChildren[y];
+      splitSums[y] -= x;
+
+      splice( x, joinParents, joinSums );
+    }
+
+    splitChildren[x] = 0;
+    joinChildren[x]  = 0;
+
+    arcs.push_back( std::make_pair( Index( x ), Index( y ) ) );
+
+    if( splitChildren[y] + joinChildren[y] == 1 )
+      leaves.push_back( Index( y ) );
+  }
+
+  return arcs;
+}
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
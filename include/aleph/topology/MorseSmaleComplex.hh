@@ -1,117 +1,456 @@
 #ifndef ALEPH_TOPOLOGY_MORSE_SMALE_COMPLEX__
 #define ALEPH_TOPOLOGY_MORSE_SMALE_COMPLEX__
 
+#include <aleph/topology/IndexedMesh.hh>
+#include <aleph/topology/UnionFind.hh>
+
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-// TODO: Remove after debugging
-#include <iostream>
-
-#include <aleph/topology/UnionFind.hh>
-
 namespace aleph
 {
 
 namespace topology
 {
 
+/** Types of vertices of a piecewise linear function on a 2-manifold */
+enum class CriticalPointType : std::uint8_t
+{
+  Regular,
+  Minimum,
+  Maximum,
+  Saddle
+};
+
+namespace detail
+{
+
+/**
+  Visits all neighbours of a vertex in the order of its link. This is the
+  generic version for any mesh that is able to report the link of vertex.
+*/
+
+template <class Mesh, class Functor> void forEachNeighbour( const Mesh& M, typename Mesh::Index v, Functor&& functor )
+{
+  for( auto&& u : M.link( v ) )
+    functor( u );
+}
+
+/** Visits all neighbours of a vertex without allocating any memory */
+template <class Position, class Data, class Functor> void forEachNeighbour( const IndexedMesh<Position, Data>& M, typename IndexedMesh<Position, Data>::Index v, Functor&& functor )
+{
+  M.forEachNeighbour( v, std::forward<Functor>( functor ) );
+}
+
+/**
+  Counts the contiguous segments of the lower and the upper link of a
+  vertex. This is the generic version, which does not assume that links
+  are reported in order. Instead, it counts the edges between vertices
+  on the same side of the link: a segment with $k$ vertices has $k-1$
+  edges, unless it closes the link.
+
+  @returns Number of segments of the lower and the upper link
+*/
+
+template <class Mesh, class Predicate> std::pair<std::uint32_t, std::uint32_t> countLinkSegments( const Mesh& M, typename Mesh::Index, const std::vector<typename Mesh::Index>& link, Predicate&& isLower )
+{
+  std::uint32_t vertices[2] = { 0, 0 };
+  std::uint32_t edges[2]    = { 0, 0 };
+
+  for( std::size_t i = 0; i < link.size(); i++ )
+  {
+    bool side = isLower( link[i] );
+    ++vertices[side];
+
+    for( std::size_t j = i + 1; j < link.size(); j++ )
+      if( isLower( link[j] ) == side && M.hasEdge( link[i], link[j] ) )
+        ++edges[side];
+  }
+
+  auto segments = [&vertices, &edges] ( bool side ) -> std::uint32_t
+  {
+    if( vertices[side] == 0 )
+      return 0;
+    else if( edges[side] >= vertices[side] )
+      return 1;
+    else
+      return vertices[side] - edges[side];
+  };
+
+  return std::make_pair( segments( true ), segments( false ) );
+}
+
+/**
+  Counts the contiguous segments of the lower and the upper link of a
+  vertex by a single traversal of the link, which is ordered and open at
+  the boundary of the mesh.
+*/
+
+template <class Position, class Data, class Predicate> std::pair<std::uint32_t, std::uint32_t> countLinkSegments( const IndexedMesh<Position, Data>& M, typename IndexedMesh<Position, Data>::Index v, const std::vector<typename IndexedMesh<Position, Data>::Index>& link, Predicate&& isLower )
+{
+  std::uint32_t nl = 0;
+  std::uint32_t nu = 0;
+
+  bool closed = !M.isBoundary( v );
+
+  // Every change from the upper to the lower link starts a new lower
+  // segment, and vice versa. Open links additionally start with one
+  // segment of their own.
+  for( std::size_t j = 0; j < link.size(); j++ )
+  {
+    bool lower = isLower( link[j] );
+
+    if( j == 0 && !closed )
+      ++( lower ? nl : nu );
+    else if( isLower( j > 0 ? link[j-1] : link.back() ) != lower )
+      ++( lower ? nl : nu );
+  }
+
+  // A closed link that does not change at all consists of a single
+  // segment.
+  if( closed && nl == 0 && nu == 0 && !link.empty() )
+    ++( isLower( link.front() ) ? nl : nu );
+
+  return std::make_pair( nl, nu );
+}
+
+} // namespace detail
+
+/**
+  @class MorseSmaleComplex
+  @brief Critical points and Morse--Smale segmentation of a scalar field
+
+  Calculates the critical points of a piecewise linear function that is
+  defined on the vertices of a two-dimensional mesh, as well as the
+  ascending manifolds of all minima and the descending manifolds of all
+  maxima. Every step is carried out in parallel over all vertices:
+
+  - Vertices are classified by counting the contiguous segments of their
+    lower and their upper link.
+  - Every vertex points to its lowest (highest) neighbour. The manifolds
+    are obtained by pointer jumping, i.e. by repeatedly replacing every
+    pointer by the pointer of its target, which requires a logarithmic
+    number of rounds only.
+
+  Ties in function values are resolved by vertex index, so that every
+  vertex is either lower or higher than any of its neighbours. Vertices
+  must be indexed contiguously, starting from zero. This is always the
+  case for IndexedMesh, which is the recommended mesh class here.
+
+  Optionally, the segmentation may be simplified by persistence: every
+  extremum whose persistence is below a given threshold is cancelled and
+  its manifold is merged into the one of the extremum it is paired with.
+*/
+
 template <class Mesh> class MorseSmaleComplex
 {
 public:
-  void operator()( const Mesh& M )
+  using Index = typename Mesh::Index;
+  using Data  = typename std::decay<decltype( std::declval<const Mesh&>().data( Index() ) )>::type;
+
+  /** Per-vertex classification */
+  struct CriticalPoints
   {
-    std::cerr << "\n";
+    std::vector<CriticalPointType> types;
 
-    auto&& vertices = M.vertices();
+    /**
+      Multiplicity of every saddle, i.e. the number of lower link segments
+      minus one; a monkey saddle has multiplicity two. The entry is zero for
+      vertices that are not saddles.
+    */
 
-    for( auto&& vertex : vertices )
-    {
-      auto higherNeigbours = M.getHigherNeighbours( vertex );
-      auto lowerNeighbours = M.getLowerNeighbours( vertex );
+    std::vector<std::uint32_t> multiplicities;
+  };
+
+  /** Per-vertex labels of the Morse--Smale segmentation */
+  struct Segmentation
+  {
+    std::vector<Index> ascending;  // Minimum whose ascending manifold contains the vertex
+    std::vector<Index> descending; // Maximum whose descending manifold contains the vertex
+  };
+
+  /**
+    Creates a new calculation engine.
+
+    @param threshold Persistence threshold for simplifying the segmentation;
+                     extrema with smaller persistence are cancelled. The
+                     default value does not simplify anything.
+  */
+
+  explicit MorseSmaleComplex( Data threshold = Data() )
+    : _threshold( threshold )
+  {
+  }
 
-      std::size_t nl = 0;
-      std::size_t nu = 0;
+  /** Classifies all vertices and calculates the segmentation */
+  std::pair<CriticalPoints, Segmentation> operator()( const Mesh& M ) const
+  {
+    return std::make_pair( classify( M ), this->segment( M ) );
+  }
 
-      std::tie( nl, nu ) = contiguousSegments( M, vertex );
+  /**
+    Classifies all vertices of a mesh by counting the contiguous segments
+    in their lower and upper link. Vertices are processed in parallel, so
+    the mesh must support concurrent queries.
+  */
+
+  static CriticalPoints classify( const Mesh& M )
+  {
+    auto n = checkVertices( M );
 
-      std::cerr << "[" << vertex << "]: ";
+    CriticalPoints result;
+    result.types.resize( n );
+    result.multiplicities.resize( n );
 
-      if( higherNeigbours.empty() )
-        std::cerr << "Maximum\n";
-      else if( lowerNeighbours.empty() )
-        std::cerr << "Minimum\n";
-      else
+    #pragma omp parallel
+    {
+      std::vector<Index> link;
+
+      #pragma omp for schedule(dynamic, 1024)
+      for( std::size_t i = 0; i < n; i++ )
       {
-        std::cerr << "Saddle\n";
-        std::cerr << "  +: ";
-        for( auto&& n : higherNeigbours )
-          std::cerr << n << " " ;
-        std::cerr << "\n";
-
-        std::cerr << "  -: ";
-        for( auto&& n : lowerNeighbours )
-          std::cerr << n << " " ;
-        std::cerr << "\n";
+        auto v = Index( i );
+
+        link.clear();
+        detail::forEachNeighbour( M, v, [&link] ( Index u ) { link.push_back( u ); } );
+
+        if( link.empty() )
+        {
+          result.types[i] = CriticalPointType::Regular;
+          continue;
+        }
+
+        std::uint32_t nl = 0;
+        std::uint32_t nu = 0;
+
+        std::tie( nl, nu ) = detail::countLinkSegments( M, v, link, [&M, &v] ( Index u ) { return isLower( M, u, v ); } );
+
+        if( nl == 0 )
+          result.types[i] = CriticalPointType::Minimum;
+        else if( nu == 0 )
+          result.types[i] = CriticalPointType::Maximum;
+        else if( nl > 1 || nu > 1 )
+        {
+          result.types[i]          = CriticalPointType::Saddle;
+          result.multiplicities[i] = std::max( nl, nu ) - 1;
+        }
+        else
+          result.types[i] = CriticalPointType::Regular;
       }
+    }
 
-      std::cerr << "  nl: " << nl << "\n"
-                << "  nu: " << nu << "\n\n";
+    return result;
+  }
 
+  /**
+    Calculates the ascending manifolds of all minima and the descending
+    manifolds of all maxima, and simplifies them if a threshold has been
+    specified.
+  */
+
+  Segmentation segment( const Mesh& M ) const
+  {
+    checkVertices( M );
+
+    auto lower  = [&M] ( Index u, Index v ) { return isLower( M, u, v ); };
+    auto higher = [&M] ( Index u, Index v ) { return isLower( M, v, u ); };
+
+    Segmentation result;
+    result.ascending  = manifolds( M, lower );
+    result.descending = manifolds( M, higher );
+
+    if( _threshold > Data() )
+    {
+      simplify( M, lower,  result.ascending,  _threshold );
+      simplify( M, higher, result.descending, _threshold );
     }
+
+    return result;
   }
+
 private:
 
+  /** Checks that vertices are indexed contiguously and returns their number */
+  static std::size_t checkVertices( const Mesh& M )
+  {
+    auto n = M.numVertices();
+
+    for( auto&& v : M.vertices() )
+      if( static_cast<std::size_t>( v ) >= n )
+        throw std::runtime_error( "Vertex indices must be contiguous" );
+
+    return n;
+  }
+
+  /** Order of vertices, using vertex indices to resolve ties */
+  static bool isLower( const Mesh& M, Index u, Index v )
+  {
+    auto a = M.data( u );
+    auto b = M.data( v );
+
+    return a < b || ( !( b < a ) && u < v );
+  }
+
   /**
-    Calculates the number of contiguous segments in the link of
-    a vertex, with respect to the given mesh.
+    Calculates the manifolds of all extrema with respect to the given
+    order: every vertex is labelled with the extremum that is reached by
+    following the steepest path along the order.
   */
 
-  static std::pair<std::size_t, std::size_t> contiguousSegments( const Mesh& M, typename Mesh::Index id )
+  template <class Order> static std::vector<Index> manifolds( const Mesh& M, Order&& order )
   {
-    using Index = typename Mesh::Index;
+    auto n = M.numVertices();
 
-    auto data = M.data(id);
-    auto link = M.link(id);
+    std::vector<Index> pointers( n );
 
-    std::vector<Index> upperLink;
-    std::vector<Index> lowerLink;
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      auto v        = Index( i );
+      auto steepest = v;
 
-    std::copy_if( link.begin(), link.end(), std::back_inserter( upperLink ), [&data, &M] ( Index& u ) { return M.data(u) >= data; } );
-    std::copy_if( link.begin(), link.end(), std::back_inserter( lowerLink ), [&data, &M] ( Index& u ) { return M.data(u) <= data; } );
+      detail::forEachNeighbour( M, v, [&steepest, &order] ( Index u )
+                                      {
+                                        if( order( u, steepest ) )
+                                          steepest = u;
+                                      } );
 
-    auto&& numConnectedComponents = [&M, &id] ( const std::vector<Index>& link )
+      pointers[i] = steepest;
+    }
+
+    // Pointer jumping: every round halves the length of the remaining
+    // paths, so the number of rounds is logarithmic in the length of the
+    // longest steepest path.
+    std::vector<Index> next( n );
+
+    bool changed = true;
+    while( changed )
     {
-      auto curr = link.begin();
-      auto next = std::next( curr );
+      changed = false;
+
+      #pragma omp parallel for reduction(||:changed)
+      for( std::size_t i = 0; i < n; i++ )
+      {
+        auto p  = pointers[i];
+        next[i] = pointers[ static_cast<std::size_t>( p ) ];
 
-      UnionFind<Index> uf( link.begin(), link.end() );
+        if( next[i] != p )
+          changed = true;
+      }
+
+      pointers.swap( next );
+    }
 
-      for( ; curr != link.end(); )
+    return pointers;
+  }
+
+  /**
+    Simplifies manifolds by persistence. Vertices are processed along the
+    order while tracking the connected components of the sub-level (or
+    super-level) sets. When two components meet, the younger extremum is
+    cancelled if its persistence is below the threshold, and its manifold
+    is merged into the one of the older extremum.
+
+    Since every vertex is connected to its extremum by a steepest path,
+    it suffices to track the components of the extrema. Moreover, only
+    vertices with a neighbour in a different manifold are able to merge
+    two components, so all other vertices are skipped.
+  */
+
+  template <class Order> static void simplify( const Mesh& M, Order&& order, std::vector<Index>& labels, Data threshold )
+  {
+    auto n = M.numVertices();
+
+    std::vector<Index> vertices;
+
+    #pragma omp parallel
+    {
+      std::vector<Index> candidates;
+
+      #pragma omp for schedule(dynamic, 1024) nowait
+      for( std::size_t i = 0; i < n; i++ )
       {
-        if( next == link.end() )
-          next = link.begin();
+        auto v        = Index( i );
+        bool boundary = false;
+
+        detail::forEachNeighbour( M, v, [&] ( Index u )
+                                        {
+                                          boundary = boundary || labels[ static_cast<std::size_t>( u ) ] != labels[i];
+                                        } );
+
+        if( boundary )
+          candidates.push_back( v );
+      }
+
+      #pragma omp critical
+      vertices.insert( vertices.end(), candidates.begin(), candidates.end() );
+    }
+
+    std::sort( vertices.begin(), vertices.end(), order );
+
+    // The root of every component is its oldest extremum because merges
+    // are always directed towards the older extremum.
+    DenseUnionFind<Index> uf( n );
 
-        auto u    = id;
-        auto v    = *curr++;
-        auto w    = *next++;
+    std::vector<Index> targets( n );
+    for( std::size_t i = 0; i < n; i++ )
+      targets[i] = Index( i );
 
-        if( M.hasEdge(u,v) )
+    std::vector<Index> cancelled;
+
+    for( auto&& v : vertices )
+    {
+      detail::forEachNeighbour( M, v, [&] ( Index u )
+      {
+        if( !order( u, v ) )
+          return;
+
+        auto ru = uf.find( labels[ static_cast<std::size_t>( u ) ] );
+        auto rv = uf.find( labels[ static_cast<std::size_t>( v ) ] );
+
+        if( ru == rv )
+          return;
+
+        auto older   = order( ru, rv ) ? ru : rv;
+        auto younger = older == ru ? rv : ru;
+
+        auto a = M.data( v );
+        auto b = M.data( younger );
+
+        Data persistence = a < b ? b - a : a - b;
+
+        if( persistence < threshold )
         {
-          if( M.hasEdge(v,w) )
-            uf.merge(v,w);
+          targets[ static_cast<std::size_t>( younger ) ] = older;
+          cancelled.push_back( younger );
         }
-        else
-          throw std::runtime_error( "Edge to link centre vertex does not exist" );
-      }
 
-      std::vector<Index> roots;
-      uf.roots( std::back_inserter(roots) );
+        uf.merge( younger, older );
+      } );
+    }
+
+    // Older extrema are visited first, so every target has already been
+    // resolved when it is being used.
+    std::sort( cancelled.begin(), cancelled.end(), order );
 
-      return roots.size();
-    };
+    for( auto&& v : cancelled )
+    {
+      auto i = static_cast<std::size_t>( v );
+      targets[i] = targets[ static_cast<std::size_t>( targets[i] ) ];
+    }
 
-    return std::make_pair( numConnectedComponents( lowerLink ), numConnectedComponents( upperLink ) );
+    #pragma omp parallel for
+    for( std::size_t i = 0; i < n; i++ )
+      labels[i] = targets[ static_cast<std::size_t>( labels[i] ) ];
   }
+
+  Data _threshold;
 };
 
 } // namespace topology
@@ -19,18 +19,18 @@ namespace topology
 /**
   Generates an Erdős--Rényi graph with n vertices and a link probability
   of p. Note that the graph will be returned as an unweighted simplicial
-  complex.
+  complex. The seed of the random number generator may be specified in
+  order to obtain reproducible graphs.
 */
 
-auto generateErdosRenyiGraph( unsigned n, double p ) -> SimplicialComplex< Simplex<short, unsigned> >
+auto generateErdosRenyiGraph( unsigned n, double p, unsigned seed ) -> SimplicialComplex< Simplex<short, unsigned> >
 {
   using S = Simplex<short, unsigned>;
   using K = SimplicialComplex<S>;
 
   std::vector<S> simplices;
 
-  std::random_device rd;
-  std::mt19937 mt( rd() );
+  std::mt19937 mt( seed );
   std::uniform_real_distribution<> distribution( 0.0, 1.0 );
 
   for( unsigned i = 0; i < n; i++ )
@@ -44,22 +44,28 @@ auto generateErdosRenyiGraph( unsigned n, double p ) -> SimplicialComplex< Simpl
   return K( simplices.begin(), simplices.end() );
 }
 
+auto generateErdosRenyiGraph( unsigned n, double p ) -> SimplicialComplex< Simplex<short, unsigned> >
+{
+  std::random_device rd;
+  return generateErdosRenyiGraph( n, p, rd() );
+}
+
 /**
   Generates a weighted random graph with n vertices and a link
   probability of p. In contrast to Erdős--Rényi graphs, here a
   weight is assigned according to a number of Bernoulli trials
-  with success probability p.
+  with success probability p. The seed of the random number generator
+  may be specified in order to obtain reproducible graphs.
 */
 
-auto generateWeightedRandomGraph( unsigned n, double p ) -> SimplicialComplex< Simplex<unsigned, unsigned> >
+auto generateWeightedRandomGraph( unsigned n, double p, unsigned seed ) -> SimplicialComplex< Simplex<unsigned, unsigned> >
 {
   using S = Simplex<unsigned, unsigned>;
   using K = SimplicialComplex<S>;
 
   std::vector<S> simplices;
 
-  std::random_device rd;
-  std::mt19937 mt( rd() );
+  std::mt19937 mt( seed );
   std::uniform_real_distribution<> distribution( 0.0, 1.0 );
 
   for( unsigned i = 0; i < n; i++ )
@@ -87,6 +93,12 @@ auto generateWeightedRandomGraph( unsigned n, double p ) -> SimplicialComplex< S
 
 }
 
+auto generateWeightedRandomGraph( unsigned n, double p ) -> SimplicialComplex< Simplex<unsigned, unsigned> >
+{
+  std::random_device rd;
+  return generateWeightedRandomGraph( n, p, rd() );
+}
+
 } // namespace topology
 
 } // namespace aleph
@@ -7,6 +7,7 @@
 #include <boost/iterator/filter_iterator.hpp>
 
 #include <algorithm>
+#include <functional>
 #include <initializer_list>
 #include <iosfwd>
 #include <stdexcept>
@@ -425,10 +426,10 @@ private:
     // return all vertices that are _not_ equal to its current position.
 
     vertex_container_type vertices(
-          boost::make_filter_iterator( std::bind2nd( std::not_equal_to<vertex_type>(), *( this->base() ) ),
+          boost::make_filter_iterator( std::bind( std::not_equal_to<vertex_type>(), std::placeholders::_1, *( this->base() ) ),
                                                      _vertices.begin(),
                                                      _vertices.end() ),
-          boost::make_filter_iterator( std::bind2nd( std::not_equal_to<vertex_type>(), *( this->base() ) ),
+          boost::make_filter_iterator( std::bind( std::not_equal_to<vertex_type>(), std::placeholders::_1, *( this->base() ) ),
                                                      _vertices.end(),
                                                      _vertices.end() )
           );
@@ -8,7 +8,11 @@
 #include <boost/multi_index/ordered_index.hpp>
 #include <boost/multi_index/random_access_index.hpp>
 
+#include <aleph/utilities/RadixSort.hh>
+
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
@@ -24,6 +28,38 @@ namespace aleph
 namespace topology
 {
 
+namespace detail
+{
+
+/** Unwraps comparison functors that are passed via std::ref() */
+template <class T> struct Unwrap
+{
+  using type = T;
+  static const T& get( const T& t ) { return t; }
+};
+
+template <class T> struct Unwrap< std::reference_wrapper<T> >
+{
+  using type = T;
+  static const T& get( const std::reference_wrapper<T>& t ) { return t.get(); }
+};
+
+/**
+  Checks whether a filtration functor is able to calculate a key for
+  every simplex, which permits sorting simplices without comparisons.
+*/
+
+template <class Filtration, class Simplex> class HasKey
+{
+  template <class F> static auto test( int ) -> decltype( std::declval<const F&>().key( std::declval<const Simplex&>() ), std::true_type() );
+  template <class F> static std::false_type test( ... );
+
+public:
+  static constexpr bool value = decltype( test<Filtration>( 0 ) )::value;
+};
+
+} // namespace detail
+
 template <class Simplex> class SimplicialComplex
 {
 public:
@@ -444,13 +480,19 @@ public:
     function as its input.
 
     See the aleph::topology::filtrations namespace for admissible functors.
+    If a functor is able to calculate a key for every simplex, the keys are
+    calculated in parallel and sorted by a radix sort, which only requires
+    rearranging the simplices once. Else, the comparison is used directly.
 
     @param comparison Simplex comparison object (or function)
   */
 
   template <class Comparison> void sort( Comparison&& comparison )
   {
-    _simplices.sort( std::ref( comparison ) );
+    using Unwrap     = detail::Unwrap< typename std::decay<Comparison>::type >;
+    using Filtration = typename Unwrap::type;
+
+    this->sort( std::forward<Comparison>( comparison ), std::integral_constant<bool, detail::HasKey<Filtration, Simplex>::value>() );
   }
 
   /** Sorts simplices according to their builtin comparison function */
@@ -695,6 +737,89 @@ private:
     }
   }
 
+  /**
+    Sorts simplices by a comparison functor. The functor is used by
+    reference, so its call operator does not have to be const, and
+    any state it keeps is visible to the caller afterwards.
+  */
+
+  template <class Comparison> void sort( Comparison&& comparison, std::false_type )
+  {
+    _simplices.sort( std::ref( comparison ) );
+  }
+
+  /**
+    Sorts simplices by the keys of a filtration functor. Ties in keys are
+    broken by dimension, if the functor requires this, and afterwards by
+    the lexicographical order of simplices. Keys usually have few ties,
+    so these criteria are only evaluated for simplices with equal keys.
+  */
+
+  template <class Comparison> void sort( Comparison&& comparison, std::true_type )
+  {
+    using Unwrap     = detail::Unwrap< typename std::decay<Comparison>::type >;
+    using Filtration = typename Unwrap::type;
+
+    auto&& filtration = Unwrap::get( comparison );
+    auto&& simplices  = _simplices.template get<index_t>();
+
+    auto n = simplices.size();
+
+    std::vector< std::pair<std::uint64_t, std::size_t> > order( n );
+
+    #pragma omp parallel for
+    for( std::size_t i = 0; i < n; i++ )
+      order[i] = std::make_pair( filtration.key( simplices[i] ), i );
+
+    {
+      decltype(order) buffer;
+      utilities::radixSort( order, buffer );
+    }
+
+    // Ranges of simplices with the same key
+    std::vector<std::size_t> ties;
+
+    for( std::size_t i = 0, j = 0; i < n; i = j )
+    {
+      for( j = i + 1; j < n && order[j].first == order[i].first; j++ )
+      {
+      }
+
+      if( j - i > 1 )
+      {
+        ties.push_back( i );
+        ties.push_back( j );
+      }
+    }
+
+    auto precedes = [&simplices] ( const std::pair<std::uint64_t, std::size_t>& a, const std::pair<std::uint64_t, std::size_t>& b )
+    {
+      auto&& s = simplices[ a.second ];
+      auto&& t = simplices[ b.second ];
+
+      if( Filtration::breaksTiesByDimension && s.dimension() != t.dimension() )
+        return s.dimension() < t.dimension();
+
+      return s < t;
+    };
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for( std::size_t k = 0; k < ties.size() / 2; k++ )
+    {
+      std::sort( order.begin() + static_cast<std::ptrdiff_t>( ties[2*k] ),
+                 order.begin() + static_cast<std::ptrdiff_t>( ties[2*k+1] ),
+                 precedes );
+    }
+
+    std::vector< std::reference_wrapper<const Simplex> > view;
+    view.reserve( n );
+
+    for( auto&& pair : order )
+      view.push_back( std::cref( simplices[ pair.second ] ) );
+
+    _simplices.rearrange( view.begin() );
+  }
+
   /**
     Checks validity of a single simplex. A simplex in the simplicial complex is
     deemed valid if all of its faces can be found in the complex.
@@ -2,6 +2,8 @@
 #define ALEPH_TOPOLOGY_UNION_FIND_HH__
 
 #include <algorithm>
+#include <numeric>
+#include <vector>
 
 #include <unordered_map>
 #include <unordered_set>
@@ -111,6 +113,90 @@ private:
   std::unordered_map<Vertex, Vertex> _parent;
 };
 
+/**
+  @class DenseUnionFind
+  @brief Union--Find data structure for contiguous indices
+
+  This variant of the Union--Find data structure assumes that all items
+  are the indices $0, 1, \dots, n-1$. It stores the parent relationship
+  in a single contiguous array instead of a hash map, which makes it the
+  preferred choice for large graphs whose vertices have been renumbered
+  by the client.
+
+  The semantics of all operations are identical to the ones of the usual
+  UnionFind class. In particular, merging is directional.
+*/
+
+template <class Index> class DenseUnionFind
+{
+public:
+
+  /**
+    Creates a new Union--Find data structure for $n$ items. Initially,
+    every item is its own parent.
+  */
+
+  explicit DenseUnionFind( std::size_t n )
+    : _parent( n )
+  {
+    std::iota( _parent.begin(), _parent.end(), Index(0) );
+  }
+
+  /**
+    Merges a given index $u$ into the set corresponding to index $v$. Note
+    that the merge is directional.
+  */
+
+  void merge( Index u, Index v ) noexcept
+  {
+    if( u != v )
+      _parent[ static_cast<std::size_t>( this->find( u ) ) ] = this->find( v );
+  }
+
+  /**
+    Finds the parent of a given index. Uses path halving, which does not
+    require any recursion and is thus safe for very long paths.
+  */
+
+  Index find( Index u ) noexcept
+  {
+    auto i = static_cast<std::size_t>( u );
+
+    while( _parent[i] != Index( i ) )
+    {
+      _parent[i] = _parent[ static_cast<std::size_t>( _parent[i] ) ];
+      i          = static_cast<std::size_t>( _parent[i] );
+    }
+
+    return Index( i );
+  }
+
+  /**
+    Enumerates all roots, i.e. all sets that have themselves as a parent
+    index, and stores it using an output iterator. In contrast to the
+    usual UnionFind class, roots are guaranteed to appear in ascending
+    order.
+  */
+
+  template <class OutputIterator> void roots( OutputIterator result ) const
+  {
+    for( std::size_t i = 0; i < _parent.size(); i++ )
+      if( _parent[i] == Index( i ) )
+        *result++ = Index( i );
+  }
+
+  /** @returns Number of items stored in the data structure */
+  std::size_t size() const noexcept
+  {
+    return _parent.size();
+  }
+
+private:
+
+  /** Stores the usual parent--child relationship */
+  std::vector<Index> _parent;
+};
+
 } // namespace topology
 
 } // namespace aleph
@@ -1,7 +1,11 @@
 #ifndef ALEPH_TOPOLOGY_FILTRATIONS_DATA_HH__
 #define ALEPH_TOPOLOGY_FILTRATIONS_DATA_HH__
 
+#include <aleph/utilities/RadixSort.hh>
+
+#include <cstdint>
 #include <functional>
+#include <type_traits>
 
 namespace aleph
 {
@@ -35,6 +39,33 @@ public:
     else
       return Compare()( s.data(), t.data() );
   }
+
+  /**
+    Ties in the data of simplices are broken by their dimension before
+    using the lexicographical order. This is used by keys below.
+  */
+
+  static constexpr bool breaksTiesByDimension = true;
+
+  /**
+    Calculates a key for the data of a simplex whose order is the same
+    as the one of the comparison functor. This permits sorting simplices
+    without comparisons. Keys are only available for the standard order
+    and its reverse.
+
+    @see SimplicialComplex::sort()
+  */
+
+  template <class C = Compare> typename std::enable_if<
+       std::is_arithmetic<typename Simplex::DataType>::value
+    && (    std::is_same< C, std::less<typename Simplex::DataType> >::value
+         || std::is_same< C, std::greater<typename Simplex::DataType> >::value ),
+    std::uint64_t
+  >::type key( const Simplex& s ) const
+  {
+    auto key = utilities::radixKey( s.data() );
+    return std::is_same< C, std::greater<typename Simplex::DataType> >::value ? ~key : key;
+  }
 };
 
 } // namespace filtrations
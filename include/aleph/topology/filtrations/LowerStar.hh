@@ -1,6 +1,9 @@
 #ifndef ALEPH_TOPOLOGY_LOWER_STAR_HH__
 #define ALEPH_TOPOLOGY_LOWER_STAR_HH__
 
+#include <aleph/utilities/RadixSort.hh>
+
+#include <cstdint>
 #include <limits>
 #include <vector>
 
@@ -85,6 +88,27 @@ public:
       return false;
   }
 
+  /**
+    Ties in function values are broken by the lexicographical order only,
+    which already ensures that faces precede cofaces.
+  */
+
+  static constexpr bool breaksTiesByDimension = false;
+
+  /**
+    Calculates a key for the maximum function value of a simplex whose
+    order is the same as the one of the comparison operator. This permits
+    sorting simplices without comparisons, each of which would calculate
+    the maximum value of two simplices again.
+
+    @see SimplicialComplex::sort()
+  */
+
+  std::uint64_t key( const Simplex& s ) const
+  {
+    return utilities::radixKey( this->maximumValue( s ) );
+  }
+
   /**
     Given a simplex, determines its maximum function value and returns the
     value.
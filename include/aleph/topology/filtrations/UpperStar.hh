@@ -1,6 +1,9 @@
 #ifndef ALEPH_TOPOLOGY_UPPER_STAR_HH__
 #define ALEPH_TOPOLOGY_UPPER_STAR_HH__
 
+#include <aleph/utilities/RadixSort.hh>
+
+#include <cstdint>
 #include <limits>
 #include <vector>
 
@@ -73,6 +76,15 @@ public:
       return false;
   }
 
+  /** @see LowerStar::breaksTiesByDimension */
+  static constexpr bool breaksTiesByDimension = false;
+
+  /** @see LowerStar::key() */
+  std::uint64_t key( const Simplex& s ) const
+  {
+    return ~utilities::radixKey( this->minimumValue( s ) );
+  }
+
   /**
     Given a simplex, determines its minimum function value and returns the
     value.
@@ -0,0 +1,762 @@
+#ifndef ALEPH_TOPOLOGY_IO_BINARY_FILTRATION_HH__
+#define ALEPH_TOPOLOGY_IO_BINARY_FILTRATION_HH__
+
+#include <aleph/topology/BoundaryMatrix.hh>
+
+#include <aleph/topology/io/Volume.hh>
+
+#include <aleph/topology/representations/Mapped.hh>
+
+#include <aleph/utilities/Instrumentation.hh>
+#include <aleph/utilities/MemoryMappedFile.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+namespace io
+{
+
+namespace detail
+{
+
+/*
+  Header of a binary filtration file. All fields and all sections are
+  stored in the byte order of the machine that wrote the file, which is
+  detected by means of the byte order mark. Every section starts at an
+  offset that is a multiple of eight bytes.
+*/
+
+struct BinaryFiltrationHeader
+{
+  char          magic[8];         // "ALEPHBF" followed by a null byte
+  std::uint32_t byteOrder;        // 0x01020304 in the byte order of the file
+  std::uint32_t version;          // Version of the format
+  std::uint32_t flags;            // Combination of BinaryFiltrationFlags
+  std::uint8_t  vertexType;       // Scalar type of simplex vertices
+  std::uint8_t  indexType;        // Scalar type of row indices of the boundary matrix
+  std::uint8_t  dataType;         // Scalar type of data values
+  std::uint8_t  reserved;
+  std::uint64_t numSimplices;     // Number of simplices or columns
+  std::uint64_t sections[5][2];   // Offset and size of every section in bytes
+};
+
+static_assert( sizeof(BinaryFiltrationHeader) == 112, "Unexpected padding in header" );
+
+enum BinaryFiltrationFlags : std::uint32_t
+{
+  HasSimplices      = 1,
+  HasData           = 2,
+  HasBoundaryMatrix = 4,
+  Compressed        = 8
+};
+
+enum BinaryFiltrationSection : std::size_t
+{
+  SimplexOffsets = 0, // Offset of every simplex in the vertex array (uint64)
+  Vertices       = 1, // Vertices of all simplices
+  Data           = 2, // Data values of all simplices
+  ColumnOffsets  = 3, // Offset of every column in the row index array (uint64)
+  RowIndices     = 4  // Row indices of all columns
+};
+
+static const char          BinaryFiltrationMagic[8]   = { 'A', 'L', 'E', 'P', 'H', 'B', 'F', '\0' };
+static const std::uint32_t BinaryFiltrationByteOrder  = 0x01020304;
+static const std::uint32_t BinaryFiltrationVersion    = 1;
+static const std::size_t   BinaryFiltrationBlockSize  = 1 << 16;
+
+// Compression ---------------------------------------------------------
+//
+// Integer sections may be compressed by block-wise delta coding: every
+// value is replaced by its difference to the previous value in the same
+// block, mapped to an unsigned integer (zig-zag coding), and stored as a
+// variable-length integer of seven bits per byte. Offsets and indices
+// thus shrink to one or two bytes per entry in most cases. Blocks are
+// independent of each other, so they are encoded and decoded in parallel.
+//
+// A compressed section consists of the number of values, the number of
+// blocks, the byte offsets of all blocks, followed by the blocks.
+
+template <class T> std::vector<unsigned char> encodeBlocks( const T* values, std::size_t n )
+{
+  auto numBlocks = ( n + BinaryFiltrationBlockSize - 1 ) / BinaryFiltrationBlockSize;
+
+  std::vector< std::vector<unsigned char> > blocks( numBlocks );
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for( std::size_t b = 0; b < numBlocks; b++ )
+  {
+    auto begin = b * BinaryFiltrationBlockSize;
+    auto end   = std::min( n, begin + BinaryFiltrationBlockSize );
+
+    auto&& block      = blocks[b];
+    std::uint64_t last = 0;
+
+    block.reserve( 2 * ( end - begin ) );
+
+    for( auto i = begin; i < end; i++ )
+    {
+      auto value = static_cast<std::uint64_t>( values[i] );
+      auto delta = value - last;
+      last       = value;
+
+      // Zig-zag coding of the difference, interpreted as a signed value
+      auto zigzag = ( delta << 1 ) ^ ( ( delta >> 63 ) ? ~std::uint64_t(0) : std::uint64_t(0) );
+
+      while( zigzag >= 0x80 )
+      {
+        block.push_back( static_cast<unsigned char>( zigzag | 0x80 ) );
+        zigzag >>= 7;
+      }
+
+      block.push_back( static_cast<unsigned char>( zigzag ) );
+    }
+  }
+
+  std::vector<std::uint64_t> header( 2 + numBlocks + 1 );
+  header[0] = n;
+  header[1] = numBlocks;
+
+  for( std::size_t b = 0; b < numBlocks; b++ )
+    header[ 2 + b + 1 ] = header[ 2 + b ] + blocks[b].size();
+
+  std::vector<unsigned char> result( header.size() * sizeof(std::uint64_t) + header.back() );
+  std::memcpy( result.data(), header.data(), header.size() * sizeof(std::uint64_t) );
+
+  auto data = result.data() + header.size() * sizeof(std::uint64_t);
+
+  #pragma omp parallel for
+  for( std::size_t b = 0; b < numBlocks; b++ )
+    std::copy( blocks[b].begin(), blocks[b].end(), data + header[ 2 + b ] );
+
+  return result;
+}
+
+template <class T> void decodeBlocks( const unsigned char* source, std::size_t size, bool swap, T* values, std::size_t n )
+{
+  auto readHeader = [&source, &size, &swap] ( std::size_t i )
+  {
+    if( ( i + 1 ) * sizeof(std::uint64_t) > size )
+      throw std::runtime_error( "Format error: Truncated compressed section" );
+
+    return readScalar<std::uint64_t>( source + i * sizeof(std::uint64_t), ScalarType::UInt64, swap );
+  };
+
+  auto numValues = readHeader( 0 );
+  auto numBlocks = readHeader( 1 );
+
+  if( numValues != n || numBlocks != ( n + BinaryFiltrationBlockSize - 1 ) / BinaryFiltrationBlockSize )
+    throw std::runtime_error( "Format error: Unexpected number of values in compressed section" );
+
+  std::vector<std::uint64_t> offsets( numBlocks + 1 );
+  for( std::size_t b = 0; b <= numBlocks; b++ )
+    offsets[b] = readHeader( 2 + b );
+
+  auto data     = source + ( 2 + numBlocks + 1 ) * sizeof(std::uint64_t);
+  auto dataSize = size - ( 2 + numBlocks + 1 ) * sizeof(std::uint64_t);
+
+  bool invalid = offsets.back() > dataSize;
+
+  #pragma omp parallel for schedule(dynamic, 1) reduction(||:invalid)
+  for( std::size_t b = 0; b < numBlocks; b++ )
+  {
+    if( invalid || offsets[b] > offsets[b+1] || offsets[b+1] > dataSize )
+    {
+      invalid = true;
+      continue;
+    }
+
+    auto begin = b * BinaryFiltrationBlockSize;
+    auto end   = std::min( n, begin + BinaryFiltrationBlockSize );
+
+    auto p             = data + offsets[b];
+    auto q             = data + offsets[b+1];
+    std::uint64_t last = 0;
+
+    for( auto i = begin; i < end && !invalid; i++ )
+    {
+      std::uint64_t zigzag = 0;
+      unsigned shift       = 0;
+
+      while( true )
+      {
+        if( p == q || shift > 63 )
+        {
+          invalid = true;
+          break;
+        }
+
+        auto byte = *p++;
+        zigzag   |= static_cast<std::uint64_t>( byte & 0x7F ) << shift;
+        shift    += 7;
+
+        if( ( byte & 0x80 ) == 0 )
+          break;
+      }
+
+      auto delta = ( zigzag >> 1 ) ^ ( ( zigzag & 1 ) ? ~std::uint64_t(0) : std::uint64_t(0) );
+      last      += delta;
+      values[i]  = static_cast<T>( last );
+    }
+  }
+
+  if( invalid )
+    throw std::runtime_error( "Format error: Corrupt compressed section" );
+}
+
+/**
+  @class BinaryFiltrationFile
+  @brief Memory-mapped binary filtration file
+
+  Validates the header of a binary filtration file and provides access
+  to its sections. Sections are shared with the mapping whenever their
+  scalar type and byte order match the requested type, and converted
+  or decompressed otherwise.
+*/
+
+class BinaryFiltrationFile
+{
+public:
+  explicit BinaryFiltrationFile( const std::string& filename )
+    : _file( std::make_shared<utilities::MemoryMappedFile>( filename ) )
+  {
+    if( _file->size() < sizeof(BinaryFiltrationHeader) )
+      throw std::runtime_error( "Format error: File too small for binary filtration header" );
+
+    std::memcpy( &_header, _file->data(), sizeof(BinaryFiltrationHeader) );
+
+    if( std::memcmp( _header.magic, BinaryFiltrationMagic, sizeof(BinaryFiltrationMagic) ) != 0 )
+      throw std::runtime_error( "Format error: Expecting binary filtration" );
+
+    if( _header.byteOrder == BinaryFiltrationByteOrder )
+      _swap = false;
+    else if( _header.byteOrder == swapBytes( BinaryFiltrationByteOrder ) )
+      _swap = true;
+    else
+      throw std::runtime_error( "Format error: Unknown byte order" );
+
+    if( _swap )
+    {
+      _header.version      = swapBytes( _header.version );
+      _header.flags        = swapBytes( _header.flags );
+      _header.numSimplices = swapBytes( _header.numSimplices );
+
+      for( auto&& section : _header.sections )
+      {
+        section[0] = swapBytes( section[0] );
+        section[1] = swapBytes( section[1] );
+      }
+    }
+
+    if( _header.version != BinaryFiltrationVersion )
+      throw std::runtime_error( "Format error: Unsupported version of binary filtration" );
+
+    for( auto&& section : _header.sections )
+    {
+      if( section[0] > _file->size() || section[1] > _file->size() - section[0] )
+        throw std::runtime_error( "Format error: Section exceeds file" );
+    }
+
+    for( auto type : { _header.vertexType, _header.indexType, _header.dataType } )
+      if( type > static_cast<std::uint8_t>( ScalarType::Float64 ) )
+        throw std::runtime_error( "Format error: Unknown scalar type" );
+  }
+
+  std::size_t size() const noexcept
+  {
+    return static_cast<std::size_t>( _header.numSimplices );
+  }
+
+  bool has( BinaryFiltrationFlags flag ) const noexcept
+  {
+    return ( _header.flags & flag ) != 0;
+  }
+
+  ScalarType type( BinaryFiltrationSection section ) const noexcept
+  {
+    switch( section )
+    {
+    case SimplexOffsets:
+    case ColumnOffsets:
+      return ScalarType::UInt64;
+    case Vertices:
+      return static_cast<ScalarType>( _header.vertexType );
+    case Data:
+      return static_cast<ScalarType>( _header.dataType );
+    case RowIndices:
+      return static_cast<ScalarType>( _header.indexType );
+    }
+
+    return ScalarType::UInt64;
+  }
+
+  /**
+    Reads a section containing n values and converts them to type T if
+    necessary. Offset sections are checked to be non-decreasing, with the
+    last offset being the number of values of the corresponding section.
+
+    @returns Shared values, which may refer to the mapped file
+  */
+
+  template <class T> std::shared_ptr<const T> section( BinaryFiltrationSection section, std::size_t n ) const
+  {
+    auto offset = static_cast<std::size_t>( _header.sections[section][0] );
+    auto size   = static_cast<std::size_t>( _header.sections[section][1] );
+    auto type   = this->type( section );
+
+    if( this->has( Compressed ) && section != Data )
+    {
+      auto values = std::make_shared< std::vector<T> >( n );
+      decodeBlocks( _file->data() + offset, size, _swap, values->data(), n );
+
+      return std::shared_ptr<const T>( values, values->data() );
+    }
+
+    if( size != n * sizeOf( type ) )
+      throw std::runtime_error( "Format error: Unexpected size of section" );
+
+    bool bigEndian = isLittleEndian() == _swap;
+    return makeScalarField<T>( _file, offset, n, type, bigEndian );
+  }
+
+  /** Reads an offset section and checks its consistency */
+  std::shared_ptr<const std::uint64_t> offsets( BinaryFiltrationSection section ) const
+  {
+    auto n      = this->size();
+    auto values = this->section<std::uint64_t>( section, n + 1 );
+    auto data   = values.get();
+
+    bool invalid = data[0] != 0;
+
+    #pragma omp parallel for reduction(||:invalid)
+    for( std::size_t i = 0; i < n; i++ )
+      if( data[i] > data[i+1] )
+        invalid = true;
+
+    if( invalid )
+      throw std::runtime_error( "Format error: Offsets must be non-decreasing" );
+
+    return values;
+  }
+
+private:
+  std::shared_ptr<utilities::MemoryMappedFile> _file;
+  BinaryFiltrationHeader                       _header;
+  bool                                         _swap = false;
+};
+
+} // namespace detail
+
+/**
+  @class BinaryFiltrationWriter
+  @brief Writes filtrations in a compact binary format
+
+  Stores a filtered simplicial complex, i.e. the vertices and the data
+  values of all simplices in filtration order, together with its boundary
+  matrix in compressed sparse column (CSC) layout. Alternatively, a single
+  boundary matrix with optional data values may be stored.
+
+  The boundary matrix permits reading a filtration and reducing it right
+  away, without creating a simplicial complex first. Integer sections may
+  optionally be compressed; the file is then smaller, but its sections
+  have to be decompressed instead of being used directly.
+*/
+
+class BinaryFiltrationWriter
+{
+public:
+
+  /** Enables or disables block compression of all integer sections */
+  void setCompression( bool value ) noexcept
+  {
+    _compression = value;
+  }
+
+  /** Enables or disables storing the boundary matrix of simplicial complexes */
+  void setBoundaryMatrix( bool value ) noexcept
+  {
+    _boundaryMatrix = value;
+  }
+
+  template <class SimplicialComplex> void operator()( const std::string& filename, const SimplicialComplex& K )
+  {
+    using Simplex    = typename SimplicialComplex::ValueType;
+    using DataType   = typename Simplex::DataType;
+    using VertexType = typename Simplex::VertexType;
+
+    auto n = K.size();
+
+    std::vector<std::uint64_t> simplexOffsets( n + 1 );
+    std::vector<DataType> data( n );
+
+    for( std::size_t j = 0; j < n; j++ )
+    {
+      auto&& simplex      = K.at( j );
+      simplexOffsets[j+1] = simplexOffsets[j] + simplex.size();
+      data[j]             = simplex.data();
+    }
+
+    std::vector<VertexType> vertices( static_cast<std::size_t>( simplexOffsets.back() ) );
+
+    #pragma omp parallel for
+    for( std::size_t j = 0; j < n; j++ )
+    {
+      auto&& simplex = K.at( j );
+      std::copy( simplex.begin(), simplex.end(), vertices.begin() + static_cast<std::ptrdiff_t>( simplexOffsets[j] ) );
+    }
+
+    detail::BinaryFiltrationHeader header = this->makeHeader( n );
+
+    header.flags      = detail::HasSimplices | detail::HasData;
+    header.vertexType = static_cast<std::uint8_t>( scalarTypeOf<VertexType>() );
+    header.dataType   = static_cast<std::uint8_t>( scalarTypeOf<DataType>() );
+
+    std::ofstream out = this->open( filename, header );
+
+    this->write( out, header, detail::SimplexOffsets, simplexOffsets );
+    this->write( out, header, detail::Vertices,       vertices );
+    this->write( out, header, detail::Data,           data );
+
+    if( _boundaryMatrix )
+    {
+      // The boundary of every simplex consists of the indices of its
+      // faces in the filtration, sorted in ascending order.
+      std::vector<std::uint64_t> columnOffsets( n + 1 );
+
+      for( std::size_t j = 0; j < n; j++ )
+      {
+        auto&& simplex     = K.at( j );
+        columnOffsets[j+1] = columnOffsets[j] + ( simplex.dimension() == 0 ? 0 : simplex.size() );
+      }
+
+      if( n <= std::numeric_limits<std::uint32_t>::max() )
+        this->writeBoundaryMatrix<std::uint32_t>( out, header, K, columnOffsets );
+      else
+        this->writeBoundaryMatrix<std::uint64_t>( out, header, K, columnOffsets );
+    }
+
+    this->close( out, header );
+  }
+
+  /**
+    Writes a boundary matrix and, optionally, the data values of all of
+    its columns. Dualized matrices are not supported.
+  */
+
+  template <class Representation, class T> void operator()( const std::string& filename,
+                                                            const BoundaryMatrix<Representation>& M,
+                                                            const std::vector<T>& values = {} )
+  {
+    using Index = typename Representation::Index;
+
+    if( M.isDualized() )
+      throw std::runtime_error( "Dualized boundary matrices cannot be stored" );
+
+    auto n = static_cast<std::size_t>( M.getNumColumns() );
+
+    if( !values.empty() && values.size() != n )
+      throw std::runtime_error( "Number of data values does not match number of columns" );
+
+    std::vector<std::uint64_t> columnOffsets( n + 1 );
+    std::vector<Index> indices;
+
+    for( std::size_t j = 0; j < n; j++ )
+    {
+      auto column = M.getColumn( Index( j ) );
+
+      indices.insert( indices.end(), column.begin(), column.end() );
+      columnOffsets[j+1] = indices.size();
+    }
+
+    detail::BinaryFiltrationHeader header = this->makeHeader( n );
+
+    header.flags     = values.empty() ? detail::HasBoundaryMatrix : detail::HasBoundaryMatrix | detail::HasData;
+    header.indexType = static_cast<std::uint8_t>( scalarTypeOf<Index>() );
+    header.dataType  = static_cast<std::uint8_t>( scalarTypeOf<T>() );
+
+    std::ofstream out = this->open( filename, header );
+
+    if( !values.empty() )
+      this->write( out, header, detail::Data, values );
+
+    this->write( out, header, detail::ColumnOffsets, columnOffsets );
+    this->write( out, header, detail::RowIndices,    indices );
+
+    this->close( out, header );
+  }
+
+private:
+
+  detail::BinaryFiltrationHeader makeHeader( std::size_t n ) const
+  {
+    detail::BinaryFiltrationHeader header;
+    std::memset( &header, 0, sizeof(header) );
+    std::memcpy( header.magic, detail::BinaryFiltrationMagic, sizeof(header.magic) );
+
+    header.byteOrder    = detail::BinaryFiltrationByteOrder;
+    header.version      = detail::BinaryFiltrationVersion;
+    header.numSimplices = n;
+
+    return header;
+  }
+
+  std::ofstream open( const std::string& filename, detail::BinaryFiltrationHeader& header ) const
+  {
+    std::ofstream out( filename, std::ios::binary );
+    if( !out )
+      throw std::runtime_error( "Unable to open output file" );
+
+    if( _compression )
+      header.flags |= detail::Compressed;
+
+    // The header is written again once all sections are known
+    out.write( reinterpret_cast<const char*>( &header ), sizeof(header) );
+    return out;
+  }
+
+  void close( std::ofstream& out, const detail::BinaryFiltrationHeader& header ) const
+  {
+    out.seekp( 0 );
+    out.write( reinterpret_cast<const char*>( &header ), sizeof(header) );
+
+    if( !out )
+      throw std::runtime_error( "Unable to write output file" );
+  }
+
+  template <class T> void write( std::ofstream& out,
+                                 detail::BinaryFiltrationHeader& header,
+                                 detail::BinaryFiltrationSection section,
+                                 const std::vector<T>& values ) const
+  {
+    // Align the section to eight bytes
+    auto position = static_cast<std::uint64_t>( out.tellp() );
+    auto padding  = ( 8 - position % 8 ) % 8;
+
+    static const char zeros[8] = { 0 };
+    out.write( zeros, static_cast<std::streamsize>( padding ) );
+
+    header.sections[section][0] = position + padding;
+
+    if( _compression && section != detail::Data )
+    {
+      auto bytes = detail::encodeBlocks( values.data(), values.size() );
+
+      out.write( reinterpret_cast<const char*>( bytes.data() ), static_cast<std::streamsize>( bytes.size() ) );
+      header.sections[section][1] = bytes.size();
+    }
+    else
+    {
+      out.write( reinterpret_cast<const char*>( values.data() ), static_cast<std::streamsize>( values.size() * sizeof(T) ) );
+      header.sections[section][1] = values.size() * sizeof(T);
+    }
+  }
+
+  template <class Index, class SimplicialComplex> void writeBoundaryMatrix( std::ofstream& out,
+                                                                            detail::BinaryFiltrationHeader& header,
+                                                                            const SimplicialComplex& K,
+                                                                            const std::vector<std::uint64_t>& columnOffsets ) const
+  {
+    auto n = K.size();
+
+    std::vector<Index> indices( static_cast<std::size_t>( columnOffsets.back() ) );
+
+    bool missingFace = false;
+
+    #pragma omp parallel for schedule(dynamic, 1024) reduction(||:missingFace)
+    for( std::size_t j = 0; j < n; j++ )
+    {
+      auto&& simplex = K.at( j );
+      auto begin     = indices.begin() + static_cast<std::ptrdiff_t>( columnOffsets[j] );
+      auto it        = begin;
+
+      if( simplex.dimension() == 0 )
+        continue;
+
+      for( auto itBoundary = simplex.begin_boundary(); itBoundary != simplex.end_boundary(); ++itBoundary )
+      {
+        auto index = K.index( *itBoundary );
+
+        if( index >= n )
+          missingFace = true;
+
+        *it++ = static_cast<Index>( index );
+      }
+
+      std::sort( begin, it );
+    }
+
+    if( missingFace )
+      throw std::runtime_error( "Simplicial complex does not contain all faces" );
+
+    header.flags     |= detail::HasBoundaryMatrix;
+    header.indexType  = static_cast<std::uint8_t>( scalarTypeOf<Index>() );
+
+    this->write( out, header, detail::ColumnOffsets, columnOffsets );
+    this->write( out, header, detail::RowIndices,    indices );
+  }
+
+  bool _compression    = false;
+  bool _boundaryMatrix = true;
+};
+
+/**
+  @class BinaryFiltrationReader
+  @brief Reads filtrations that are stored in a compact binary format
+
+  Maps a file written by BinaryFiltrationWriter into memory. A boundary
+  matrix with the Mapped representation refers to the columns in the
+  file directly, so it may be reduced without any conversion. For other
+  representations, the columns are copied.
+*/
+
+class BinaryFiltrationReader
+{
+public:
+
+  /** Reads a filtered simplicial complex */
+  template <class SimplicialComplex> void operator()( const std::string& filename, SimplicialComplex& K )
+  {
+    using Simplex    = typename SimplicialComplex::ValueType;
+    using DataType   = typename Simplex::DataType;
+    using VertexType = typename Simplex::VertexType;
+
+    ALEPH_PHASE( "read_binary_filtration" );
+
+    detail::BinaryFiltrationFile file( filename );
+
+    if( !file.has( detail::HasSimplices ) )
+      throw std::runtime_error( "Binary filtration does not contain simplices" );
+
+    auto n        = file.size();
+    auto offsets  = file.offsets( detail::SimplexOffsets );
+    auto o        = offsets.get();
+    auto vertices = file.section<VertexType>( detail::Vertices, static_cast<std::size_t>( o[n] ) );
+    auto data     = file.section<DataType>( detail::Data, n );
+    auto v        = vertices.get();
+    auto d        = data.get();
+
+    std::vector<Simplex> simplices( n );
+
+    #pragma omp parallel for
+    for( std::size_t j = 0; j < n; j++ )
+      simplices[j] = Simplex( v + o[j], v + o[j+1], d[j] );
+
+    K = SimplicialComplex( simplices.begin(), simplices.end() );
+  }
+
+  /**
+    Reads a boundary matrix that refers to the file directly, as well as
+    the data values of all columns, if present.
+  */
+
+  template <class Index, class T> void operator()( const std::string& filename,
+                                                   BoundaryMatrix< representations::Mapped<Index> >& M,
+                                                   std::vector<T>& values )
+  {
+    ALEPH_PHASE( "read_binary_filtration" );
+
+    detail::BinaryFiltrationFile file( filename );
+
+    auto n       = file.size();
+    auto offsets = this->readOffsets( file );
+    auto indices = file.section<Index>( detail::RowIndices, static_cast<std::size_t>( offsets.get()[n] ) );
+
+    this->check( offsets.get(), indices.get(), n );
+    this->readData( file, values );
+
+    M = BoundaryMatrix< representations::Mapped<Index> >( representations::Mapped<Index>( offsets, indices, n ) );
+  }
+
+  /** Reads a boundary matrix into an arbitrary representation */
+  template <class Representation, class T> void operator()( const std::string& filename,
+                                                            BoundaryMatrix<Representation>& M,
+                                                            std::vector<T>& values )
+  {
+    using Index = typename Representation::Index;
+
+    ALEPH_PHASE( "read_binary_filtration" );
+
+    detail::BinaryFiltrationFile file( filename );
+
+    auto n       = file.size();
+    auto offsets = this->readOffsets( file );
+    auto indices = file.section<Index>( detail::RowIndices, static_cast<std::size_t>( offsets.get()[n] ) );
+    auto o       = offsets.get();
+    auto r       = indices.get();
+
+    this->check( o, r, n );
+    this->readData( file, values );
+
+    M = BoundaryMatrix<Representation>();
+    M.setNumColumns( static_cast<Index>( n ) );
+
+    for( std::size_t j = 0; j < n; j++ )
+      M.setColumn( Index( j ), r + o[j], r + o[j+1] );
+  }
+
+private:
+
+  static std::shared_ptr<const std::uint64_t> readOffsets( const detail::BinaryFiltrationFile& file )
+  {
+    if( !file.has( detail::HasBoundaryMatrix ) )
+      throw std::runtime_error( "Binary filtration does not contain a boundary matrix" );
+
+    return file.offsets( detail::ColumnOffsets );
+  }
+
+  /**
+    Checks that every column is sorted and only refers to preceding
+    columns, which is required by all reduction algorithms.
+  */
+
+  template <class Index> static void check( const std::uint64_t* offsets, const Index* indices, std::size_t n )
+  {
+    bool invalid = false;
+
+    #pragma omp parallel for reduction(||:invalid)
+    for( std::size_t j = 0; j < n; j++ )
+    {
+      for( auto i = offsets[j]; i < offsets[j+1]; i++ )
+      {
+        if( static_cast<std::uint64_t>( indices[i] ) >= j || ( i > offsets[j] && !( indices[i-1] < indices[i] ) ) )
+          invalid = true;
+      }
+    }
+
+    if( invalid )
+      throw std::runtime_error( "Format error: Invalid boundary matrix column" );
+  }
+
+  template <class T> static void readData( const detail::BinaryFiltrationFile& file, std::vector<T>& values )
+  {
+    if( file.has( detail::HasData ) )
+    {
+      auto data = file.section<T>( detail::Data, file.size() );
+      values.assign( data.get(), data.get() + file.size() );
+    }
+    else
+      values.clear();
+  }
+};
+
+} // namespace io
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
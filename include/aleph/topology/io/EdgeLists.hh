@@ -2,6 +2,7 @@
 #define ALEPH_TOPOLOGY_IO_EDGE_LISTS_HH__
 
 #include <algorithm>
+#include <cctype>
 #include <fstream>
 #include <set>
 #include <stdexcept>
@@ -9,6 +10,7 @@
 #include <vector>
 
 #include <aleph/utilities/String.hh>
+#include <aleph/utilities/Tokenizer.hh>
 
 namespace aleph
 {
@@ -29,77 +31,108 @@ public:
   void setReadWeights( bool value = true ) noexcept { _readWeights = value; }
   void setTrimLines( bool value = true )   noexcept { _trimLines = value; }
 
+  /**
+    Reads an edge list from a file. The file is mapped into memory, and
+    its lines are tokenized without copying them.
+  */
+
   template <class SimplicialComplex> void operator()( const std::string& filename, SimplicialComplex& K )
   {
-    std::ifstream in( filename );
-    if( !in )
-      throw std::runtime_error( "Unable to read input file" );
+    using Simplex = typename SimplicialComplex::ValueType;
+
+    utilities::LineReader reader( filename );
+    utilities::StringView line;
+
+    std::vector<Simplex> simplices;
+
+    while( reader.next( line ) )
+      this->parseLine( line, simplices );
 
-    this->operator()( in, K );
+    this->makeSimplicialComplex( simplices, K );
   }
 
   template <class SimplicialComplex> void operator()( std::ifstream& in, SimplicialComplex& K )
   {
-    using namespace utilities;
-
-    using Simplex           = typename SimplicialComplex::ValueType;
-    using DataType          = typename Simplex::DataType;
-    using VertexType        = typename Simplex::VertexType;
+    using Simplex = typename SimplicialComplex::ValueType;
 
     std::string line;
+    std::vector<Simplex> simplices;
+
+    while( std::getline( in, line ) )
+      this->parseLine( utilities::StringView( line ), simplices );
 
-    std::set<Simplex> vertices;
-    std::vector<Simplex> edges;
+    this->makeSimplicialComplex( simplices, K );
+  }
+
+private:
+
+  /**
+    Parses a single line of an edge list and adds the edge and its two
+    vertices to a vector of simplices. Empty lines and comments, i.e.
+    lines starting with any of the comment tokens, are skipped.
+  */
+
+  template <class Simplex> void parseLine( utilities::StringView line, std::vector<Simplex>& simplices )
+  {
+    using namespace utilities;
 
-    while( in )
+    using DataType   = typename Simplex::DataType;
+    using VertexType = typename Simplex::VertexType;
+
+    // Only leading white-space characters are relevant for detecting
+    // comments; tokens are always separated by white-space characters.
+    if( _trimLines )
     {
-      std::getline( in, line );
-
-      if( _trimLines )
-        line = trim( line );
-
-      // TODO: Make this configurable and permit splitting by different
-      // tokens such as commas
-      auto tokens = split( line );
-
-      // Skip empty lines and comments
-      if( line.empty() || std::find( _commentTokens.begin(), _commentTokens.end(), line.front() ) != _commentTokens.end() )
-        continue;
-
-      if( tokens.size() >= 2 )
-      {
-        // TODO: Make order of vertices & weights configurable?
-        VertexType u = convert<VertexType>( tokens[0] );
-        VertexType v = convert<VertexType>( tokens[1] );
-        DataType   w = DataType();
-
-        if( tokens.size() >= 3 && _readWeights )
-          w = convert<DataType>( tokens[2] );
-
-        edges.push_back( Simplex( { u, v }, w ) );
-
-        vertices.insert( Simplex( u ) );
-        vertices.insert( Simplex( v ) );
-      }
-      else
-      {
-        // TODO: Throw error?
-      }
+      auto begin = std::find_if_not( line.begin(), line.end(), [] ( char c ) { return std::isspace( static_cast<unsigned char>( c ) ); } );
+      line       = StringView( begin, line.end() );
     }
 
-    // Using a set has the advantage of ensuring that duplicate
-    // simplices are deleted automatically. A duplicate simplex
-    // is usually created by the input data set itself. It must
-    // not be considered for any subsequent analysis.
-    std::set<Simplex> simplices;
+    // Skip empty lines and comments
+    if( line.empty() || std::find( _commentTokens.begin(), _commentTokens.end(), line.front() ) != _commentTokens.end() )
+      return;
+
+    // TODO: Make this configurable and permit splitting by different
+    // tokens such as commas
+    Tokenizer tokenizer( line );
+    StringView tokens[3];
 
-    simplices.insert( vertices.begin(), vertices.end() );
-    simplices.insert( edges.begin(), edges.end() );
+    std::size_t numTokens = 0;
+    while( numTokens < 3 && tokenizer.next( tokens[numTokens] ) )
+      ++numTokens;
+
+    if( numTokens >= 2 )
+    {
+      // TODO: Make order of vertices & weights configurable?
+      VertexType u = convert<VertexType>( tokens[0] );
+      VertexType v = convert<VertexType>( tokens[1] );
+      DataType   w = DataType();
+
+      if( numTokens >= 3 && _readWeights )
+        w = convert<DataType>( tokens[2] );
+
+      simplices.push_back( Simplex( { u, v }, w ) );
+      simplices.push_back( Simplex( u ) );
+      simplices.push_back( Simplex( v ) );
+    }
+    else
+    {
+      // TODO: Throw error?
+    }
+  }
+
+  template <class Simplex, class SimplicialComplex> void makeSimplicialComplex( std::vector<Simplex>& simplices, SimplicialComplex& K )
+  {
+    // Sorting and removing duplicates has the advantage of ensuring that
+    // duplicate simplices are deleted. A duplicate simplex is usually
+    // created by the input data set itself. It must not be considered
+    // for any subsequent analysis. The sort is stable, so the first
+    // occurrence of a simplex is kept.
+    std::stable_sort( simplices.begin(), simplices.end() );
+    simplices.erase( std::unique( simplices.begin(), simplices.end() ), simplices.end() );
 
     K = SimplicialComplex( simplices.begin(), simplices.end() );
   }
 
-private:
   std::vector<char> _commentTokens = { '#', '%', '\"', '*' };
 
   bool _readWeights              = true;
@@ -3,11 +3,15 @@
 
 #include <aleph/topology/BoundaryMatrix.hh>
 
+#include <aleph/utilities/Tokenizer.hh>
+
 #include <algorithm>
+#include <cstddef>
 #include <fstream>
 #include <iterator>
 #include <numeric>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -33,17 +37,24 @@ template <
   using BoundaryMatrix = BoundaryMatrix<Representation>;
   using Index          = typename BoundaryMatrix::Index;
 
-  std::ifstream in( filename );
-
-  if( !in )
-    throw std::runtime_error( "Unable to open input filename" );
-
   functionValues.clear();
   functionValues.shrink_to_fit();
 
-  std::copy( std::istream_iterator<DataType>( in ),
-             std::istream_iterator<DataType>(),
-             std::back_inserter( functionValues ) );
+  {
+    utilities::LineReader reader( filename );
+    utilities::Tokenizer tokenizer( reader.contents() );
+    utilities::StringView token;
+
+    DataType value = DataType();
+
+    while( tokenizer.next( token ) )
+    {
+      if( !utilities::parse( token, value ) )
+        throw std::runtime_error( "Unable to parse function value '" + token.str() + "'" );
+
+      functionValues.push_back( value );
+    }
+  }
 
   if( functionValues.empty() )
     throw std::runtime_error( "Unable to load any function values" );
@@ -141,10 +152,6 @@ template <
 template <class SimplicialComplex, class Functor> std::vector<SimplicialComplex> loadFunctions( const std::string& filename,
                                                                                                 Functor f )
 {
-  std::ifstream in( filename );
-  if( !in )
-    throw std::runtime_error( "Unable to read input file" );
-
   using Simplex    = typename SimplicialComplex::ValueType;
   using DataType   = typename Simplex::DataType;
   using VertexType = typename Simplex::VertexType;
@@ -154,16 +161,27 @@ template <class SimplicialComplex, class Functor> std::vector<SimplicialComplex>
 
   std::vector<SimplicialComplex> complexes;
 
-  std::string line;
-  while( std::getline( in, line ) )
+  utilities::LineReader reader( filename );
+  utilities::StringView line;
+
+  std::vector<DataType> functionValues;
+
+  while( reader.next( line ) )
   {
-    std::vector<DataType> functionValues;
+    functionValues.clear();
 
-    std::istringstream stream( line );
+    utilities::Tokenizer tokenizer( line );
+    utilities::StringView token;
 
-    std::copy( std::istream_iterator<DataType>( stream ),
-               std::istream_iterator<DataType>(),
-               std::back_inserter( functionValues ) );
+    DataType value = DataType();
+
+    while( tokenizer.next( token ) )
+    {
+      if( !utilities::parse( token, value ) )
+        throw std::runtime_error( "Unable to parse function value '" + token.str() + "'" );
+
+      functionValues.push_back( value );
+    }
 
     SimplicialComplex K;
 
@@ -204,6 +222,48 @@ template <class SimplicialComplex> std::vector<SimplicialComplex> loadFunctions(
   return loadFunctions<SimplicialComplex>( filename, [] ( DataType a, DataType b ) { return std::max(a,b); } );
 }
 
+/**
+  Loads the values of multiple 1D functions from a file that uses the
+  same format as loadFunctions(), i.e. one function per line. Instead of
+  creating a simplicial complex for every function, all values are stored
+  consecutively in a flat buffer, as required for the calculation of the
+  persistence diagrams of many functions at once.
+
+  @param filename Input filename
+  @param values   Output parameter for the values of all functions
+  @param offsets  Output parameter for the offsets of all functions in
+                  the values, followed by the total number of values
+*/
+
+template <class DataType> void loadFunctionValues( const std::string& filename,
+                                                   std::vector<DataType>& values,
+                                                   std::vector<std::size_t>& offsets )
+{
+  values.clear();
+  offsets.assign( 1, 0 );
+
+  utilities::LineReader reader( filename );
+  utilities::StringView line;
+
+  while( reader.next( line ) )
+  {
+    utilities::Tokenizer tokenizer( line );
+    utilities::StringView token;
+
+    DataType value = DataType();
+
+    while( tokenizer.next( token ) )
+    {
+      if( !utilities::parse( token, value ) )
+        throw std::runtime_error( "Unable to parse function value '" + token.str() + "'" );
+
+      values.push_back( value );
+    }
+
+    offsets.push_back( values.size() );
+  }
+}
+
 } // namespace io
 
 } // namespace topology
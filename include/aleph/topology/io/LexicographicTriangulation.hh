@@ -2,6 +2,7 @@
 #define ALEPH_TOPOLOGY_IO_LEXICOGRAPHIC_TRIANGULATION_HH__
 
 #include <aleph/utilities/String.hh>
+#include <aleph/utilities/Tokenizer.hh>
 
 #include <algorithm>
 #include <fstream>
@@ -207,10 +208,10 @@ private:
 
         using namespace aleph::utilities;
 
-        auto list   = trim( block.substr( positionBegin + 1, positionEnd - positionBegin - 1 ) );
-        auto tokens = split( list, std::string(",") );
+        Tokenizer tokenizer( block.data() + positionBegin + 1, block.data() + positionEnd, ", \t\n\v\f\r" );
+        StringView token;
 
-        for( auto&& token : tokens )
+        while( tokenizer.next( token ) )
           vertices.emplace_back( convert<VertexType>( token ) );
 
         std::advance( it, positionEnd - offset );
@@ -1,17 +1,27 @@
 #ifndef ALEPH_TOPOLOGY_IO_PLY_HH__
 #define ALEPH_TOPOLOGY_IO_PLY_HH__
 
+#include <aleph/utilities/Instrumentation.hh>
+#include <aleph/utilities/MemoryMappedFile.hh>
 #include <aleph/utilities/String.hh>
+#include <aleph/utilities/Tokenizer.hh>
 
+#include <aleph/topology/IndexedMesh.hh>
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
 #include <aleph/topology/filtrations/Data.hh>
 
+#include <aleph/topology/io/Volume.hh>
+
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 
 #include <fstream>
+#include <functional>
 #include <limits>
+#include <numeric>
 #include <map>
 #include <set>
 #include <stdexcept>
@@ -71,53 +81,201 @@ std::map<std::string, bool> TypeSignednessMap = {
   { "uint8"  , false }
 };
 
-/* Describes an arbitrary value of a PLY file */
-union PLYValue
+/* Describes a single property of an element in a PLY file */
+struct PLYProperty
 {
-  double         d;
-  float          f;
-  int            i;
-  short          s;
-  char           c;
-  unsigned       u;
-  unsigned short us;
-  unsigned char  uc;
+  std::string name;
+  ScalarType  type;               // Type of the property, or of list entries
+  ScalarType  sizeType;           // Type of the list size
+  bool        isList   = false;
 };
 
-/*
-  Reads a single value from a binary input stream, reversing the storage
-  order if necessary.
-*/
+/* Describes an element of a PLY file, e.g. all vertices */
+struct PLYElement
+{
+  std::string              name;
+  std::size_t              count = 0;
+  std::vector<PLYProperty> properties;
+
+  /**
+    @returns Size of a single element in bytes, or zero if the size is
+    variable because the element contains lists
+  */
+
+  std::size_t stride() const
+  {
+    std::size_t result = 0;
+
+    for( auto&& property : properties )
+    {
+      if( property.isList )
+        return 0;
+
+      result += sizeOf( property.type );
+    }
+
+    return result;
+  }
+
+  /** @returns Offset of a property in bytes for fixed-size elements */
+  std::size_t offset( std::size_t index ) const
+  {
+    std::size_t result = 0;
+
+    for( std::size_t i = 0; i < index; i++ )
+      result += sizeOf( properties[i].type );
+
+    return result;
+  }
+
+  /** @returns Index of a property, or the number of properties if it does not exist */
+  std::size_t find( const std::string& name ) const
+  {
+    auto it = std::find_if( properties.begin(), properties.end(),
+                            [&name] ( const PLYProperty& property )
+                            {
+                              return property.name == name;
+                            } );
+
+    return static_cast<std::size_t>( std::distance( properties.begin(), it ) );
+  }
+};
+
+/* Describes the header of a PLY file */
+struct PLYHeader
+{
+  bool        binary       = false;
+  bool        littleEndian = true;
+  std::size_t bodyOffset   = 0;     // Offset of the first element in the file
+
+  std::vector<PLYElement> elements;
+};
+
+/** Parses the name of a scalar type in a PLY file */
+inline ScalarType parsePLYScalarType( const std::string& name )
+{
+  if( name == "char" || name == "int8" )
+    return ScalarType::Int8;
+  else if( name == "uchar" || name == "uint8" )
+    return ScalarType::UInt8;
+  else if( name == "short" || name == "int16" )
+    return ScalarType::Int16;
+  else if( name == "ushort" || name == "uint16" )
+    return ScalarType::UInt16;
+  else if( name == "int" || name == "int32" )
+    return ScalarType::Int32;
+  else if( name == "uint" || name == "uint32" )
+    return ScalarType::UInt32;
+  else if( name == "float" || name == "float32" )
+    return ScalarType::Float32;
+  else if( name == "double" || name == "float64" )
+    return ScalarType::Float64;
+
+  throw std::runtime_error( "Format error: Unknown data type \"" + name + "\"" );
+}
 
-template <class T> void readValue( std::ifstream& stream,
-                                   std::size_t bytes,
-                                   bool littleEndian,
-                                   T* target )
+/** Parses the header of a memory-mapped PLY file */
+inline PLYHeader parsePLYHeader( const utilities::MemoryMappedFile& file )
 {
-  if( !littleEndian || bytes == 1 )
-    stream.read( reinterpret_cast<char*>( target ), static_cast<std::streamsize>( bytes ) );
-  else
+  using namespace aleph::utilities;
+
+  PLYHeader header;
+
+  std::size_t offset = 0;
+  std::string line   = trim( readLine( file, offset ) );
+
+  if( line != "ply" )
+    throw std::runtime_error( "Format error: Expecting \"ply\"" );
+
+  bool formatParsed = false;
+
+  while( offset < file.size() )
   {
-    char* buffer         = new char[bytes];
-    char* reversedBuffer = new char[bytes];
+    line = readLine( file, offset );
 
-    stream.read( buffer, static_cast<std::streamsize>( bytes ) );
+    Tokenizer tokenizer( line );
+    StringView keyword;
 
-    for( std::size_t i = 0; i < bytes; i++ )
-      reversedBuffer[i] = buffer[ bytes - 1 - i ];
+    if( !tokenizer.next( keyword ) || keyword == "comment" || keyword == "obj_info" )
+      continue;
 
-    std::copy( reversedBuffer, reversedBuffer + bytes, target );
+    std::vector<std::string> tokens;
+    StringView token;
 
-    // FIXME: Superfluous?
-#if 0
-    memcpy( reinterpret_cast<void*>( &target ),
-            reinterpret_cast<void*>( reversedBuffer ),
-            bytes );
-#endif
+    while( tokenizer.next( token ) )
+      tokens.push_back( token.str() );
+
+    if( keyword == "format" )
+    {
+      if( tokens.size() != 2 || tokens[1] != "1.0" )
+        throw std::runtime_error( "Format error: Expecting \"ascii 1.0\" or \"binary_little_endian 1.0\" or \"binary_big_endian 1.0\" " );
+
+      if( tokens[0] == "ascii" )
+        header.binary = false;
+      else if( tokens[0] == "binary_little_endian" )
+      {
+        header.binary       = true;
+        header.littleEndian = true;
+      }
+      else if( tokens[0] == "binary_big_endian" )
+      {
+        header.binary       = true;
+        header.littleEndian = false;
+      }
+      else
+        throw std::runtime_error( "Format error: Expecting \"ascii 1.0\" or \"binary_little_endian 1.0\" or \"binary_big_endian 1.0\" " );
+
+      formatParsed = true;
+    }
+    else if( keyword == "element" )
+    {
+      if( tokens.size() != 2 )
+        throw std::runtime_error( "Element conversion error: Expecting number of elements" );
+
+      PLYElement element;
+      element.name  = tokens[0];
+      element.count = convert<std::size_t>( StringView( tokens[1] ) );
+
+      header.elements.push_back( element );
+    }
+    else if( keyword == "property" )
+    {
+      if( header.elements.empty() )
+        throw std::runtime_error( "Format error: Property without element" );
+
+      PLYProperty property;
+
+      // The syntax for lists is "property list SIZE_TYPE ENTRY_TYPE NAME",
+      // e.g. "property list uchar int vertex_indices".
+      if( tokens.size() == 4 && tokens[0] == "list" )
+      {
+        property.isList   = true;
+        property.sizeType = parsePLYScalarType( tokens[1] );
+        property.type     = parsePLYScalarType( tokens[2] );
+        property.name     = tokens[3];
+      }
+      else if( tokens.size() == 2 )
+      {
+        property.type     = parsePLYScalarType( tokens[0] );
+        property.sizeType = property.type;
+        property.name     = tokens[1];
+      }
+      else
+        throw std::runtime_error( "Property conversion error: Expecting data type and name of property" );
+
+      header.elements.back().properties.push_back( property );
+    }
+    else if( keyword == "end_header" )
+    {
+      if( !formatParsed )
+        throw std::runtime_error( "Format error: Expecting \"format\"" );
 
-    delete[] reversedBuffer;
-    delete[] buffer;
+      header.bodyOffset = offset;
+      return header;
+    }
   }
+
+  throw std::runtime_error( "Format error: Expecting \"end_header\"" );
 }
 
 } // namespace detail
@@ -130,6 +288,13 @@ template <class T> void readValue( std::ifstream& stream,
   reading PLY files with an arbitrary number of vertex properties. A
   user may specify which property to use in order to assign the data
   stored for each simplex.
+
+  Files that are specified by their name are mapped into memory. Binary
+  bodies are read by gathering every required property at its stride,
+  while ASCII bodies are split into chunks of lines that are parsed in
+  parallel. The vertex coordinates, the selected property, and the face
+  list are thus stored in contiguous arrays, which can be used for the
+  construction of an IndexedMesh or of a lower-star filtration.
 */
 
 class PLYReader
@@ -151,13 +316,125 @@ public:
     unsigned bytesListEntry;
   };
 
+  /**
+    Reads a PLY file into contiguous arrays.
+
+    @param filename    Input file
+    @param coordinates Coordinates of all vertices, stored as x, y, and z
+                       for every vertex; will be empty if the file does not
+                       contain coordinates
+    @param data        Value of the data property for every vertex, or the
+                       default value if the property does not exist
+    @param offsets     Offsets of all faces in the list of face vertices,
+                       followed by the total number of face vertices
+    @param vertices    Vertices of all faces
+  */
+
+  template <class Position, class Data, class Index> void operator()( const std::string& filename,
+                                                                      std::vector<Position>& coordinates,
+                                                                      std::vector<Data>& data,
+                                                                      std::vector<std::size_t>& offsets,
+                                                                      std::vector<Index>& vertices )
+  {
+    ALEPH_PHASE( "read_ply" );
+
+    utilities::MemoryMappedFile file( filename );
+
+    auto header = detail::parsePLYHeader( file );
+
+    coordinates.clear();
+    data.clear();
+    offsets.assign( 1, 0 );
+    vertices.clear();
+
+    if( header.binary )
+      this->readBinary( file, header, coordinates, data, offsets, vertices );
+    else
+      this->readASCII( file, header, coordinates, data, offsets, vertices );
+
+    bool invalidVertex = false;
+
+    #pragma omp parallel for reduction(||:invalidVertex)
+    for( std::size_t i = 0; i < vertices.size(); i++ )
+      if( static_cast<std::size_t>( vertices[i] ) >= data.size() )
+        invalidVertex = true;
+
+    if( invalidVertex )
+      throw std::runtime_error( "Format error: Face refers to unknown vertex" );
+  }
+
+  /** Reads a PLY file into an indexed mesh */
+  template <class Position, class Data> void operator()( const std::string& filename, IndexedMesh<Position, Data>& M )
+  {
+    std::vector<Position> coordinates;
+    std::vector<Data> data;
+    std::vector<std::size_t> offsets;
+    std::vector<typename IndexedMesh<Position, Data>::Index> vertices;
+
+    this->operator()( filename, coordinates, data, offsets, vertices );
+
+    M = IndexedMesh<Position, Data>( std::move( coordinates ), std::move( data ), offsets, vertices );
+  }
+
+  /**
+    Reads a PLY file into a simplicial complex, using the data property
+    for creating a lower-star filtration. Only triangular faces are
+    supported.
+  */
+
   template <class SimplicialComplex> void operator()( const std::string& filename, SimplicialComplex& K )
   {
-    std::ifstream in( filename );
-    if( !in )
-      throw std::runtime_error( "Unable to read input file" );
+    using Simplex    = typename SimplicialComplex::ValueType;
+    using DataType   = typename Simplex::DataType;
+    using VertexType = typename Simplex::VertexType;
+
+    std::vector<float> coordinates;
+    std::vector<DataType> data;
+    std::vector<std::size_t> offsets;
+    std::vector<VertexType> vertices;
+
+    this->operator()( filename, coordinates, data, offsets, vertices );
+
+    auto numFaces = offsets.size() - 1;
+
+    if( vertices.size() != 3 * numFaces )
+      throw std::runtime_error( "Format error: Expecting triangular faces only" );
 
-    this->operator()( in, K );
+    // Collect the edges of all triangles; sorting them removes all of the
+    // duplicates and ensures that the simplicial complex is valid upon
+    // construction.
+    std::vector< std::pair<VertexType, VertexType> > edges( vertices.size() );
+
+    #pragma omp parallel for
+    for( std::size_t f = 0; f < numFaces; f++ )
+    {
+      for( std::size_t i = 0; i < 3; i++ )
+      {
+        auto u = vertices[ 3*f + i ];
+        auto v = vertices[ 3*f + ( i + 1 ) % 3 ];
+
+        edges[ 3*f + i ] = std::make_pair( std::min( u, v ), std::max( u, v ) );
+      }
+    }
+
+    std::sort( edges.begin(), edges.end() );
+    edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+
+    std::vector<Simplex> simplices;
+    simplices.reserve( data.size() + edges.size() + numFaces );
+
+    for( std::size_t i = 0; i < data.size(); i++ )
+      simplices.push_back( Simplex( VertexType( i ), data[i] ) );
+
+    for( auto&& edge : edges )
+      simplices.push_back( Simplex( { edge.first, edge.second } ) );
+
+    for( std::size_t f = 0; f < numFaces; f++ )
+      simplices.push_back( Simplex( { vertices[3*f], vertices[3*f+1], vertices[3*f+2] } ) );
+
+    K = SimplicialComplex( simplices.begin(), simplices.end() );
+    K.recalculateWeights();
+    K.sort( filtrations::Data<Simplex>() );
   }
 
   template <class SimplicialComplex> void operator()( std::ifstream& in, SimplicialComplex& K )
@@ -178,7 +455,6 @@ public:
 
     bool headerParsed = false;
     bool parseBinary  = false;
-    bool littleEndian = false;
 
     std::getline( in, line );
     line = utilities::trim( line );
@@ -198,16 +474,8 @@ public:
 
       if( format == "ascii 1.0" )
         parseBinary = false;
-      else if( format == "binary_little_endian 1.0" )
-      {
-        parseBinary  = true;
-        littleEndian = true;
-      }
-      else if( format == "binary_big_endian 1.0" )
-      {
-        parseBinary  = true;
-        littleEndian = false;
-      }
+      else if( format == "binary_little_endian 1.0" || format == "binary_big_endian 1.0" )
+        parseBinary = true;
       else
         throw std::runtime_error( "Format error: Expecting \"ascii 1.0\" or \"binary_little_endian 1.0\" or \"binary_big_endian 1.0\" " );
     }
@@ -340,12 +608,7 @@ public:
     std::vector<Simplex> simplices;
 
     if( parseBinary )
-    {
-      simplices = this->parseBinary<Simplex>( in,
-                                              numVertices, numFaces,
-                                              littleEndian,
-                                              properties );
-    }
+      throw std::runtime_error( "Binary files can only be read from a filename" );
     else
     {
       simplices = this->parseASCII<Simplex>( in,
@@ -368,56 +631,421 @@ public:
 
 private:
 
-  template <class Simplex> std::vector<Simplex> parseBinary( std::ifstream& in,
-                                                             std::size_t numVertices,
-                                                             std::size_t numFaces,
-                                                             bool littleEndian,
-                                                             const std::vector<PropertyDescriptor>& properties )
+  /**
+    Reads the body of a binary PLY file. Elements of a fixed size are
+    read by gathering each required property at the stride of the
+    element. Elements containing lists have to be scanned once in order
+    to determine the offsets of all entries; afterwards, the entries are
+    converted in parallel.
+  */
+
+  template <class Position, class Data, class Index> void readBinary( const utilities::MemoryMappedFile& file,
+                                                                      const detail::PLYHeader& header,
+                                                                      std::vector<Position>& coordinates,
+                                                                      std::vector<Data>& data,
+                                                                      std::vector<std::size_t>& offsets,
+                                                                      std::vector<Index>& vertices )
   {
-    using DataType   = typename Simplex::DataType;
-    using VertexType = typename Simplex::VertexType;
+    bool swap         = header.littleEndian != detail::isLittleEndian();
+    auto position     = header.bodyOffset;
+    auto checkRemains = [&file] ( std::size_t position, std::size_t size )
+    {
+      if( position > file.size() || file.size() - position < size )
+        throw std::runtime_error( "Format error: Unexpected end of file" );
+    };
 
-    DataType weight = DataType();
+    for( auto&& element : header.elements )
+    {
+      auto n      = element.count;
+      auto stride = element.stride();
+      auto begin  = file.data() + position;
 
-    for( std::size_t vertexIndex = 0; vertexIndex < numVertices; vertexIndex++ )
+      if( element.name == "vertex" )
+      {
+        if( stride == 0 )
+          throw std::runtime_error( "Format error: Vertices must not contain lists" );
+
+        checkRemains( position, n * stride );
+
+        auto ix = element.find( "x" );
+        auto iy = element.find( "y" );
+        auto iz = element.find( "z" );
+        auto iw = element.find( _property );
+
+        if( ix < element.properties.size() && iy < element.properties.size() && iz < element.properties.size() )
+        {
+          coordinates.resize( 3 * n );
+
+          auto ox = element.offset( ix );
+          auto oy = element.offset( iy );
+          auto oz = element.offset( iz );
+          auto tx = element.properties[ix].type;
+          auto ty = element.properties[iy].type;
+          auto tz = element.properties[iz].type;
+
+          #pragma omp parallel for
+          for( std::size_t i = 0; i < n; i++ )
+          {
+            auto record = begin + i * stride;
+
+            coordinates[3*i  ] = detail::readScalar<Position>( record + ox, tx, swap );
+            coordinates[3*i+1] = detail::readScalar<Position>( record + oy, ty, swap );
+            coordinates[3*i+2] = detail::readScalar<Position>( record + oz, tz, swap );
+          }
+        }
+
+        data.assign( n, Data() );
+
+        if( !_property.empty() && iw < element.properties.size() )
+          detail::gatherScalars( begin + element.offset( iw ), n, stride, element.properties[iw].type, swap, data.data() );
+
+        position += n * stride;
+      }
+      else if( stride != 0 )
+      {
+        checkRemains( position, n * stride );
+        position += n * stride;
+      }
+      else
+      {
+        bool isFace = element.name == "face";
+        auto il     = isFace ? this->findFaceList( element ) : element.properties.size();
+
+        // Scan all elements to determine the position of the face lists.
+        // This only requires reading the sizes of all lists.
+        std::vector<std::size_t> positions;
+
+        if( isFace )
+        {
+          positions.resize( n );
+          offsets.resize( n + 1 );
+        }
+
+        for( std::size_t i = 0; i < n; i++ )
+        {
+          for( std::size_t k = 0; k < element.properties.size(); k++ )
+          {
+            auto&& property = element.properties[k];
+
+            if( !property.isList )
+            {
+              checkRemains( position, sizeOf( property.type ) );
+              position += sizeOf( property.type );
+              continue;
+            }
+
+            checkRemains( position, sizeOf( property.sizeType ) );
+
+            auto size  = detail::readScalar<std::size_t>( file.data() + position, property.sizeType, swap );
+            position  += sizeOf( property.sizeType );
+
+            if( size > ( file.size() - position ) / sizeOf( property.type ) )
+              throw std::runtime_error( "Format error: Unexpected end of file" );
+
+            if( k == il )
+            {
+              positions[i]  = position;
+              offsets[i+1]  = offsets[i] + size;
+            }
+
+            position += size * sizeOf( property.type );
+          }
+        }
+
+        if( isFace )
+        {
+          auto type = element.properties[il].type;
+          auto size = sizeOf( type );
+
+          vertices.resize( offsets.back() );
+
+          #pragma omp parallel for
+          for( std::size_t i = 0; i < n; i++ )
+          {
+            for( std::size_t j = offsets[i]; j < offsets[i+1]; j++ )
+              vertices[j] = detail::readScalar<Index>( file.data() + positions[i] + ( j - offsets[i] ) * size, type, swap );
+          }
+        }
+      }
+    }
+  }
+
+  /**
+    Reads the body of an ASCII PLY file. Every element is stored in a
+    single line. The body is split into chunks of complete lines, which
+    are processed in parallel: a first pass counts the lines in every
+    chunk in order to assign them to elements, a second pass parses all
+    vertices and the sizes of all faces, and a third pass parses all of
+    the face vertices, whose offsets are known by then.
+  */
+
+  template <class Position, class Data, class Index> void readASCII( const utilities::MemoryMappedFile& file,
+                                                                     const detail::PLYHeader& header,
+                                                                     std::vector<Position>& coordinates,
+                                                                     std::vector<Data>& data,
+                                                                     std::vector<std::size_t>& offsets,
+                                                                     std::vector<Index>& vertices )
+  {
+    using namespace aleph::utilities;
+
+    auto begin = reinterpret_cast<const char*>( file.data() ) + header.bodyOffset;
+    auto end   = reinterpret_cast<const char*>( file.data() ) + file.size();
+
+    // Chunks ----------------------------------------------------------
+
+    std::vector<const char*> chunks = { begin };
+
+    while( end - chunks.back() > chunkSize )
     {
-      std::vector<double> coordinates;
+      auto it = std::find( chunks.back() + chunkSize, end, '\n' );
+      if( it == end || it + 1 == end )
+        break;
+
+      chunks.push_back( it + 1 );
+    }
+
+    chunks.push_back( end );
+
+    auto numChunks = chunks.size() - 1;
+
+    // The first line of every chunk, followed by the total number of lines
+    std::vector<std::size_t> lines( numChunks + 1 );
+
+    #pragma omp parallel for
+    for( std::size_t c = 0; c < numChunks; c++ )
+    {
+      auto first = chunks[c];
+      auto last  = chunks[c+1];
+
+      lines[c+1] = static_cast<std::size_t>( std::count( first, last, '\n' ) );
+
+      // The last line of the file does not have to be terminated
+      if( last == end && last != first && *( last - 1 ) != '\n' )
+        ++lines[c+1];
+    }
+
+    std::partial_sum( lines.begin(), lines.end(), lines.begin() );
+
+    // Elements --------------------------------------------------------
+
+    std::size_t vertexElement = header.elements.size();
+    std::size_t faceElement   = header.elements.size();
+
+    // The first line of every element, followed by the first line after
+    // the last element
+    std::vector<std::size_t> elementLines( header.elements.size() + 1 );
+
+    for( std::size_t e = 0; e < header.elements.size(); e++ )
+    {
+      elementLines[e+1] = elementLines[e] + header.elements[e].count;
+
+      if( header.elements[e].name == "vertex" )
+        vertexElement = e;
+      else if( header.elements[e].name == "face" )
+        faceElement = e;
+    }
 
-      for( auto&& descriptor : properties )
+    if( elementLines.back() > lines.back() )
+      throw std::runtime_error( "Format error: Unexpected end of file" );
+
+    std::size_t ix = std::numeric_limits<std::size_t>::max();
+    std::size_t iy = ix;
+    std::size_t iz = ix;
+    std::size_t iw = ix;
+    std::size_t il = ix;
+
+    if( vertexElement < header.elements.size() )
+    {
+      auto&& element = header.elements[vertexElement];
+
+      ix = element.find( "x" );
+      iy = element.find( "y" );
+      iz = element.find( "z" );
+      iw = _property.empty() ? element.properties.size() : element.find( _property );
+
+      if( ix < element.properties.size() && iy < element.properties.size() && iz < element.properties.size() )
+        coordinates.resize( 3 * element.count );
+
+      data.assign( element.count, Data() );
+    }
+
+    if( faceElement < header.elements.size() )
+    {
+      il = this->findFaceList( header.elements[faceElement] );
+      offsets.resize( header.elements[faceElement].count + 1 );
+    }
+
+    // Visits all lines of an element in parallel. The functor is called
+    // with the index of the element and a tokenizer for its line.
+    auto forEachLine = [&] ( std::size_t e, std::function<void( std::size_t, Tokenizer& )> functor )
+    {
+      bool invalid = false;
+
+      #pragma omp parallel for schedule(dynamic, 1) reduction(||:invalid)
+      for( std::size_t c = 0; c < numChunks; c++ )
       {
-        // Only faces may have lists for now...
-        if( descriptor.bytesListSize + descriptor.bytesListEntry != 0 )
+        if( lines[c+1] <= elementLines[e] || lines[c] >= elementLines[e+1] )
           continue;
 
-        detail::PLYValue pv;
+        auto line  = lines[c];
+        auto first = chunks[c];
 
-        switch( descriptor.bytes )
+        while( first < chunks[c+1] && line < elementLines[e+1] )
         {
-          case 8:
-            detail::readValue( in, descriptor.bytes, littleEndian, &pv.d );
-            break;
-          case 4:
-            detail::readValue( in, descriptor.bytes, littleEndian, &pv.f );
-            break;
-          case 2:
-            detail::readValue( in, descriptor.bytes, littleEndian, &pv.s );
-            break;
-          case 1:
-            detail::readValue( in, descriptor.bytes, littleEndian, &pv.c );
-            break;
+          auto last = std::find( first, chunks[c+1], '\n' );
+
+          if( line >= elementLines[e] )
+          {
+            Tokenizer tokenizer( StringView( first, last ) );
+
+            try
+            {
+              functor( line - elementLines[e], tokenizer );
+            }
+            catch( std::runtime_error& )
+            {
+              invalid = true;
+            }
+          }
+
+          first = last + 1;
+          ++line;
         }
+      }
 
-        // FIXME: Not sure whether this is legal...
-        if( descriptor.name == "x" || descriptor.name == "y" || descriptor.name == "z" )
-          coordinates.push_back( pv.d );
+      if( invalid )
+        throw std::runtime_error( "Format error: Unable to parse element" );
+    };
+
+    // Skips all properties of an element until the given index and
+    // returns the token of the property.
+    auto skip = [] ( const detail::PLYElement& element, std::size_t index, Tokenizer& tokenizer )
+    {
+      StringView token;
+
+      for( std::size_t k = 0; k <= index; k++ )
+      {
+        if( !tokenizer.next( token ) )
+          throw std::runtime_error( "Format error: Missing property" );
+
+        if( k == index )
+          break;
+
+        if( element.properties[k].isList )
+        {
+          auto size = convert<std::size_t>( token );
+          for( std::size_t j = 0; j < size; j++ )
+            if( !tokenizer.next( token ) )
+              throw std::runtime_error( "Format error: Missing list entry" );
+        }
       }
+
+      return token;
+    };
+
+    if( vertexElement < header.elements.size() )
+    {
+      auto&& element = header.elements[vertexElement];
+
+      std::size_t last = 0;
+
+      if( !coordinates.empty() )
+        last = std::max( { ix, iy, iz } );
+
+      if( iw < element.properties.size() )
+        last = std::max( last, iw );
+
+      forEachLine( vertexElement, [&] ( std::size_t i, Tokenizer& tokenizer )
+      {
+        StringView token;
+
+        for( std::size_t k = 0; k <= last; k++ )
+        {
+          if( !tokenizer.next( token ) )
+            throw std::runtime_error( "Format error: Missing property" );
+
+          if( !coordinates.empty() )
+          {
+            if( k == ix )
+              coordinates[3*i  ] = convert<Position>( token );
+            if( k == iy )
+              coordinates[3*i+1] = convert<Position>( token );
+            if( k == iz )
+              coordinates[3*i+2] = convert<Position>( token );
+          }
+
+          if( k == iw )
+            data[i] = convert<Data>( token );
+
+          if( element.properties[k].isList )
+          {
+            auto size = convert<std::size_t>( token );
+            for( std::size_t j = 0; j < size; j++ )
+              if( !tokenizer.next( token ) )
+                throw std::runtime_error( "Format error: Missing list entry" );
+          }
+        }
+      } );
     }
 
-    for( std::size_t faceIndex = 0; faceIndex < numVertices; faceIndex++ )
+    if( faceElement < header.elements.size() )
     {
+      auto&& element = header.elements[faceElement];
+
+      forEachLine( faceElement, [&] ( std::size_t i, Tokenizer& tokenizer )
+      {
+        offsets[i+1] = convert<std::size_t>( skip( element, il, tokenizer ) );
+      } );
+
+      std::partial_sum( offsets.begin(), offsets.end(), offsets.begin() );
+      vertices.resize( offsets.back() );
+
+      forEachLine( faceElement, [&] ( std::size_t i, Tokenizer& tokenizer )
+      {
+        skip( element, il, tokenizer );
+
+        StringView token;
+
+        for( auto j = offsets[i]; j < offsets[i+1]; j++ )
+        {
+          if( !tokenizer.next( token ) )
+            throw std::runtime_error( "Format error: Missing list entry" );
+
+          vertices[j] = convert<Index>( token );
+        }
+      } );
     }
   }
 
+  /**
+    Determines the index of the list property that contains the vertices
+    of a face. If there is no property with a standard name, the first
+    list is used.
+  */
+
+  static std::size_t findFaceList( const detail::PLYElement& element )
+  {
+    auto index = element.find( "vertex_indices" );
+
+    if( index == element.properties.size() )
+      index = element.find( "vertex_index" );
+
+    if( index == element.properties.size() )
+    {
+      auto it = std::find_if( element.properties.begin(), element.properties.end(),
+                              [] ( const detail::PLYProperty& property )
+                              {
+                                return property.isList;
+                              } );
+
+      index = static_cast<std::size_t>( std::distance( element.properties.begin(), it ) );
+    }
+
+    if( index == element.properties.size() || !element.properties[index].isList )
+      throw std::runtime_error( "Format error: Expecting list of face vertices" );
+
+    return index;
+  }
 
   template <class Simplex> std::vector<Simplex> parseASCII( std::ifstream& in,
                                                             std::size_t numVertices, std::size_t numFaces,
@@ -547,6 +1175,9 @@ private:
     return simplices;
   }
 
+  /** Size of chunks of ASCII files that are parsed in parallel */
+  static constexpr std::ptrdiff_t chunkSize = 1 << 22;
+
   /** Data property to assign to new simplices */
   std::string _property = "z";
 
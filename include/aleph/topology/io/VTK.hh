@@ -11,7 +11,12 @@
 #include <string>
 #include <vector>
 
+#include <aleph/topology/CubicalComplex.hh>
+
+#include <aleph/topology/io/Volume.hh>
+
 #include <aleph/utilities/String.hh>
+#include <aleph/utilities/Tokenizer.hh>
 
 namespace aleph
 {
@@ -30,6 +35,12 @@ namespace io
   capable of parsing a structured grid and converting it to a simplicial
   complex. Data and weights of the simplicial complex will be taken from
   the VTK file.
+
+  Alternatively, the grid may be converted to an implicit cubical complex,
+  which only stores the values at the vertices of the grid.
+
+  Files in binary format are memory-mapped instead of being parsed; see
+  loadVTKVolume() for more details.
 */
 
 class VTKStructuredGridReader
@@ -45,6 +56,15 @@ public:
 
   template <class SimplicialComplex, class Functor> void operator()( const std::string& filename, SimplicialComplex& K, Functor f )
   {
+    using Simplex  = typename SimplicialComplex::ValueType;
+    using DataType = typename Simplex::DataType;
+
+    if( isBinary( filename ) )
+    {
+      this->operator()( loadVTKVolume<DataType>( filename ), K, f );
+      return;
+    }
+
     std::ifstream in( filename );
     if( !in )
       throw std::runtime_error( "Unable to read input file" );
@@ -62,19 +82,14 @@ public:
 
   template <class SimplicialComplex, class Functor> void operator()( std::ifstream& in, SimplicialComplex& K, Functor f )
   {
-    using namespace aleph::utilities;
-
     using Simplex    = typename SimplicialComplex::ValueType;
     using DataType   = typename Simplex::DataType;
-    using VertexType = typename Simplex::VertexType;
-
-    std::string line;
 
     // Parse header first ----------------------------------------------
 
-    std::size_t nx, ny, nz,
-                n,
-                s;
+    std::size_t nx = 0, ny = 0, nz = 0,
+                n  = 0,
+                s  = 0;
 
     bool parsedHeader = this->parseHeader( in, nx, ny, nz, n, s );
     if( !parsedHeader )
@@ -83,76 +98,110 @@ public:
     // TODO: Check data type size against 's' and report if there are
     // issues such as insufficient storage space
 
-    // Parse body ------------------------------------------------------
-    //
-    // The body contains coordinates for each of the points, which are
-    // dutifully ignored for now, and attributes. For now, point-based
-    // attributes are supported.
+    std::vector<DataType> values;
+    this->parseBody( in, n, values );
 
-    std::regex rePointData( "POINT_DATA[[:space:]]+([[:digit:]]+)" );
-    std::regex reScalars( "SCALARS[[:space:]]+([[:alnum:]]+)[[:space:]]+([[:alnum:]]+)[[:space:]]*([[:digit:]]*)" );
-    std::regex reLookupTable( "LOOKUP_TABLE[[:space:]]+([[:alnum:]]+)" );
+    this->createTopology( nx, ny, nz, values.data(), values.size(), K, f );
+  }
 
-    std::vector<DataType> coordinates;
-    coordinates.reserve( n*3 );
+  /**
+    Converts a volume, e.g. a memory-mapped binary file or a raw volume,
+    to a simplicial complex. The volume must not have more than three
+    axes.
+  */
 
-    while( std::getline( in, line ) )
-    {
-      line         = trim( line );
-      auto strings = split( line );
+  template <class T, class SimplicialComplex, class Functor> void operator()( const Volume<T>& volume, SimplicialComplex& K, Functor f )
+  {
+    auto&& shape = volume.shape();
 
-      for( auto&& coordinate : strings )
-        coordinates.push_back( convert<DataType>( coordinate ) );
+    if( shape.empty() || shape.size() > 3 )
+      throw std::runtime_error( "Volume must have between one and three axes" );
 
-      if( coordinates.size() == n*3 )
-        break;
-    }
+    std::size_t nx = shape[0];
+    std::size_t ny = shape.size() > 1 ? shape[1] : 1;
+    std::size_t nz = shape.size() > 2 ? shape[2] : 1;
 
-    std::vector<DataType> values;
-    values.reserve( n );
+    this->createTopology( nx, ny, nz, volume.data(), volume.size(), K, f );
+  }
 
+  /**
+    Reads a structured grid from a file and converts it to a cubical
+    complex. In contrast to the conversion to a simplicial complex, no
+    cells are created explicitly, making this the preferred option for
+    large grids.
+  */
+
+  template <class T> void operator()( const std::string& filename, CubicalComplex<T>& C )
+  {
+    // Binary files are mapped into memory, and their values are shared
+    // with the cubical complex whenever possible.
+    if( isBinary( filename ) )
     {
-      std::smatch matches;
+      auto volume = loadVTKVolume<T>( filename );
+      C           = CubicalComplex<T>( volume.shape(), volume.values() );
+      return;
+    }
 
-      while( std::getline( in, line ) )
-      {
-        if( std::regex_match( line, matches, rePointData ) )
-        {
-          auto sn = matches[1];
-          if( static_cast<std::size_t>( std::stoull( sn ) ) != n )
-            throw std::runtime_error( "Format error: number of point data attributes does not match number of points" );
-        }
-        else if( std::regex_match( line, matches, reScalars ) )
-        {
-          auto name       = matches[1];
-          auto type       = matches[2];
-          auto components = matches[3];
-
-          // TODO:
-          //  - Use name
-          //  - Check type
-          //  - Check number of components (if present)
-
-          (void) name;
-          (void) type;
-          (void) components;
-        }
-        else if( std::regex_match( line, matches, reLookupTable ) )
-        {
-          auto name = matches[1];
-          if( name != "default" )
-            throw std::runtime_error( "Handling non-default lookup tables is not yet implemented" );
-        }
-        else
-        {
-          line         = trim( line );
-          auto strings = split( line );
+    std::ifstream in( filename );
+    if( !in )
+      throw std::runtime_error( "Unable to read input file" );
 
-          for( auto&& value : strings )
-            values.push_back( convert<DataType>( value ) );
-        }
-      }
-    }
+    this->operator()( in, C );
+  }
+
+  /** @overload operator()( const std::string&, CubicalComplex<T>& ) */
+  template <class T> void operator()( std::ifstream& in, CubicalComplex<T>& C )
+  {
+    std::size_t nx = 0, ny = 0, nz = 0,
+                n  = 0,
+                s  = 0;
+
+    bool parsedHeader = this->parseHeader( in, nx, ny, nz, n, s );
+    if( !parsedHeader )
+      return;
+
+    std::vector<T> values;
+    this->parseBody( in, n, values );
+
+    if( values.size() != n )
+      throw std::runtime_error( "Format error: number of values does not match number of points" );
+
+    C = CubicalComplex<T>( { nx, ny, nz }, std::move( values ) );
+  }
+
+private:
+
+  /**
+    Checks whether a file uses the binary variant of the legacy format by
+    inspecting the third line of its header.
+  */
+
+  static bool isBinary( const std::string& filename )
+  {
+    std::ifstream in( filename );
+    if( !in )
+      throw std::runtime_error( "Unable to read input file" );
+
+    std::string line;
+    for( unsigned i = 0; i < 3; i++ )
+      std::getline( in, line );
+
+    return aleph::utilities::trim( line ) == "BINARY";
+  }
+
+  /**
+    Creates the 1-skeleton of a structured grid from the values at its
+    vertices and stores it in a simplicial complex. The functor is used
+    to assign weights to edges.
+  */
+
+  template <class SimplicialComplex, class DataType, class Functor> void createTopology( std::size_t nx, std::size_t ny, std::size_t nz,
+                                                                                         const DataType* values, std::size_t n,
+                                                                                         SimplicialComplex& K,
+                                                                                         Functor f )
+  {
+    using Simplex    = typename SimplicialComplex::ValueType;
+    using VertexType = typename Simplex::VertexType;
 
     // Create topology -------------------------------------------------
     //
@@ -168,8 +217,8 @@ public:
     {
       VertexType v = VertexType();
 
-      for( auto&& value : values )
-        simplices.push_back( Simplex(v++, value) );
+      for( std::size_t i = 0; i < n; i++ )
+        simplices.push_back( Simplex(v++, values[i]) );
     }
 
     // Create 1-simplices ----------------------------------------------
@@ -204,7 +253,77 @@ public:
     K = SimplicialComplex( simplices.begin(), simplices.end() );
   }
 
-private:
+  /**
+    Parses the body of a structured VTK file, i.e. the coordinates of
+    all points, which are dutifully ignored for now, and the point-based
+    attributes, which are stored as values.
+  */
+
+  template <class T> void parseBody( std::ifstream& in, std::size_t n, std::vector<T>& values )
+  {
+    using namespace aleph::utilities;
+
+    using DataType = T;
+
+    std::string line;
+
+    // Parse body ------------------------------------------------------
+    //
+    // The body contains coordinates for each of the points, which are
+    // dutifully ignored for now, and attributes. For now, point-based
+    // attributes are supported.
+
+    // Coordinates are only counted, but not converted, because they are
+    // not used at present.
+    std::size_t numCoordinates = 0;
+
+    while( numCoordinates < n*3 && std::getline( in, line ) )
+    {
+      Tokenizer tokenizer( line );
+      StringView token;
+
+      while( tokenizer.next( token ) )
+        ++numCoordinates;
+    }
+
+    values.clear();
+    values.reserve( n );
+
+    while( std::getline( in, line ) )
+    {
+      Tokenizer tokenizer( line );
+      StringView token;
+
+      if( !tokenizer.next( token ) )
+        continue;
+
+      if( token == "POINT_DATA" )
+      {
+        StringView sn;
+        if( !tokenizer.next( sn ) || convert<std::size_t>( sn ) != n )
+          throw std::runtime_error( "Format error: number of point data attributes does not match number of points" );
+      }
+      else if( token == "SCALARS" )
+      {
+        // TODO:
+        //  - Use name
+        //  - Check type
+        //  - Check number of components (if present)
+      }
+      else if( token == "LOOKUP_TABLE" )
+      {
+        StringView name;
+        if( !tokenizer.next( name ) || name != "default" )
+          throw std::runtime_error( "Handling non-default lookup tables is not yet implemented" );
+      }
+      else
+      {
+        do
+          values.push_back( convert<DataType>( token ) );
+        while( tokenizer.next( token ) );
+      }
+    }
+  }
 
   /**
     Converts an index in the array of values to the corresponding set of
@@ -316,7 +435,7 @@ private:
       return false;
 
     if( format != "ASCII" )
-      throw std::runtime_error( "Binary file parsing is not yet supported" );
+      throw std::runtime_error( "Binary files can only be read from a filename" );
 
     std::getline( in, structure );
     std::getline( in, dimensions );
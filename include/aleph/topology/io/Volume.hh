@@ -0,0 +1,697 @@
+#ifndef ALEPH_TOPOLOGY_IO_VOLUME_HH__
+#define ALEPH_TOPOLOGY_IO_VOLUME_HH__
+
+#include <aleph/utilities/Instrumentation.hh>
+#include <aleph/utilities/MemoryMappedFile.hh>
+#include <aleph/utilities/String.hh>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+namespace io
+{
+
+/** Scalar types that may be stored in a binary volume */
+enum class ScalarType
+{
+  Int8,  UInt8,
+  Int16, UInt16,
+  Int32, UInt32,
+  Int64, UInt64,
+  Float32,
+  Float64
+};
+
+/** @returns Size of a scalar type in bytes */
+inline std::size_t sizeOf( ScalarType type )
+{
+  switch( type )
+  {
+  case ScalarType::Int8:
+  case ScalarType::UInt8:
+    return 1;
+  case ScalarType::Int16:
+  case ScalarType::UInt16:
+    return 2;
+  case ScalarType::Int32:
+  case ScalarType::UInt32:
+  case ScalarType::Float32:
+    return 4;
+  case ScalarType::Int64:
+  case ScalarType::UInt64:
+  case ScalarType::Float64:
+    return 8;
+  }
+
+  return 0;
+}
+
+/** @returns Scalar type that corresponds to a C++ type */
+template <class T> ScalarType scalarTypeOf()
+{
+  static_assert( std::is_arithmetic<T>::value && sizeof(T) <= 8, "Type must be a scalar type" );
+
+  if( std::is_floating_point<T>::value )
+    return sizeof(T) == 4 ? ScalarType::Float32 : ScalarType::Float64;
+
+  switch( sizeof(T) )
+  {
+  case 1:
+    return std::is_signed<T>::value ? ScalarType::Int8  : ScalarType::UInt8;
+  case 2:
+    return std::is_signed<T>::value ? ScalarType::Int16 : ScalarType::UInt16;
+  case 4:
+    return std::is_signed<T>::value ? ScalarType::Int32 : ScalarType::UInt32;
+  default:
+    return std::is_signed<T>::value ? ScalarType::Int64 : ScalarType::UInt64;
+  }
+}
+
+/**
+  @class Volume
+  @brief Scalar field of a structured grid
+
+  Stores the shape of a grid, i.e. the number of vertices along every
+  axis, with the first axis varying the fastest, and the values at all
+  of its vertices. The values are shared: if they have been loaded from
+  a file with a matching scalar type, they refer to a memory-mapped copy
+  of the file, which is kept alive as long as the values are in use.
+*/
+
+template <class T> class Volume
+{
+public:
+  using DataType = T;
+
+  Volume() = default;
+
+  Volume( std::vector<std::size_t> shape, std::shared_ptr<const T> values )
+    : _shape( std::move( shape ) )
+    , _values( std::move( values ) )
+  {
+  }
+
+  /** @returns Number of vertices along every axis */
+  const std::vector<std::size_t>& shape() const noexcept
+  {
+    return _shape;
+  }
+
+  /** @returns Number of vertices */
+  std::size_t size() const noexcept
+  {
+    if( _shape.empty() )
+      return 0;
+
+    return std::accumulate( _shape.begin(), _shape.end(), std::size_t(1), std::multiplies<std::size_t>() );
+  }
+
+  /** @returns Pointer to the values at all vertices */
+  const T* data() const noexcept
+  {
+    return _values.get();
+  }
+
+  /** @returns Shared storage of the values, e.g. for a cubical complex */
+  const std::shared_ptr<const T>& values() const noexcept
+  {
+    return _values;
+  }
+
+  const T* begin() const noexcept { return this->data(); }
+  const T* end()   const noexcept { return this->data() + this->size(); }
+
+private:
+  std::vector<std::size_t> _shape;
+  std::shared_ptr<const T> _values;
+};
+
+namespace detail
+{
+
+/** @returns true if the host stores multi-byte values in little-endian order */
+inline bool isLittleEndian() noexcept
+{
+  std::uint16_t value = 1;
+  unsigned char byte  = 0;
+
+  std::memcpy( &byte, &value, 1 );
+  return byte == 1;
+}
+
+inline std::uint8_t swapBytes( std::uint8_t x ) noexcept
+{
+  return x;
+}
+
+inline std::uint16_t swapBytes( std::uint16_t x ) noexcept
+{
+  return static_cast<std::uint16_t>( ( x >> 8 ) | ( x << 8 ) );
+}
+
+inline std::uint32_t swapBytes( std::uint32_t x ) noexcept
+{
+  return ( x >> 24 )
+       | ( ( x >>  8 ) & 0x0000FF00u )
+       | ( ( x <<  8 ) & 0x00FF0000u )
+       | ( x << 24 );
+}
+
+inline std::uint64_t swapBytes( std::uint64_t x ) noexcept
+{
+  return ( std::uint64_t( swapBytes( static_cast<std::uint32_t>( x ) ) ) << 32 )
+       | swapBytes( static_cast<std::uint32_t>( x >> 32 ) );
+}
+
+/**
+  Reverses the byte order of all values in a contiguous buffer. Values
+  are loaded as unsigned integers of the same size, which permits the
+  compiler to vectorise the loop.
+*/
+
+template <class U> void swapBytes( U* values, std::size_t n )
+{
+  #pragma omp parallel for
+  for( std::size_t i = 0; i < n; i++ )
+    values[i] = swapBytes( values[i] );
+}
+
+template <std::size_t N> struct UnsignedOfSize;
+
+template <> struct UnsignedOfSize<1> { using Type = std::uint8_t;  };
+template <> struct UnsignedOfSize<2> { using Type = std::uint16_t; };
+template <> struct UnsignedOfSize<4> { using Type = std::uint32_t; };
+template <> struct UnsignedOfSize<8> { using Type = std::uint64_t; };
+
+/**
+  Gathers scalars of type S, stored in the given byte order, at a fixed
+  stride from a buffer and converts them to type T. This permits reading
+  a single property of interleaved records, e.g. one vertex attribute of
+  a mesh. The source buffer does not have to be aligned.
+*/
+
+template <class S, class T> void gatherScalars( const unsigned char* source, std::size_t n, std::size_t stride, bool swap, T* target )
+{
+  using U = typename UnsignedOfSize<sizeof(S)>::Type;
+
+  #pragma omp parallel for
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    U raw;
+    std::memcpy( &raw, source + i * stride, sizeof(S) );
+
+    if( swap )
+      raw = swapBytes( raw );
+
+    S value;
+    std::memcpy( &value, &raw, sizeof(S) );
+
+    target[i] = static_cast<T>( value );
+  }
+}
+
+/** Dispatches gathering scalars of a type that is only known at runtime */
+template <class T> void gatherScalars( const unsigned char* source, std::size_t n, std::size_t stride, ScalarType type, bool swap, T* target )
+{
+  switch( type )
+  {
+  case ScalarType::Int8:
+    return gatherScalars<std::int8_t>( source, n, stride, swap, target );
+  case ScalarType::UInt8:
+    return gatherScalars<std::uint8_t>( source, n, stride, swap, target );
+  case ScalarType::Int16:
+    return gatherScalars<std::int16_t>( source, n, stride, swap, target );
+  case ScalarType::UInt16:
+    return gatherScalars<std::uint16_t>( source, n, stride, swap, target );
+  case ScalarType::Int32:
+    return gatherScalars<std::int32_t>( source, n, stride, swap, target );
+  case ScalarType::UInt32:
+    return gatherScalars<std::uint32_t>( source, n, stride, swap, target );
+  case ScalarType::Int64:
+    return gatherScalars<std::int64_t>( source, n, stride, swap, target );
+  case ScalarType::UInt64:
+    return gatherScalars<std::uint64_t>( source, n, stride, swap, target );
+  case ScalarType::Float32:
+    return gatherScalars<float>( source, n, stride, swap, target );
+  case ScalarType::Float64:
+    return gatherScalars<double>( source, n, stride, swap, target );
+  }
+}
+
+/** Reads a single scalar of type S, stored in the given byte order */
+template <class S, class T> T readScalar( const unsigned char* source, bool swap )
+{
+  using U = typename UnsignedOfSize<sizeof(S)>::Type;
+
+  U raw;
+  std::memcpy( &raw, source, sizeof(S) );
+
+  if( swap )
+    raw = swapBytes( raw );
+
+  S value;
+  std::memcpy( &value, &raw, sizeof(S) );
+
+  return static_cast<T>( value );
+}
+
+/** Reads a single scalar of a type that is only known at runtime */
+template <class T> T readScalar( const unsigned char* source, ScalarType type, bool swap )
+{
+  switch( type )
+  {
+  case ScalarType::Int8:
+    return readScalar<std::int8_t, T>( source, swap );
+  case ScalarType::UInt8:
+    return readScalar<std::uint8_t, T>( source, swap );
+  case ScalarType::Int16:
+    return readScalar<std::int16_t, T>( source, swap );
+  case ScalarType::UInt16:
+    return readScalar<std::uint16_t, T>( source, swap );
+  case ScalarType::Int32:
+    return readScalar<std::int32_t, T>( source, swap );
+  case ScalarType::UInt32:
+    return readScalar<std::uint32_t, T>( source, swap );
+  case ScalarType::Int64:
+    return readScalar<std::int64_t, T>( source, swap );
+  case ScalarType::UInt64:
+    return readScalar<std::uint64_t, T>( source, swap );
+  case ScalarType::Float32:
+    return readScalar<float, T>( source, swap );
+  case ScalarType::Float64:
+    return readScalar<double, T>( source, swap );
+  }
+
+  return T();
+}
+
+/**
+  Converts a buffer of scalars of type S, stored in the given byte order,
+  to a buffer of type T. The source buffer does not have to be aligned.
+*/
+
+template <class S, class T> void convertScalars( const unsigned char* source, std::size_t n, bool swap, T* target )
+{
+  gatherScalars<S>( source, n, sizeof(S), swap, target );
+}
+
+/**
+  Creates a scalar field of type T from a range of bytes in a mapped
+  file. If the scalar type of the file matches T, its byte order matches
+  the one of the machine, and the range is suitably aligned, the field
+  refers to the mapping directly. Else, the values are copied, and their
+  byte order and type are converted in a single pass.
+*/
+
+template <class S, class T> std::shared_ptr<const T> makeScalarField( std::shared_ptr<utilities::MemoryMappedFile> file,
+                                                                      std::size_t offset,
+                                                                      std::size_t n,
+                                                                      bool bigEndian )
+{
+  if( offset > file->size() || n * sizeof(S) > file->size() - offset )
+    throw std::runtime_error( "Format error: file does not contain enough values" );
+
+  bool swap = sizeof(S) > 1 && bigEndian == isLittleEndian();
+  auto data = file->data() + offset;
+
+  bool aligned = reinterpret_cast<std::uintptr_t>( data ) % alignof(T) == 0;
+
+  if( std::is_same<S, T>::value && aligned && !swap )
+  {
+    // Aliasing constructor: the pointer refers to the values, while
+    // the ownership of the mapping is shared.
+    return std::shared_ptr<const T>( file, reinterpret_cast<const T*>( data ) );
+  }
+
+  auto values = std::make_shared< std::vector<T> >( n );
+  convertScalars<S>( data, n, swap, values->data() );
+
+  return std::shared_ptr<const T>( values, values->data() );
+}
+
+template <class T> std::shared_ptr<const T> makeScalarField( std::shared_ptr<utilities::MemoryMappedFile> file,
+                                                             std::size_t offset,
+                                                             std::size_t n,
+                                                             ScalarType type,
+                                                             bool bigEndian )
+{
+  switch( type )
+  {
+  case ScalarType::Int8:
+    return makeScalarField<std::int8_t, T>( file, offset, n, bigEndian );
+  case ScalarType::UInt8:
+    return makeScalarField<std::uint8_t, T>( file, offset, n, bigEndian );
+  case ScalarType::Int16:
+    return makeScalarField<std::int16_t, T>( file, offset, n, bigEndian );
+  case ScalarType::UInt16:
+    return makeScalarField<std::uint16_t, T>( file, offset, n, bigEndian );
+  case ScalarType::Int32:
+    return makeScalarField<std::int32_t, T>( file, offset, n, bigEndian );
+  case ScalarType::UInt32:
+    return makeScalarField<std::uint32_t, T>( file, offset, n, bigEndian );
+  case ScalarType::Int64:
+    return makeScalarField<std::int64_t, T>( file, offset, n, bigEndian );
+  case ScalarType::UInt64:
+    return makeScalarField<std::uint64_t, T>( file, offset, n, bigEndian );
+  case ScalarType::Float32:
+    return makeScalarField<float, T>( file, offset, n, bigEndian );
+  case ScalarType::Float64:
+    return makeScalarField<double, T>( file, offset, n, bigEndian );
+  }
+
+  throw std::runtime_error( "Unknown scalar type" );
+}
+
+/**
+  Reads a single line of text from a mapped file, starting at the given
+  offset, which is advanced past the line terminator.
+*/
+
+inline std::string readLine( const utilities::MemoryMappedFile& file, std::size_t& offset )
+{
+  auto begin = file.data() + offset;
+  auto end   = file.data() + file.size();
+  auto it    = std::find( begin, end, '\n' );
+
+  std::string line( begin, it );
+  offset = static_cast<std::size_t>( it - file.data() ) + ( it != end ? 1 : 0 );
+
+  if( !line.empty() && line.back() == '\r' )
+    line.pop_back();
+
+  return line;
+}
+
+/** Parses the name of a scalar type in a legacy VTK file */
+inline ScalarType parseVTKScalarType( const std::string& name )
+{
+  if( name == "char" )
+    return ScalarType::Int8;
+  else if( name == "unsigned_char" )
+    return ScalarType::UInt8;
+  else if( name == "short" )
+    return ScalarType::Int16;
+  else if( name == "unsigned_short" )
+    return ScalarType::UInt16;
+  else if( name == "int" )
+    return ScalarType::Int32;
+  else if( name == "unsigned_int" )
+    return ScalarType::UInt32;
+  else if( name == "long" || name == "vtktypeint64" )
+    return ScalarType::Int64;
+  else if( name == "unsigned_long" || name == "vtktypeuint64" )
+    return ScalarType::UInt64;
+  else if( name == "float" )
+    return ScalarType::Float32;
+  else if( name == "double" )
+    return ScalarType::Float64;
+
+  throw std::runtime_error( "Format error: unknown scalar type '" + name + "'" );
+}
+
+/** Parses the name of a scalar type in a NRRD header */
+inline ScalarType parseNRRDScalarType( const std::string& name )
+{
+  if( name == "signed char" || name == "int8" || name == "int8_t" )
+    return ScalarType::Int8;
+  else if( name == "uchar" || name == "unsigned char" || name == "uint8" || name == "uint8_t" )
+    return ScalarType::UInt8;
+  else if( name == "short" || name == "short int" || name == "signed short" || name == "signed short int" || name == "int16" || name == "int16_t" )
+    return ScalarType::Int16;
+  else if( name == "ushort" || name == "unsigned short" || name == "unsigned short int" || name == "uint16" || name == "uint16_t" )
+    return ScalarType::UInt16;
+  else if( name == "int" || name == "signed int" || name == "int32" || name == "int32_t" )
+    return ScalarType::Int32;
+  else if( name == "uint" || name == "unsigned int" || name == "uint32" || name == "uint32_t" )
+    return ScalarType::UInt32;
+  else if( name == "longlong" || name == "long long" || name == "long long int" || name == "signed long long" || name == "signed long long int" || name == "int64" || name == "int64_t" )
+    return ScalarType::Int64;
+  else if( name == "ulonglong" || name == "unsigned long long" || name == "unsigned long long int" || name == "uint64" || name == "uint64_t" )
+    return ScalarType::UInt64;
+  else if( name == "float" )
+    return ScalarType::Float32;
+  else if( name == "double" )
+    return ScalarType::Float64;
+
+  throw std::runtime_error( "Format error: unknown scalar type '" + name + "'" );
+}
+
+} // namespace detail
+
+/**
+  Loads a raw volume, i.e. a file that only contains the values of all
+  vertices of a grid, whose shape and scalar type need to be specified
+  by the client. The file is mapped into memory.
+
+  @param filename  Input file
+  @param shape     Number of vertices along every axis; the first axis
+                   varies the fastest
+  @param type      Scalar type of the values in the file
+  @param bigEndian Flag indicating whether values are stored in big-endian
+                   byte order
+  @param offset    Number of bytes to skip at the beginning of the file
+*/
+
+template <class T> Volume<T> loadRawVolume( const std::string& filename,
+                                            const std::vector<std::size_t>& shape,
+                                            ScalarType type,
+                                            bool bigEndian = false,
+                                            std::size_t offset = 0 )
+{
+  ALEPH_PHASE( "read_volume" );
+
+  auto file = std::make_shared<utilities::MemoryMappedFile>( filename );
+  auto n    = std::accumulate( shape.begin(), shape.end(), std::size_t(1), std::multiplies<std::size_t>() );
+
+  return Volume<T>( shape, detail::makeScalarField<T>( file, offset, n, type, bigEndian ) );
+}
+
+/**
+  Loads a volume in NRRD format. Only the 'raw' encoding is supported,
+  but the data may either be attached to the header or be stored in a
+  separate file.
+*/
+
+template <class T> Volume<T> loadNRRDVolume( const std::string& filename )
+{
+  using namespace aleph::utilities;
+
+  ALEPH_PHASE( "read_volume" );
+
+  auto file   = std::make_shared<MemoryMappedFile>( filename );
+  auto offset = std::size_t(0);
+
+  auto magic = detail::readLine( *file, offset );
+  if( magic.compare( 0, 4, "NRRD" ) != 0 )
+    throw std::runtime_error( "Format error: missing NRRD magic" );
+
+  std::vector<std::size_t> shape;
+
+  std::string type;
+  std::string encoding = "raw";
+  std::string endian   = "little";
+  std::string dataFile;
+  std::size_t byteSkip = 0;
+
+  while( offset < file->size() )
+  {
+    auto line = detail::readLine( *file, offset );
+
+    // An empty line terminates the header
+    if( line.empty() )
+      break;
+
+    if( line.front() == '#' )
+      continue;
+
+    auto colon = line.find( ':' );
+    if( colon == std::string::npos )
+      continue;
+
+    auto key   = trim( line.substr( 0, colon ) );
+    auto value = trim( line.substr( line[colon+1] == '=' ? colon + 2 : colon + 1 ) );
+
+    if( key == "type" )
+      type = value;
+    else if( key == "encoding" )
+      encoding = value;
+    else if( key == "endian" )
+      endian = value;
+    else if( key == "data file" || key == "datafile" )
+      dataFile = value;
+    else if( key == "byte skip" || key == "byteskip" )
+    {
+      if( value == "-1" )
+        throw std::runtime_error( "Skipping bytes from the end of a file is not yet supported" );
+
+      byteSkip = static_cast<std::size_t>( std::stoull( value ) );
+    }
+    else if( key == "sizes" )
+    {
+      std::istringstream stream( value );
+      std::size_t n = 0;
+
+      while( stream >> n )
+        shape.push_back( n );
+    }
+  }
+
+  if( encoding != "raw" )
+    throw std::runtime_error( "Format error: only raw NRRD encoding is supported" );
+
+  if( shape.empty() || type.empty() )
+    throw std::runtime_error( "Format error: NRRD header does not specify sizes and type" );
+
+  auto scalarType = detail::parseNRRDScalarType( type );
+  auto bigEndian  = endian == "big";
+
+  if( !dataFile.empty() )
+  {
+    // Detached data files are relative to the header
+    if( dataFile.front() != '/' )
+    {
+      auto slash = filename.find_last_of( '/' );
+      if( slash != std::string::npos )
+        dataFile = filename.substr( 0, slash + 1 ) + dataFile;
+    }
+
+    return loadRawVolume<T>( dataFile, shape, scalarType, bigEndian, byteSkip );
+  }
+
+  auto n = std::accumulate( shape.begin(), shape.end(), std::size_t(1), std::multiplies<std::size_t>() );
+  return Volume<T>( shape, detail::makeScalarField<T>( file, offset + byteSkip, n, scalarType, bigEndian ) );
+}
+
+/**
+  Loads the point data of a legacy VTK file in binary format. Structured
+  grids as well as structured points are supported. The coordinates of
+  points are skipped, and only the first scalar attribute is used. As
+  required by the format, all values are assumed to be big-endian.
+*/
+
+template <class T> Volume<T> loadVTKVolume( const std::string& filename )
+{
+  using namespace aleph::utilities;
+
+  ALEPH_PHASE( "read_volume" );
+
+  auto file   = std::make_shared<MemoryMappedFile>( filename );
+  auto offset = std::size_t(0);
+
+  auto identifier = detail::readLine( *file, offset );
+  auto header     = detail::readLine( *file, offset );
+  auto format     = trim( detail::readLine( *file, offset ) );
+
+  (void) header;
+
+  if( identifier.find( "vtk" ) == std::string::npos )
+    throw std::runtime_error( "Format error: missing VTK identifier" );
+
+  if( format != "BINARY" )
+    throw std::runtime_error( "Format error: expected binary VTK file" );
+
+  std::vector<std::size_t> shape;
+  std::size_t n = 0;
+
+  ScalarType type   = ScalarType::Float32;
+  bool parsedScalar = false;
+
+  while( offset < file->size() )
+  {
+    auto line = trim( detail::readLine( *file, offset ) );
+    if( line.empty() )
+      continue;
+
+    std::istringstream stream( line );
+    std::string keyword;
+
+    stream >> keyword;
+
+    if( keyword == "DATASET" )
+    {
+      std::string structure;
+      stream >> structure;
+
+      if( structure != "STRUCTURED_GRID" && structure != "STRUCTURED_POINTS" )
+        throw std::runtime_error( "Format error: unsupported data set '" + structure + "'" );
+    }
+    else if( keyword == "DIMENSIONS" )
+    {
+      std::size_t x = 0, y = 0, z = 0;
+      stream >> x >> y >> z;
+
+      shape = { x, y, z };
+    }
+    else if( keyword == "POINTS" )
+    {
+      std::size_t m = 0;
+      std::string name;
+
+      stream >> m >> name;
+
+      // Skip coordinates
+      offset += 3 * m * sizeOf( detail::parseVTKScalarType( name ) );
+    }
+    else if( keyword == "POINT_DATA" )
+      stream >> n;
+    else if( keyword == "SCALARS" )
+    {
+      std::string name, typeName;
+      std::size_t components = 1;
+
+      stream >> name >> typeName;
+      if( !( stream >> components ) )
+        components = 1;
+
+      if( components != 1 )
+        throw std::runtime_error( "Handling multiple components is not yet implemented" );
+
+      type         = detail::parseVTKScalarType( typeName );
+      parsedScalar = true;
+    }
+    else if( keyword == "LOOKUP_TABLE" )
+    {
+      std::string name;
+      stream >> name;
+
+      if( name != "default" )
+        throw std::runtime_error( "Handling non-default lookup tables is not yet implemented" );
+
+      // The values follow immediately
+      break;
+    }
+  }
+
+  if( shape.empty() || !parsedScalar )
+    throw std::runtime_error( "Format error: VTK file does not contain dimensions and scalars" );
+
+  auto numVertices = std::accumulate( shape.begin(), shape.end(), std::size_t(1), std::multiplies<std::size_t>() );
+  if( n != numVertices )
+    throw std::runtime_error( "Format error: number of point data attributes does not match number of points" );
+
+  return Volume<T>( shape, detail::makeScalarField<T>( file, offset, n, type, true ) );
+}
+
+} // namespace io
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,246 @@
+#ifndef ALEPH_REPRESENTATIONS_MAPPED_HH__
+#define ALEPH_REPRESENTATIONS_MAPPED_HH__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+namespace topology
+{
+
+namespace representations
+{
+
+/**
+  @class Mapped
+  @brief Copy-on-write view of a boundary matrix in CSC layout
+
+  This representation refers to a boundary matrix that is stored in
+  compressed sparse column (CSC) layout elsewhere, e.g. in a file that
+  has been mapped into memory. Column $j$ consists of the row indices in
+  the range given by the offsets $j$ and $j+1$, sorted in ascending order.
+
+  The arrays are shared and never modified. Instead, every column that
+  is changed by a reduction algorithm is copied first. Since most of the
+  columns of a boundary matrix are either never touched or cleared, the
+  reduction can start immediately, without converting the matrix.
+*/
+
+template <class IndexType = unsigned> class Mapped
+{
+public:
+  using Index = IndexType;
+
+  Mapped() = default;
+
+  /**
+    Creates a new view of a boundary matrix.
+
+    @param offsets    Offsets of all columns, followed by the number of
+                      row indices
+    @param indices    Row indices of all columns
+    @param numColumns Number of columns
+  */
+
+  Mapped( std::shared_ptr<const std::uint64_t> offsets,
+          std::shared_ptr<const Index> indices,
+          std::size_t numColumns )
+    : _offsets( std::move( offsets ) )
+    , _indices( std::move( indices ) )
+    , _states( numColumns, State::Shared )
+    , _dimensions( numColumns )
+  {
+    auto o = _offsets.get();
+
+    #pragma omp parallel for
+    for( std::size_t j = 0; j < numColumns; j++ )
+    {
+      auto size      = o[j+1] - o[j];
+      _dimensions[j] = size == 0 ? Index(0) : static_cast<Index>( size - 1 );
+    }
+
+    _dimension = _dimensions.empty() ? Index(0) : *std::max_element( _dimensions.begin(), _dimensions.end() );
+  }
+
+  void setNumColumns( Index numColumns )
+  {
+    _offsets.reset();
+    _indices.reset();
+    _columns.clear();
+
+    _states.assign( static_cast<std::size_t>( numColumns ), State::Empty );
+    _dimensions.assign( static_cast<std::size_t>( numColumns ), Index(0) );
+    _dimension = Index(0);
+  }
+
+  Index getNumColumns() const
+  {
+    return static_cast<Index>( _states.size() );
+  }
+
+  std::pair<Index, bool> getMaximumIndex( Index column ) const
+  {
+    auto j = static_cast<std::size_t>( column );
+
+    switch( _states.at( j ) )
+    {
+    case State::Shared:
+      if( _offsets.get()[j] == _offsets.get()[j+1] )
+        return std::make_pair( Index(0), false );
+      else
+        return std::make_pair( _indices.get()[ _offsets.get()[j+1] - 1 ], true );
+
+    case State::Owned:
+    {
+      auto&& data = _columns.at( column );
+      if( data.empty() )
+        return std::make_pair( Index(0), false );
+      else
+        return std::make_pair( data.back(), true );
+    }
+
+    case State::Empty:
+      break;
+    }
+
+    return std::make_pair( Index(0), false );
+  }
+
+  void addColumns( Index source, Index target )
+  {
+    auto&& sourceColumn = this->getColumn( source );
+    auto&& targetColumn = this->getColumn( target );
+
+    std::vector<Index> result;
+    result.reserve( sourceColumn.size() + targetColumn.size() );
+
+    std::set_symmetric_difference( sourceColumn.begin(), sourceColumn.end(),
+                                   targetColumn.begin(), targetColumn.end(),
+                                   std::back_inserter( result ) );
+
+    this->own( target ).swap( result );
+  }
+
+  template <class InputIterator> void setColumn( Index column,
+                                                 InputIterator begin, InputIterator end )
+  {
+    auto&& data = this->own( column );
+    data.assign( begin, end );
+
+    // Ensures proper sorting order. Else, the reduction algorithm will
+    // not be able to reduce the matrix.
+    std::sort( data.begin(), data.end() );
+
+    this->setDimension( column, begin == end ? 0 : static_cast<Index>( std::distance( begin, end ) - 1 ) );
+  }
+
+  std::vector<Index> getColumn( Index column ) const
+  {
+    auto j = static_cast<std::size_t>( column );
+
+    switch( _states.at( j ) )
+    {
+    case State::Shared:
+      return std::vector<Index>( _indices.get() + _offsets.get()[j], _indices.get() + _offsets.get()[j+1] );
+    case State::Owned:
+      return _columns.at( column );
+    case State::Empty:
+      break;
+    }
+
+    return {};
+  }
+
+  void clearColumn( Index column )
+  {
+    _states.at( static_cast<std::size_t>( column ) ) = State::Empty;
+    _columns.erase( column );
+  }
+
+  void setDimension( Index column, Index dimension )
+  {
+    auto&& current = _dimensions.at( static_cast<std::size_t>( column ) );
+    bool decreased = current == _dimension && dimension < current;
+
+    current = dimension;
+
+    if( decreased )
+      _dimension = *std::max_element( _dimensions.begin(), _dimensions.end() );
+    else
+      _dimension = std::max( _dimension, dimension );
+  }
+
+  Index getDimension( Index column ) const
+  {
+    return _dimensions.at( static_cast<std::size_t>( column ) );
+  }
+
+  Index getDimension() const
+  {
+    return _dimension;
+  }
+
+  bool operator==( const Mapped& other ) const
+  {
+    if( _dimensions != other._dimensions )
+      return false;
+
+    for( std::size_t j = 0; j < _states.size(); j++ )
+      if( this->getColumn( Index( j ) ) != other.getColumn( Index( j ) ) )
+        return false;
+
+    return true;
+  }
+
+  /** @returns Number of columns that have been copied so far */
+  std::size_t numOwnedColumns() const noexcept
+  {
+    return _columns.size();
+  }
+
+private:
+  enum class State : std::uint8_t
+  {
+    Shared, // Column refers to the shared arrays
+    Owned,  // Column has been copied
+    Empty   // Column has been cleared
+  };
+
+  /** Ensures that a column is owned and returns its storage */
+  std::vector<Index>& own( Index column )
+  {
+    auto j = static_cast<std::size_t>( column );
+
+    if( _states.at( j ) != State::Owned )
+    {
+      auto data    = this->getColumn( column );
+      _states[j]   = State::Owned;
+      _columns[column].swap( data );
+    }
+
+    return _columns[column];
+  }
+
+  std::shared_ptr<const std::uint64_t> _offsets;
+  std::shared_ptr<const Index>         _indices;
+
+  std::vector<State>                                _states;
+  std::unordered_map<Index, std::vector<Index> >    _columns;
+  std::vector<Index>                                _dimensions;
+  Index                                             _dimension = Index(0);
+};
+
+} // namespace representations
+
+} // namespace topology
+
+} // namespace aleph
+
+#endif
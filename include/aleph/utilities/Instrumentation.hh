@@ -0,0 +1,463 @@
+#ifndef ALEPH_UTILITIES_INSTRUMENTATION_HH__
+#define ALEPH_UTILITIES_INSTRUMENTATION_HH__
+
+#include <aleph/config/Instrumentation.hh>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+  Lightweight instrumentation of the library. Algorithms declare phases
+  and increment counters via the macros below. Both are aggregated per
+  thread and merged only when a report is requested, so instrumentation
+  does not introduce any contention in parallel code.
+
+  Instrumentation is compiled in if `ALEPH_WITH_INSTRUMENTATION` is set
+  during configuration. It then still needs to be enabled at runtime via
+  `enable()`; until then, every phase and every counter costs a single
+  relaxed atomic load. If the option is not set, all macros expand to
+  nothing.
+*/
+
+#ifdef ALEPH_WITH_INSTRUMENTATION
+
+  #define ALEPH_INSTRUMENTATION_CONCATENATE_DETAIL( a, b ) a##b
+  #define ALEPH_INSTRUMENTATION_CONCATENATE( a, b ) ALEPH_INSTRUMENTATION_CONCATENATE_DETAIL( a, b )
+
+  /** Measures the remainder of the current scope as a phase with the given name */
+  #define ALEPH_PHASE( name ) \
+    ::aleph::utilities::instrumentation::ScopedPhase ALEPH_INSTRUMENTATION_CONCATENATE( alephPhase, __LINE__ )( name )
+
+  /** Increments a counter, e.g. ALEPH_COUNT( ColumnAdditions, 1 ) */
+  #define ALEPH_COUNT( counter, n ) \
+    ::aleph::utilities::instrumentation::count( ::aleph::utilities::instrumentation::Counter::counter, static_cast<std::uint64_t>( n ) )
+
+#else
+
+  #define ALEPH_PHASE( name )       static_cast<void>( 0 )
+  #define ALEPH_COUNT( counter, n ) static_cast<void>( n )
+
+#endif
+
+namespace aleph
+{
+
+namespace utilities
+{
+
+namespace instrumentation
+{
+
+enum class Counter : unsigned
+{
+  ColumnAdditions,
+  SimplicesEmitted,
+  FacetLookups,
+  MatchingProbes,
+  BytesRead
+};
+
+static const std::size_t numCounters = 5;
+
+/** @returns Name of a counter for use in reports */
+inline const char* name( Counter counter )
+{
+  switch( counter )
+  {
+  case Counter::ColumnAdditions:
+    return "column_additions";
+  case Counter::SimplicesEmitted:
+    return "simplices_emitted";
+  case Counter::FacetLookups:
+    return "facet_lookups";
+  case Counter::MatchingProbes:
+    return "matching_probes";
+  case Counter::BytesRead:
+    return "bytes_read";
+  }
+
+  return "unknown";
+}
+
+/** Accumulated measurements of a single phase */
+struct Phase
+{
+  std::uint64_t calls = 0;
+  double seconds      = 0.0;
+};
+
+/**
+  Merged measurements of all threads. Phases are identified by their
+  path, i.e. the names of all enclosing phases of the same thread,
+  separated by slashes.
+*/
+
+struct Report
+{
+  std::map<std::string, Phase> phases;
+  std::array<std::uint64_t, numCounters> counters = {};
+};
+
+namespace detail
+{
+
+/**
+  Measurements of a single thread. Counters are only written by their
+  own thread, so they do not require read-modify-write operations; they
+  are atomic only to permit reading them while a report is created.
+*/
+
+struct ThreadData
+{
+  ThreadData()
+  {
+    for( auto&& counter : counters )
+      counter.store( 0, std::memory_order_relaxed );
+  }
+
+  std::array<std::atomic<std::uint64_t>, numCounters> counters;
+
+  std::mutex mutex;
+  std::map<std::string, Phase> phases;
+
+  // Paths of all active phases of the thread; the last one is the
+  // innermost phase.
+  std::vector<std::string> paths;
+};
+
+class Registry
+{
+public:
+  static Registry& instance()
+  {
+    static Registry registry;
+    return registry;
+  }
+
+  /** @returns Measurements of the calling thread */
+  ThreadData& local()
+  {
+    thread_local ThreadData* data = nullptr;
+
+    if( !data )
+    {
+      std::lock_guard<std::mutex> lock( _mutex );
+
+      _threads.emplace_back( new ThreadData );
+      data = _threads.back().get();
+    }
+
+    return *data;
+  }
+
+  std::atomic<bool> enabled = { false };
+
+  Report report()
+  {
+    Report report;
+
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    for( auto&& data : _threads )
+    {
+      for( std::size_t i = 0; i < numCounters; i++ )
+        report.counters[i] += data->counters[i].load( std::memory_order_relaxed );
+
+      std::lock_guard<std::mutex> threadLock( data->mutex );
+
+      for( auto&& pair : data->phases )
+      {
+        auto&& phase    = report.phases[ pair.first ];
+        phase.calls    += pair.second.calls;
+        phase.seconds  += pair.second.seconds;
+      }
+    }
+
+    return report;
+  }
+
+  void reset()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    for( auto&& data : _threads )
+    {
+      for( auto&& counter : data->counters )
+        counter.store( 0, std::memory_order_relaxed );
+
+      std::lock_guard<std::mutex> threadLock( data->mutex );
+      data->phases.clear();
+    }
+  }
+
+private:
+  Registry() = default;
+
+  std::mutex _mutex;
+
+  // Thread data is never released because threads refer to it until
+  // they terminate. The number of threads of a process is small enough
+  // for this to be irrelevant.
+  std::vector< std::unique_ptr<ThreadData> > _threads;
+};
+
+} // namespace detail
+
+/** Enables or disables measurements at runtime */
+inline void enable( bool value = true )
+{
+  detail::Registry::instance().enabled.store( value, std::memory_order_relaxed );
+}
+
+/** @returns true if measurements are enabled */
+inline bool enabled()
+{
+  return detail::Registry::instance().enabled.load( std::memory_order_relaxed );
+}
+
+/** @returns true if instrumentation has been compiled in */
+inline constexpr bool available()
+{
+#ifdef ALEPH_WITH_INSTRUMENTATION
+  return true;
+#else
+  return false;
+#endif
+}
+
+/** Increments a counter of the calling thread */
+inline void count( Counter counter, std::uint64_t n )
+{
+  if( !enabled() )
+    return;
+
+  auto&& value = detail::Registry::instance().local().counters[ static_cast<std::size_t>( counter ) ];
+  value.store( value.load( std::memory_order_relaxed ) + n, std::memory_order_relaxed );
+}
+
+/**
+  @class ScopedPhase
+  @brief Measures the lifetime of an object as a phase
+
+  Phases may be nested; nested phases are reported as children of the
+  enclosing phase. Nesting is tracked per thread, so phases that start
+  in a parallel region are reported at the top level.
+*/
+
+class ScopedPhase
+{
+public:
+  explicit ScopedPhase( const char* name )
+  {
+    if( !enabled() )
+      return;
+
+    _data = &detail::Registry::instance().local();
+
+    auto&& paths = _data->paths;
+
+    if( paths.empty() )
+      paths.push_back( name );
+    else
+      paths.push_back( paths.back() + "/" + name );
+
+    _start = std::chrono::steady_clock::now();
+  }
+
+  ~ScopedPhase()
+  {
+    if( !_data )
+      return;
+
+    auto seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - _start ).count();
+
+    {
+      std::lock_guard<std::mutex> lock( _data->mutex );
+
+      auto&& phase    = _data->phases[ _data->paths.back() ];
+      phase.calls    += 1;
+      phase.seconds  += seconds;
+    }
+
+    _data->paths.pop_back();
+  }
+
+  ScopedPhase( const ScopedPhase& )            = delete;
+  ScopedPhase& operator=( const ScopedPhase& ) = delete;
+
+private:
+  detail::ThreadData* _data = nullptr;
+  std::chrono::steady_clock::time_point _start;
+};
+
+/** @returns Merged measurements of all threads */
+inline Report report()
+{
+  return detail::Registry::instance().report();
+}
+
+/** Resets all measurements */
+inline void reset()
+{
+  detail::Registry::instance().reset();
+}
+
+/**
+  Prints a report as a table. Nested phases are indented below their
+  enclosing phase.
+*/
+
+inline void print( std::ostream& o, const Report& report )
+{
+  o << std::left  << std::setw(40) << "Phase"
+    << std::right << std::setw(12) << "Calls"
+    << std::right << std::setw(16) << "Time [s]" << "\n";
+
+  for( auto&& pair : report.phases )
+  {
+    auto&& path  = pair.first;
+    auto depth   = std::count( path.begin(), path.end(), '/' );
+    auto name    = path.substr( path.find_last_of( '/' ) + 1 );
+
+    o << std::left  << std::setw(40) << ( std::string( 2 * static_cast<std::size_t>( depth ), ' ' ) + name )
+      << std::right << std::setw(12) << pair.second.calls
+      << std::right << std::setw(16) << std::fixed << std::setprecision(6) << pair.second.seconds << "\n";
+  }
+
+  o << "\n"
+    << std::left  << std::setw(40) << "Counter"
+    << std::right << std::setw(12) << "Value" << "\n";
+
+  for( std::size_t i = 0; i < numCounters; i++ )
+  {
+    o << std::left  << std::setw(40) << name( static_cast<Counter>( i ) )
+      << std::right << std::setw(12) << report.counters[i] << "\n";
+  }
+}
+
+/** Prints a report in JSON format */
+inline void printJSON( std::ostream& o, const Report& report )
+{
+  o << "{\n"
+    << "  \"phases\": [";
+
+  for( auto it = report.phases.begin(); it != report.phases.end(); ++it )
+  {
+    o << ( it == report.phases.begin() ? "\n" : ",\n" )
+      << "    { \"path\": \"" << it->first << "\", "
+      << "\"calls\": " << it->second.calls << ", "
+      << "\"seconds\": " << std::setprecision(9) << it->second.seconds << " }";
+  }
+
+  o << "\n  ],\n"
+    << "  \"counters\": {";
+
+  for( std::size_t i = 0; i < numCounters; i++ )
+  {
+    o << ( i == 0 ? "\n" : ",\n" )
+      << "    \"" << name( static_cast<Counter>( i ) ) << "\": " << report.counters[i];
+  }
+
+  o << "\n  }\n"
+    << "}\n";
+}
+
+/**
+  Writes a report of all measurements, using JSON if the filename ends
+  with ".json" and a table otherwise. The special filename "-" writes a
+  table to STDERR.
+*/
+
+inline void writeReport( const std::string& filename )
+{
+  auto r = report();
+
+  if( filename == "-" )
+  {
+    print( std::cerr, r );
+    return;
+  }
+
+  std::ofstream out( filename );
+  if( !out )
+    throw std::runtime_error( "Unable to open '" + filename + "' for writing" );
+
+  auto suffix = std::string( ".json" );
+
+  if( filename.size() >= suffix.size() && filename.compare( filename.size() - suffix.size(), suffix.size(), suffix ) == 0 )
+    printJSON( out, r );
+  else
+    print( out, r );
+}
+
+/**
+  @class ScopedReport
+  @brief Enables measurements and reports them when going out of scope
+
+  This is meant to be used in the main function of a tool, such that
+  the report is written whenever main() returns, including the early
+  returns for invalid inputs. Since the report is written by the
+  destructor, it is not written if the tool calls std::exit() or if an
+  exception leaves main(), because the stack is not necessarily unwound
+  in this case. An empty filename disables the report.
+*/
+
+class ScopedReport
+{
+public:
+  explicit ScopedReport( std::string filename )
+    : _filename( std::move( filename ) )
+  {
+    if( _filename.empty() )
+      return;
+
+    if( !available() )
+      std::cerr << "* Instrumentation is not available in this build; the report will be empty\n";
+
+    enable();
+  }
+
+  ~ScopedReport()
+  {
+    if( _filename.empty() )
+      return;
+
+    try
+    {
+      writeReport( _filename );
+    }
+    catch( std::exception& e )
+    {
+      std::cerr << "* Unable to write report: " << e.what() << "\n";
+    }
+  }
+
+  ScopedReport( const ScopedReport& )            = delete;
+  ScopedReport& operator=( const ScopedReport& ) = delete;
+
+private:
+  std::string _filename;
+};
+
+} // namespace instrumentation
+
+} // namespace utilities
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef ALEPH_UTILITIES_MEMORY_MAPPED_FILE_HH__
+#define ALEPH_UTILITIES_MEMORY_MAPPED_FILE_HH__
+
+#if defined(__unix__) || defined(__unix) || ( defined(__APPLE__) && defined(__MACH__) )
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <aleph/utilities/Instrumentation.hh>
+
+#include <cstddef>
+
+#include <stdexcept>
+#include <string>
+
+namespace aleph
+{
+
+namespace utilities
+{
+
+/**
+  @class MemoryMappedFile
+  @brief Read-only view of a file that is mapped into memory
+
+  Maps a complete file into memory so that its contents can be accessed
+  without copying them into a buffer first. The mapping is read-only, so
+  its pages are always shared with the page cache. Data that has to be
+  converted, e.g. because of its byte order, needs to be copied.
+*/
+
+class MemoryMappedFile
+{
+public:
+
+  /**
+    Maps the given file into memory.
+
+    @throws std::runtime_error if the file cannot be opened or mapped
+  */
+
+  explicit MemoryMappedFile( const std::string& filename )
+  {
+#if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L
+    int fd = ::open( filename.c_str(), O_RDONLY );
+    if( fd < 0 )
+      throw std::runtime_error( "Unable to read input file" );
+
+    struct stat status;
+    if( ::fstat( fd, &status ) != 0 )
+    {
+      ::close( fd );
+      throw std::runtime_error( "Unable to determine size of input file" );
+    }
+
+    _size = static_cast<std::size_t>( status.st_size );
+
+    // Mapping an empty file is not permitted, but there is nothing to
+    // read anyway.
+    if( _size > 0 )
+    {
+      void* address = ::mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0 );
+      if( address == MAP_FAILED )
+      {
+        ::close( fd );
+        throw std::runtime_error( "Unable to map input file into memory" );
+      }
+
+      _data = static_cast<const unsigned char*>( address );
+
+  #ifdef POSIX_MADV_SEQUENTIAL
+      ::posix_madvise( address, _size, POSIX_MADV_SEQUENTIAL );
+  #endif
+    }
+
+    // The mapping remains valid after closing the descriptor
+    ::close( fd );
+
+    // Files are only mapped in order to be read completely, so mapping
+    // a file is counted as reading it.
+    ALEPH_COUNT( BytesRead, _size );
+#else
+  #error "No compatible implementation of memory-mapped files available"
+#endif
+  }
+
+  ~MemoryMappedFile()
+  {
+    if( _data )
+      ::munmap( const_cast<unsigned char*>( _data ), _size );
+  }
+
+  MemoryMappedFile( const MemoryMappedFile& )            = delete;
+  MemoryMappedFile& operator=( const MemoryMappedFile& ) = delete;
+
+  /** @returns Pointer to the first byte of the file */
+  const unsigned char* data() const noexcept { return _data; }
+
+  /** @returns Size of the file in bytes */
+  std::size_t size() const noexcept { return _size; }
+
+private:
+  const unsigned char* _data = nullptr;
+  std::size_t    _size = 0;
+};
+
+} // namespace utilities
+
+} // namespace aleph
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef ALEPH_UTILITIES_PARALLEL_SORT_HH__
+#define ALEPH_UTILITIES_PARALLEL_SORT_HH__
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+
+namespace aleph
+{
+
+namespace utilities
+{
+
+/**
+  Sorts a range in parallel. The range is split into blocks of a fixed
+  size, which are sorted independently. Afterwards, adjacent blocks are
+  merged in rounds, such that every round doubles the size of the sorted
+  blocks. Blocks of the same round are processed in parallel.
+
+  The function falls back to a sequential sort for small ranges, or if
+  OpenMP is not available. Like std::sort, the sort is not stable.
+
+  @param begin   Iterator to the beginning of the range
+  @param end     Iterator to the end of the range
+  @param compare Strict weak ordering of the elements; the functor must
+                 support being called concurrently.
+*/
+
+template <class RandomAccessIterator, class Compare> void parallelSort( RandomAccessIterator begin,
+                                                                        RandomAccessIterator end,
+                                                                        Compare compare )
+{
+  using Difference = typename std::iterator_traits<RandomAccessIterator>::difference_type;
+
+  static const Difference blockSize = Difference( 1 ) << 16;
+
+  auto n = std::distance( begin, end );
+
+  if( n <= blockSize )
+  {
+    std::sort( begin, end, compare );
+    return;
+  }
+
+  auto numBlocks = ( n + blockSize - 1 ) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic, 1)
+  for( Difference i = 0; i < numBlocks; i++ )
+  {
+    auto first = begin + i * blockSize;
+    auto last  = begin + std::min( n, ( i + 1 ) * blockSize );
+
+    std::sort( first, last, compare );
+  }
+
+  for( Difference width = blockSize; width < n; width *= 2 )
+  {
+    auto numMerges = ( n + 2 * width - 1 ) / ( 2 * width );
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for( Difference i = 0; i < numMerges; i++ )
+    {
+      auto first  = begin + i * 2 * width;
+      auto middle = begin + std::min( n, i * 2 * width + width );
+      auto last   = begin + std::min( n, ( i + 1 ) * 2 * width );
+
+      std::inplace_merge( first, middle, last, compare );
+    }
+  }
+}
+
+/** Sorts a range in parallel, using the default order of its elements */
+template <class RandomAccessIterator> void parallelSort( RandomAccessIterator begin,
+                                                         RandomAccessIterator end )
+{
+  using Value = typename std::iterator_traits<RandomAccessIterator>::value_type;
+
+  parallelSort( begin, end, [] ( const Value& a, const Value& b ) { return a < b; } );
+}
+
+} // namespace utilities
+
+} // namespace aleph
+
+#endif
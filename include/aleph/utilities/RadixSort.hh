@@ -0,0 +1,233 @@
+#ifndef ALEPH_UTILITIES_RADIX_SORT_HH__
+#define ALEPH_UTILITIES_RADIX_SORT_HH__
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aleph
+{
+
+namespace utilities
+{
+
+/**
+  Maps a floating point value to an unsigned key with the same order.
+  Negative values are inverted completely, while non-negative values
+  only have their sign bit set. Both zeros are mapped to the same key
+  because they compare equal.
+
+  NaNs are not treated specially: they are mapped by their bits, so a
+  NaN without a sign bit is placed after positive infinity, and a NaN
+  with a sign bit before negative infinity. This keeps the order total
+  and deterministic, whereas a comparison-based sort has no defined
+  result for NaNs. Callers that have to reproduce such a sort must not
+  pass NaNs.
+*/
+
+template <class T> typename std::enable_if<std::is_floating_point<T>::value, std::uint64_t>::type radixKey( T x ) noexcept
+{
+  static_assert( sizeof(T) == sizeof(std::uint32_t) || sizeof(T) == sizeof(std::uint64_t), "Unsupported floating point type" );
+
+  using Bits = typename std::conditional<sizeof(T) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>::type;
+
+  if( x == T(0) )
+    x = T(0);
+
+  Bits bits;
+  std::memcpy( &bits, &x, sizeof(T) );
+
+  auto sign = Bits(1) << ( 8 * sizeof(T) - 1 );
+
+  if( bits & sign )
+    bits = Bits( ~bits );
+  else
+    bits = Bits( bits | sign );
+
+  return std::uint64_t( bits );
+}
+
+/** Maps an integral value to an unsigned key with the same order */
+template <class T> typename std::enable_if<std::is_integral<T>::value, std::uint64_t>::type radixKey( T x ) noexcept
+{
+  static_assert( sizeof(T) <= sizeof(std::uint64_t), "Unsupported integral type" );
+
+  auto key = static_cast<std::uint64_t>( x );
+
+  if( std::is_signed<T>::value )
+    key ^= std::uint64_t(1) << 63;
+
+  return key;
+}
+
+namespace detail
+{
+
+/**
+  Sorts a sequence of items stably by their keys, using a radix sort on
+  the bytes of the keys, starting with the least significant one. Bytes
+  that are the same for all keys, e.g. the upper bytes of small integers,
+  are skipped. Large sequences are split into blocks that are counted and
+  distributed in parallel.
+
+  @param items  Items to sort
+  @param buffer Temporary storage, which is resized as required
+  @param key    Functor for obtaining the key of an item
+*/
+
+template <class T, class Key> void radixSort( std::vector<T>& items, std::vector<T>& buffer, Key&& key )
+{
+  static const std::size_t numDigits = sizeof(std::uint64_t);
+  static const std::size_t blockSize = 1 << 16;
+  static const std::size_t maxBlocks = 64;
+
+  using Counts = std::array<std::size_t, 256>;
+
+  auto n = items.size();
+
+  if( n == 0 )
+    return;
+
+  auto numBlocks = std::min( n / blockSize + 1, maxBlocks );
+
+  auto digit = [&key] ( const T& item, std::size_t d )
+  {
+    return static_cast<std::size_t>( ( key( item ) >> ( 8 * d ) ) & 0xFF );
+  };
+
+  // Counts of all digits of every block. They are used to detect digits
+  // that are shared by all keys, and they are valid for the first pass
+  // that is not skipped.
+  std::vector< std::array<Counts, numDigits> > counts( numBlocks );
+
+  #pragma omp parallel for if( numBlocks > 1 )
+  for( std::size_t b = 0; b < numBlocks; b++ )
+  {
+    for( auto&& count : counts[b] )
+      count.fill( 0 );
+
+    for( auto i = b * n / numBlocks; i < ( b + 1 ) * n / numBlocks; i++ )
+    {
+      auto k = key( items[i] );
+
+      for( std::size_t d = 0; d < numDigits; d++ )
+        ++counts[b][d][ ( k >> ( 8 * d ) ) & 0xFF ];
+    }
+  }
+
+  buffer.resize( n );
+
+  std::vector<Counts> offsets( numBlocks );
+
+  bool first = true;
+
+  for( std::size_t d = 0; d < numDigits; d++ )
+  {
+    auto value = digit( items.front(), d );
+    auto total = std::size_t( 0 );
+
+    for( std::size_t b = 0; b < numBlocks; b++ )
+      total += counts[b][d][value];
+
+    // All keys share this byte, so the pass would not change the order
+    if( total == n )
+      continue;
+
+    // Every block counts its digits, and the blocks are then assigned
+    // consecutive ranges of the output for every digit. This keeps the
+    // sort stable.
+    if( first )
+    {
+      for( std::size_t b = 0; b < numBlocks; b++ )
+        offsets[b] = counts[b][d];
+
+      first = false;
+    }
+    else
+    {
+      #pragma omp parallel for if( numBlocks > 1 )
+      for( std::size_t b = 0; b < numBlocks; b++ )
+      {
+        offsets[b].fill( 0 );
+
+        for( auto i = b * n / numBlocks; i < ( b + 1 ) * n / numBlocks; i++ )
+          ++offsets[b][ digit( items[i], d ) ];
+      }
+    }
+
+    std::size_t offset = 0;
+
+    for( std::size_t v = 0; v < 256; v++ )
+    {
+      for( std::size_t b = 0; b < numBlocks; b++ )
+      {
+        auto count    = offsets[b][v];
+        offsets[b][v] = offset;
+        offset       += count;
+      }
+    }
+
+    #pragma omp parallel for if( numBlocks > 1 )
+    for( std::size_t b = 0; b < numBlocks; b++ )
+    {
+      for( auto i = b * n / numBlocks; i < ( b + 1 ) * n / numBlocks; i++ )
+        buffer[ offsets[b][ digit( items[i], d ) ]++ ] = items[i];
+    }
+
+    items.swap( buffer );
+  }
+}
+
+} // namespace detail
+
+/**
+  Sorts a sequence of keys and values stably by their keys, using a
+  radix sort. No comparisons are required. Storing keys next to their
+  values avoids random accesses during the sort.
+
+  @param items  Keys and values to sort
+  @param buffer Temporary storage, which is resized as required; this
+                permits reusing the memory for multiple sorts
+*/
+
+template <class T> void radixSort( std::vector< std::pair<std::uint64_t, T> >& items,
+                                   std::vector< std::pair<std::uint64_t, T> >& buffer )
+{
+  detail::radixSort( items, buffer,
+                     [] ( const std::pair<std::uint64_t, T>& item )
+                     {
+                       return item.first;
+                     } );
+}
+
+/**
+  Sorts a sequence of indices stably by their keys, using a radix sort.
+  No comparisons are required.
+
+  @param indices Indices to sort, which refer to the keys
+  @param keys    Keys of all indices
+  @param buffer  Temporary storage, which is resized as required; this
+                 permits reusing the memory for multiple sorts
+*/
+
+template <class Index> void radixSort( std::vector<Index>& indices,
+                                       const std::vector<std::uint64_t>& keys,
+                                       std::vector<Index>& buffer )
+{
+  detail::radixSort( indices, buffer,
+                     [&keys] ( Index index )
+                     {
+                       return keys[ static_cast<std::size_t>( index ) ];
+                     } );
+}
+
+} // namespace utilities
+
+} // namespace aleph
+
+#endif
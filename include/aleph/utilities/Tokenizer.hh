@@ -0,0 +1,556 @@
+#ifndef ALEPH_UTILITIES_TOKENIZER_HH__
+#define ALEPH_UTILITIES_TOKENIZER_HH__
+
+#include <aleph/utilities/MemoryMappedFile.hh>
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+namespace aleph
+{
+
+namespace utilities
+{
+
+/**
+  @class StringView
+  @brief Non-owning view of a contiguous range of characters
+
+  A view does not allocate any memory, and it is only valid as long as
+  the underlying characters, e.g. a string or a memory-mapped file, are
+  valid. It is used by the tokenizer to refer to tokens without copying
+  them.
+*/
+
+class StringView
+{
+public:
+  StringView() = default;
+
+  StringView( const char* begin, const char* end )
+    : _begin( begin )
+    , _end( end )
+  {
+  }
+
+  StringView( const std::string& string )
+    : _begin( string.data() )
+    , _end( string.data() + string.size() )
+  {
+  }
+
+  const char* begin() const noexcept { return _begin; }
+  const char* end()   const noexcept { return _end;   }
+
+  std::size_t size() const noexcept { return static_cast<std::size_t>( _end - _begin ); }
+  bool empty()       const noexcept { return _begin == _end; }
+
+  char front() const noexcept { return *_begin; }
+
+  char operator[]( std::size_t i ) const noexcept { return _begin[i]; }
+
+  /** @returns Copy of the characters in the view */
+  std::string str() const
+  {
+    return std::string( _begin, _end );
+  }
+
+  bool operator==( const char* string ) const noexcept
+  {
+    auto n = std::strlen( string );
+    return n == this->size() && std::equal( _begin, _end, string );
+  }
+
+  bool operator!=( const char* string ) const noexcept
+  {
+    return !this->operator==( string );
+  }
+
+private:
+  const char* _begin = nullptr;
+  const char* _end   = nullptr;
+};
+
+/**
+  @class Tokenizer
+  @brief Splits a range of characters into tokens without allocating
+
+  Tokens are separated by any non-empty sequence of delimiter characters.
+  By default, white-space characters are used as delimiters. In contrast
+  to splitting with a regular expression, empty tokens are never reported,
+  so leading or trailing delimiters do not have to be removed.
+*/
+
+class Tokenizer
+{
+public:
+  Tokenizer( const char* begin, const char* end, const char* delimiters = " \t\n\v\f\r" )
+    : _current( begin )
+    , _end( end )
+  {
+    std::fill( _isDelimiter, _isDelimiter + 256, false );
+
+    for( auto c = delimiters; *c; ++c )
+      _isDelimiter[ static_cast<unsigned char>( *c ) ] = true;
+  }
+
+  explicit Tokenizer( StringView view, const char* delimiters = " \t\n\v\f\r" )
+    : Tokenizer( view.begin(), view.end(), delimiters )
+  {
+  }
+
+  /**
+    Extracts the next token.
+
+    @param token View of the next token; only valid if the function
+                 returns true
+
+    @returns true if a token was found, false if the range has been
+    exhausted
+  */
+
+  bool next( StringView& token ) noexcept
+  {
+    while( _current != _end && isDelimiter( *_current ) )
+      ++_current;
+
+    if( _current == _end )
+      return false;
+
+    auto begin = _current;
+
+    while( _current != _end && !isDelimiter( *_current ) )
+      ++_current;
+
+    token = StringView( begin, _current );
+    return true;
+  }
+
+private:
+  bool isDelimiter( char c ) const noexcept
+  {
+    return _isDelimiter[ static_cast<unsigned char>( c ) ];
+  }
+
+  const char* _current;
+  const char* _end;
+
+  bool _isDelimiter[256];
+};
+
+/**
+  @class LineReader
+  @brief Enumerates the lines of a memory-mapped file
+
+  The file is mapped into memory, and every line is reported as a view,
+  so reading a file does not require any copies. Line terminators, i.e.
+  '\\n' and '\\r\\n', are not part of the lines.
+*/
+
+class LineReader
+{
+public:
+  explicit LineReader( const std::string& filename )
+    : _file( filename )
+  {
+    _current = reinterpret_cast<const char*>( _file.data() );
+    _end     = _current + _file.size();
+  }
+
+  /**
+    Extracts the next line.
+
+    @param line View of the next line; only valid if the function returns
+                true, and as long as the reader exists
+
+    @returns true if a line was found, false if the file has been exhausted
+  */
+
+  bool next( StringView& line ) noexcept
+  {
+    if( _current == _end )
+      return false;
+
+    auto begin = _current;
+    auto end   = static_cast<const char*>( std::memchr( begin, '\n', static_cast<std::size_t>( _end - begin ) ) );
+
+    if( end )
+      _current = end + 1;
+    else
+      _current = end = _end;
+
+    if( end != begin && *( end - 1 ) == '\r' )
+      --end;
+
+    line = StringView( begin, end );
+    return true;
+  }
+
+  /** Restarts the enumeration at the first line of the file */
+  void rewind() noexcept
+  {
+    _current = reinterpret_cast<const char*>( _file.data() );
+  }
+
+  /** @returns Complete contents of the file */
+  StringView contents() const noexcept
+  {
+    auto begin = reinterpret_cast<const char*>( _file.data() );
+    return StringView( begin, begin + _file.size() );
+  }
+
+private:
+  MemoryMappedFile _file;
+
+  const char* _current = nullptr;
+  const char* _end     = nullptr;
+};
+
+namespace detail
+{
+
+/** Compares a token to a lowercase string, ignoring the case of the token */
+inline bool equalsIgnoringCase( StringView token, const char* string ) noexcept
+{
+  auto n = std::strlen( string );
+  if( n != token.size() )
+    return false;
+
+  for( std::size_t i = 0; i < n; i++ )
+    if( std::tolower( static_cast<unsigned char>( token[i] ) ) != string[i] )
+      return false;
+
+  return true;
+}
+
+/**
+  Parses the special tokens for infinity and NaN, just like convert() in
+  String.hh does.
+*/
+
+template <class T> bool parseSpecial( StringView token, T& result ) noexcept
+{
+  if( !std::numeric_limits<T>::has_infinity )
+    return false;
+
+  if(    equalsIgnoringCase( token, "+inf" ) || equalsIgnoringCase( token, "inf" )
+      || equalsIgnoringCase( token, "+infinity" ) || equalsIgnoringCase( token, "infinity" ) )
+    result = std::numeric_limits<T>::infinity();
+  else if( equalsIgnoringCase( token, "-inf" ) || equalsIgnoringCase( token, "-infinity" ) )
+    result = -std::numeric_limits<T>::infinity();
+  else if( equalsIgnoringCase( token, "nan" ) )
+    result = std::numeric_limits<T>::quiet_NaN();
+  else
+    return false;
+
+  return true;
+}
+
+/**
+  Parses the longest prefix of a token that forms an integer. Values
+  that exceed the range of the type are clamped, as is the case for a
+  stream. The end of the prefix is stored in the last parameter.
+*/
+
+template <class T> bool parseInteger( StringView token, T& result, const char*& last ) noexcept
+{
+  auto it  = token.begin();
+  auto end = token.end();
+
+  bool negative = false;
+
+  if( it != end && ( *it == '+' || *it == '-' ) )
+    negative = *it++ == '-';
+
+  if( it == end || !std::isdigit( static_cast<unsigned char>( *it ) ) )
+    return false;
+
+  using U = typename std::make_unsigned<T>::type;
+
+  // Largest magnitude that can be represented for the given sign
+  U limit = std::is_signed<T>::value
+          ? ( negative ? U( U( std::numeric_limits<T>::max() ) + 1 ) : U( std::numeric_limits<T>::max() ) )
+          : std::numeric_limits<U>::max();
+
+  U value       = 0;
+  bool overflow = false;
+
+  for( ; it != end && std::isdigit( static_cast<unsigned char>( *it ) ); ++it )
+  {
+    auto digit = static_cast<U>( *it - '0' );
+
+    if( value > U( ( limit - digit ) / 10 ) )
+      overflow = true;
+    else
+      value = U( value * 10 + digit );
+  }
+
+  last = it;
+
+  if( overflow )
+  {
+    result = negative && std::is_signed<T>::value ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    return true;
+  }
+
+  // Negative values for unsigned types wrap around, which is what the
+  // standard library does as well.
+  if( negative )
+    result = static_cast<T>( U( U(0) - value ) );
+  else
+    result = static_cast<T>( value );
+
+  return true;
+}
+
+template <class T> struct FastPath;
+
+template <> struct FastPath<float>
+{
+  static constexpr std::uint64_t maxMantissa = std::uint64_t(1) << 24;
+  static constexpr int           maxExponent = 10;
+};
+
+template <> struct FastPath<double>
+{
+  static constexpr std::uint64_t maxMantissa = std::uint64_t(1) << 53;
+  static constexpr int           maxExponent = 22;
+};
+
+template <class T> T strtoT( const char* s, char** end );
+
+template <> inline float       strtoT<float>      ( const char* s, char** end ) { return std::strtof( s, end );  }
+template <> inline double      strtoT<double>     ( const char* s, char** end ) { return std::strtod( s, end );  }
+template <> inline long double strtoT<long double>( const char* s, char** end ) { return std::strtold( s, end ); }
+
+/**
+  Parses the longest prefix of a token that forms a decimal floating
+  point number. Numbers with a short mantissa and a small exponent are
+  calculated exactly, using a single multiplication or division. Every
+  other number is handed to the C library, which rounds correctly, just
+  like a stream would. The end of the prefix is stored in the last
+  parameter.
+*/
+
+template <class T> bool parseFloatingPoint( StringView token, T& result, const char*& last )
+{
+  auto it  = token.begin();
+  auto end = token.end();
+
+  bool negative = false;
+
+  if( it != end && ( *it == '+' || *it == '-' ) )
+    negative = *it++ == '-';
+
+  std::uint64_t mantissa = 0;
+  int numDigits          = 0;     // significant digits in the mantissa
+  int exponent           = 0;     // decimal exponent of the mantissa
+  bool hasDigits         = false;
+  bool exact             = true;  // mantissa fits into 19 digits
+
+  auto isDigit = [] ( char c ) { return std::isdigit( static_cast<unsigned char>( c ) ) != 0; };
+
+  for( ; it != end && isDigit( *it ); ++it )
+  {
+    hasDigits = true;
+
+    if( numDigits < 19 )
+    {
+      mantissa = mantissa * 10 + std::uint64_t( *it - '0' );
+      if( mantissa != 0 )
+        ++numDigits;
+    }
+    else
+    {
+      exact = false;
+      ++exponent;
+    }
+  }
+
+  if( it != end && *it == '.' )
+  {
+    ++it;
+
+    for( ; it != end && isDigit( *it ); ++it )
+    {
+      hasDigits = true;
+
+      if( numDigits < 19 )
+      {
+        mantissa = mantissa * 10 + std::uint64_t( *it - '0' );
+        if( mantissa != 0 )
+          ++numDigits;
+
+        --exponent;
+      }
+      else
+        exact = false;
+    }
+  }
+
+  if( !hasDigits )
+    return false;
+
+  // An exponent without any digits is an error, just as it is for a
+  // stream, which does not back up to the 'e'.
+  if( it != end && ( *it == 'e' || *it == 'E' ) )
+  {
+    ++it;
+    bool negativeExponent = false;
+
+    if( it != end && ( *it == '+' || *it == '-' ) )
+      negativeExponent = *it++ == '-';
+
+    if( it == end || !isDigit( *it ) )
+      return false;
+
+    int value = 0;
+
+    for( ; it != end && isDigit( *it ); ++it )
+      if( value < 100000 )
+        value = value * 10 + ( *it - '0' );
+
+    exponent += negativeExponent ? -value : value;
+  }
+
+  last = it;
+
+  if( std::is_same<T, float>::value || std::is_same<T, double>::value )
+  {
+    using F = typename std::conditional<std::is_same<T, float>::value, float, double>::type;
+
+    if( exact && mantissa <= FastPath<F>::maxMantissa && exponent >= -FastPath<F>::maxExponent && exponent <= FastPath<F>::maxExponent )
+    {
+      static const F powers[] = { F(1e0),  F(1e1),  F(1e2),  F(1e3),  F(1e4),  F(1e5),
+                                  F(1e6),  F(1e7),  F(1e8),  F(1e9),  F(1e10), F(1e11),
+                                  F(1e12), F(1e13), F(1e14), F(1e15), F(1e16), F(1e17),
+                                  F(1e18), F(1e19), F(1e20), F(1e21), F(1e22) };
+
+      F value = static_cast<F>( mantissa );
+
+      if( exponent < 0 )
+        value /= powers[ -exponent ];
+      else
+        value *= powers[ exponent ];
+
+      result = static_cast<T>( negative ? -value : value );
+      return true;
+    }
+  }
+
+  // Slow path: copy the prefix into a null-terminated buffer, which
+  // only requires an allocation for extremely long numbers.
+  using C = typename std::conditional<std::is_same<T, float>::value, float,
+              typename std::conditional<std::is_same<T, double>::value, double, long double>::type>::type;
+
+  auto length = static_cast<std::size_t>( it - token.begin() );
+
+  char buffer[128];
+
+  if( length < sizeof( buffer ) )
+  {
+    std::copy( token.begin(), it, buffer );
+    buffer[length] = '\0';
+
+    result = static_cast<T>( strtoT<C>( buffer, nullptr ) );
+  }
+  else
+  {
+    std::string string( token.begin(), it );
+    result = static_cast<T>( strtoT<C>( string.c_str(), nullptr ) );
+  }
+
+  // Values that are out of range are clamped, just as for a stream
+  if( result == std::numeric_limits<T>::infinity() )
+    result = std::numeric_limits<T>::max();
+  else if( result == -std::numeric_limits<T>::infinity() )
+    result = -std::numeric_limits<T>::max();
+
+  return true;
+}
+
+template <class T> bool parseNumber( StringView token, T& result, const char*& last, std::true_type /* floating point */ )
+{
+  return parseFloatingPoint( token, result, last );
+}
+
+template <class T> bool parseNumber( StringView token, T& result, const char*& last, std::false_type /* floating point */ ) noexcept
+{
+  return parseInteger( token, result, last );
+}
+
+/**
+  Indicates whether a type can be parsed as a number. Character types
+  are excluded because streams treat them as characters.
+*/
+
+template <class T> struct IsNumber
+{
+  static constexpr bool value =    std::is_floating_point<T>::value
+                                || (    std::is_integral<T>::value
+                                     && !std::is_same<T, bool>::value
+                                     && !std::is_same<T, char>::value
+                                     && !std::is_same<T, signed char>::value
+                                     && !std::is_same<T, unsigned char>::value );
+};
+
+} // namespace detail
+
+/**
+  Converts a token to a number without allocating any memory. As with
+  convert() in String.hh, the longest prefix of the token that forms a
+  number is used, and the special tokens for infinity and NaN are also
+  supported, regardless of their case. If no number can be parsed, the
+  default value of the type is returned.
+*/
+
+template <class T> typename std::enable_if<detail::IsNumber<T>::value, T>::type convert( StringView token )
+{
+  T result         = T();
+  const char* last = nullptr;
+
+  if( !detail::parseNumber( token, result, last, std::is_floating_point<T>() ) )
+  {
+    result = T();
+    detail::parseSpecial( token, result );
+  }
+
+  return result;
+}
+
+/**
+  Parses a token that must consist of a single number. In contrast to
+  convert(), trailing characters are not permitted, and the function
+  reports whether parsing was successful. The special tokens for
+  infinity and NaN are supported as well.
+
+  @param token  Token to parse
+  @param result Output parameter for the number; only valid if the
+                function returns true
+
+  @returns true if the complete token forms a number, else false
+*/
+
+template <class T> typename std::enable_if<detail::IsNumber<T>::value, bool>::type parse( StringView token, T& result )
+{
+  const char* last = nullptr;
+
+  if( detail::parseNumber( token, result, last, std::is_floating_point<T>() ) && last == token.end() )
+    return true;
+
+  result = T();
+  return detail::parseSpecial( token, result );
+}
+
+} // namespace utilities
+
+} // namespace aleph
+
+#endif
@@ -39,9 +39,9 @@
 #include <aleph/persistenceDiagrams/Norms.hh>
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 
+#include <aleph/persistentHomology/CliquePersistence.hh>
 #include <aleph/persistentHomology/ConnectedComponents.hh>
 
-#include <aleph/topology/CliqueGraph.hh>
 #include <aleph/topology/ConnectedComponents.hh>
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
@@ -53,6 +53,7 @@
 #include <aleph/topology/io/Pajek.hh>
 
 #include <aleph/utilities/Filesystem.hh>
+#include <aleph/utilities/Instrumentation.hh>
 
 using DataType           = double;
 using VertexType         = unsigned;
@@ -155,6 +156,21 @@ public:
     _destruction = threshold;
   }
 
+  /**
+    Merges the vertex information of another functor into the current
+    one. This is required when clique communities of different orders
+    are being tracked by different functors.
+  */
+
+  void merge( const CliqueCommunityInformationFunctor& other )
+  {
+    for( auto&& pair : other._vim )
+    {
+      _vim[pair.first].accumulatedPersistence    += pair.second.accumulatedPersistence;
+      _vim[pair.first].numberOfCliqueCommunities += pair.second.numberOfCliqueCommunities;
+    }
+  }
+
   /** Query component size information */
   unsigned getComponentSize( VertexType vertex ) const
   {
@@ -234,6 +250,7 @@ void usage()
 {
   std::cerr << "Usage: clique_persistence_diagram [--ignore-empty] [--invert-weights]\n"
             << "                                  [--min-k] [--normalize] [--reverse]\n"
+            << "                                  [--profile FILE]\n"
             << "                                  FILE K\n"
             << "\n"
             << "Calculates the clique persistence diagram for FILE, which is\n"
@@ -259,6 +276,11 @@ void usage()
             << " --normalize     : Normalizes all weights to [0,1]. Use this\n"
             << "                   to compare multiple networks.\n"
             << "\n"
+            << " --profile FILE  : Writes a report of the time spent in every\n"
+            << "                   phase of the calculation to FILE, using a\n"
+            << "                   JSON format if FILE ends with '.json'. Use\n"
+            << "                   '-' for writing the report to STDERR.\n"
+            << "\n"
             << " --reverse       : Reverses the enumeration order of cliques\n"
             << "                   by looking for higher-dimensional cliques\n"
             << "                   before enumerating lower-dimensional ones\n"
@@ -275,6 +297,7 @@ int main( int argc, char** argv )
     { "normalize"     , no_argument      , nullptr, 'n' },
     { "reverse"       , no_argument      , nullptr, 'r' },
     { "min-k"         , required_argument, nullptr, 'k' },
+    { "profile"       , required_argument, nullptr, 'P' },
     { nullptr         , 0                , nullptr,  0  }
   };
 
@@ -283,9 +306,10 @@ int main( int argc, char** argv )
   bool normalize           = false;
   bool reverse             = false;
   unsigned minK            = 0;
+  std::string profile;
 
   int option = 0;
-  while( ( option = getopt_long( argc, argv, "k:einr", commandLineOptions, nullptr ) ) != -1 )
+  while( ( option = getopt_long( argc, argv, "k:P:einr", commandLineOptions, nullptr ) ) != -1 )
   {
     switch( option )
     {
@@ -309,6 +333,10 @@ int main( int argc, char** argv )
       reverse = true;
       break;
 
+    case 'P':
+      profile = optarg;
+      break;
+
     default:
       break;
     }
@@ -320,6 +348,8 @@ int main( int argc, char** argv )
     return -1;
   }
 
+  aleph::utilities::instrumentation::ScopedReport report( profile );
+
   std::string filename = argv[optind++];
   unsigned maxK        = static_cast<unsigned>( std::stoul( argv[optind++] ) );
 
@@ -466,36 +496,47 @@ int main( int argc, char** argv )
   CliqueCommunityInformationFunctor ccif( K );
   ccif.setDestructionThreshold( 2 * maxWeight );
 
+  // The persistence calculations for all clique graphs are performed in
+  // a single sweep. Every k requires its own functor because the graphs
+  // are being processed concurrently.
+  std::vector<CliqueCommunityInformationFunctor> functors( maxK + 1, ccif );
+
+  // A top-down expansion contains all simplices of dimension minK and
+  // above, so the first non-empty clique graph is the one for minK. If
+  // the expansion is not reversed, the minimum order is ignored.
+  unsigned firstK = reverse ? std::max( minK, 1u ) : 1u;
+
+  std::cerr << "* Calculating clique community persistence for k=" << firstK << ",...," << maxK << "...";
+
+  auto&& results
+    = aleph::calculateCliquePersistence<VertexType, aleph::traits::PersistencePairingCalculation<aleph::PersistencePairing<VertexType> > >( K, firstK, maxK, functors );
+
+  std::cerr << "finished\n";
+
   // By traversing the clique graphs in descending order I can be sure
   // that a graph will be available. Otherwise, in case of a minimum k
   // parameter and a reverted expansion, only empty clique graphs will
   // be traversed.
-  for( unsigned k = maxK; k >= 1; k-- )
+  for( auto itResult = results.rbegin(); itResult != results.rend(); ++itResult )
   {
-    std::cerr << "* Extracting " << k << "-cliques graph...";
+    auto&& k = itResult->k;
 
-    auto C
-        = aleph::topology::getCliqueGraph( K, k );
+    std::cerr << "* " << k << "-cliques graph has " << itResult->numNodes << " nodes and " << itResult->numEdges << " edges\n";
 
-    C.sort( aleph::topology::filtrations::Data<Simplex>() );
-
-    std::cerr << "finished\n";
-
-    std::cerr << "* " << k << "-cliques graph has " << C.size() << " simplices\n";
-
-    if( !ignoreEmpty && C.empty())
+    if( !ignoreEmpty && itResult->numNodes == 0 )
     {
       std::cerr << "* Stopping here because no further cliques for processing exist\n";
       break;
     }
 
-    auto&& tuple = aleph::calculateZeroDimensionalPersistenceDiagram<Simplex, aleph::traits::PersistencePairingCalculation<aleph::PersistencePairing<VertexType> > >( C, ccif );
-    auto&& pd    = std::get<0>( tuple );
-    auto&& pp    = std::get<1>( tuple );
+    ccif.merge( functors[k] );
+
+    auto&& pd = itResult->diagram;
+    auto&& pp = itResult->pairing;
 
     pd.removeDiagonal();
 
-    if( !C.empty() )
+    if( itResult->numNodes != 0 )
     {
       using namespace aleph::utilities;
       auto outputFilename = formatOutput( "/tmp/" + stem( basename( filename ) ) + "_k", k, maxK );
@@ -519,10 +560,11 @@ int main( int argc, char** argv )
         auto itPoint = pd.begin();
         for( auto itPair = pp.begin(); itPair != pp.end(); ++itPair, ++itPoint )
         {
-          auto&& simplex = C.at( itPair->first );
-          auto&& vertex  = *simplex.begin();
+          // The creator of a pair is reported as the index of its
+          // k-simplex, which is also used to identify components.
+          auto&& vertex  = itPair->first;
 
-          out << itPoint->x() << "\t" << itPoint->y() << "\t" << ccif.getComponentSize( vertex ) << "\n";
+          out << itPoint->x() << "\t" << itPoint->y() << "\t" << functors[k].getComponentSize( vertex ) << "\n";
         }
       }
     }
@@ -0,0 +1,45 @@
+/*
+  This is a tool shipped by 'Aleph - A Library for Exploring Persistent
+  Homology'.
+
+  It converts a set of persistence diagrams, stored in text or in JSON
+  format, to a single binary container. Containers are considerably
+  faster to load because they are memory-mapped instead of parsed, and
+  they store arbitrarily many diagrams in a single file.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <aleph/persistenceDiagrams/io/Binary.hh>
+
+void usage()
+{
+  std::cerr << "Usage: convert_persistence_diagrams OUTPUT FILES\n"
+            << "\n"
+            << "Converts persistence diagrams in FILES to a binary container that\n"
+            << "is written to OUTPUT. Files ending in '.json' may contain multiple\n"
+            << "diagrams, which are named after the file and their dimension. All\n"
+            << "other files are read as raw persistence diagrams and named after\n"
+            << "the file.\n"
+            << "\n";
+}
+
+int main( int argc, char** argv )
+{
+  if( argc < 3 )
+  {
+    usage();
+    return -1;
+  }
+
+  std::string output = argv[1];
+  std::vector<std::string> inputs( argv + 2, argv + argc );
+
+  std::cerr << "* Converting " << inputs.size() << " files to '" << output << "'...";
+
+  aleph::io::convertToBinary( inputs, output );
+
+  std::cerr << "finished\n";
+}
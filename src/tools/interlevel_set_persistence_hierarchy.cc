@@ -39,9 +39,11 @@
 #include <aleph/persistenceDiagrams/Calculation.hh>
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 
+#include <aleph/persistentHomology/CubicalPersistence.hh>
 #include <aleph/persistentHomology/ExtendedPersistenceHierarchy.hh>
 #include <aleph/persistentHomology/PersistencePairing.hh>
 
+#include <aleph/topology/CubicalComplex.hh>
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 #include <aleph/topology/UnionFind.hh>
@@ -50,8 +52,10 @@
 
 #include <aleph/topology/io/Function.hh>
 #include <aleph/topology/io/VTK.hh>
+#include <aleph/topology/io/Volume.hh>
 
 #include <aleph/utilities/Filesystem.hh>
+#include <aleph/utilities/Instrumentation.hh>
 
 #include <algorithm>
 #include <functional>
@@ -59,6 +63,7 @@
 #include <iostream>
 #include <numeric>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // TODO: Replace this as soon as possible with a more modern option
@@ -73,7 +78,8 @@ using PersistenceDiagram = aleph::PersistenceDiagram<DataType>;
 
 void usage()
 {
-  std::cerr << "Usage: extended_persistence_hierarchy [--superlevels] [--sublevels] FILES\n"
+  std::cerr << "Usage: extended_persistence_hierarchy [--cubical] [--superlevels] [--sublevels]\n"
+            << "                                      [--profile FILE] FILES\n"
             << "\n"
             << "Calculates the extended persistence hierarchy of a set of VTK files or 1D\n"
             << "functions stored in FILES. By default, a filtration based on the sublevel\n"
@@ -82,9 +88,20 @@ void usage()
             << "\n"
             << "The hierarchy is written to STDOUT.\n"
             << "\n"
+            << "If the cubical mode is selected, VTK files or NRRD volumes are converted\n"
+            << "to implicit cubical complexes instead, and their persistence diagrams of\n"
+            << "all dimensions are written to STDOUT. This mode is suitable for large\n"
+            << "grids because no simplicial complex needs to be created.\n"
+            << "\n"
             << "Flags:\n"
+            << "  -c: use cubical complexes and report persistence diagrams\n"
             << "  -s: use sublevel set filtration\n"
             << "  -S: use superlevel set filtration\n"
+            << "\n"
+            << "Options:\n"
+            << "  --profile FILE: write a report of the time spent in every phase of\n"
+            << "                  the calculation to FILE, using a JSON format if FILE\n"
+            << "                  ends with '.json', or to STDERR if FILE is '-'\n"
             << "\n";
 }
 
@@ -92,18 +109,28 @@ int main( int argc, char** argv )
 {
   static option commandLineOptions[] =
   {
-    { "superlevels", no_argument, nullptr, 'S' },
-    { "sublevels"  , no_argument, nullptr, 's' },
-    { nullptr      , 0          , nullptr,  0  }
+    { "cubical"    , no_argument      , nullptr, 'c' },
+    { "profile"    , required_argument, nullptr, 'P' },
+    { "superlevels", no_argument      , nullptr, 'S' },
+    { "sublevels"  , no_argument      , nullptr, 's' },
+    { nullptr      , 0                , nullptr,  0  }
   };
 
   bool calculateSuperlevelSets = false;
+  bool useCubicalComplexes     = false;
+  std::string profile;
 
   int option = 0;
-  while( ( option = getopt_long( argc, argv, "Ss", commandLineOptions, nullptr ) ) != -1 )
+  while( ( option = getopt_long( argc, argv, "cP:Ss", commandLineOptions, nullptr ) ) != -1 )
   {
     switch( option )
     {
+    case 'c':
+      useCubicalComplexes = true;
+      break;
+    case 'P':
+      profile = optarg;
+      break;
     case 'S':
       calculateSuperlevelSets = true;
       break;
@@ -121,12 +148,58 @@ int main( int argc, char** argv )
     return -1;
   }
 
+  aleph::utilities::instrumentation::ScopedReport report( profile );
+
   std::vector<std::string> filenames;
   filenames.reserve( argc - optind );
 
   for( int i = optind; i < argc; i++ )
     filenames.push_back( argv[i] );
 
+  // Cubical complexes -------------------------------------------------
+  //
+  // Structured grids are represented implicitly and their persistence
+  // diagrams are reported directly. No hierarchy is calculated.
+
+  if( useCubicalComplexes )
+  {
+    for( auto&& filename : filenames )
+    {
+      auto extension = aleph::utilities::extension( filename );
+
+      if( extension != ".vtk" && extension != ".nrrd" )
+      {
+        std::cerr << "* Skipping '" << filename << "' because it is neither a VTK nor a NRRD file\n";
+        continue;
+      }
+
+      std::cerr << "* Reading '" << filename << "'...";
+
+      aleph::topology::CubicalComplex<DataType> C;
+
+      if( extension == ".vtk" )
+      {
+        aleph::topology::io::VTKStructuredGridReader reader;
+        reader( filename, C );
+      }
+      else
+      {
+        auto volume = aleph::topology::io::loadNRRDVolume<DataType>( filename );
+        C           = aleph::topology::CubicalComplex<DataType>( volume.shape(), volume.values() );
+      }
+
+      std::cerr << "finished\n";
+
+      auto diagrams = aleph::calculatePersistenceDiagrams( C, calculateSuperlevelSets );
+
+      for( auto&& diagram : diagrams )
+        std::cout << "# Dimension " << diagram.dimension() << "\n"
+                  << diagram << "\n\n";
+    }
+
+    return 0;
+  }
+
   std::vector<SimplicialComplex> simplicialComplexes;
   simplicialComplexes.reserve( filenames.size() );
 
@@ -214,16 +287,29 @@ int main( int argc, char** argv )
     }
 
     // Display nodes of the hierarchy ----------------------------------
+    //
+    // Looking up destroyers and node IDs via maps keeps the output linear
+    // in the size of the hierarchy, which matters for large functions.
+
+    std::unordered_map<VertexType, VertexType> destroyers;
+    destroyers.reserve( persistencePairing.size() );
+
+    for( auto&& pair : persistencePairing )
+      destroyers[ pair.first ] = pair.second;
+
+    std::unordered_map<VertexType, unsigned> nodes;
+    nodes.reserve( vertices.size() );
 
     {
       unsigned index = 0;
       for( auto&& vertex : vertices )
       {
+        nodes[vertex] = index;
+
         auto itCreator = K.find( Simplex(vertex) );
         if( itCreator != K.end() )
         {
-          auto itPair         = persistencePairing.find( static_cast<VertexType>( K.index( *itCreator ) ) );
-          auto destroyerIndex = itPair->second;
+          auto destroyerIndex = destroyers.at( static_cast<VertexType>( K.index( *itCreator ) ) );
 
           if( destroyerIndex < K.size() )
             std::cout << index << ": " << itCreator->data() << "\t" << K.at( destroyerIndex ).data() << "\n";
@@ -240,12 +326,7 @@ int main( int argc, char** argv )
     // Display edges of the hierarchy ----------------------------------
 
     for( auto&& edge : edges )
-    {
-      auto uIndex = std::distance( vertices.begin(), vertices.find( edge.first ) );
-      auto vIndex = std::distance( vertices.begin(), vertices.find( edge.second ) );
-
-      std::cout << uIndex << " -- " << vIndex << "\n";
-    }
+      std::cout << nodes.at( edge.first ) << " -- " << nodes.at( edge.second ) << "\n";
 
     std::cout << "\n\n";
   }
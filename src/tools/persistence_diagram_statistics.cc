@@ -13,8 +13,12 @@
 #include <aleph/persistenceDiagrams/Norms.hh>
 #include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
 
+#include <aleph/persistenceDiagrams/io/Binary.hh>
 #include <aleph/persistenceDiagrams/io/Raw.hh>
 
+#include <aleph/utilities/Filesystem.hh>
+#include <aleph/utilities/Instrumentation.hh>
+
 #include <iostream>
 #include <limits>
 #include <numeric>
@@ -39,7 +43,8 @@ void usage()
   std::cerr << "Usage: persistence_diagram_statistics FILES\n"
             << "\n"
             << "Given a set of persistence diagrams, calculates numerous statistics\n"
-            << "and writes them to STDOUT in CSV format.\n"
+            << "and writes them to STDOUT in CSV format. Binary containers (.bpd)\n"
+            << "contribute one row per diagram.\n"
             << "\n"
             << "Currently, the following statistics are calculated:\n"
             << "  - Average persistence\n"
@@ -55,6 +60,10 @@ void usage()
             << " --power  : Use the specified power as an exponent during persistence\n"
             << "            calculations. This does not apply to the infinity norm of\n"
             << "            a persistence diagram.\n"
+            << "\n"
+            << " --profile: Write a report of the time spent in every phase to the\n"
+            << "            specified file, using a JSON format if its name ends with\n"
+            << "            '.json'. Use '-' for writing the report to STDERR.\n"
             << "\n\n";
 }
 
@@ -64,15 +73,18 @@ int main( int argc, char** argv )
   {
     { "invalid"       , required_argument, nullptr, 'i' },
     { "power"         , required_argument, nullptr, 'p' },
+    { "profile"       , required_argument, nullptr, 'P' },
     { nullptr         , 0                , nullptr,  0  }
   };
 
   DataType invalid = std::numeric_limits<DataType>::has_quiet_NaN ? std::numeric_limits<DataType>::quiet_NaN() : std::numeric_limits<DataType>::max();
   double p         = 2.0;
 
+  std::string profile;
+
   {
     int option = 0;
-    while( ( option = getopt_long( argc, argv, "i:p:", commandLineOptions, nullptr ) ) != -1 )
+    while( ( option = getopt_long( argc, argv, "i:p:P:", commandLineOptions, nullptr ) ) != -1 )
     {
       switch( option )
       {
@@ -80,6 +92,10 @@ int main( int argc, char** argv )
         invalid = static_cast<DataType>( std::stod( optarg ) );
         break;
 
+      case 'P':
+        profile = optarg;
+        break;
+
       default:
         p = std::stod( optarg );
         break;
@@ -93,6 +109,8 @@ int main( int argc, char** argv )
     return -1;
   }
 
+  aleph::utilities::instrumentation::ScopedReport report( profile );
+
   std::vector<Input> inputs;
   inputs.reserve( argc - optind );
 
@@ -111,12 +129,34 @@ int main( int argc, char** argv )
 
     std::cerr << "* Loading '" << filename << "'...";
 
-    Input input = {
-      filename,
-      aleph::io::load<DataType>( filename )
-    };
+    // Binary containers contribute all of their diagrams, which are
+    // identified by the name of the container and their own name.
+    if( aleph::utilities::extension( filename ) == ".bpd" )
+    {
+      aleph::io::BinaryPersistenceDiagramReader reader( filename );
 
-    inputs.push_back( input );
+      for( std::size_t j = 0; j < reader.size(); j++ )
+      {
+        auto view = reader[j];
+        auto name = view.name().empty() ? std::to_string( j ) : view.name().str();
+
+        Input input = {
+          filename + ":" + name,
+          view.toDiagram<DataType>()
+        };
+
+        inputs.push_back( input );
+      }
+    }
+    else
+    {
+      Input input = {
+        filename,
+        aleph::io::load<DataType>( filename )
+      };
+
+      inputs.push_back( input );
+    }
 
     std::cerr << "finished\n";
   }
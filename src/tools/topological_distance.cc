@@ -57,10 +57,12 @@
 #include <aleph/persistenceDiagrams/distances/Hausdorff.hh>
 #include <aleph/persistenceDiagrams/distances/Wasserstein.hh>
 
+#include <aleph/persistenceDiagrams/io/Binary.hh>
 #include <aleph/persistenceDiagrams/io/JSON.hh>
 #include <aleph/persistenceDiagrams/io/Raw.hh>
 
 #include <aleph/utilities/Filesystem.hh>
+#include <aleph/utilities/Instrumentation.hh>
 
 using DataType                     = double;
 using PersistenceDiagram           = aleph::PersistenceDiagram<DataType>;
@@ -85,7 +87,8 @@ struct DataSet
 void usage()
 {
   std::cerr << "Usage: topological_distance [--power=POWER] [--kernel] [--exp] [--sigma]\n"
-            << "                            [--hausdorff|indicator|wasserstein] FILES\n"
+            << "                            [--hausdorff|indicator|wasserstein]\n"
+            << "                            [--profile=FILE] FILES\n"
             << "\n"
             << "Calculates distances between a set of persistence diagrams, stored\n"
             << "in FILES. By default, this tool calculates Hausdorff distances for\n"
@@ -104,6 +107,10 @@ void usage()
             << "each file contains a suffix with digits that is preceded by either\n"
             << "a 'd' (for dimension) or a 'k' (for clique dimension).\n"
             << "\n"
+            << "Instead of many text files, binary containers (.bpd) that store\n"
+            << "many diagrams at once may be used. Their diagrams are grouped by\n"
+            << "their names in the same manner.\n"
+            << "\n"
             << "Flags:\n"
             << "  -e: use exponential weighting for kernel calculation\n"
             << "  -h: calculate Hausdorff distances\n"
@@ -112,6 +119,11 @@ void usage()
             << "  -n: normalize the persistence indicator function\n"
             << "  -s: use sigma as a scale parameter for the kernel\n"
             << "  -w: calculate Wasserstein distances\n"
+            << "\n"
+            << "Options:\n"
+            << "  --profile=FILE: write a report of the time spent in every phase of\n"
+            << "                  the calculation to FILE, using a JSON format if FILE\n"
+            << "                  ends with '.json', or to STDERR if FILE is '-'\n"
             << "\n";
 }
 
@@ -249,6 +261,7 @@ int main( int argc, char** argv )
   static option commandLineOptions[] =
   {
     { "power"      , required_argument, nullptr, 'p' },
+    { "profile"    , required_argument, nullptr, 'P' },
     { "sigma"      , required_argument, nullptr, 's' },
     { "exp"        , no_argument      , nullptr, 'e' },
     { "hausdorff"  , no_argument      , nullptr, 'h' },
@@ -266,15 +279,19 @@ int main( int argc, char** argv )
   bool normalize                    = false;
   bool calculateKernel              = false;
   bool useWassersteinDistance       = false;
+  std::string profile;
 
   int option = 0;
-  while( ( option = getopt_long( argc, argv, "p:s:ehikw", commandLineOptions, nullptr ) ) != -1 )
+  while( ( option = getopt_long( argc, argv, "p:P:s:ehikw", commandLineOptions, nullptr ) ) != -1 )
   {
     switch( option )
     {
     case 'p':
       power = std::stod( optarg );
       break;
+    case 'P':
+      profile = optarg;
+      break;
     case 's':
       sigma = std::stod( optarg );
       break;
@@ -304,12 +321,17 @@ int main( int argc, char** argv )
     }
   }
 
-  if( ( argc - optind ) <= 1 )
+  // A single binary container may already contain multiple data sets,
+  // whereas all other formats require at least two files.
+  if(    ( argc - optind ) < 1
+      || ( ( argc - optind ) == 1 && aleph::utilities::extension( argv[optind] ) != ".bpd" ) )
   {
     usage();
     return -1;
   }
 
+  aleph::utilities::instrumentation::ScopedReport report( profile );
+
   std::vector< std::vector<DataSet> > dataSets;
 
   // Get filenames & prefixes ------------------------------------------
@@ -442,6 +464,62 @@ int main( int argc, char** argv )
         dataSets.push_back( dataSet );
       }
     }
+    else if( aleph::utilities::extension( filenames.front() ) == ".bpd" )
+    {
+      // Binary containers store many diagrams at once. Their names are
+      // matched like the names of text files, so converting a set of text
+      // files to a container results in the same data sets.
+      std::regex reDataSetPrefix( "(.*)_[dk]([[:digit:]]+)" );
+      std::smatch matches;
+
+      std::map<std::string, unsigned> nameMap;
+
+      for( auto&& filename : filenames )
+      {
+        std::cerr << "* Processing '" << filename << "'...";
+
+        aleph::io::BinaryPersistenceDiagramReader reader( filename );
+
+        for( std::size_t i = 0; i < reader.size(); i++ )
+        {
+          auto view      = reader[i];
+          auto name      = view.name().str();
+          auto dimension = static_cast<unsigned>( view.dimension() );
+
+          if( std::regex_match( name, matches, reDataSetPrefix ) )
+          {
+            name      = matches[1];
+            dimension = unsigned( std::stoul( matches[2] ) );
+          }
+
+          if( nameMap.find( name ) == nameMap.end() )
+          {
+            nameMap[ name ] = static_cast<unsigned>( dataSets.size() );
+            dataSets.push_back( {} );
+          }
+
+          minDimension = std::min( minDimension, dimension );
+          maxDimension = std::max( maxDimension, dimension );
+
+          auto diagram = view.toDiagram<DataType>();
+
+          // FIXME: This is only required in order to ensure that the
+          // persistence indicator function has a finite integral; it
+          // can be solved more elegantly by using a special value to
+          // indicate infinite intervals.
+          auto pd = diagram;
+          pd.removeUnpaired();
+
+          dataSets.at( nameMap[name] ).push_back( { name,
+                                                    filename,
+                                                    dimension,
+                                                    diagram,
+                                                    aleph::persistenceIndicatorFunction( pd ) } );
+        }
+
+        std::cerr << "finished\n";
+      }
+    }
   }
 
   // Setup distance functor --------------------------------------------
@@ -5,6 +5,11 @@
 #include <aleph/topology/SimplicialComplex.hh>
 
 #include <algorithm>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
 #include <vector>
 
 template <class T> void test()
@@ -40,6 +45,208 @@ template <class T> void test()
   ALEPH_ASSERT_EQUAL( num1Simplices, 12 );
   ALEPH_ASSERT_EQUAL( num2Simplices,  6 );
 
+  auto M = Sd(L);
+
+  // 25 vertices, 60 edges, and 36 triangles
+  ALEPH_ASSERT_EQUAL( M.size(), 121 );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testTetrahedron()
+{
+  ALEPH_TEST_BEGIN( "Tetrahedron" );
+
+  using DataType          = double;
+  using VertexType        = T;
+  using Simplex           = aleph::topology::Simplex<DataType, VertexType>;
+  using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+
+  SimplicialComplex K = {
+    {0}, {1}, {2}, {3},
+    {0,1}, {0,2}, {0,3}, {1,2}, {1,3}, {2,3},
+    {0,1,2}, {0,1,3}, {0,2,3}, {1,2,3},
+    {0,1,2,3}
+  };
+
+  aleph::topology::BarycentricSubdivision Sd;
+
+  auto L = Sd(K);
+
+  std::vector<std::size_t> counts( 4 );
+
+  for( auto&& s : L )
+    ++counts.at( s.dimension() );
+
+  ALEPH_ASSERT_EQUAL( counts[0], 15 );
+  ALEPH_ASSERT_EQUAL( counts[1], 50 );
+  ALEPH_ASSERT_EQUAL( counts[2], 60 );
+  ALEPH_ASSERT_EQUAL( counts[3], 24 );
+
+  // Barycentres are numbered in the order of the dimension of their
+  // simplices, starting after the largest vertex
+  ALEPH_ASSERT_THROW( L.contains( Simplex( VertexType(4) ) ) );
+  ALEPH_ASSERT_THROW( L.contains( Simplex( VertexType(14) ) ) );
+  ALEPH_ASSERT_THROW( L.contains( Simplex( {0,4,10,14} ) ) );
+
+  // Missing faces cannot be subdivided
+  SimplicialComplex M = {
+    {0}, {1}, {2},
+    {0,1}, {1,2},
+    {0,1,2}
+  };
+
+  ALEPH_EXPECT_EXCEPTION( Sd(M), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+/**
+  Compares the subdivision of random complexes with a subdivision that
+  enumerates all flags of faces by brute force, including the data that
+  is assigned by the functor.
+*/
+
+void testRandom()
+{
+  ALEPH_TEST_BEGIN( "Random complexes" );
+
+  using DataType          = double;
+  using VertexType        = unsigned;
+  using Simplex           = aleph::topology::Simplex<DataType, VertexType>;
+  using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+  using Vertices          = std::vector<VertexType>;
+
+  std::mt19937 rng( 42 );
+
+  for( unsigned round = 0; round < 10; round++ )
+  {
+    std::uniform_int_distribution<unsigned> vertexDistribution( 0, 7 );
+    std::uniform_int_distribution<unsigned> sizeDistribution( 1, 5 );
+    std::uniform_real_distribution<DataType> dataDistribution( 0.0, 1.0 );
+
+    // Closure of random simplices; vertices are not contiguous in order
+    // to check the numbering of barycentres
+    std::set<Vertices> closure;
+
+    for( unsigned i = 0; i < 6; i++ )
+    {
+      std::set<VertexType> vertices;
+      auto size = sizeDistribution( rng );
+
+      while( vertices.size() < size )
+        vertices.insert( 3 * vertexDistribution( rng ) + 2 );
+
+      Vertices top( vertices.begin(), vertices.end() );
+
+      for( unsigned mask = 1; mask < ( 1u << top.size() ); mask++ )
+      {
+        Vertices face;
+
+        for( unsigned j = 0; j < top.size(); j++ )
+        {
+          if( mask & ( 1u << j ) )
+            face.push_back( top[j] );
+        }
+
+        closure.insert( face );
+      }
+    }
+
+    std::vector<Simplex> simplices;
+
+    for( auto&& vertices : closure )
+      simplices.push_back( Simplex( vertices.begin(), vertices.end(), dataDistribution( rng ) ) );
+
+    SimplicialComplex K( simplices.begin(), simplices.end() );
+
+    auto functor = [] ( std::size_t n )
+    {
+      return n == 0 ? 0.5 : 1.0 + double( n );
+    };
+
+    auto L = aleph::topology::BarycentricSubdivision()( K, functor );
+
+    // Brute-force subdivision -----------------------------------------
+
+    std::vector<Simplex> faces;
+    std::vector<Vertices> vertices;
+    std::vector<VertexType> barycentres;
+
+    VertexType barycentre = 0;
+
+    for( auto&& s : K )
+    {
+      if( s.dimension() == 0 )
+        barycentre = std::max( barycentre, VertexType( *s.begin() + 1 ) );
+    }
+
+    for( auto it = K.begin_dimension(); it != K.end_dimension(); ++it )
+    {
+      faces.push_back( *it );
+      vertices.push_back( Vertices( it->begin(), it->end() ) );
+
+      std::sort( vertices.back().begin(), vertices.back().end() );
+
+      if( it->dimension() == 0 )
+        barycentres.push_back( *it->begin() );
+      else
+        barycentres.push_back( barycentre++ );
+    }
+
+    std::map<Vertices, DataType> expected;
+
+    std::vector<std::size_t> flag;
+
+    std::function<void( std::size_t )> enumerate = [&] ( std::size_t top )
+    {
+      Vertices result;
+
+      for( auto&& i : flag )
+        result.push_back( barycentres[i] );
+
+      std::sort( result.begin(), result.end() );
+
+      auto&& s = faces[top];
+
+      if( s.dimension() == 0 )
+        expected[result] = s.data();
+      else if( flag.size() == 1 )
+        expected[result] = s.data() * functor( 0 );
+      else
+        expected[result] = s.data() * functor( flag.size() );
+
+      for( std::size_t i = 0; i < faces.size(); i++ )
+      {
+        auto&& last = vertices[ flag.back() ];
+
+        if( vertices[i].size() < last.size() && std::includes( last.begin(), last.end(), vertices[i].begin(), vertices[i].end() ) )
+        {
+          flag.push_back( i );
+          enumerate( top );
+          flag.pop_back();
+        }
+      }
+    };
+
+    for( std::size_t i = 0; i < faces.size(); i++ )
+    {
+      flag.assign( 1, i );
+      enumerate( i );
+    }
+
+    ALEPH_ASSERT_EQUAL( L.size(), expected.size() );
+
+    for( auto&& s : L )
+    {
+      Vertices result( s.begin(), s.end() );
+      std::sort( result.begin(), result.end() );
+
+      ALEPH_ASSERT_THROW( expected.find( result ) != expected.end() );
+      ALEPH_ASSERT_EQUAL( s.data(), expected.at( result ) );
+    }
+  }
+
   ALEPH_TEST_END();
 }
 
@@ -49,4 +256,9 @@ int main(int, char**)
   test<int>     ();
   test<unsigned>();
   test<long>    ();
+
+  testTetrahedron<short>   ();
+  testTetrahedron<unsigned>();
+
+  testRandom();
 }
@@ -0,0 +1,286 @@
+#include <tests/Base.hh>
+
+#include <aleph/geometry/RipsExpander.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistentHomology/BatchedPersistence.hh>
+#include <aleph/persistentHomology/Calculation.hh>
+
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/utilities/RadixSort.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using DataType          = double;
+using VertexType        = unsigned;
+using Simplex           = aleph::topology::Simplex<DataType, VertexType>;
+using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+using Point             = std::pair<DataType, DataType>;
+using Points            = std::vector< std::vector<Point> >;
+
+/**
+  Converts persistence diagrams into sorted lists of points, which are
+  indexed by dimension. Points of zero persistence are removed because
+  they depend on the order of simplices with the same value.
+*/
+
+Points points( std::vector< aleph::PersistenceDiagram<DataType> > diagrams )
+{
+  Points result;
+
+  for( auto&& D : diagrams )
+  {
+    D.removeDiagonal();
+
+    if( D.dimension() >= result.size() )
+      result.resize( D.dimension() + 1 );
+
+    for( auto&& p : D )
+      result[ D.dimension() ].push_back( std::make_pair( p.x(), p.y() ) );
+
+    std::sort( result[ D.dimension() ].begin(), result[ D.dimension() ].end() );
+  }
+
+  while( !result.empty() && result.back().empty() )
+    result.pop_back();
+
+  return result;
+}
+
+/**
+  Creates the flag complex of a random graph. The vertices are not
+  contiguous, so the mapping of the batched calculation is used.
+*/
+
+SimplicialComplex makeRandomComplex( std::mt19937& rng, unsigned n, unsigned m )
+{
+  std::uniform_int_distribution<unsigned> distribution( 0, n - 1 );
+
+  std::vector<Simplex> simplices;
+
+  for( unsigned i = 0; i < n; i++ )
+    simplices.push_back( Simplex( 5 * i + 1 ) );
+
+  std::set< std::pair<unsigned, unsigned> > edges;
+
+  while( edges.size() < m )
+  {
+    auto u = distribution( rng );
+    auto v = distribution( rng );
+
+    if( u != v )
+      edges.insert( std::make_pair( std::min( u, v ), std::max( u, v ) ) );
+  }
+
+  for( auto&& edge : edges )
+    simplices.push_back( Simplex( {5 * edge.first + 1, 5 * edge.second + 1} ) );
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+
+  aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
+  return ripsExpander( K, 2 );
+}
+
+void testRadixSort()
+{
+  ALEPH_TEST_BEGIN( "Radix sort" );
+
+  using namespace aleph::utilities;
+
+  std::vector<double> values = {
+    -std::numeric_limits<double>::infinity(),
+    std::numeric_limits<double>::lowest(),
+    -1e10, -2.5, -1.0, -1e-300, 0.0, 1e-300, 1.0, 2.5, 1e10,
+    std::numeric_limits<double>::max(),
+    std::numeric_limits<double>::infinity()
+  };
+
+  for( std::size_t i = 0; i + 1 < values.size(); i++ )
+    ALEPH_ASSERT_THROW( radixKey( values[i] ) < radixKey( values[i+1] ) );
+
+  ALEPH_ASSERT_THROW( radixKey( -1.0f ) < radixKey( 0.0f ) );
+  ALEPH_ASSERT_THROW( radixKey( -1 )    < radixKey( 0 ) );
+  ALEPH_ASSERT_THROW( radixKey( 1u )    < radixKey( 2u ) );
+
+  // Both zeros compare equal, so they must not be ordered by the sort
+  ALEPH_ASSERT_EQUAL( radixKey( -0.0 ),  radixKey( 0.0 ) );
+  ALEPH_ASSERT_EQUAL( radixKey( -0.0f ), radixKey( 0.0f ) );
+
+  auto nan = std::numeric_limits<double>::quiet_NaN();
+
+  ALEPH_ASSERT_THROW( radixKey( std::numeric_limits<double>::infinity() )  < radixKey(  std::fabs( nan ) ) );
+  ALEPH_ASSERT_THROW( radixKey( -std::numeric_limits<double>::infinity() ) > radixKey( -std::fabs( nan ) ) );
+
+  std::mt19937 rng( 42 );
+
+  for( std::size_t n : { std::size_t( 0 ), std::size_t( 1 ), std::size_t( 10000 ) } )
+  {
+    // Few distinct values result in many ties, which have to be resolved
+    // stably
+    std::uniform_int_distribution<int> distribution( -20, 20 );
+
+    std::vector<float> data( n );
+    std::vector<std::uint64_t> keys( n );
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      data[i] = float( distribution( rng ) ) / 4.0f;
+      keys[i] = radixKey( data[i] );
+    }
+
+    std::vector<unsigned> expected( n );
+    std::iota( expected.begin(), expected.end(), 0u );
+
+    std::stable_sort( expected.begin(), expected.end(),
+                      [&data] ( unsigned i, unsigned j )
+                      {
+                        return data[i] < data[j];
+                      } );
+
+    std::vector<unsigned> indices( n );
+    std::vector<unsigned> buffer;
+
+    std::iota( indices.begin(), indices.end(), 0u );
+    radixSort( indices, keys, buffer );
+
+    ALEPH_ASSERT_THROW( indices == expected );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testSimple()
+{
+  ALEPH_TEST_BEGIN( "Batched persistence: simple" );
+
+  // A square with one diagonal: two triangles, but no cycle survives
+  std::vector<Simplex> simplices = {
+    Simplex( 0u ), Simplex( 1u ), Simplex( 2u ), Simplex( 3u ),
+    Simplex( {0,1} ), Simplex( {1,2} ), Simplex( {2,3} ), Simplex( {0,3} ), Simplex( {0,2} ),
+    Simplex( {0,1,2} ), Simplex( {0,2,3} )
+  };
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+
+  aleph::BatchedPersistence<Simplex> batchedPersistence( K );
+
+  ALEPH_ASSERT_EQUAL( batchedPersistence.numVertices(), 4 );
+
+  std::vector<DataType> values = {
+    0, 1, 2, 3, // monotone function: single component
+    2, 0, 3, 1  // two minima that are not connected by the diagonal
+  };
+
+  auto diagrams = batchedPersistence( values );
+
+  ALEPH_ASSERT_EQUAL( diagrams.size(), 2 );
+
+  auto inf = std::numeric_limits<DataType>::infinity();
+
+  Points expected0 = { { {0, inf} } };
+  Points expected1 = { { {0, inf}, {1,2} } };
+
+  ALEPH_ASSERT_THROW( points( diagrams[0] ) == expected0 );
+  ALEPH_ASSERT_THROW( points( diagrams[1] ) == expected1 );
+
+  // Superlevel sets of the second function: the two maxima are
+  // connected by the diagonal, so only one of them persists.
+  auto superlevelDiagrams = batchedPersistence( values, true );
+
+  Points expected2 = { { {3, inf} } };
+  Points expected3 = { { {3, inf} } };
+
+  ALEPH_ASSERT_EQUAL( superlevelDiagrams.size(), 2 );
+  ALEPH_ASSERT_THROW( points( superlevelDiagrams[0] ) == expected2 );
+  ALEPH_ASSERT_THROW( points( superlevelDiagrams[1] ) == expected3 );
+
+  ALEPH_EXPECT_EXCEPTION( batchedPersistence( std::vector<DataType>( 5 ) ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+void testRandom()
+{
+  ALEPH_TEST_BEGIN( "Batched persistence: random functions" );
+
+  std::mt19937 rng( 23 );
+
+  for( unsigned k = 0; k < 6; k++ )
+  {
+    unsigned n = 10 + 15 * k;
+
+    auto K = makeRandomComplex( rng, n, 3 * n );
+
+    aleph::BatchedPersistence<Simplex> batchedPersistence( K );
+
+    ALEPH_ASSERT_EQUAL( batchedPersistence.numVertices(), n );
+
+    // Few distinct values result in many ties
+    std::uniform_int_distribution<int> distribution( 0, k % 2 == 0 ? 5 : 1000 );
+
+    unsigned numFunctions = 8;
+    std::vector<DataType> values( numFunctions * n );
+
+    for( auto&& value : values )
+      value = DataType( distribution( rng ) );
+
+    for( bool superlevel : { false, true } )
+    {
+      for( bool dualize : { true, false } )
+      {
+        auto diagrams = batchedPersistence( values, superlevel, dualize );
+
+        ALEPH_ASSERT_EQUAL( diagrams.size(), numFunctions );
+
+        for( unsigned f = 0; f < numFunctions; f++ )
+        {
+          auto begin = values.begin() + static_cast<std::ptrdiff_t>( f * n );
+          auto end   = begin + static_cast<std::ptrdiff_t>( n );
+
+          aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
+
+          SimplicialComplex L;
+
+          if( superlevel )
+          {
+            L = ripsExpander.assignData( K, begin, end, std::numeric_limits<DataType>::max(),
+                                         [] ( DataType a, DataType b ) { return std::min( a, b ); } );
+
+            L.sort( aleph::topology::filtrations::Data<Simplex, std::greater<DataType> >() );
+          }
+          else
+          {
+            L = ripsExpander.assignMaximumData( K, begin, end );
+            L.sort( aleph::topology::filtrations::Data<Simplex>() );
+          }
+
+          auto expected = aleph::calculatePersistenceDiagrams( L, dualize );
+
+          ALEPH_ASSERT_THROW( points( diagrams[f] ) == points( expected ) );
+        }
+      }
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testRadixSort();
+  testSimple();
+  testRandom();
+}
@@ -1,9 +1,18 @@
 #include <tests/Base.hh>
 
+#include <aleph/geometry/RipsExpander.hh>
+#include <aleph/geometry/RipsExpanderTopDown.hh>
+
+#include <aleph/persistentHomology/CliquePersistence.hh>
+#include <aleph/persistentHomology/ConnectedComponents.hh>
+
 #include <aleph/topology/CliqueGraph.hh>
+#include <aleph/topology/RandomGraph.hh>
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/topology/filtrations/Data.hh>
+
 #include <algorithm>
 #include <vector>
 
@@ -82,6 +91,207 @@ template <class Data, class Vertex> void triangles()
   ALEPH_TEST_END();
 }
 
+template <class Data, class Vertex> void adjacency()
+{
+  ALEPH_TEST_BEGIN( "Clique graph adjacency" );
+
+  using Simplex           = Simplex<Data, Vertex>;
+  using SimplicialComplex = SimplicialComplex<Simplex>;
+
+  std::vector<Simplex> simplices
+    = {
+        {0,1}, {0,2}, {0,3}, {1,2}, {1,3}, {2,3},
+        {0,1,2}, {0,1,3}, {0,2,3}
+    };
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+  K.createMissingFaces();
+  K.sort();
+
+  auto C = getCliqueGraphAdjacency( K, 2 );
+
+  ALEPH_ASSERT_EQUAL( C.size()    , 3 );
+  ALEPH_ASSERT_EQUAL( C.numEdges(), 3 );
+
+  for( unsigned i = 0; i < C.size(); i++ )
+  {
+    ALEPH_ASSERT_EQUAL( C.degree(i), 2 );
+    ALEPH_ASSERT_EQUAL( K.at( C.simplex(i) ).dimension(), 2 );
+  }
+
+  auto D = getCliqueGraphAdjacency( K, 0 );
+
+  ALEPH_ASSERT_EQUAL( D.size()    , 4 );
+  ALEPH_ASSERT_EQUAL( D.numEdges(), 0 );
+
+  ALEPH_TEST_END();
+}
+
+void adjacencyPersistence()
+{
+  ALEPH_TEST_BEGIN( "Clique graph adjacency persistence" );
+
+  auto K = generateWeightedRandomGraph( 25, 0.5 );
+
+  using SimplicialComplex = decltype(K);
+  using Simplex           = typename SimplicialComplex::ValueType;
+  using DataType          = typename Simplex::DataType;
+  using VertexType        = typename Simplex::VertexType;
+  using Point             = typename aleph::PersistenceDiagram<DataType>::Point;
+
+  aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
+
+  K = ripsExpander( K, 3 );
+  K = ripsExpander.assignMaximumWeight( K );
+
+  K.sort( filtrations::Data<Simplex>() );
+
+  auto sorted = [] ( aleph::PersistenceDiagram<DataType> D )
+  {
+    std::vector<Point> points( D.begin(), D.end() );
+    std::sort( points.begin(), points.end(),
+               [] ( const Point& p, const Point& q )
+               {
+                 return std::make_pair( p.x(), p.y() ) < std::make_pair( q.x(), q.y() );
+               } );
+
+    return points;
+  };
+
+  for( unsigned k = 1; k <= 3; k++ )
+  {
+    auto C1 = getCliqueGraph( K, k );
+    auto C2 = getCliqueGraphAdjacency( K, k );
+
+    C1.sort( filtrations::Data<Simplex>() );
+
+    auto n = static_cast<std::size_t>( std::count_if( C1.begin(), C1.end(), [] ( const Simplex& s ) { return s.dimension() == 0; } ) );
+
+    ALEPH_ASSERT_EQUAL( C2.size(), n );
+    ALEPH_ASSERT_EQUAL( C2.numEdges(), C1.size() - n );
+
+    auto D1 = std::get<0>( aleph::calculateZeroDimensionalPersistenceDiagram( C1 ) );
+    auto D2 = std::get<0>( aleph::calculateZeroDimensionalPersistenceDiagram<DataType, VertexType>( C2 ) );
+
+    ALEPH_ASSERT_EQUAL( D1.size(), D2.size() );
+    ALEPH_ASSERT_THROW( sorted( D1 ) == sorted( D2 ) );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void multipleOrders()
+{
+  ALEPH_TEST_BEGIN( "Clique graph index for multiple orders" );
+
+  auto K = generateWeightedRandomGraph( 25, 0.5 );
+
+  using SimplicialComplex = decltype(K);
+  using Simplex           = typename SimplicialComplex::ValueType;
+  using DataType          = typename Simplex::DataType;
+
+  aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
+
+  K = ripsExpander( K, 4 );
+  K = ripsExpander.assignMaximumWeight( K );
+
+  K.sort( filtrations::Data<Simplex>() );
+
+  CliqueGraphIndex<Simplex> index( K, 4 );
+
+  ALEPH_ASSERT_EQUAL( index.maxK(), 4 );
+
+  for( unsigned k = 0; k <= 4; k++ )
+  {
+    auto C1 = getCliqueGraphAdjacency( K, k );
+    auto C2 = index( k );
+
+    ALEPH_ASSERT_EQUAL( C1.size()    , C2.size()     );
+    ALEPH_ASSERT_EQUAL( C1.numEdges(), C2.numEdges() );
+
+    for( unsigned i = 0; i < C1.size(); i++ )
+    {
+      ALEPH_ASSERT_EQUAL( C1.simplex(i), C2.simplex(i) );
+      ALEPH_ASSERT_THROW( std::equal( C1.begin_neighbours(i), C1.end_neighbours(i), C2.begin_neighbours(i) ) );
+    }
+  }
+
+  ALEPH_EXPECT_EXCEPTION( index( 5 ), std::runtime_error );
+
+  std::vector<aleph::utilities::EmptyFunctor> functors( 5 );
+
+  auto results = aleph::calculateCliquePersistence( K, 1, 4, functors );
+
+  ALEPH_ASSERT_EQUAL( results.size(), 4 );
+
+  for( auto&& result : results )
+  {
+    auto C = getCliqueGraphAdjacency( K, result.k );
+    auto D = std::get<0>( aleph::calculateZeroDimensionalPersistenceDiagram<DataType, unsigned>( C ) );
+
+    ALEPH_ASSERT_EQUAL( result.numNodes, C.size() );
+    ALEPH_ASSERT_EQUAL( result.numEdges, C.numEdges() );
+    ALEPH_ASSERT_THROW( result.diagram == D );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void topDownExpansion()
+{
+  ALEPH_TEST_BEGIN( "Clique graph index for top-down expansion" );
+
+  auto K = generateWeightedRandomGraph( 25, 0.5 );
+
+  using SimplicialComplex = decltype(K);
+  using Simplex           = typename SimplicialComplex::ValueType;
+  using DataType          = typename Simplex::DataType;
+
+  // Only simplices of dimension 2 and above are created, so the faces of
+  // the 2-simplices are missing from the complex.
+  aleph::geometry::RipsExpanderTopDown<SimplicialComplex> ripsExpander;
+
+  auto L = ripsExpander( K, 4, 2 );
+  K      = ripsExpander.assignMaximumWeight( L, K );
+
+  K.sort( filtrations::Data<Simplex>() );
+
+  CliqueGraphIndex<Simplex> index( K, 4 );
+
+  for( unsigned k = 0; k <= 4; k++ )
+  {
+    auto C1 = getCliqueGraphAdjacency( K, k );
+    auto C2 = index( k );
+
+    ALEPH_ASSERT_EQUAL( C1.size()    , C2.size()     );
+    ALEPH_ASSERT_EQUAL( C1.numEdges(), C2.numEdges() );
+
+    for( unsigned i = 0; i < C1.size(); i++ )
+    {
+      ALEPH_ASSERT_EQUAL( C1.simplex(i), C2.simplex(i) );
+      ALEPH_ASSERT_THROW( std::equal( C1.begin_neighbours(i), C1.end_neighbours(i), C2.begin_neighbours(i) ) );
+    }
+  }
+
+  std::vector<aleph::utilities::EmptyFunctor> functors( 5 );
+
+  auto results = aleph::calculateCliquePersistence( K, 2, 4, functors );
+
+  ALEPH_ASSERT_EQUAL( results.size(), 3 );
+
+  for( auto&& result : results )
+  {
+    auto C = getCliqueGraphAdjacency( K, result.k );
+    auto D = std::get<0>( aleph::calculateZeroDimensionalPersistenceDiagram<DataType, unsigned>( C ) );
+
+    ALEPH_ASSERT_EQUAL( result.numNodes, C.size() );
+    ALEPH_ASSERT_EQUAL( result.numEdges, C.numEdges() );
+    ALEPH_ASSERT_THROW( result.diagram == D );
+  }
+
+  ALEPH_TEST_END();
+}
+
 int main()
 {
   triangle<double, unsigned>();
@@ -89,4 +299,11 @@ int main()
 
   triangles<double, unsigned>();
   triangles<float,  unsigned>();
+
+  adjacency<double, unsigned>();
+  adjacency<float,  unsigned>();
+
+  adjacencyPersistence();
+  multipleOrders();
+  topDownExpansion();
 }
@@ -0,0 +1,262 @@
+#include <aleph/config/Base.hh>
+
+#include <tests/Base.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistentHomology/ConnectedComponents.hh>
+#include <aleph/persistentHomology/CubicalPersistence.hh>
+
+#include <aleph/topology/CubicalComplex.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/topology/io/VTK.hh>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using namespace aleph::topology;
+using namespace aleph;
+
+template <class T> std::vector< std::pair<T, T> > sortedPoints( const PersistenceDiagram<T>& D )
+{
+  std::vector< std::pair<T, T> > points;
+
+  for( auto&& p : D )
+    points.push_back( std::make_pair( p.x(), p.y() ) );
+
+  std::sort( points.begin(), points.end() );
+  return points;
+}
+
+template <class T> void cells()
+{
+  ALEPH_TEST_BEGIN( "Cells" );
+
+  CubicalComplex<T> C( { 3, 2 }, { 0, 1, 2, 3, 4, 5 } );
+
+  ALEPH_ASSERT_EQUAL( C.size(),      15 );
+  ALEPH_ASSERT_EQUAL( C.dimension(),  2 );
+
+  std::vector<std::size_t> numCells( 3 );
+
+  for( std::size_t cell = 0; cell < C.size(); cell++ )
+    numCells.at( C.dimension( cell ) ) += 1;
+
+  ALEPH_ASSERT_EQUAL( numCells[0], 6 );
+  ALEPH_ASSERT_EQUAL( numCells[1], 7 );
+  ALEPH_ASSERT_EQUAL( numCells[2], 2 );
+
+  // The square at (1,1) in the doubled grid
+  {
+    std::vector<std::size_t> faces;
+    C.boundary( 6, std::back_inserter( faces ) );
+    std::sort( faces.begin(), faces.end() );
+
+    ALEPH_ASSERT_THROW( faces == std::vector<std::size_t>( { 1, 5, 7, 11 } ) );
+
+    ALEPH_ASSERT_EQUAL( C.value( 6 )      , T(4) );
+    ALEPH_ASSERT_EQUAL( C.value( 6, true ), T(0) );
+  }
+
+  ALEPH_ASSERT_THROW( C.value( 0 ) == T(0) );
+  ALEPH_ASSERT_THROW( C.value( 14 ) == T(5) );
+
+  // Ranks of cells within their dimension
+  {
+    aleph::detail::CubicalCellIndex<T> index( C );
+
+    for( std::size_t d = 0; d <= 2; d++ )
+    {
+      ALEPH_ASSERT_EQUAL( index.size( d ), numCells[d] );
+
+      for( std::size_t rank = 0; rank < index.size( d ); rank++ )
+      {
+        auto cell = index.cell( d, rank );
+
+        ALEPH_ASSERT_EQUAL( C.dimension( cell ), d );
+        ALEPH_ASSERT_EQUAL( index.rank( cell ), rank );
+      }
+    }
+  }
+
+  ALEPH_EXPECT_EXCEPTION( CubicalComplex<T>( { 2, 2 }, std::vector<T>( { 0, 1, 2 } ) ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void ring()
+{
+  ALEPH_TEST_BEGIN( "Ring" );
+
+  // A ring of low values surrounding a block of high values. The ring
+  // creates a 1-dimensional feature that is destroyed once the block
+  // has been filled.
+  CubicalComplex<T> C( { 4, 4 }, { 1, 1, 1, 1,
+                                   1, 5, 5, 1,
+                                   1, 5, 5, 1,
+                                   1, 1, 1, 1 } );
+
+  {
+    auto diagrams = calculatePersistenceDiagrams( C );
+
+    ALEPH_ASSERT_EQUAL( diagrams.size(), 3 );
+
+    ALEPH_ASSERT_EQUAL( diagrams[0].size(), 1 );
+    ALEPH_ASSERT_EQUAL( diagrams[1].size(), 1 );
+    ALEPH_ASSERT_EQUAL( diagrams[2].size(), 0 );
+
+    ALEPH_ASSERT_EQUAL( diagrams[0].dimension(), 0 );
+    ALEPH_ASSERT_EQUAL( diagrams[1].dimension(), 1 );
+
+    ALEPH_ASSERT_EQUAL( diagrams[0].begin()->x(), T(1) );
+    ALEPH_ASSERT_THROW( diagrams[0].begin()->isUnpaired() );
+
+    ALEPH_ASSERT_EQUAL( diagrams[1].begin()->x(), T(1) );
+    ALEPH_ASSERT_EQUAL( diagrams[1].begin()->y(), T(5) );
+  }
+
+  // The superlevel set filtration only contains a single component
+  // because the block is connected to the ring.
+  {
+    auto diagrams = calculatePersistenceDiagrams( C, true );
+
+    ALEPH_ASSERT_EQUAL( diagrams[0].size(), 1 );
+    ALEPH_ASSERT_EQUAL( diagrams[1].size(), 0 );
+    ALEPH_ASSERT_EQUAL( diagrams[2].size(), 0 );
+
+    ALEPH_ASSERT_EQUAL( diagrams[0].begin()->x(), T(5) );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void randomVolume()
+{
+  ALEPH_TEST_BEGIN( "Random volume" );
+
+  std::mt19937 rng( 42 );
+  std::uniform_real_distribution<T> distribution( T(0), T(1) );
+
+  std::vector<T> values( 6*5*4 );
+  std::generate( values.begin(), values.end(), [&rng, &distribution] () { return distribution( rng ); } );
+
+  CubicalComplex<T> C( { 6, 5, 4 }, values );
+
+  for( bool upperStar : { false, true } )
+  {
+    auto diagrams = calculatePersistenceDiagrams( C, upperStar );
+
+    ALEPH_ASSERT_EQUAL( diagrams.size(), 4 );
+
+    // The volume is contractible, so there must be a single essential
+    // class, which is created by the global minimum (or maximum).
+    std::size_t numEssential = 0;
+
+    for( auto&& D : diagrams )
+      numEssential += static_cast<std::size_t>( std::count_if( D.begin(), D.end(), [] ( const typename PersistenceDiagram<T>::Point& p ) { return p.isUnpaired(); } ) );
+
+    ALEPH_ASSERT_EQUAL( numEssential, 1 );
+
+    auto extremum = upperStar ? *std::max_element( values.begin(), values.end() )
+                              : *std::min_element( values.begin(), values.end() );
+
+    ALEPH_ASSERT_THROW( std::find_if( diagrams[0].begin(), diagrams[0].end(), [&extremum] ( const typename PersistenceDiagram<T>::Point& p ) { return p.isUnpaired() && p.x() == extremum; } ) != diagrams[0].end() );
+
+    // Every pair must respect the direction of the filtration
+    for( auto&& D : diagrams )
+    {
+      for( auto&& p : D )
+      {
+        if( !p.isUnpaired() )
+          ALEPH_ASSERT_THROW( upperStar ? p.x() > p.y() : p.x() < p.y() );
+      }
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void vtk()
+{
+  ALEPH_TEST_BEGIN( "VTK structured grid" );
+
+  using Simplex           = aleph::topology::Simplex<T, unsigned>;
+  using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+
+  auto filename = CMAKE_SOURCE_DIR + std::string( "/tests/input/Simple.vtk" );
+
+  aleph::topology::io::VTKStructuredGridReader reader;
+
+  CubicalComplex<T> C;
+  reader( filename, C );
+
+  ALEPH_ASSERT_EQUAL( C.numVertices(), 5000 );
+  ALEPH_ASSERT_EQUAL( C.dimension()    ,    3 );
+
+  // The binary variant of the file is memory-mapped but has to result
+  // in the same diagrams.
+  {
+    CubicalComplex<T> B;
+    reader( CMAKE_SOURCE_DIR + std::string( "/tests/input/Simple_binary.vtk" ), B );
+
+    ALEPH_ASSERT_EQUAL( B.numVertices(), 5000 );
+
+    auto D1 = calculatePersistenceDiagrams( C );
+    auto D2 = calculatePersistenceDiagrams( B );
+
+    ALEPH_ASSERT_EQUAL( D1.size(), D2.size() );
+
+    for( std::size_t d = 0; d < D1.size(); d++ )
+      ALEPH_ASSERT_THROW( sortedPoints( D1[d] ) == sortedPoints( D2[d] ) );
+  }
+
+  // Connected components only depend on the 1-skeleton of the grid, so
+  // the cubical complex and the simplicial complex have to agree.
+  for( bool upperStar : { false, true } )
+  {
+    SimplicialComplex K;
+
+    if( upperStar )
+    {
+      reader( filename, K, [] ( T a, T b ) { return std::min(a,b); } );
+      K.sort( filtrations::Data<Simplex, std::greater<T> >() );
+    }
+    else
+    {
+      reader( filename, K, [] ( T a, T b ) { return std::max(a,b); } );
+      K.sort( filtrations::Data<Simplex>() );
+    }
+
+    auto D1 = std::get<0>( calculateZeroDimensionalPersistenceDiagram( K ) );
+    auto D2 = calculatePersistenceDiagrams( C, upperStar ).front();
+
+    D1.removeDiagonal();
+
+    ALEPH_ASSERT_EQUAL( D1.size(), D2.size() );
+    ALEPH_ASSERT_THROW( sortedPoints( D1 ) == sortedPoints( D2 ) );
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  cells<float> ();
+  cells<double>();
+
+  ring<float> ();
+  ring<double>();
+
+  randomVolume<float> ();
+  randomVolume<double>();
+
+  vtk<float> ();
+  vtk<double>();
+}
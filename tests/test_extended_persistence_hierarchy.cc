@@ -0,0 +1,416 @@
+#include <tests/Base.hh>
+
+#include <aleph/persistentHomology/ExtendedPersistenceHierarchy.hh>
+
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using DataType          = double;
+using VertexType        = unsigned;
+using Simplex           = aleph::topology::Simplex<DataType, VertexType>;
+using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+
+/** Creates a sublevel set filtration of a 1D function */
+SimplicialComplex makeFunction( const std::vector<DataType>& values )
+{
+  std::vector<Simplex> simplices;
+
+  auto n = static_cast<VertexType>( values.size() );
+
+  for( VertexType i = 0; i < n; i++ )
+    simplices.push_back( Simplex( i, values[i] ) );
+
+  for( VertexType i = 0; i + 1 < n; i++ )
+    simplices.push_back( Simplex( {i, i+1}, std::max( values[i], values[i+1] ) ) );
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+  K.sort( aleph::topology::filtrations::Data<Simplex>() );
+
+  return K;
+}
+
+/**
+  Creates a sublevel set or superlevel set filtration of a function on
+  a graph with the given edges.
+*/
+
+SimplicialComplex makeGraph( const std::vector<DataType>& values,
+                             const std::vector< std::pair<VertexType, VertexType> >& edges,
+                             bool superlevelSets )
+{
+  std::vector<Simplex> simplices;
+
+  auto n = static_cast<VertexType>( values.size() );
+
+  for( VertexType i = 0; i < n; i++ )
+    simplices.push_back( Simplex( i, values[i] ) );
+
+  for( auto&& edge : edges )
+  {
+    auto u = edge.first;
+    auto v = edge.second;
+
+    simplices.push_back( Simplex( {u, v}, superlevelSets ? std::min( values[u], values[v] )
+                                                         : std::max( values[u], values[v] ) ) );
+  }
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+
+  if( superlevelSets )
+    K.sort( aleph::topology::filtrations::Data<Simplex, std::greater<DataType> >() );
+  else
+    K.sort( aleph::topology::filtrations::Data<Simplex>() );
+
+  return K;
+}
+
+/**
+  Brute-force calculation of the hierarchy, which builds the interlevel
+  set for every merge and counts the critical points along the path that
+  a breadth-first search finds between both critical points. Optionally,
+  the search only uses edges of the regions of both critical points, for
+  which the path is not necessarily unique.
+*/
+
+std::pair< std::set< std::pair<VertexType, VertexType> >, std::vector< std::pair<VertexType, VertexType> > >
+  referenceHierarchy( const SimplicialComplex& K, bool restrictToRegions )
+{
+  std::map<VertexType, std::size_t> indices;
+  std::map<VertexType, DataType> values;
+
+  for( std::size_t i = 0; i < K.size(); i++ )
+  {
+    auto&& simplex = K.at(i);
+
+    if( simplex.dimension() == 0 )
+    {
+      indices[ *simplex.begin() ] = i;
+      values[ *simplex.begin() ]  = simplex.data();
+    }
+  }
+
+  // Regions -----------------------------------------------------------
+
+  std::map<std::size_t, VertexType> regions;
+
+  {
+    std::map<VertexType, VertexType> criticalPoints;
+    for( auto&& pair : indices )
+      criticalPoints[pair.first] = pair.first;
+
+    for( std::size_t i = 0; i < K.size(); i++ )
+    {
+      auto&& simplex = K.at(i);
+
+      if( simplex.dimension() != 1 )
+        continue;
+
+      auto younger = *( simplex.begin() );
+      auto older   = *( simplex.begin() + 1 );
+
+      if( indices.at( younger ) < indices.at( older ) )
+        std::swap( younger, older );
+
+      if( values.at( younger ) == simplex.data() )
+        criticalPoints[younger] = criticalPoints[older];
+
+      regions[i] = criticalPoints[older];
+    }
+  }
+
+  // Hierarchy ---------------------------------------------------------
+
+  std::set< std::pair<VertexType, VertexType> > pairs;
+  std::vector< std::pair<VertexType, VertexType> > edges;
+
+  std::map<VertexType, VertexType> vertexToCriticalPoint;
+  std::map<VertexType, VertexType> parents;
+
+  for( auto&& pair : indices )
+  {
+    vertexToCriticalPoint[pair.first] = pair.first;
+    parents[pair.first]               = pair.first;
+  }
+
+  auto find = [&parents] ( VertexType u )
+  {
+    while( parents.at(u) != u )
+      u = parents.at(u);
+
+    return u;
+  };
+
+  for( std::size_t i = 0; i < K.size(); i++ )
+  {
+    auto&& simplex = K.at(i);
+
+    if( simplex.dimension() != 1 )
+      continue;
+
+    auto younger = find( *( simplex.begin() ) );
+    auto older   = find( *( simplex.begin() + 1 ) );
+
+    if( younger == older )
+      continue;
+
+    if( indices.at( younger ) < indices.at( older ) )
+      std::swap( younger, older );
+
+    if( values.at( younger ) == simplex.data() )
+      vertexToCriticalPoint[younger] = older;
+    else
+    {
+      auto a = vertexToCriticalPoint.at( older );
+      auto b = vertexToCriticalPoint.at( younger );
+
+      if( indices.at( b ) < indices.at( a ) )
+        std::swap( a, b );
+
+      auto lower = std::min( values.at(a), simplex.data() );
+      auto upper = std::max( values.at(a), simplex.data() );
+
+      auto contains = [&lower, &upper] ( DataType x )
+      {
+        return x >= lower && x <= upper;
+      };
+
+      // Stores the neighbours of every vertex along with the index of
+      // the connecting edge.
+      std::map<VertexType, std::vector< std::pair<VertexType, std::size_t> > > neighbours;
+
+      for( std::size_t j = 0; j < K.size(); j++ )
+      {
+        auto&& edge = K.at(j);
+
+        if( edge.dimension() != 1 || !contains( edge.data() ) )
+          continue;
+
+        auto u = *( edge.begin() );
+        auto v = *( edge.begin() + 1 );
+
+        if( !contains( values.at(u) ) || !contains( values.at(v) ) )
+          continue;
+
+        if( restrictToRegions && regions.at(j) != a && regions.at(j) != b )
+          continue;
+
+        neighbours[u].push_back( std::make_pair( v, j ) );
+        neighbours[v].push_back( std::make_pair( u, j ) );
+      }
+
+      std::map<VertexType, std::size_t> predecessors;
+      std::vector<VertexType> queue = { a };
+      predecessors[a] = K.size();
+
+      for( std::size_t j = 0; j < queue.size(); j++ )
+      {
+        for( auto&& neighbour : neighbours[ queue[j] ] )
+        {
+          if( predecessors.find( neighbour.first ) == predecessors.end() )
+          {
+            predecessors[ neighbour.first ] = neighbour.second;
+            queue.push_back( neighbour.first );
+          }
+        }
+      }
+
+      std::set<VertexType> criticalPoints;
+
+      if( contains( values.at(b) ) && predecessors.find(b) != predecessors.end() )
+      {
+        for( auto v = b; v != a; )
+        {
+          auto j = predecessors.at(v);
+          auto u = *( K.at(j).begin() );
+
+          criticalPoints.insert( regions.at(j) );
+          v = u != v ? u : *( K.at(j).begin() + 1 );
+        }
+      }
+
+      if( criticalPoints.size() == 2 )
+        edges.push_back( std::make_pair( vertexToCriticalPoint.at( older ), younger ) );
+      else
+        edges.push_back( std::make_pair( older, younger ) );
+
+      vertexToCriticalPoint[older] = younger;
+    }
+
+    pairs.insert( std::make_pair( VertexType( indices.at( younger ) ), VertexType(i) ) );
+    parents[younger] = older;
+  }
+
+  for( auto&& pair : indices )
+  {
+    if( find( pair.first ) == pair.first )
+      pairs.insert( std::make_pair( VertexType( pair.second ), std::numeric_limits<VertexType>::max() ) );
+  }
+
+  return std::make_pair( pairs, edges );
+}
+
+/** Compares the hierarchy of a simplicial complex to the reference */
+bool isEqualToReference( const SimplicialComplex& K, bool restrictToRegions )
+{
+  aleph::ExtendedPersistenceHierarchy<Simplex> eph;
+
+  auto result    = eph( K );
+  auto reference = referenceHierarchy( K, restrictToRegions );
+
+  std::set< std::pair<VertexType, VertexType> > pairs( result.first.begin(), result.first.end() );
+
+  return pairs == reference.first && result.second == reference.second;
+}
+
+void testSimple()
+{
+  ALEPH_TEST_BEGIN( "Extended persistence hierarchy: simple function" );
+
+  // Two minima that are merged into the global minimum at different
+  // times, such that the first one is a child of the second one.
+  auto K = makeFunction( { 0, 3, 1, 2, 0.5, 4, 0.25 } );
+
+  aleph::ExtendedPersistenceHierarchy<Simplex> eph;
+
+  auto result  = eph( K );
+  auto pairing = result.first;
+  auto edges   = result.second;
+
+  ALEPH_ASSERT_EQUAL( pairing.size(), 7 );
+  ALEPH_ASSERT_EQUAL( edges.size(),   3 );
+
+  std::size_t numEssential = 0;
+
+  for( auto&& pair : pairing )
+  {
+    if( pair.second == std::numeric_limits<VertexType>::max() )
+    {
+      ++numEssential;
+      ALEPH_ASSERT_EQUAL( K.at( pair.first ).data(), 0 );
+    }
+  }
+
+  ALEPH_ASSERT_EQUAL( numEssential, 1 );
+
+  ALEPH_TEST_END();
+}
+
+void testRandom()
+{
+  ALEPH_TEST_BEGIN( "Extended persistence hierarchy: random functions" );
+
+  std::mt19937 rng( 42 );
+
+  for( unsigned n : { 2u, 5u, 17u, 64u, 200u } )
+  {
+    for( unsigned k = 0; k < 20; k++ )
+    {
+      // Few distinct values result in many ties, which exercises the
+      // handling of zero-persistence pairs.
+      std::uniform_int_distribution<int> distribution( 0, k % 2 == 0 ? 10 : 1000 );
+
+      std::vector<DataType> values;
+      for( unsigned i = 0; i < n; i++ )
+        values.push_back( DataType( distribution( rng ) ) );
+
+      // The path between two vertices is unique, so the hierarchy has to
+      // coincide with the one of a search in the full interlevel set.
+      ALEPH_ASSERT_THROW( isEqualToReference( makeFunction( values ), false ) );
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testTrees()
+{
+  ALEPH_TEST_BEGIN( "Extended persistence hierarchy: random trees" );
+
+  std::mt19937 rng( 23 );
+
+  for( unsigned n : { 3u, 10u, 50u, 150u } )
+  {
+    for( unsigned k = 0; k < 20; k++ )
+    {
+      std::uniform_int_distribution<int> distribution( 0, k % 2 == 0 ? 10 : 1000 );
+
+      std::vector<DataType> values;
+      for( unsigned i = 0; i < n; i++ )
+        values.push_back( DataType( distribution( rng ) ) );
+
+      std::vector< std::pair<VertexType, VertexType> > edges;
+
+      for( VertexType i = 1; i < n; i++ )
+      {
+        std::uniform_int_distribution<VertexType> parents( 0, i - 1 );
+        edges.push_back( std::make_pair( parents( rng ), i ) );
+      }
+
+      // As for 1D functions, the paths in a tree are unique.
+      ALEPH_ASSERT_THROW( isEqualToReference( makeGraph( values, edges, k % 4 < 2 ), false ) );
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testGrids()
+{
+  ALEPH_TEST_BEGIN( "Extended persistence hierarchy: random grids" );
+
+  std::mt19937 rng( 7 );
+
+  for( unsigned width : { 2u, 5u, 12u } )
+  {
+    for( unsigned height : { 1u, 4u, 9u } )
+    {
+      for( unsigned k = 0; k < 10; k++ )
+      {
+        std::uniform_int_distribution<int> distribution( 0, k % 2 == 0 ? 10 : 1000 );
+
+        std::vector<DataType> values;
+        for( unsigned i = 0; i < width * height; i++ )
+          values.push_back( DataType( distribution( rng ) ) );
+
+        std::vector< std::pair<VertexType, VertexType> > edges;
+
+        for( VertexType y = 0; y < height; y++ )
+        {
+          for( VertexType x = 0; x < width; x++ )
+          {
+            auto i = y * width + x;
+
+            if( x + 1 < width )
+              edges.push_back( std::make_pair( i, i + 1 ) );
+
+            if( y + 1 < height )
+              edges.push_back( std::make_pair( i, i + width ) );
+          }
+        }
+
+        ALEPH_ASSERT_THROW( isEqualToReference( makeGraph( values, edges, k % 4 < 2 ), true ) );
+      }
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testSimple();
+  testRandom();
+  testTrees();
+  testGrids();
+}
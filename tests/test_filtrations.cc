@@ -0,0 +1,235 @@
+#include <tests/Base.hh>
+
+#include <aleph/geometry/RipsExpander.hh>
+
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+#include <aleph/topology/filtrations/LowerStar.hh>
+#include <aleph/topology/filtrations/UpperStar.hh>
+
+#include <aleph/utilities/RadixSort.hh>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+/**
+  Creates the flag complex of a random graph whose simplices have random
+  data, in random order.
+*/
+
+template <class Simplex> aleph::topology::SimplicialComplex<Simplex> makeRandomComplex( std::mt19937& rng, unsigned n, unsigned m, int maxValue )
+{
+  using DataType          = typename Simplex::DataType;
+  using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+
+  std::uniform_int_distribution<unsigned> vertexDistribution( 0, n - 1 );
+  std::uniform_int_distribution<int> valueDistribution( -maxValue, maxValue );
+
+  std::vector<Simplex> simplices;
+
+  for( unsigned i = 0; i < n; i++ )
+    simplices.push_back( Simplex( i ) );
+
+  std::set< std::pair<unsigned, unsigned> > edges;
+
+  while( edges.size() < m )
+  {
+    auto u = vertexDistribution( rng );
+    auto v = vertexDistribution( rng );
+
+    if( u != v )
+      edges.insert( std::make_pair( std::min( u, v ), std::max( u, v ) ) );
+  }
+
+  for( auto&& edge : edges )
+    simplices.push_back( Simplex( {edge.first, edge.second} ) );
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+
+  aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
+  K = ripsExpander( K, 2 );
+
+  simplices.assign( K.begin(), K.end() );
+
+  for( auto&& s : simplices )
+    s.setData( DataType( valueDistribution( rng ) ) / DataType( 2 ) );
+
+  std::shuffle( simplices.begin(), simplices.end(), rng );
+
+  return SimplicialComplex( simplices.begin(), simplices.end() );
+}
+
+/**
+  Checks that sorting a simplicial complex with the keys of a filtration
+  results in the same order as sorting it with the comparison, which is
+  enforced by wrapping the filtration in a lambda expression.
+*/
+
+template <class SimplicialComplex, class Filtration> bool checkSort( const SimplicialComplex& K, Filtration filtration )
+{
+  using Simplex = typename SimplicialComplex::ValueType;
+
+  auto L = K;
+  auto M = K;
+
+  L.sort( filtration );
+  M.sort( [&filtration] ( const Simplex& s, const Simplex& t ) { return filtration( s, t ); } );
+
+  return std::equal( L.begin(), L.end(), M.begin(),
+                     [] ( const Simplex& s, const Simplex& t )
+                     {
+                       return s == t && s.data() == t.data();
+                     } );
+}
+
+/**
+  Comparison functor whose call operator is not const. It counts the
+  number of comparisons in order to check that the sort uses the object
+  that was passed to it.
+*/
+
+template <class Simplex> struct CountingComparison
+{
+  bool operator()( const Simplex& s, const Simplex& t )
+  {
+    ++count;
+    return aleph::topology::filtrations::Data<Simplex>()( s, t );
+  }
+
+  std::size_t count = 0;
+};
+
+template <class T> void testSort()
+{
+  ALEPH_TEST_BEGIN( "Filtration sort" );
+
+  using Simplex = aleph::topology::Simplex<T, unsigned>;
+
+  // Only the standard order and its reverse provide keys
+  ALEPH_ASSERT_THROW( ( aleph::topology::detail::HasKey< aleph::topology::filtrations::Data<Simplex>, Simplex >::value ) );
+  ALEPH_ASSERT_THROW( ( aleph::topology::detail::HasKey< aleph::topology::filtrations::LowerStar<Simplex>, Simplex >::value ) );
+  ALEPH_ASSERT_THROW( ( !aleph::topology::detail::HasKey< aleph::topology::filtrations::Data<Simplex, std::less_equal<T> >, Simplex >::value ) );
+
+  std::mt19937 rng( 42 );
+
+  for( unsigned k = 0; k < 6; k++ )
+  {
+    unsigned n = 20 + 20 * k;
+
+    // Few distinct values result in many ties
+    auto K = makeRandomComplex<Simplex>( rng, n, 4 * n, k % 2 == 0 ? 3 : 1000 );
+
+    std::vector<T> values( n );
+
+    {
+      std::uniform_int_distribution<int> distribution( -5, 5 );
+
+      for( auto&& value : values )
+        value = T( distribution( rng ) );
+    }
+
+    aleph::topology::filtrations::LowerStar<Simplex> lowerStar( values.begin(), values.end() );
+    aleph::topology::filtrations::UpperStar<Simplex> upperStar( values.begin(), values.end() );
+
+    ALEPH_ASSERT_THROW( checkSort( K, aleph::topology::filtrations::Data<Simplex>() ) );
+    ALEPH_ASSERT_THROW( checkSort( K, aleph::topology::filtrations::Data<Simplex, std::greater<T> >() ) );
+    ALEPH_ASSERT_THROW( checkSort( K, lowerStar ) );
+    ALEPH_ASSERT_THROW( checkSort( K, upperStar ) );
+    ALEPH_ASSERT_THROW( checkSort( K, std::ref( lowerStar ) ) );
+
+    // Comparisons without keys may keep state
+    {
+      auto L = K;
+      auto M = K;
+
+      CountingComparison<Simplex> comparison;
+
+      L.sort( comparison );
+      M.sort( aleph::topology::filtrations::Data<Simplex>() );
+
+      ALEPH_ASSERT_THROW( comparison.count > 0 );
+      ALEPH_ASSERT_THROW( L == M );
+
+      std::size_t count = 0;
+
+      L.sort( [&count] ( const Simplex& s, const Simplex& t ) mutable { ++count; return s.data() < t.data(); } );
+
+      ALEPH_ASSERT_THROW( count > 0 );
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testLarge()
+{
+  ALEPH_TEST_BEGIN( "Filtration sort: large complex" );
+
+  using Simplex = aleph::topology::Simplex<float, unsigned>;
+
+  std::mt19937 rng( 23 );
+
+  // Sufficiently many simplices for sorting in parallel
+  auto K = makeRandomComplex<Simplex>( rng, 2000, 100000, 100 );
+
+  ALEPH_ASSERT_THROW( K.size() > ( 1 << 17 ) );
+  ALEPH_ASSERT_THROW( checkSort( K, aleph::topology::filtrations::Data<Simplex>() ) );
+
+  ALEPH_TEST_END();
+}
+
+void testKeys()
+{
+  ALEPH_TEST_BEGIN( "Radix keys" );
+
+  using namespace aleph::utilities;
+
+  ALEPH_ASSERT_EQUAL( radixKey( -0.0 ),  radixKey( 0.0 ) );
+  ALEPH_ASSERT_EQUAL( radixKey( -0.0f ), radixKey( 0.0f ) );
+
+  std::mt19937 rng( 23 );
+  std::uniform_int_distribution<std::uint64_t> distribution;
+
+  // Keys that differ in all bytes require all passes, so the blocks of
+  // the parallel sort have to be combined correctly.
+  std::size_t n = 300000;
+
+  std::vector<std::uint64_t> keys( n );
+  std::vector<std::size_t> indices( n );
+
+  for( std::size_t i = 0; i < n; i++ )
+  {
+    keys[i]    = distribution( rng ) % 1000000007;
+    indices[i] = i;
+  }
+
+  auto expected = indices;
+
+  std::stable_sort( expected.begin(), expected.end(),
+                    [&keys] ( std::size_t i, std::size_t j )
+                    {
+                      return keys[i] < keys[j];
+                    } );
+
+  std::vector<std::size_t> buffer;
+  radixSort( indices, keys, buffer );
+
+  ALEPH_ASSERT_THROW( indices == expected );
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testSort<double>();
+  testSort<float>();
+  testSort<int>();
+  testLarge();
+  testKeys();
+}
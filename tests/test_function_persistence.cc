@@ -0,0 +1,183 @@
+#include <aleph/config/Base.hh>
+
+#include <tests/Base.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/FunctionPersistence.hh>
+
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/topology/io/Function.hh>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using DataType          = double;
+using VertexType        = unsigned;
+using Simplex           = aleph::topology::Simplex<DataType, VertexType>;
+using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+using Point             = std::pair<DataType, DataType>;
+
+std::vector<Point> points( const aleph::PersistenceDiagram<DataType>& D )
+{
+  std::vector<Point> result;
+
+  for( auto&& p : D )
+    result.push_back( std::make_pair( p.x(), p.y() ) );
+
+  std::sort( result.begin(), result.end() );
+  return result;
+}
+
+/** Calculates the persistence diagram of a function via its path complex */
+aleph::PersistenceDiagram<DataType> calculateReferenceDiagram( const std::vector<DataType>& values, bool superlevel )
+{
+  std::vector<Simplex> simplices;
+
+  auto n = static_cast<VertexType>( values.size() );
+
+  for( VertexType i = 0; i < n; i++ )
+    simplices.push_back( Simplex( i, values[i] ) );
+
+  for( VertexType i = 0; i + 1 < n; i++ )
+  {
+    auto value = superlevel ? std::min( values[i], values[i+1] ) : std::max( values[i], values[i+1] );
+    simplices.push_back( Simplex( {i, i+1}, value ) );
+  }
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+
+  if( superlevel )
+    K.sort( aleph::topology::filtrations::Data<Simplex, std::greater<DataType> >() );
+  else
+    K.sort( aleph::topology::filtrations::Data<Simplex>() );
+
+  auto diagrams = aleph::calculatePersistenceDiagrams( K );
+  auto D        = diagrams.front();
+
+  D.removeDiagonal();
+  return D;
+}
+
+void testSingle()
+{
+  ALEPH_TEST_BEGIN( "Function persistence: single functions" );
+
+  {
+    auto D = aleph::calculateFunctionPersistenceDiagram( std::vector<DataType>( { 1, 2, 0, 4, 3 } ) );
+
+    std::vector<Point> expected = { {0, std::numeric_limits<DataType>::infinity() }, {1, 2}, {3, 4} };
+    ALEPH_ASSERT_THROW( points( D ) == expected );
+  }
+
+  {
+    auto D = aleph::calculateFunctionPersistenceDiagram( std::vector<DataType>( { 1, 2, 0, 4, 3 } ), true );
+
+    std::vector<Point> expected = { {2, 0}, {4, std::numeric_limits<DataType>::infinity() } };
+    ALEPH_ASSERT_THROW( points( D ) == expected );
+  }
+
+  ALEPH_ASSERT_EQUAL( aleph::calculateFunctionPersistenceDiagram( std::vector<DataType>() ).size(), 0 );
+  ALEPH_ASSERT_EQUAL( aleph::calculateFunctionPersistenceDiagram( std::vector<DataType>( 1, 1.0 ) ).size(), 1 );
+
+  std::mt19937 rng( 42 );
+
+  for( bool superlevel : { false, true } )
+  {
+    for( unsigned n : { 2u, 3u, 10u, 100u, 1000u } )
+    {
+      for( unsigned maxValue : { 3u, 1000u } )
+      {
+        std::uniform_int_distribution<unsigned> distribution( 0, maxValue );
+
+        std::vector<DataType> values;
+        for( unsigned i = 0; i < n; i++ )
+          values.push_back( DataType( distribution( rng ) ) );
+
+        auto D = aleph::calculateFunctionPersistenceDiagram( values, superlevel );
+        auto E = calculateReferenceDiagram( values, superlevel );
+
+        ALEPH_ASSERT_THROW( points( D ) == points( E ) );
+      }
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testBatch()
+{
+  ALEPH_TEST_BEGIN( "Function persistence: batches" );
+
+  std::vector<DataType> values;
+  std::vector<std::size_t> offsets;
+
+  aleph::topology::io::loadFunctionValues( CMAKE_SOURCE_DIR + std::string( "/tests/input/Functions_simple.txt" ), values, offsets );
+
+  ALEPH_ASSERT_EQUAL( values.size(),  10 );
+  ALEPH_ASSERT_THROW( offsets == std::vector<std::size_t>( { 0, 5, 10 } ) );
+
+  std::mt19937 rng( 23 );
+  std::uniform_int_distribution<unsigned> lengths( 0, 50 );
+  std::uniform_real_distribution<DataType> distribution( -1, 1 );
+
+  for( unsigned i = 0; i < 1000; i++ )
+  {
+    auto n = lengths( rng );
+
+    for( unsigned j = 0; j < n; j++ )
+      values.push_back( distribution( rng ) );
+
+    offsets.push_back( values.size() );
+  }
+
+  for( bool superlevel : { false, true } )
+  {
+    std::vector<DataType> buffer;
+    std::vector<std::size_t> pointOffsets;
+
+    aleph::calculateFunctionPersistenceDiagrams( values, offsets, buffer, pointOffsets, superlevel );
+
+    ALEPH_ASSERT_EQUAL( pointOffsets.size(), offsets.size() );
+    ALEPH_ASSERT_EQUAL( buffer.size(),       2 * pointOffsets.back() );
+
+    for( std::size_t i = 0; i + 1 < offsets.size(); i++ )
+    {
+      std::vector<DataType> function( values.begin() + static_cast<std::ptrdiff_t>( offsets[i] ),
+                                      values.begin() + static_cast<std::ptrdiff_t>( offsets[i+1] ) );
+
+      std::vector<Point> batchPoints;
+
+      for( std::size_t j = pointOffsets[i]; j < pointOffsets[i+1]; j++ )
+        batchPoints.push_back( std::make_pair( buffer[2*j], buffer[2*j+1] ) );
+
+      std::sort( batchPoints.begin(), batchPoints.end() );
+
+      ALEPH_ASSERT_THROW( batchPoints == points( aleph::calculateFunctionPersistenceDiagram( function, superlevel ) ) );
+    }
+  }
+
+  {
+    std::vector<DataType> buffer;
+    std::vector<std::size_t> pointOffsets;
+
+    ALEPH_EXPECT_EXCEPTION( aleph::calculateFunctionPersistenceDiagrams( values, { 0, 3 }, buffer, pointOffsets ), std::runtime_error );
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testSingle();
+  testBatch();
+}
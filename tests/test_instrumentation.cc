@@ -0,0 +1,138 @@
+#include <tests/Base.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+
+#include <aleph/persistentHomology/algorithms/Standard.hh>
+
+#include <aleph/topology/Conversions.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/representations/Vector.hh>
+
+#include <aleph/utilities/Instrumentation.hh>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace aleph::utilities;
+
+using Simplex           = aleph::topology::Simplex<double, unsigned>;
+using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+using Representation    = aleph::topology::representations::Vector<unsigned>;
+
+SimplicialComplex makeTriangle()
+{
+  std::vector<Simplex> simplices
+    = { {0}, {1}, {2}, {0,1}, {0,2}, {1,2}, {0,1,2} };
+
+  return SimplicialComplex( simplices.begin(), simplices.end() );
+}
+
+void testPhases()
+{
+  ALEPH_TEST_BEGIN( "Instrumentation: phases" );
+
+  instrumentation::reset();
+  instrumentation::enable();
+
+  aleph::calculatePersistenceDiagrams( makeTriangle() );
+
+  auto report = instrumentation::report();
+  auto&& phases = report.phases;
+
+  ALEPH_ASSERT_THROW( phases.find( "persistent_homology" )                 != phases.end() );
+  ALEPH_ASSERT_THROW( phases.find( "persistent_homology/boundary_matrix" ) != phases.end() );
+  ALEPH_ASSERT_THROW( phases.find( "persistent_homology/reduction" )       != phases.end() );
+
+  ALEPH_ASSERT_EQUAL( phases.at( "persistent_homology" ).calls,           1 );
+  ALEPH_ASSERT_EQUAL( phases.at( "persistent_homology/reduction" ).calls, 1 );
+
+  ALEPH_ASSERT_THROW( phases.at( "persistent_homology" ).seconds >= phases.at( "persistent_homology/reduction" ).seconds );
+
+  instrumentation::enable( false );
+
+  ALEPH_TEST_END();
+}
+
+void testCounters()
+{
+  ALEPH_TEST_BEGIN( "Instrumentation: counters" );
+
+  instrumentation::reset();
+  instrumentation::enable();
+
+  auto K = makeTriangle();
+  auto M = aleph::topology::makeBoundaryMatrix<Representation>( K );
+
+  aleph::persistentHomology::algorithms::Standard algorithm;
+  algorithm( M );
+
+  auto report   = instrumentation::report();
+  auto counters = report.counters;
+
+  // Every edge has two facets and the triangle has three of them
+  ALEPH_ASSERT_EQUAL( counters[ static_cast<std::size_t>( instrumentation::Counter::FacetLookups ) ],    9 );
+
+  // The edge {1,2} is reduced by adding {0,2} and {0,1}
+  ALEPH_ASSERT_EQUAL( counters[ static_cast<std::size_t>( instrumentation::Counter::ColumnAdditions ) ], 2 );
+
+  std::ostringstream stream;
+  instrumentation::printJSON( stream, report );
+
+  ALEPH_ASSERT_THROW( stream.str().find( "\"facet_lookups\": 9" )    != std::string::npos );
+  ALEPH_ASSERT_THROW( stream.str().find( "\"column_additions\": 2" ) != std::string::npos );
+
+  // Measurements stop once instrumentation has been disabled
+  instrumentation::reset();
+  instrumentation::enable( false );
+
+  aleph::topology::makeBoundaryMatrix<Representation>( K );
+
+  report = instrumentation::report();
+
+  ALEPH_ASSERT_THROW( report.phases.empty() );
+  ALEPH_ASSERT_EQUAL( report.counters[ static_cast<std::size_t>( instrumentation::Counter::FacetLookups ) ], 0 );
+
+  ALEPH_TEST_END();
+}
+
+void testThreads()
+{
+  ALEPH_TEST_BEGIN( "Instrumentation: threads" );
+
+  instrumentation::reset();
+  instrumentation::enable();
+
+  int n = 1000;
+
+  #pragma omp parallel for
+  for( int i = 0; i < n; i++ )
+  {
+    ALEPH_PHASE( "iteration" );
+    ALEPH_COUNT( BytesRead, 2 );
+  }
+
+  auto report = instrumentation::report();
+
+  ALEPH_ASSERT_EQUAL( report.phases.at( "iteration" ).calls,                                                 1000 );
+  ALEPH_ASSERT_EQUAL( report.counters[ static_cast<std::size_t>( instrumentation::Counter::BytesRead ) ], 2000 );
+
+  instrumentation::enable( false );
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  if( !instrumentation::available() )
+  {
+    std::cerr << "* Instrumentation is not available; skipping tests\n";
+    return 0;
+  }
+
+  testPhases();
+  testCounters();
+  testThreads();
+}
@@ -0,0 +1,162 @@
+#include <aleph/config/Base.hh>
+
+#include <tests/Base.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+#include <aleph/persistenceDiagrams/io/Binary.hh>
+
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+template <class T> std::vector< aleph::PersistenceDiagram<T> > makeDiagrams()
+{
+  using PersistenceDiagram = aleph::PersistenceDiagram<T>;
+
+  std::vector<PersistenceDiagram> diagrams( 3 );
+
+  diagrams[0].add( T(0), T(1) );
+  diagrams[0].add( T(0.5), T(2.25) );
+  diagrams[0].add( T(1) );
+
+  diagrams[1].setDimension( 1 );
+  diagrams[1].add( T(1.5), T(3) );
+
+  // The last diagram is empty on purpose
+  diagrams[2].setDimension( 2 );
+
+  return diagrams;
+}
+
+template <class T> void testRoundTrip()
+{
+  ALEPH_TEST_BEGIN( "Binary persistence diagrams: round trip" );
+
+  auto diagrams = makeDiagrams<T>();
+  auto filename = CMAKE_CURRENT_BINARY_DIR + std::string( "/Diagrams.bpd" );
+
+  aleph::io::writeBinary( filename, diagrams, { "foo", "bar", "" } );
+
+  aleph::io::BinaryPersistenceDiagramReader reader( filename );
+
+  ALEPH_ASSERT_EQUAL( reader.size(), diagrams.size() );
+
+  ALEPH_ASSERT_THROW( reader[0].name() == "foo" );
+  ALEPH_ASSERT_THROW( reader[1].name() == "bar" );
+  ALEPH_ASSERT_THROW( reader[2].name().empty() );
+
+  for( std::size_t i = 0; i < diagrams.size(); i++ )
+  {
+    auto view = reader[i];
+
+    ALEPH_ASSERT_EQUAL( view.size(),      diagrams[i].size() );
+    ALEPH_ASSERT_EQUAL( view.dimension(), diagrams[i].dimension() );
+    ALEPH_ASSERT_THROW( view.toDiagram<T>() == diagrams[i] );
+  }
+
+  ALEPH_ASSERT_EQUAL( reader[0][1].x(), 0.5 );
+  ALEPH_ASSERT_EQUAL( reader[0][1].y(), 2.25 );
+  ALEPH_ASSERT_EQUAL( reader[0][2].y(), std::numeric_limits<double>::infinity() );
+
+  ALEPH_ASSERT_THROW( aleph::io::readBinary<T>( filename ) == diagrams );
+
+  ALEPH_TEST_END();
+}
+
+void testStreaming()
+{
+  ALEPH_TEST_BEGIN( "Binary persistence diagrams: streaming and views" );
+
+  auto filename = CMAKE_CURRENT_BINARY_DIR + std::string( "/Streamed.bpd" );
+  auto diagrams = makeDiagrams<double>();
+
+  {
+    aleph::io::BinaryPersistenceDiagramWriter writer( filename );
+
+    for( std::size_t i = 0; i < 100; i++ )
+      writer.add( diagrams[ i % diagrams.size() ], "diagram_" + std::to_string( i ) );
+  }
+
+  aleph::io::BinaryPersistenceDiagramReader reader( filename );
+
+  ALEPH_ASSERT_EQUAL( reader.size(), 100 );
+  ALEPH_ASSERT_THROW( reader[42].name() == "diagram_42" );
+  ALEPH_ASSERT_THROW( reader[42].toDiagram<double>() == diagrams[0] );
+
+  // Views may be copied to another container without any conversion
+  auto copy = CMAKE_CURRENT_BINARY_DIR + std::string( "/Copied.bpd" );
+
+  {
+    aleph::io::BinaryPersistenceDiagramWriter writer( copy );
+    writer.add( reader[43], reader[43].name().str() );
+  }
+
+  aleph::io::BinaryPersistenceDiagramReader copyReader( copy );
+
+  ALEPH_ASSERT_EQUAL( copyReader.size(), 1 );
+  ALEPH_ASSERT_THROW( copyReader[0].name() == "diagram_43" );
+  ALEPH_ASSERT_THROW( copyReader[0].toDiagram<double>() == diagrams[1] );
+
+  ALEPH_EXPECT_EXCEPTION( reader[100], std::out_of_range );
+
+  ALEPH_TEST_END();
+}
+
+void testConversion()
+{
+  ALEPH_TEST_BEGIN( "Binary persistence diagrams: conversion" );
+
+  auto input  = CMAKE_CURRENT_BINARY_DIR + std::string( "/Raw_diagram.txt" );
+  auto output = CMAKE_CURRENT_BINARY_DIR + std::string( "/Raw_diagram.bpd" );
+
+  {
+    std::ofstream out( input );
+    out << "# Birth Death\n"
+        << "0 1\n"
+        << "0.5\t2.25\n"
+        << "\n"
+        << "1 inf\n";
+  }
+
+  aleph::io::convertToBinary( { input, input }, output );
+
+  aleph::io::BinaryPersistenceDiagramReader reader( output );
+
+  ALEPH_ASSERT_EQUAL( reader.size(), 2 );
+  ALEPH_ASSERT_THROW( reader[0].name() == "Raw_diagram" );
+  ALEPH_ASSERT_THROW( reader[1].toDiagram<double>() == aleph::io::load<double>( input ) );
+
+  ALEPH_TEST_END();
+}
+
+void testInvalidFiles()
+{
+  ALEPH_TEST_BEGIN( "Binary persistence diagrams: invalid files" );
+
+  using Reader = aleph::io::BinaryPersistenceDiagramReader;
+
+  ALEPH_EXPECT_EXCEPTION( Reader( CMAKE_SOURCE_DIR + std::string( "/tests/input/Triangle.txt" ) ), std::runtime_error );
+
+  auto filename = CMAKE_CURRENT_BINARY_DIR + std::string( "/Truncated.bpd" );
+
+  {
+    std::ofstream out( filename, std::ios::binary );
+    out << "ALEPHPD";
+  }
+
+  ALEPH_EXPECT_EXCEPTION( Reader( filename ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testRoundTrip<double>();
+  testRoundTrip<float> ();
+
+  testStreaming();
+  testConversion();
+  testInvalidFiles();
+}
@@ -0,0 +1,167 @@
+#include <aleph/config/Base.hh>
+
+#include <tests/Base.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+
+#include <aleph/topology/BoundaryMatrix.hh>
+#include <aleph/topology/Conversions.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/io/BinaryFiltration.hh>
+#include <aleph/topology/io/PLY.hh>
+
+#include <aleph/topology/representations/Mapped.hh>
+#include <aleph/topology/representations/Vector.hh>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+template <class D, class V> void testSimplicialComplex( bool compression )
+{
+  ALEPH_TEST_BEGIN( "Binary filtration: simplicial complex" );
+
+  using Simplex           = aleph::topology::Simplex<D, V>;
+  using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+
+  SimplicialComplex K;
+
+  aleph::topology::io::PLYReader reader;
+  reader.setDataProperty( "quality" );
+  reader( CMAKE_SOURCE_DIR + std::string( "/tests/input/Grid.ply" ), K );
+
+  auto filename = CMAKE_CURRENT_BINARY_DIR + std::string( "/Grid.bf" );
+
+  aleph::topology::io::BinaryFiltrationWriter writer;
+  writer.setCompression( compression );
+  writer( filename, K );
+
+  SimplicialComplex L;
+
+  aleph::topology::io::BinaryFiltrationReader binaryReader;
+  binaryReader( filename, L );
+
+  ALEPH_ASSERT_EQUAL( K.size(), L.size() );
+
+  for( std::size_t i = 0; i < K.size(); i++ )
+  {
+    ALEPH_ASSERT_THROW( K.at(i) == L.at(i) );
+    ALEPH_ASSERT_EQUAL( K.at(i).data(), L.at(i).data() );
+  }
+
+  // Boundary matrices ---------------------------------------------------
+
+  using Index = unsigned;
+
+  auto M = aleph::topology::makeBoundaryMatrix<aleph::topology::representations::Vector<Index> >( K );
+
+  aleph::topology::BoundaryMatrix< aleph::topology::representations::Mapped<Index> > B;
+  aleph::topology::BoundaryMatrix< aleph::topology::representations::Vector<Index> > C;
+
+  std::vector<D> values;
+
+  binaryReader( filename, B, values );
+
+  ALEPH_ASSERT_EQUAL( B.getNumColumns(), M.getNumColumns() );
+  ALEPH_ASSERT_EQUAL( B.getDimension(),  M.getDimension() );
+  ALEPH_ASSERT_EQUAL( values.size(),     K.size() );
+
+  for( Index j = 0; j < M.getNumColumns(); j++ )
+  {
+    ALEPH_ASSERT_THROW( B.getColumn(j) == M.getColumn(j) );
+    ALEPH_ASSERT_EQUAL( B.getDimension(j), M.getDimension(j) );
+    ALEPH_ASSERT_EQUAL( values[j], K.at(j).data() );
+  }
+
+  binaryReader( filename, C, values );
+
+  ALEPH_ASSERT_THROW( C == M );
+
+  auto pairing = aleph::calculatePersistencePairing( M );
+
+  ALEPH_ASSERT_THROW( aleph::calculatePersistencePairing( B )            == pairing );
+  ALEPH_ASSERT_THROW( aleph::calculatePersistencePairing( C )            == pairing );
+  ALEPH_ASSERT_THROW( aleph::calculatePersistencePairing( B.dualize() ) == aleph::calculatePersistencePairing( M.dualize() ) );
+
+  // Reduction must not modify the shared columns
+  ALEPH_ASSERT_THROW( B.getColumn( Index( K.size() - 1 ) ) == M.getColumn( Index( K.size() - 1 ) ) );
+
+  ALEPH_TEST_END();
+}
+
+void testBoundaryMatrix( bool compression )
+{
+  ALEPH_TEST_BEGIN( "Binary filtration: boundary matrix" );
+
+  using Index = unsigned;
+
+  aleph::topology::BoundaryMatrix< aleph::topology::representations::Vector<Index> > M;
+  M.setNumColumns( 7 );
+
+  std::vector<Index> c3 = { 0, 1 };
+  std::vector<Index> c4 = { 1, 2 };
+  std::vector<Index> c5 = { 0, 2 };
+  std::vector<Index> c6 = { 3, 4, 5 };
+
+  M.setColumn( 3, c3.begin(), c3.end() );
+  M.setColumn( 4, c4.begin(), c4.end() );
+  M.setColumn( 5, c5.begin(), c5.end() );
+  M.setColumn( 6, c6.begin(), c6.end() );
+
+  auto filename = CMAKE_CURRENT_BINARY_DIR + std::string( "/Triangle.bf" );
+
+  aleph::topology::io::BinaryFiltrationWriter writer;
+  writer.setCompression( compression );
+  writer( filename, M, std::vector<float>( { 0, 0, 0, 1, 1, 2, 3 } ) );
+
+  aleph::topology::BoundaryMatrix< aleph::topology::representations::Mapped<Index> > B;
+  std::vector<double> values;
+
+  aleph::topology::io::BinaryFiltrationReader reader;
+  reader( filename, B, values );
+
+  ALEPH_ASSERT_THROW( values == std::vector<double>( { 0, 0, 0, 1, 1, 2, 3 } ) );
+  ALEPH_ASSERT_THROW( aleph::calculatePersistencePairing( B ) == aleph::calculatePersistencePairing( M ) );
+
+  // Simplices are not available in this file
+  aleph::topology::SimplicialComplex< aleph::topology::Simplex<double, unsigned> > K;
+  ALEPH_EXPECT_EXCEPTION( reader( filename, K ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+void testInvalidFiles()
+{
+  ALEPH_TEST_BEGIN( "Binary filtration: invalid files" );
+
+  aleph::topology::SimplicialComplex< aleph::topology::Simplex<double, unsigned> > K;
+  aleph::topology::io::BinaryFiltrationReader reader;
+
+  ALEPH_EXPECT_EXCEPTION( reader( CMAKE_SOURCE_DIR + std::string( "/tests/input/Grid.ply" ), K ), std::runtime_error );
+
+  auto filename = CMAKE_CURRENT_BINARY_DIR + std::string( "/Truncated.bf" );
+
+  {
+    std::ofstream out( filename, std::ios::binary );
+    out << "ALEPHBF";
+  }
+
+  ALEPH_EXPECT_EXCEPTION( reader( filename, K ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  for( bool compression : { false, true } )
+  {
+    testSimplicialComplex<double, unsigned>      ( compression );
+    testSimplicialComplex<float,  unsigned short>( compression );
+
+    testBoundaryMatrix( compression );
+  }
+
+  testInvalidFiles();
+}
@@ -126,6 +126,24 @@ template <class D, class V> void test( const std::string& filename )
   ALEPH_TEST_END();
 }
 
+template <class D, class V> void testInvalid()
+{
+  ALEPH_TEST_BEGIN( "Functions file with invalid values" );
+
+  using Simplex           = aleph::topology::Simplex<D, V>;
+  using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+
+  std::string filename = CMAKE_SOURCE_DIR + std::string( "/tests/input/Functions_invalid.txt" );
+
+  std::vector<D> values;
+  std::vector<std::size_t> offsets;
+
+  ALEPH_EXPECT_EXCEPTION( aleph::topology::io::loadFunctions<SimplicialComplex>( filename ), std::runtime_error );
+  ALEPH_EXPECT_EXCEPTION( aleph::topology::io::loadFunctionValues( filename, values, offsets ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
 int main()
 {
   std::vector<std::string> inputs = {
@@ -140,4 +158,7 @@ int main()
     test<float, unsigned>      ( input );
     test<float, unsigned short>( input );
   }
+
+  testInvalid<double, unsigned>();
+  testInvalid<float,  unsigned>();
 }
@@ -0,0 +1,150 @@
+#include <aleph/config/Base.hh>
+
+#include <tests/Base.hh>
+
+#include <aleph/topology/IndexedMesh.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/io/PLY.hh>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+template <class T> void testArrays( const std::string& filename )
+{
+  ALEPH_TEST_BEGIN( "PLY file parsing into arrays" );
+
+  std::vector<T> coordinates;
+  std::vector<T> data;
+  std::vector<std::size_t> offsets;
+  std::vector<unsigned> vertices;
+
+  aleph::topology::io::PLYReader reader;
+  reader.setDataProperty( "quality" );
+  reader( filename, coordinates, data, offsets, vertices );
+
+  ALEPH_ASSERT_EQUAL( coordinates.size(), 27 );
+  ALEPH_ASSERT_EQUAL( data.size(),         9 );
+  ALEPH_ASSERT_EQUAL( offsets.size(),      9 );
+  ALEPH_ASSERT_EQUAL( vertices.size(),    24 );
+
+  ALEPH_ASSERT_THROW( data == std::vector<T>( { 0, 1, 0, 1, 2, 1, 0, 1, 0 } ) );
+
+  for( std::size_t i = 0; i < 9; i++ )
+  {
+    ALEPH_ASSERT_EQUAL( coordinates[3*i  ], T( i % 3 ) );
+    ALEPH_ASSERT_EQUAL( coordinates[3*i+1], T( i / 3 ) );
+    ALEPH_ASSERT_EQUAL( coordinates[3*i+2], T( 0 ) );
+  }
+
+  for( std::size_t f = 0; f < 9; f++ )
+    ALEPH_ASSERT_EQUAL( offsets[f], 3*f );
+
+  ALEPH_ASSERT_THROW( std::vector<unsigned>( vertices.end() - 3, vertices.end() ) == std::vector<unsigned>( { 4, 7, 6 } ) );
+
+  // The default property is the z coordinate
+  reader.setDataProperty( "z" );
+  reader( filename, coordinates, data, offsets, vertices );
+
+  ALEPH_ASSERT_THROW( data == std::vector<T>( 9, T( 0 ) ) );
+
+  ALEPH_TEST_END();
+}
+
+void testMesh( const std::string& filename )
+{
+  ALEPH_TEST_BEGIN( "PLY file parsing into indexed mesh" );
+
+  aleph::topology::IndexedMesh<float, float> M;
+
+  aleph::topology::io::PLYReader reader;
+  reader.setDataProperty( "quality" );
+  reader( filename, M );
+
+  ALEPH_ASSERT_EQUAL( M.numVertices(), 9 );
+  ALEPH_ASSERT_EQUAL( M.numFaces(),    8 );
+  ALEPH_ASSERT_EQUAL( M.numConnectedComponents(), 1 );
+  ALEPH_ASSERT_EQUAL( M.link(4).size(), 8 );
+  ALEPH_ASSERT_EQUAL( M.data(4), 2.0f );
+  ALEPH_ASSERT_EQUAL( M.position(5)[0], 2.0f );
+
+  ALEPH_TEST_END();
+}
+
+template <class D, class V> void testSimplicialComplex( const std::string& filename )
+{
+  ALEPH_TEST_BEGIN( "PLY file parsing into simplicial complex" );
+
+  using Simplex           = aleph::topology::Simplex<D, V>;
+  using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+
+  SimplicialComplex K;
+
+  aleph::topology::io::PLYReader reader;
+  reader.setDataProperty( "quality" );
+  reader( filename, K );
+
+  ALEPH_ASSERT_EQUAL( K.size(), 33 );
+  ALEPH_ASSERT_EQUAL( std::count_if( K.begin(), K.end(), [] ( const Simplex& s ) { return s.dimension() == 0; } ), 9 );
+  ALEPH_ASSERT_EQUAL( std::count_if( K.begin(), K.end(), [] ( const Simplex& s ) { return s.dimension() == 1; } ), 16 );
+  ALEPH_ASSERT_EQUAL( std::count_if( K.begin(), K.end(), [] ( const Simplex& s ) { return s.dimension() == 2; } ), 8 );
+
+  // Lower-star filtration: the central vertex has the largest value, so
+  // every simplex containing it is created last.
+  ALEPH_ASSERT_EQUAL( K.at( K.size() - 1 ).data(), D( 2 ) );
+  ALEPH_ASSERT_EQUAL( K.begin()->data(),  D( 0 ) );
+
+  ALEPH_TEST_END();
+}
+
+void testStream()
+{
+  ALEPH_TEST_BEGIN( "PLY file parsing from stream" );
+
+  using Simplex           = aleph::topology::Simplex<double, unsigned>;
+  using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+
+  SimplicialComplex K;
+  SimplicialComplex L;
+
+  aleph::topology::io::PLYReader reader;
+  reader.setDataProperty( "quality" );
+
+  std::ifstream in( CMAKE_SOURCE_DIR + std::string( "/tests/input/Grid.ply" ) );
+  reader( in, K );
+  reader( CMAKE_SOURCE_DIR + std::string( "/tests/input/Grid.ply" ), L );
+
+  ALEPH_ASSERT_EQUAL( K.size(), L.size() );
+
+  for( auto&& s : K )
+  {
+    ALEPH_ASSERT_THROW( L.contains( s ) );
+    ALEPH_ASSERT_EQUAL( L.find( s )->data(), s.data() );
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  std::vector<std::string> inputs = {
+    CMAKE_SOURCE_DIR + std::string( "/tests/input/Grid.ply" ),
+    CMAKE_SOURCE_DIR + std::string( "/tests/input/Grid_binary.ply" )
+  };
+
+  for( auto&& input : inputs )
+  {
+    testArrays<float> ( input );
+    testArrays<double>( input );
+
+    testMesh( input );
+
+    testSimplicialComplex<double, unsigned>      ( input );
+    testSimplicialComplex<float,  unsigned short>( input );
+  }
+
+  testStream();
+}
@@ -10,6 +10,7 @@
 #include <aleph/topology/filtrations/Data.hh>
 
 #include <aleph/topology/io/VTK.hh>
+#include <aleph/topology/io/Volume.hh>
 
 #include <algorithm>
 
@@ -49,10 +50,78 @@ template <class D, class V> void test()
   ALEPH_TEST_END();
 }
 
+template <class D, class V> void testBinary()
+{
+  ALEPH_TEST_BEGIN( "VTK binary structured points" );
+
+  using Simplex           = aleph::topology::Simplex<D, V>;
+  using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+
+  SimplicialComplex K;
+  SimplicialComplex L;
+
+  aleph::topology::io::VTKStructuredGridReader reader;
+
+  auto functor = [] ( D a, D b ) { return std::min(a,b); };
+
+  reader( CMAKE_SOURCE_DIR + std::string( "/tests/input/Simple.vtk" ),        K, functor );
+  reader( CMAKE_SOURCE_DIR + std::string( "/tests/input/Simple_binary.vtk" ), L, functor );
+
+  ALEPH_ASSERT_EQUAL( K.size(), L.size() );
+  ALEPH_ASSERT_THROW( K == L );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testVolumes()
+{
+  ALEPH_TEST_BEGIN( "Memory-mapped volumes" );
+
+  using namespace aleph::topology::io;
+
+  auto vtk  = loadVTKVolume<T> ( CMAKE_SOURCE_DIR + std::string( "/tests/input/Simple_binary.vtk" ) );
+  auto nrrd = loadNRRDVolume<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Simple.nrrd" ) );
+  auto raw  = loadRawVolume<T> ( CMAKE_SOURCE_DIR + std::string( "/tests/input/Simple.raw" ),
+                                 { 50, 50, 2 },
+                                 ScalarType::Float64 );
+
+  auto reference = loadRawVolume<double>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Simple.raw" ),
+                                          { 50, 50, 2 },
+                                          ScalarType::Float64 );
+
+  ALEPH_ASSERT_EQUAL( vtk.size(),  5000 );
+  ALEPH_ASSERT_EQUAL( nrrd.size(), 5000 );
+  ALEPH_ASSERT_EQUAL( raw.size(),  5000 );
+
+  ALEPH_ASSERT_THROW( vtk.shape()  == std::vector<std::size_t>( { 50, 50, 2 } ) );
+  ALEPH_ASSERT_THROW( nrrd.shape() == std::vector<std::size_t>( { 50, 50, 2 } ) );
+
+  ALEPH_ASSERT_THROW( std::equal( vtk.begin(), vtk.end(), nrrd.begin() ) );
+  ALEPH_ASSERT_THROW( std::equal( vtk.begin(), vtk.end(), raw.begin() ) );
+
+  ALEPH_ASSERT_THROW( std::equal( vtk.begin(), vtk.end(), reference.begin(),
+                                  [] ( T a, double b ) { return a == static_cast<T>( b ); } ) );
+
+  // Asking for more values than the file contains must not read beyond
+  // the mapping.
+  ALEPH_EXPECT_EXCEPTION( loadRawVolume<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Simple.raw" ),
+                                            { 50, 50, 3 },
+                                            ScalarType::Float64 ),
+                          std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
 int main()
 {
   test<double,unsigned>      ();
   test<double,unsigned short>();
   test<float, unsigned>      ();
   test<float, unsigned short>();
+
+  testBinary<double, unsigned>();
+  testBinary<float,  unsigned>();
+
+  testVolumes<double>();
+  testVolumes<float> ();
 }
@@ -0,0 +1,320 @@
+#include <tests/Base.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistentHomology/ConnectedComponents.hh>
+
+#include <aleph/topology/IndexedMesh.hh>
+#include <aleph/topology/MergeTree.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/utilities/ParallelSort.hh>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using DataType          = double;
+using VertexType        = unsigned;
+using Simplex           = aleph::topology::Simplex<DataType, VertexType>;
+using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+using Point             = std::pair<DataType, DataType>;
+
+std::vector<Point> points( const aleph::PersistenceDiagram<DataType>& D )
+{
+  std::vector<Point> result;
+
+  for( auto&& p : D )
+    result.push_back( std::make_pair( p.x(), p.y() ) );
+
+  std::sort( result.begin(), result.end() );
+  return result;
+}
+
+/**
+  Creates a random graph with a random function on its vertices. Edges
+  are assigned the maximum (minimum) of their vertices, such that the
+  complex is a lower-star (upper-star) filtration.
+*/
+
+SimplicialComplex makeRandomGraph( std::mt19937& rng, unsigned n, unsigned m, unsigned maxValue, bool sublevel )
+{
+  std::uniform_int_distribution<unsigned> vertexDistribution( 0, n - 1 );
+  std::uniform_int_distribution<unsigned> valueDistribution( 0, maxValue );
+
+  std::vector<DataType> values;
+  std::vector<Simplex> simplices;
+
+  // Vertices are not contiguous, so the mapping to the indices of the
+  // tree is used
+  for( unsigned i = 0; i < n; i++ )
+  {
+    values.push_back( DataType( valueDistribution( rng ) ) );
+    simplices.push_back( Simplex( 3 * i, values.back() ) );
+  }
+
+  std::set< std::pair<unsigned, unsigned> > edges;
+
+  while( edges.size() < m )
+  {
+    auto u = vertexDistribution( rng );
+    auto v = vertexDistribution( rng );
+
+    if( u != v )
+      edges.insert( std::make_pair( std::min( u, v ), std::max( u, v ) ) );
+  }
+
+  for( auto&& edge : edges )
+  {
+    auto value = sublevel ? std::max( values[edge.first], values[edge.second] )
+                          : std::min( values[edge.first], values[edge.second] );
+
+    simplices.push_back( Simplex( {3 * edge.first, 3 * edge.second}, value ) );
+  }
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+
+  if( sublevel )
+    K.sort( aleph::topology::filtrations::Data<Simplex>() );
+  else
+    K.sort( aleph::topology::filtrations::Data<Simplex, std::greater<DataType> >() );
+
+  return K;
+}
+
+void testSimple()
+{
+  ALEPH_TEST_BEGIN( "Merge tree: simple function" );
+
+  std::vector<Simplex> simplices = {
+    Simplex( 0u, 1 ), Simplex( 1u, 3 ), Simplex( 2u, 0 ), Simplex( 3u, 4 ), Simplex( 4u, 2 ),
+    Simplex( {0,1}, 3 ), Simplex( {1,2}, 3 ), Simplex( {2,3}, 4 ), Simplex( {3,4}, 4 )
+  };
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+
+  std::vector<VertexType> vertices;
+  auto T = aleph::topology::makeMergeTree( K, vertices );
+
+  using Tree = decltype( T );
+
+  ALEPH_ASSERT_EQUAL( vertices.size(), 5 );
+  ALEPH_ASSERT_EQUAL( T.size(),        5 );
+
+  auto&& branches = T.branches();
+
+  ALEPH_ASSERT_EQUAL( branches.size(), 3 );
+
+  ALEPH_ASSERT_EQUAL( branches[0].creator,   2 );
+  ALEPH_ASSERT_EQUAL( branches[0].destroyer, Tree::invalid() );
+  ALEPH_ASSERT_EQUAL( branches[1].creator,   0 );
+  ALEPH_ASSERT_EQUAL( branches[1].destroyer, 1 );
+  ALEPH_ASSERT_EQUAL( branches[1].parent,    0 );
+  ALEPH_ASSERT_EQUAL( branches[2].creator,   4 );
+  ALEPH_ASSERT_EQUAL( branches[2].destroyer, 3 );
+  ALEPH_ASSERT_EQUAL( branches[2].parent,    0 );
+
+  ALEPH_ASSERT_THROW( T.nodes() == std::vector<VertexType>( { 2, 0, 4, 1, 3 } ) );
+
+  std::vector< std::pair<VertexType, VertexType> > arcs = { {2,1}, {0,1}, {4,3}, {1,3} };
+  ALEPH_ASSERT_THROW( T.arcs() == arcs );
+
+  std::vector<Point> expected = { {0, std::numeric_limits<DataType>::infinity() }, {1,3}, {2,4} };
+  ALEPH_ASSERT_THROW( points( T.persistenceDiagram() ) == expected );
+
+  // The contour tree of a 1D function is the path itself
+  auto S = aleph::topology::makeMergeTree( K, vertices, false );
+  auto C = aleph::topology::makeContourTree( T, S );
+
+  std::set< std::pair<VertexType, VertexType> > contourTreeArcs;
+
+  for( auto&& arc : C )
+    contourTreeArcs.insert( std::make_pair( std::min( arc.first, arc.second ), std::max( arc.first, arc.second ) ) );
+
+  std::set< std::pair<VertexType, VertexType> > path = { {0,1}, {1,2}, {2,3}, {3,4} };
+  ALEPH_ASSERT_THROW( contourTreeArcs == path );
+
+  ALEPH_EXPECT_EXCEPTION( aleph::topology::makeContourTree( T, T ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+void testRandom()
+{
+  ALEPH_TEST_BEGIN( "Merge tree: random graphs" );
+
+  std::mt19937 rng( 42 );
+
+  for( bool sublevel : { true, false } )
+  {
+    for( unsigned k = 0; k < 20; k++ )
+    {
+      unsigned n = 10 + 20 * k;
+
+      // Few distinct values result in many ties
+      auto K = makeRandomGraph( rng, n, n + k, k % 2 == 0 ? 5 : 1000, sublevel );
+
+      std::vector<VertexType> vertices;
+      auto T = aleph::topology::makeMergeTree( K, vertices, sublevel );
+
+      auto D = std::get<0>( aleph::calculateZeroDimensionalPersistenceDiagram( K ) );
+
+      ALEPH_ASSERT_THROW( points( T.persistenceDiagram() ) == points( D ) );
+
+      // Every vertex except for the roots has a parent that succeeds it
+      // in the sweep
+      std::size_t numRoots = 0;
+
+      for( VertexType v = 0; v < T.size(); v++ )
+      {
+        if( T.parent( v ) == decltype( T )::invalid() )
+          ++numRoots;
+        else
+          ALEPH_ASSERT_THROW( T.rank( v ) < T.rank( T.parent( v ) ) );
+      }
+
+      ALEPH_ASSERT_EQUAL( numRoots, D.betti() );
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testContourTree()
+{
+  ALEPH_TEST_BEGIN( "Contour tree: random 1D functions" );
+
+  std::mt19937 rng( 23 );
+  std::uniform_int_distribution<unsigned> distribution( 0, 10 );
+
+  for( unsigned n = 2; n < 200; n += 13 )
+  {
+    std::vector<DataType> values;
+    std::vector<Simplex> simplices;
+
+    for( unsigned i = 0; i < n; i++ )
+    {
+      values.push_back( DataType( distribution( rng ) ) );
+      simplices.push_back( Simplex( i, values.back() ) );
+    }
+
+    for( unsigned i = 0; i + 1 < n; i++ )
+      simplices.push_back( Simplex( {i, i+1}, std::max( values[i], values[i+1] ) ) );
+
+    SimplicialComplex K( simplices.begin(), simplices.end() );
+
+    std::vector<VertexType> vertices;
+
+    auto split = aleph::topology::makeMergeTree( K, vertices, true );
+    auto join  = aleph::topology::makeMergeTree( K, vertices, false );
+    auto arcs  = aleph::topology::makeContourTree( split, join );
+
+    ALEPH_ASSERT_EQUAL( arcs.size(), n - 1 );
+
+    for( auto&& arc : arcs )
+      ALEPH_ASSERT_EQUAL( std::max( arc.first, arc.second ) - std::min( arc.first, arc.second ), 1 );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testMesh()
+{
+  ALEPH_TEST_BEGIN( "Merge tree: mesh" );
+
+  std::vector<float> data = { 0, 1, 0, 1, 2, 1, 0, 1, 0 };
+  std::vector<float> coordinates;
+
+  for( unsigned i = 0; i < 9; i++ )
+  {
+    coordinates.push_back( float( i % 3 ) );
+    coordinates.push_back( float( i / 3 ) );
+    coordinates.push_back( 0.0f );
+  }
+
+  std::vector<unsigned> triangles = {
+    0, 1, 4,
+    0, 4, 3,
+    1, 2, 4,
+    2, 5, 4,
+    4, 5, 8,
+    4, 8, 7,
+    3, 4, 6,
+    4, 7, 6
+  };
+
+  aleph::topology::IndexedMesh<float, float> M( coordinates, data, triangles );
+
+  auto split = aleph::topology::makeMergeTree( M );
+  auto join  = aleph::topology::makeMergeTree( M, false );
+
+  // Four minima in the corners, three of which are destroyed by the
+  // vertices in the middle of the sides
+  {
+    auto D = split.persistenceDiagram();
+
+    ALEPH_ASSERT_EQUAL( D.size(),    4 );
+    ALEPH_ASSERT_EQUAL( D.betti(),   1 );
+    // Four leaves, three merges, and the root; the last side vertex
+    // does not merge anything because all minima are connected already.
+    ALEPH_ASSERT_EQUAL( split.nodes().size(), 8 );
+  }
+
+  // A single maximum in the centre
+  {
+    auto D = join.persistenceDiagram();
+
+    ALEPH_ASSERT_EQUAL( D.size(),  1 );
+    ALEPH_ASSERT_EQUAL( D.betti(), 1 );
+  }
+
+  auto arcs = aleph::topology::makeContourTree( split, join );
+
+  ALEPH_ASSERT_EQUAL( arcs.size(), 8 );
+
+  ALEPH_TEST_END();
+}
+
+void testParallelSort()
+{
+  ALEPH_TEST_BEGIN( "Parallel sort" );
+
+  std::mt19937 rng( 23 );
+  std::uniform_int_distribution<int> distribution( 0, 1000 );
+
+  for( std::size_t n : { std::size_t( 0 ), std::size_t( 1 ), std::size_t( 1000 ), std::size_t( 300000 ) } )
+  {
+    std::vector<int> values( n );
+    for( auto&& value : values )
+      value = distribution( rng );
+
+    auto expected = values;
+    std::sort( expected.begin(), expected.end(), std::greater<int>() );
+
+    aleph::utilities::parallelSort( values.begin(), values.end(), std::greater<int>() );
+    ALEPH_ASSERT_THROW( values == expected );
+
+    std::reverse( expected.begin(), expected.end() );
+
+    aleph::utilities::parallelSort( values.begin(), values.end() );
+    ALEPH_ASSERT_THROW( values == expected );
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testSimple();
+  testRandom();
+  testContourTree();
+  testMesh();
+  testParallelSort();
+}
@@ -1,8 +1,10 @@
 #include <tests/Base.hh>
 
+#include <aleph/topology/IndexedMesh.hh>
 #include <aleph/topology/Mesh.hh>
 #include <aleph/topology/MorseSmaleComplex.hh>
 
+#include <stdexcept>
 #include <vector>
 
 void test1()
@@ -153,9 +155,121 @@ void test3()
   ALEPH_TEST_END();
 }
 
+void testIndexedMesh()
+{
+  ALEPH_TEST_BEGIN( "Indexed mesh" );
+
+  std::vector<float> data = { 0, 1, 0, 1, 2, 1, 0, 1, 0 };
+  std::vector<float> coordinates;
+
+  for( unsigned i = 0; i < 9; i++ )
+  {
+    coordinates.push_back( float( i % 3 ) );
+    coordinates.push_back( float( i / 3 ) );
+    coordinates.push_back( 0.0f );
+  }
+
+  std::vector<unsigned> triangles = {
+    0, 1, 4,
+    0, 4, 3,
+    1, 2, 4,
+    2, 5, 4,
+    4, 5, 8,
+    4, 8, 7,
+    3, 4, 6,
+    4, 7, 6
+  };
+
+  aleph::topology::IndexedMesh<float, float> M( coordinates, data, triangles );
+  aleph::topology::Mesh<float> N;
+
+  for( unsigned i = 0; i < 9; i++ )
+    N.addVertex( coordinates[3*i], coordinates[3*i+1], coordinates[3*i+2], data[i] );
+
+  for( unsigned f = 0; f < 8; f++ )
+    N.addFace( triangles.begin() + 3*f, triangles.begin() + 3*(f+1) );
+
+  ALEPH_ASSERT_EQUAL( M.numVertices(),  9 );
+  ALEPH_ASSERT_EQUAL( M.numFaces(),     8 );
+  ALEPH_ASSERT_EQUAL( M.numHalfEdges(), 24 );
+  ALEPH_ASSERT_EQUAL( M.numConnectedComponents(), 1 );
+
+  ALEPH_ASSERT_EQUAL( M.link(4).size(), 8 );
+  ALEPH_ASSERT_THROW( M.isBoundary(0) );
+  ALEPH_ASSERT_THROW( M.isBoundary(4) == false );
+
+  for( unsigned u = 0; u < 9; u++ )
+  {
+    ALEPH_ASSERT_EQUAL( M.link(u).size(),               N.link(u).size() );
+    ALEPH_ASSERT_EQUAL( M.getLowerNeighbours(u).size(),  N.getLowerNeighbours(u).size() );
+    ALEPH_ASSERT_EQUAL( M.getHigherNeighbours(u).size(), N.getHigherNeighbours(u).size() );
+
+    for( unsigned v = 0; v < 9; v++ )
+      ALEPH_ASSERT_EQUAL( M.hasEdge(u,v), N.hasEdge(u,v) );
+  }
+
+  {
+    auto faces = M.faces();
+
+    ALEPH_ASSERT_EQUAL( faces.size(), 8 );
+    ALEPH_ASSERT_THROW( faces.back() == std::vector<unsigned>( { 4, 7, 6 } ) );
+  }
+
+  {
+    using CriticalPointType = aleph::topology::CriticalPointType;
+
+    auto c1 = aleph::topology::MorseSmaleComplex<decltype(M)>::classify( M );
+    auto c2 = aleph::topology::MorseSmaleComplex<decltype(N)>::classify( N );
+
+    ALEPH_ASSERT_THROW( c1.types          == c2.types );
+    ALEPH_ASSERT_THROW( c1.multiplicities == c2.multiplicities );
+
+    ALEPH_ASSERT_THROW( c1.types[0] == CriticalPointType::Minimum );
+    ALEPH_ASSERT_THROW( c1.types[1] == CriticalPointType::Saddle  );
+    ALEPH_ASSERT_THROW( c1.types[4] == CriticalPointType::Maximum );
+    ALEPH_ASSERT_THROW( c1.types[7] == CriticalPointType::Saddle  );
+    ALEPH_ASSERT_EQUAL( c1.multiplicities[1], 1 );
+    ALEPH_ASSERT_EQUAL( c1.multiplicities[4], 0 );
+  }
+
+  {
+    aleph::topology::MorseSmaleComplex<decltype(M)> msc;
+
+    auto segmentation = msc.segment( M );
+
+    std::vector<unsigned> ascending  = { 0, 0, 2, 0, 0, 2, 6, 6, 8 };
+    std::vector<unsigned> descending = std::vector<unsigned>( 9, 4 );
+
+    ALEPH_ASSERT_THROW( segmentation.ascending  == ascending  );
+    ALEPH_ASSERT_THROW( segmentation.descending == descending );
+
+    // All minima have persistence one, so a smaller threshold must not
+    // change anything, while a larger one merges all manifolds.
+    aleph::topology::MorseSmaleComplex<decltype(M)> weak( 0.5f );
+    aleph::topology::MorseSmaleComplex<decltype(M)> strong( 2.0f );
+
+    ALEPH_ASSERT_THROW( weak.segment( M ).ascending   == ascending );
+    ALEPH_ASSERT_THROW( strong.segment( M ).ascending == std::vector<unsigned>( 9, 0 ) );
+    ALEPH_ASSERT_THROW( strong.segment( M ).descending == descending );
+  }
+
+  {
+    // Two faces with the same orientation of their shared edge cannot
+    // be part of an oriented manifold.
+    using Mesh = aleph::topology::IndexedMesh<float, float>;
+
+    std::vector<unsigned> invalid = { 0, 1, 2, 0, 1, 3 };
+
+    ALEPH_EXPECT_EXCEPTION( Mesh( {}, std::vector<float>( 4 ), invalid ), std::runtime_error );
+  }
+
+  ALEPH_TEST_END();
+}
+
 int main(int, char**)
 {
   test1();
   test2();
   test3();
+  testIndexedMesh();
 }
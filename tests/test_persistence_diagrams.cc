@@ -11,6 +11,8 @@
 #include <aleph/persistenceDiagrams/distances/NearestNeighbour.hh>
 #include <aleph/persistenceDiagrams/distances/Wasserstein.hh>
 
+#include <aleph/persistenceDiagrams/distances/detail/Auction.hh>
+
 #include <algorithm>
 #include <limits>
 #include <random>
@@ -109,6 +111,193 @@ template <class T> void testFrechetMean()
   ALEPH_TEST_END();
 }
 
+template <class T> void testAuction()
+{
+  using PersistenceDiagram = aleph::PersistenceDiagram<T>;
+  using Point              = typename PersistenceDiagram::Point;
+  using Auction            = aleph::distances::detail::Auction<Point, aleph::distances::InfinityDistance<T> >;
+
+  ALEPH_TEST_BEGIN( "Auction matching" );
+
+  for( unsigned n : { 0u, 1u, 10u, 40u } )
+  {
+    auto D1 = createRandomPersistenceDiagram<T>( n );
+    auto D2 = createRandomPersistenceDiagram<T>( n + 7 );
+
+    std::vector<Point> X( D1.begin(), D1.end() );
+    std::vector<Point> Y( D2.begin(), D2.end() );
+
+    auto optimal = aleph::detail::optimalPairing( D1, D2 ).cost;
+
+    Auction auction( 2.0, 0.01 );
+
+    auto cost = auction( X.data(), X.size(), Y.data(), Y.size() );
+
+    ALEPH_ASSERT_THROW( cost >= optimal - 1e-4 );
+    ALEPH_ASSERT_THROW( cost <= optimal * 1.01 + 1e-4 );
+
+    // Every point of the second diagram is used at most once
+    std::vector<bool> used( Y.size() );
+
+    for( std::size_t i = 0; i < X.size(); i++ )
+    {
+      auto j = auction.partner( i );
+
+      if( j != Auction::diagonal )
+      {
+        ALEPH_ASSERT_THROW( j < Y.size() );
+        ALEPH_ASSERT_THROW( !used[j] );
+
+        used[j] = true;
+      }
+    }
+
+    // Moving the points slightly permits reusing the matching, which
+    // has to satisfy the same guarantees.
+    for( auto&& p : X )
+      p = Point( p.x() * T(0.99), p.y() * T(0.99) );
+
+    PersistenceDiagram D3;
+
+    for( auto&& p : X )
+      D3.add( p.x(), p.y() );
+
+    optimal = aleph::detail::optimalPairing( D3, D2 ).cost;
+    cost    = auction( X.data(), X.size(), Y.data(), Y.size(), true );
+
+    ALEPH_ASSERT_THROW( cost >= optimal - 1e-4 );
+    ALEPH_ASSERT_THROW( cost <= optimal * 1.01 + 1e-4 );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testAuctionDegenerate()
+{
+  using PersistenceDiagram = aleph::PersistenceDiagram<T>;
+  using Point              = typename PersistenceDiagram::Point;
+  using Auction            = aleph::distances::detail::Auction<Point, aleph::distances::InfinityDistance<T> >;
+
+  ALEPH_TEST_BEGIN( "Auction matching: repeated points and coordinates" );
+
+  // Repeated points and shared coordinates result in empty bounding boxes
+  // and in ties when splitting the nodes of the kd-tree.
+  auto D = createRandomPersistenceDiagram<T>( 10 );
+
+  PersistenceDiagram D1;
+  PersistenceDiagram D2;
+
+  for( auto&& p : D )
+  {
+    for( unsigned k = 0; k < 3; k++ )
+      D1.add( p.x(), p.y() );
+
+    D2.add( T(0.25), p.y() );
+    D2.add( p.x(), p.x() + T(0.5) );
+  }
+
+  std::vector<Point> X( D1.begin(), D1.end() );
+  std::vector<Point> Y( D2.begin(), D2.end() );
+
+  auto optimal = aleph::detail::optimalPairing( D1, D2 ).cost;
+
+  Auction auction( 2.0, 0.01 );
+
+  auto cost = auction( X.data(), X.size(), Y.data(), Y.size() );
+
+  ALEPH_ASSERT_THROW( cost >= optimal - 1e-4 );
+  ALEPH_ASSERT_THROW( cost <= optimal * 1.01 + 1e-4 );
+
+  // Matching a diagram to itself is free
+  ALEPH_ASSERT_THROW( auction( X.data(), X.size(), X.data(), X.size() ) < 1e-6 );
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testFrechetMeanAuction()
+{
+  using PersistenceDiagram = aleph::PersistenceDiagram<T>;
+
+  ALEPH_TEST_BEGIN( "Persistence diagram mean: auction" );
+
+  // The mean of identical diagrams is the diagram itself
+  {
+    auto D = createRandomPersistenceDiagram<T>( 20 );
+    D.removeDiagonal();
+
+    std::vector<PersistenceDiagram> diagrams( 5, D );
+
+    aleph::FrechetMean<T> mean( diagrams.begin(), diagrams.end() );
+
+    auto M = mean();
+
+    ALEPH_ASSERT_EQUAL( M.size(), D.size() );
+    ALEPH_ASSERT_THROW( mean.cost() < 1e-6 );
+    ALEPH_ASSERT_THROW( std::abs( aleph::totalPersistence( M ) - aleph::totalPersistence( D ) ) < 1e-4 );
+  }
+
+  {
+    unsigned n = 10;
+
+    std::vector<PersistenceDiagram> diagrams;
+
+    for( decltype(n) i = 0; i < n; i++ )
+      diagrams.emplace_back( createRandomPersistenceDiagram<T>( 25 ) );
+
+    aleph::FrechetMean<T> mean( diagrams.begin(), diagrams.end() );
+
+    auto D = mean( 1, 42 );
+    auto c = mean.cost();
+    auto P = aleph::totalPersistence( D );
+    auto p = std::sqrt(25.0) * std::sqrt(0.50);
+
+    ALEPH_ASSERT_THROW( D.size() > 0 );
+    ALEPH_ASSERT_THROW( std::abs( P - p ) < 2.0 );
+    ALEPH_ASSERT_THROW( mean.numIterations() >= 1 );
+
+    // The mean of the lowest cost is kept if the iteration stops early,
+    // and its cost is the one of the returned diagram.
+    ALEPH_ASSERT_EQUAL( mean.costs().size(), mean.numIterations() );
+    ALEPH_ASSERT_EQUAL( c, *std::min_element( mean.costs().begin(), mean.costs().end() ) );
+
+    {
+      double cost = 0.0;
+
+      for( auto&& diagram : diagrams )
+        cost += std::pow( double( aleph::distances::wassersteinDistance( D, diagram, T(2) ) ), 2.0 );
+
+      ALEPH_ASSERT_THROW( cost <= c + 1e-4 );
+      ALEPH_ASSERT_THROW( cost >= c / 1.01 - 1e-4 );
+    }
+
+    for( unsigned maxIterations : { 1u, 2u, 3u } )
+    {
+      mean.setMaxIterations( maxIterations );
+      mean( 1, 42 );
+
+      ALEPH_ASSERT_THROW( mean.numIterations() <= maxIterations );
+      ALEPH_ASSERT_EQUAL( mean.cost(), *std::min_element( mean.costs().begin(), mean.costs().end() ) );
+    }
+
+    mean.setMaxIterations( 100 );
+
+    // Additional restarts include the first one, so they can only find
+    // a mean of lower cost.
+    mean( 4, 42 );
+
+    ALEPH_ASSERT_THROW( mean.cost() <= c );
+  }
+
+  {
+    std::vector<PersistenceDiagram> diagrams( 2 );
+
+    diagrams[0].add( T(0) );
+    ALEPH_EXPECT_EXCEPTION( aleph::FrechetMean<T>( diagrams.begin(), diagrams.end() ), std::runtime_error );
+  }
+
+  ALEPH_TEST_END();
+}
+
 template <class T> void testHausdorffDistance()
 {
   using PersistenceDiagram = aleph::PersistenceDiagram<T>;
@@ -232,6 +421,85 @@ template <class T> void testMultiScaleKernel()
   ALEPH_TEST_END();
 }
 
+template <class T> void testMultiScaleKernelMatrix()
+{
+  ALEPH_TEST_BEGIN( "Multi-scale kernel matrix" );
+
+  for( double x = -800.0; x <= 0.0; x += 0.01 )
+  {
+    auto y = std::exp( x );
+    auto z = aleph::detail::negativeExp( x );
+
+    ALEPH_ASSERT_THROW( std::abs( y - z ) <= 1e-13 * y + std::numeric_limits<double>::min() );
+  }
+
+  ALEPH_ASSERT_EQUAL( aleph::detail::negativeExp( -1e20 ), 0.0 );
+
+  std::vector< aleph::PersistenceDiagram<T> > diagrams;
+
+  for( unsigned i = 0; i < 12; i++ )
+  {
+    auto D = createRandomPersistenceDiagram<T>( 30 + i );
+
+    // Spreading the points permits the kernel to skip pairs of points
+    if( i % 2 == 1 )
+    {
+      aleph::PersistenceDiagram<T> E;
+
+      for( auto&& p : D )
+        E.add( T(50) * p.x(), T(50) * p.y() );
+
+      D = E;
+    }
+
+    diagrams.push_back( D );
+  }
+
+  // Points below and on the diagonal
+  diagrams[2].add( T(0.7), T(0.2) );
+  diagrams[3].add( T(0.5), T(0.5) );
+  diagrams.push_back( aleph::PersistenceDiagram<T>() );
+
+  auto n = diagrams.size();
+
+  // The reference implementation calculates distances with the data type
+  // of the diagrams, whereas the matrix always uses double precision.
+  auto epsilon = 1e-9 + 1e3 * double( std::numeric_limits<T>::epsilon() );
+
+  for( double tolerance : { 0.0, 1e-16 } )
+  {
+    aleph::MultiScaleKernelMatrix matrix( diagrams.begin(), diagrams.end(), 2.0, tolerance );
+
+    ALEPH_ASSERT_EQUAL( matrix.size(), n );
+
+    auto K = matrix.kernel();
+    auto D = matrix.pseudoMetric();
+
+    for( std::size_t i = 0; i < n; i++ )
+    {
+      ALEPH_ASSERT_EQUAL( D( i, i ), 0.0 );
+
+      for( std::size_t j = i; j < n; j++ )
+      {
+        auto k = aleph::multiScaleKernel( diagrams[i], diagrams[j], 2.0 );
+
+        ALEPH_ASSERT_THROW( std::abs( K( i, j ) - k ) <= epsilon * std::max( 1.0, std::abs( k ) ) );
+        ALEPH_ASSERT_EQUAL( K( i, j ), K( j, i ) );
+
+        if( i != j )
+        {
+          auto d = aleph::multiScalePseudoMetric( diagrams[i], diagrams[j], 2.0 );
+          auto s = std::abs( K( i, i ) ) + std::abs( K( j, j ) ) + 2 * std::abs( K( i, j ) );
+
+          ALEPH_ASSERT_THROW( std::abs( D( i, j ) * D( i, j ) - d * d ) <= 2 * epsilon * std::max( 1.0, s ) );
+        }
+      }
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
 template <class T> void testNearestNeighbourDistance()
 {
   ALEPH_TEST_BEGIN( "Nearest neighbour distance" );
@@ -295,15 +563,27 @@ int main(int, char**)
   testBottleneckDistance<float> ();
   testBottleneckDistance<double>();
 
+  testAuction<float> ();
+  testAuction<double>();
+
+  testAuctionDegenerate<float> ();
+  testAuctionDegenerate<double>();
+
   testFrechetMean<float> ();
   testFrechetMean<double>();
 
+  testFrechetMeanAuction<float> ();
+  testFrechetMeanAuction<double>();
+
   testHausdorffDistance<float> ();
   testHausdorffDistance<double>();
 
   testMultiScaleKernel<float> ();
   testMultiScaleKernel<double>();
 
+  testMultiScaleKernelMatrix<float> ();
+  testMultiScaleKernelMatrix<double>();
+
   testNearestNeighbourDistance<float> ();
   testNearestNeighbourDistance<double>();
 
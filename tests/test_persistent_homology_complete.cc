@@ -17,6 +17,8 @@
 #include <aleph/topology/Simplex.hh>
 #include <aleph/topology/SimplicialComplex.hh>
 
+#include <aleph/topology/filtrations/Data.hh>
+
 #include <aleph/topology/representations/List.hh>
 #include <aleph/topology/representations/Set.hh>
 #include <aleph/topology/representations/Vector.hh>
@@ -124,8 +126,72 @@ template <class T> void test()
   ALEPH_TEST_END();
 }
 
+template <class T> void testDimension()
+{
+  ALEPH_TEST_BEGIN( "Persistence diagram of a single dimension" );
+
+  using PointCloud = PointCloud<T>;
+  using Distance   = aleph::distances::Euclidean<T>;
+
+  PointCloud pointCloud = load<T>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" ) );
+
+  using Wrapper      = BruteForce<PointCloud, Distance>;
+  using RipsSkeleton = RipsSkeleton<Wrapper>;
+
+  Wrapper wrapper( pointCloud );
+  RipsSkeleton ripsSkeleton;
+
+  auto skeleton = ripsSkeleton( wrapper, T(0.5) );
+
+  RipsExpander<decltype(skeleton)> ripsExpander;
+
+  auto K = ripsExpander( skeleton, 2 );
+  K      = ripsExpander.assignMaximumWeight( K );
+
+  using Simplex = typename decltype(K)::ValueType;
+  using Index   = typename Simplex::VertexType;
+
+  K.sort( filtrations::Data<Simplex>() );
+
+  auto diagrams = calculatePersistenceDiagrams( K );
+
+  ALEPH_ASSERT_EQUAL( diagrams.size(), 2 );
+
+  for( std::size_t d = 0; d <= 3; d++ )
+  {
+    auto D1 = calculatePersistenceDiagram( K, d );
+    auto D2 = calculatePersistenceDiagram<Standard, representations::Set<Index> >( K, d );
+
+    ALEPH_ASSERT_EQUAL( D1.dimension(), d );
+    ALEPH_ASSERT_THROW( D1 == D2 );
+
+    if( d < diagrams.size() )
+    {
+      ALEPH_ASSERT_THROW( D1 == diagrams.at(d) );
+    }
+    else
+    {
+      ALEPH_ASSERT_THROW( D1.empty() );
+    }
+  }
+
+  // Unpaired creators of the largest dimension are only included on
+  // request, just like for the complete calculation
+  auto D = calculatePersistenceDiagram( K, 2, true );
+  diagrams = calculatePersistenceDiagrams( K, true, true );
+
+  ALEPH_ASSERT_EQUAL( diagrams.size(), 3 );
+  ALEPH_ASSERT_THROW( D.empty() == false );
+  ALEPH_ASSERT_THROW( D == diagrams.at(2) );
+
+  ALEPH_TEST_END();
+}
+
 int main()
 {
   test<float> ();
   test<double>();
+
+  testDimension<float> ();
+  testDimension<double>();
 }
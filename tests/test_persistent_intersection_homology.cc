@@ -21,8 +21,14 @@
 
 #include <aleph/topology/filtrations/Data.hh>
 
+#include <aleph/topology/Intersections.hh>
+
+#include <algorithm>
+#include <map>
 #include <random>
+#include <set>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <cmath>
@@ -475,6 +481,180 @@ template <class T> void testWedgeOfTwoCircles()
   ALEPH_TEST_END();
 }
 
+/**
+  Calculates persistent intersection homology by intersecting every
+  simplex with every stratum and partitioning a copy of the complex.
+  This serves as a reference for the indexed calculation.
+*/
+
+template <class Simplex> std::vector< aleph::PersistenceDiagram<typename Simplex::DataType> > referenceIntersectionHomology( const aleph::topology::SimplicialComplex<Simplex>& K,
+                                                                                                                           const std::vector< aleph::topology::SimplicialComplex<Simplex> >& X,
+                                                                                                                           const aleph::Perversity& p )
+{
+  auto d = K.dimension();
+
+  std::map<Simplex, bool> phi;
+
+  for( auto&& s : K )
+  {
+    bool admissible = true;
+
+    for( std::size_t k = 1; k <= d; k++ )
+    {
+      auto i            = s.dimension();
+      auto intersection = aleph::topology::lastLexicographicalIntersection( X.at( d - k ), s );
+      auto dimension    = intersection.empty() ? -1 : static_cast<long>( intersection.dimension() );
+      admissible        = admissible && intersection.empty() ? true : static_cast<long>( dimension ) <= ( long(i) - long(k) + long( p(k) ) );
+    }
+
+    phi[s] = admissible;
+  }
+
+  aleph::topology::SimplicialComplex<Simplex> L;
+  std::size_t s = 0;
+
+  std::tie( L, s ) =
+    aleph::partition( K, [&phi] ( const Simplex& s )
+                         {
+                           return phi.at(s);
+                         } );
+
+  auto boundaryMatrix = aleph::topology::makeBoundaryMatrix( L, s );
+  using IndexType     = typename decltype(boundaryMatrix)::Index;
+  auto pairing        = aleph::calculatePersistencePairing( boundaryMatrix, true, static_cast<IndexType>(s) );
+
+  return aleph::makePersistenceDiagrams( pairing, L );
+}
+
+template <class T> std::vector< std::vector< std::pair<T, T> > > points( const std::vector< aleph::PersistenceDiagram<T> >& diagrams )
+{
+  std::vector< std::vector< std::pair<T, T> > > result;
+
+  for( auto&& D : diagrams )
+  {
+    if( D.dimension() >= result.size() )
+      result.resize( D.dimension() + 1 );
+
+    for( auto&& p : D )
+      result[ D.dimension() ].push_back( std::make_pair( p.x(), p.y() ) );
+
+    std::sort( result[ D.dimension() ].begin(), result[ D.dimension() ].end() );
+  }
+
+  return result;
+}
+
+template <class T> void testIndexed()
+{
+  ALEPH_TEST_BEGIN( "Persistent intersection homology: indexed calculation" );
+
+  using Simplex           = aleph::topology::Simplex<T>;
+  using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+  using VertexType        = typename Simplex::VertexType;
+
+  std::mt19937 rng( 23 );
+
+  std::vector<aleph::Perversity> perversities = {
+    aleph::Perversity( {-1, -1} ),
+    aleph::Perversity( {-1,  0} ),
+    aleph::Perversity( {-1,  1} ),
+    aleph::Perversity( { 0,  0} ),
+    aleph::Perversity( { 0,  1} )
+  };
+
+  for( unsigned round = 0; round < 20; round++ )
+  {
+    std::uniform_int_distribution<VertexType> vertexDistribution( 0, 11 );
+    std::uniform_real_distribution<T> valueDistribution( T(0), T(1) );
+    std::bernoulli_distribution coin( 0.3 );
+
+    std::vector<T> values( 12 );
+
+    for( auto&& value : values )
+      value = valueDistribution( rng );
+
+    // Closure of random triangles; the data of a simplex is the maximum
+    // of its vertex values.
+    std::set< std::vector<VertexType> > closure;
+
+    for( unsigned i = 0; i < 15; i++ )
+    {
+      std::set<VertexType> triangle;
+
+      while( triangle.size() < 3 )
+        triangle.insert( vertexDistribution( rng ) );
+
+      std::vector<VertexType> vertices( triangle.begin(), triangle.end() );
+
+      for( unsigned mask = 1; mask < 8; mask++ )
+      {
+        std::vector<VertexType> face;
+
+        for( unsigned j = 0; j < 3; j++ )
+        {
+          if( mask & ( 1u << j ) )
+            face.push_back( vertices[j] );
+        }
+
+        closure.insert( face );
+      }
+    }
+
+    std::vector<Simplex> simplices;
+    std::vector<Simplex> stratum0;
+    std::vector<Simplex> stratum1;
+
+    for( auto&& vertices : closure )
+    {
+      T value = T(0);
+
+      for( auto&& v : vertices )
+        value = std::max( value, values[v] );
+
+      Simplex simplex( vertices.begin(), vertices.end(), value );
+      simplices.push_back( simplex );
+
+      // The strata are not induced by their vertices, so a triangle may
+      // have all of its vertices in a stratum without any of its edges.
+      if( simplex.dimension() == 0 && coin( rng ) )
+        stratum0.push_back( simplex );
+
+      if( simplex.dimension() <= 1 && coin( rng ) )
+      {
+        stratum1.push_back( simplex );
+
+        for( auto it = simplex.begin_boundary(); it != simplex.end_boundary(); ++it )
+          stratum1.push_back( *it );
+      }
+    }
+
+    SimplicialComplex K( simplices.begin(), simplices.end() );
+    K.sort( aleph::topology::filtrations::Data<Simplex>() );
+
+    std::vector<SimplicialComplex> X = {
+      SimplicialComplex( stratum0.begin(), stratum0.end() ),
+      SimplicialComplex( stratum1.begin(), stratum1.end() ),
+      K
+    };
+
+    aleph::PersistentIntersectionHomology<Simplex> intersectionHomology( K, X );
+
+    auto diagrams = intersectionHomology( perversities );
+
+    ALEPH_ASSERT_EQUAL( diagrams.size(), perversities.size() );
+
+    for( std::size_t i = 0; i < perversities.size(); i++ )
+    {
+      auto expected = referenceIntersectionHomology( K, X, perversities[i] );
+
+      ALEPH_ASSERT_THROW( points( diagrams[i] ) == points( expected ) );
+      ALEPH_ASSERT_THROW( points( intersectionHomology( perversities[i] ) ) == points( expected ) );
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
 int main(int, char**)
 {
   test<float> ();
@@ -494,4 +674,7 @@ int main(int, char**)
 
   testWedgeOfTwoCircles<float> ();
   testWedgeOfTwoCircles<double>();
+
+  testIndexed<float> ();
+  testIndexed<double>();
 }
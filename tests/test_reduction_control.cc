@@ -0,0 +1,339 @@
+#include <aleph/config/Base.hh>
+
+#include <aleph/containers/PointCloud.hh>
+
+#include <aleph/geometry/BruteForce.hh>
+#include <aleph/geometry/RipsExpander.hh>
+#include <aleph/geometry/RipsSkeleton.hh>
+
+#include <aleph/geometry/distances/Euclidean.hh>
+
+#include <tests/Base.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/ReductionControl.hh>
+
+#include <aleph/persistentHomology/algorithms/Standard.hh>
+#include <aleph/persistentHomology/algorithms/Twist.hh>
+
+#include <aleph/topology/Conversions.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/Data.hh>
+
+#include <aleph/topology/representations/Vector.hh>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace aleph::persistentHomology::algorithms;
+using namespace aleph::persistentHomology;
+
+using namespace aleph::containers;
+using namespace aleph::geometry;
+using namespace aleph;
+
+using Simplex           = aleph::topology::Simplex<double, unsigned>;
+using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+using Representation    = aleph::topology::representations::Vector<unsigned>;
+using Matrix            = aleph::topology::BoundaryMatrix<Representation>;
+using Pairs             = std::vector< std::pair<unsigned, unsigned> >;
+
+SimplicialComplex makeTriangle()
+{
+  std::vector<Simplex> simplices
+    = { {0}, {1}, {2}, {0,1}, {0,2}, {1,2}, {0,1,2} };
+
+  return SimplicialComplex( simplices.begin(), simplices.end() );
+}
+
+SimplicialComplex makeRipsComplex()
+{
+  using PointCloud = PointCloud<double>;
+  using Distance   = aleph::distances::Euclidean<double>;
+  using Wrapper    = BruteForce<PointCloud, Distance>;
+
+  PointCloud pointCloud = load<double>( CMAKE_SOURCE_DIR + std::string( "/tests/input/Iris_colon_separated.txt" ) );
+
+  Wrapper wrapper( pointCloud );
+  RipsSkeleton<Wrapper> ripsSkeleton;
+
+  auto skeleton = ripsSkeleton( wrapper, 0.5 );
+
+  RipsExpander<decltype(skeleton)> ripsExpander;
+
+  auto L = ripsExpander( skeleton, 2 );
+  L      = ripsExpander.assignMaximumWeight( L );
+
+  L.sort( aleph::topology::filtrations::Data<typename decltype(L)::ValueType>() );
+
+  // Convert to the simplex type of the test in order to simplify the
+  // declarations below.
+  std::vector<Simplex> simplices;
+
+  for( auto&& s : L )
+    simplices.push_back( Simplex( s.begin(), s.end(), s.data() ) );
+
+  return SimplicialComplex( simplices.begin(), simplices.end() );
+}
+
+std::vector<double> getValues( const SimplicialComplex& K )
+{
+  std::vector<double> values;
+
+  for( auto&& s : K )
+    values.push_back( s.data() );
+
+  return values;
+}
+
+template <class Algorithm> Pairs getPairs( const Matrix& M )
+{
+  auto pairing = calculatePersistencePairing<Algorithm>( M );
+  return Pairs( pairing.begin(), pairing.end() );
+}
+
+template <class Algorithm> Pairs getPairs( const Matrix& M, ReductionControl& control )
+{
+  auto pairing = calculatePersistencePairing<Algorithm>( M, control );
+  return Pairs( pairing.begin(), pairing.end() );
+}
+
+bool isEssential( const std::pair<unsigned, unsigned>& pair )
+{
+  return pair.second == std::numeric_limits<unsigned>::max();
+}
+
+void testStatistics()
+{
+  ALEPH_TEST_BEGIN( "Reduction control: statistics" );
+
+  auto K = makeTriangle();
+  auto M = aleph::topology::makeBoundaryMatrix<Representation>( K );
+
+  ReductionControl control;
+
+  Standard algorithm;
+  algorithm( M, control );
+
+  auto&& statistics = control.statistics();
+
+  ALEPH_ASSERT_EQUAL( statistics.size(), 3 );
+
+  // The edge {1,2} is reduced by adding {0,2} and {0,1}, which leaves an
+  // empty column.
+  ALEPH_ASSERT_EQUAL( statistics[1].columns,         3 );
+  ALEPH_ASSERT_EQUAL( statistics[1].columnAdditions, 2 );
+  ALEPH_ASSERT_EQUAL( statistics[1].pairs,           2 );
+  ALEPH_ASSERT_EQUAL( statistics[1].entriesBefore,   6 );
+  ALEPH_ASSERT_EQUAL( statistics[1].entriesAfter,    4 );
+  ALEPH_ASSERT_EQUAL( statistics[1].longestColumn,   2 );
+  ALEPH_ASSERT_EQUAL( statistics[1].fillIn(),       -2 );
+
+  ALEPH_ASSERT_EQUAL( statistics[2].columns,         1 );
+  ALEPH_ASSERT_EQUAL( statistics[2].columnAdditions, 0 );
+  ALEPH_ASSERT_EQUAL( statistics[2].pairs,           1 );
+  ALEPH_ASSERT_EQUAL( statistics[2].entriesAfter,    3 );
+
+  auto total = control.total();
+
+  ALEPH_ASSERT_EQUAL( total.columns,         7 );
+  ALEPH_ASSERT_EQUAL( total.skippedColumns,  0 );
+  ALEPH_ASSERT_EQUAL( total.columnAdditions, 2 );
+  ALEPH_ASSERT_EQUAL( total.pairs,           3 );
+  ALEPH_ASSERT_THROW( total.seconds >= 0.0 );
+  ALEPH_ASSERT_THROW( !control.exhausted() );
+
+  // Without any limits, the control object must not change the pairing
+  auto L = makeRipsComplex();
+  auto N = aleph::topology::makeBoundaryMatrix<Representation>( L );
+
+  for( auto&& B : { N, Matrix( N.dualize() ) } )
+  {
+    ReductionControl c1;
+    ReductionControl c2;
+
+    ALEPH_ASSERT_THROW( getPairs<Standard>( B, c1 ) == getPairs<Standard>( B ) );
+    ALEPH_ASSERT_THROW( getPairs<Twist>( B, c2 )    == getPairs<Twist>( B ) );
+
+    ALEPH_ASSERT_THROW( c1.total().pairs > 0 );
+    ALEPH_ASSERT_THROW( c2.total().pairs > 0 );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testMaximumDimension()
+{
+  ALEPH_TEST_BEGIN( "Reduction control: maximum dimension" );
+
+  auto K = makeRipsComplex();
+  auto M = aleph::topology::makeBoundaryMatrix<Representation>( K );
+
+  for( auto&& B : { M, Matrix( M.dualize() ) } )
+  {
+    auto expected = getPairs<Standard>( B );
+
+    expected.erase( std::remove_if( expected.begin(), expected.end(),
+                                    [&K] ( const std::pair<unsigned, unsigned>& pair )
+                                    {
+                                      return K.at( pair.first ).dimension() > 0;
+                                    } ),
+                    expected.end() );
+
+    ReductionControl c1;
+    ReductionControl c2;
+
+    c1.setMaximumDimension( 0 );
+    c2.setMaximumDimension( 0 );
+
+    ALEPH_ASSERT_THROW( getPairs<Standard>( B, c1 ) == expected );
+    ALEPH_ASSERT_THROW( getPairs<Twist>( B, c2 )    == expected );
+
+    // Triangles are never required for the zero-dimensional homology
+    auto&& statistics = c1.statistics();
+    auto d            = B.isDualized() ? 0 : 2;
+
+    ALEPH_ASSERT_EQUAL( statistics.at( std::size_t(d) ).columns, 0 );
+    ALEPH_ASSERT_THROW( statistics.at( std::size_t(d) ).skippedColumns > 0 );
+    ALEPH_ASSERT_THROW( !c1.exhausted() );
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testBudget()
+{
+  ALEPH_TEST_BEGIN( "Reduction control: budget" );
+
+  auto K = makeRipsComplex();
+  auto M = aleph::topology::makeBoundaryMatrix<Representation>( K );
+
+  {
+    ReductionControl control;
+    control.setOperationLimit( 0 );
+
+    auto pairs = getPairs<Standard>( M, control );
+
+    ALEPH_ASSERT_THROW( control.exhausted() );
+    ALEPH_ASSERT_THROW( pairs.empty() );
+    ALEPH_ASSERT_EQUAL( control.total().columns,         0 );
+    ALEPH_ASSERT_EQUAL( control.total().skippedColumns,  K.size() );
+  }
+
+  {
+    ReductionControl control;
+    control.setTimeLimit( 0.0 );
+
+    auto pairs = getPairs<Twist>( M, control );
+
+    // Vertices do not need to be reduced, so they remain unpaired
+    ALEPH_ASSERT_THROW( control.exhausted() );
+    ALEPH_ASSERT_THROW( std::all_of( pairs.begin(), pairs.end(), isEssential ) );
+    ALEPH_ASSERT_EQUAL( control.total().columnAdditions, 0 );
+  }
+
+  // The standard algorithm processes columns in filtration order, so an
+  // exhausted budget yields the pairs of a prefix of the filtration.
+  {
+    ReductionControl control;
+    control.setOperationLimit( 100 );
+
+    auto pairs    = getPairs<Standard>( M, control );
+    auto expected = getPairs<Standard>( M );
+
+    ALEPH_ASSERT_THROW( control.exhausted() );
+    ALEPH_ASSERT_THROW( control.total().columnAdditions >= 100 );
+    ALEPH_ASSERT_THROW( control.total().skippedColumns  >    0 );
+
+    for( auto&& pair : pairs )
+    {
+      if( !isEssential( pair ) )
+        ALEPH_ASSERT_THROW( std::find( expected.begin(), expected.end(), pair ) != expected.end() );
+    }
+  }
+
+  ALEPH_EXPECT_EXCEPTION( ReductionControl().setTimeLimit( -1.0 ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+void testPersistenceThreshold()
+{
+  ALEPH_TEST_BEGIN( "Reduction control: persistence threshold" );
+
+  auto K      = makeRipsComplex();
+  auto M      = aleph::topology::makeBoundaryMatrix<Representation>( K );
+  auto values = getValues( K );
+
+  for( double threshold : { 0.0, 0.1, 0.2, 0.3 } )
+  {
+    for( auto&& B : { M, Matrix( M.dualize() ) } )
+    {
+      auto expected = getPairs<Standard>( B );
+
+      ReductionControl c1;
+      ReductionControl c2;
+
+      c1.setPersistenceThreshold( threshold, values );
+      c2.setPersistenceThreshold( threshold, values );
+
+      auto pairs1 = getPairs<Standard>( B, c1 );
+      auto pairs2 = getPairs<Twist>( B, c2 );
+
+      for( auto&& pairs : { pairs1, pairs2 } )
+      {
+        // Every pair above the threshold has to be reported correctly,
+        // whereas essential classes may be omitted
+        for( auto&& pair : expected )
+        {
+          if( !isEssential( pair ) && values.at( pair.second ) - values.at( pair.first ) > threshold )
+            ALEPH_ASSERT_THROW( std::find( pairs.begin(), pairs.end(), pair ) != pairs.end() );
+        }
+
+        for( auto&& pair : pairs )
+        {
+          if( !isEssential( pair ) )
+            ALEPH_ASSERT_THROW( values.at( pair.second ) - values.at( pair.first ) > threshold );
+
+          ALEPH_ASSERT_THROW( std::find( expected.begin(), expected.end(), pair ) != expected.end() );
+        }
+      }
+
+      // Without any remaining deferred columns, all essential classes
+      // are known
+      auto numEssential = std::count_if( expected.begin(), expected.end(), isEssential );
+
+      if( c1.total().deferredColumns == 0 )
+        ALEPH_ASSERT_EQUAL( std::count_if( pairs1.begin(), pairs1.end(), isEssential ), numEssential );
+
+      if( c2.total().deferredColumns == 0 )
+        ALEPH_ASSERT_EQUAL( std::count_if( pairs2.begin(), pairs2.end(), isEssential ), numEssential );
+
+      ALEPH_ASSERT_THROW( c1.total().columnAdditions + c2.total().columnAdditions > 0 );
+    }
+  }
+
+  ALEPH_EXPECT_EXCEPTION( ReductionControl().setPersistenceThreshold( -1.0, values ), std::runtime_error );
+
+  {
+    ReductionControl control;
+    control.setPersistenceThreshold( 0.1, std::vector<double>( 3 ) );
+
+    ALEPH_EXPECT_EXCEPTION( getPairs<Standard>( M, control ), std::runtime_error );
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testStatistics();
+  testMaximumDimension();
+  testBudget();
+  testPersistenceThreshold();
+}
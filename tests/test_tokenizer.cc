@@ -0,0 +1,171 @@
+#include <tests/Base.hh>
+
+#include <aleph/utilities/String.hh>
+#include <aleph/utilities/Tokenizer.hh>
+
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace aleph::utilities;
+
+void testTokenizer()
+{
+  ALEPH_TEST_BEGIN( "Tokenizer" );
+
+  std::string line = "  foo\tbar,baz  1.5 ";
+
+  {
+    Tokenizer tokenizer( line );
+    StringView token;
+
+    std::vector<std::string> tokens;
+    while( tokenizer.next( token ) )
+      tokens.push_back( token.str() );
+
+    ALEPH_ASSERT_EQUAL( tokens.size(), 3 );
+    ALEPH_ASSERT_THROW( tokens[0] == "foo" );
+    ALEPH_ASSERT_THROW( tokens[1] == "bar,baz" );
+    ALEPH_ASSERT_THROW( tokens[2] == "1.5" );
+  }
+
+  {
+    Tokenizer tokenizer( line, ", \t" );
+    StringView token;
+
+    std::vector<std::string> tokens;
+    while( tokenizer.next( token ) )
+      tokens.push_back( token.str() );
+
+    ALEPH_ASSERT_EQUAL( tokens.size(), 4 );
+    ALEPH_ASSERT_THROW( tokens[1] == "bar" );
+    ALEPH_ASSERT_THROW( tokens[2] == "baz" );
+  }
+
+  {
+    std::string empty = " \t ";
+
+    Tokenizer tokenizer( empty );
+    StringView token;
+
+    ALEPH_ASSERT_THROW( tokenizer.next( token ) == false );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> bool same( T a, T b )
+{
+  if( std::isnan( a ) && std::isnan( b ) )
+    return true;
+
+  return a == b;
+}
+
+template <class T> void testFloatingPoint()
+{
+  ALEPH_TEST_BEGIN( "Floating point conversion" );
+
+  std::vector<std::string> tokens = {
+    "0", "-0", "1", "+1", "-1", "0.5", ".5", "5.", "1e3", "1E-3", "1e", "1e+",
+    "3.14159265358979323846264338327950288", "123456789012345678901234567890",
+    "0.000000000000000000000000000001", "1e308", "1e-320", "2.2250738585072014e-308",
+    "inf", "-inf", "+inf", "Infinity", "-INFINITY", "nan", "NaN",
+    "abc", "", "12abc", "0x10", "-", "+", ".", "1.5.5", "7e2x"
+  };
+
+  std::mt19937 rng( 23 );
+  std::uniform_real_distribution<double> mantissa( -1.0, 1.0 );
+  std::uniform_int_distribution<int> exponent( -40, 40 );
+  std::uniform_int_distribution<int> precision( 1, 20 );
+
+  for( unsigned i = 0; i < 10000; i++ )
+  {
+    std::ostringstream stream;
+
+    if( i % 2 == 0 )
+      stream << std::setprecision( precision( rng ) ) << mantissa( rng ) * std::pow( 10.0, exponent( rng ) );
+    else
+      stream << std::fixed << std::setprecision( precision( rng ) % 8 ) << mantissa( rng ) * 1000;
+
+    tokens.push_back( stream.str() );
+  }
+
+  for( auto&& token : tokens )
+  {
+    T expected = convert<T>( token );
+    T actual   = convert<T>( StringView( token ) );
+
+    ALEPH_ASSERT_THROW( same( expected, actual ) );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testIntegers()
+{
+  ALEPH_TEST_BEGIN( "Integer conversion" );
+
+  std::vector<std::string> tokens = {
+    "0", "1", "+1", "42", "-17", "12.5", "7e2", "abc", "", "12abc", "-", "+",
+    "99999999999999999999999", "-99999999999999999999999",
+    std::to_string( std::numeric_limits<T>::max() ),
+    std::to_string( std::numeric_limits<T>::min() )
+  };
+
+  for( auto&& token : tokens )
+  {
+    T expected = convert<T>( token );
+    T actual   = convert<T>( StringView( token ) );
+
+    ALEPH_ASSERT_EQUAL( expected, actual );
+  }
+
+  ALEPH_TEST_END();
+}
+
+template <class T> void testParse()
+{
+  ALEPH_TEST_BEGIN( "Strict parsing" );
+
+  std::vector<std::string> valid = { "0", "1", "+1", "-1", "0.5", ".5", "1e3", "inf", "-inf", "NaN" };
+
+  for( auto&& token : valid )
+  {
+    T value = T();
+
+    ALEPH_ASSERT_THROW( parse( StringView( token ), value ) );
+    ALEPH_ASSERT_THROW( same( value, convert<T>( StringView( token ) ) ) );
+  }
+
+  std::vector<std::string> invalid = { "", "abc", "12abc", "0x10", "-", "+", ".", "1.5.5", "7e2x", "1e", "1,5" };
+
+  for( auto&& token : invalid )
+  {
+    T value = T();
+    ALEPH_ASSERT_THROW( !parse( StringView( token ), value ) );
+  }
+
+  ALEPH_TEST_END();
+}
+
+int main( int, char** )
+{
+  testTokenizer();
+
+  testFloatingPoint<float> ();
+  testFloatingPoint<double>();
+
+  testIntegers<short>   ();
+  testIntegers<unsigned>();
+  testIntegers<int>     ();
+  testIntegers<long>    ();
+  testIntegers<unsigned long>();
+
+  testParse<float> ();
+  testParse<double>();
+}
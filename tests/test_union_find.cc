@@ -64,6 +64,35 @@ template <class T> void test()
   ALEPH_TEST_END();
 }
 
+template <class T> void testDense()
+{
+  ALEPH_TEST_BEGIN( "Dense Union--Find (" + std::string( typeid(T).name() ) + ")" );
+
+  DenseUnionFind<T> uf( 9 );
+
+  for( T vertex = 0; vertex < 9; vertex++ )
+    ALEPH_ASSERT_EQUAL( uf.find(vertex), vertex );
+
+  uf.merge(1,2);
+  uf.merge(5,6);
+  uf.merge(5,8);
+  uf.merge(3,4);
+  uf.merge(1,5);
+
+  ALEPH_ASSERT_EQUAL( uf.find(1), uf.find(2) );
+  ALEPH_ASSERT_EQUAL( uf.find(5), uf.find(8) );
+  ALEPH_ASSERT_EQUAL( uf.find(6), uf.find(1) );
+  ALEPH_ASSERT_EQUAL( uf.find(3), 4          );
+  ALEPH_ASSERT_EQUAL( uf.find(7), 7          );
+
+  std::vector<T> roots;
+  uf.roots( std::back_inserter( roots ) );
+
+  ALEPH_ASSERT_THROW( roots == std::vector<T>( {0,4,7,8} ) );
+
+  ALEPH_TEST_END();
+}
+
 int main(int, char**)
 {
   test<unsigned short>();
@@ -72,4 +101,9 @@ int main(int, char**)
   test<unsigned>      ();
   test<long>          ();
   test<unsigned long> ();
+
+  testDense<unsigned short>();
+  testDense<int>           ();
+  testDense<unsigned>      ();
+  testDense<unsigned long> ();
 }
@@ -0,0 +1,307 @@
+#include <tests/Base.hh>
+
+#include <aleph/geometry/RipsExpander.hh>
+
+#include <aleph/persistenceDiagrams/PersistenceDiagram.hh>
+
+#include <aleph/persistentHomology/Calculation.hh>
+#include <aleph/persistentHomology/Vineyard.hh>
+
+#include <aleph/topology/Conversions.hh>
+#include <aleph/topology/Simplex.hh>
+#include <aleph/topology/SimplicialComplex.hh>
+
+#include <aleph/topology/filtrations/LowerStar.hh>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using DataType          = double;
+using VertexType        = unsigned;
+using Simplex           = aleph::topology::Simplex<DataType, VertexType>;
+using SimplicialComplex = aleph::topology::SimplicialComplex<Simplex>;
+using Vineyard          = aleph::Vineyard<Simplex>;
+using Point             = std::pair<DataType, DataType>;
+using Points            = std::vector< std::vector<Point> >;
+
+/**
+  Converts persistence diagrams into sorted lists of points, which are
+  indexed by dimension. Points of zero persistence are removed because
+  they depend on the order of simplices with the same value.
+*/
+
+Points points( std::vector< aleph::PersistenceDiagram<DataType> > diagrams )
+{
+  Points result;
+
+  for( auto&& D : diagrams )
+  {
+    D.removeDiagonal();
+
+    if( D.dimension() >= result.size() )
+      result.resize( D.dimension() + 1 );
+
+    for( auto&& p : D )
+      result[ D.dimension() ].push_back( std::make_pair( p.x(), p.y() ) );
+
+    std::sort( result[ D.dimension() ].begin(), result[ D.dimension() ].end() );
+  }
+
+  while( !result.empty() && result.back().empty() )
+    result.pop_back();
+
+  return result;
+}
+
+/** Creates the flag complex of a random graph */
+SimplicialComplex makeRandomComplex( std::mt19937& rng, unsigned n, unsigned m )
+{
+  std::uniform_int_distribution<unsigned> distribution( 0, n - 1 );
+
+  std::vector<Simplex> simplices;
+
+  for( unsigned i = 0; i < n; i++ )
+    simplices.push_back( Simplex( i ) );
+
+  std::set< std::pair<unsigned, unsigned> > edges;
+
+  while( edges.size() < m )
+  {
+    auto u = distribution( rng );
+    auto v = distribution( rng );
+
+    if( u != v )
+      edges.insert( std::make_pair( std::min( u, v ), std::max( u, v ) ) );
+  }
+
+  for( auto&& edge : edges )
+    simplices.push_back( Simplex( {edge.first, edge.second} ) );
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+
+  aleph::geometry::RipsExpander<SimplicialComplex> ripsExpander;
+  return ripsExpander( K, 2 );
+}
+
+/** Calculates the lower-star filtration of a function from scratch */
+SimplicialComplex makeLowerStarFiltration( const SimplicialComplex& K, const std::vector<DataType>& values )
+{
+  aleph::topology::filtrations::LowerStar<Simplex> functor( values.begin(), values.end() );
+
+  std::vector<Simplex> simplices;
+
+  for( auto&& s : K )
+    simplices.push_back( Simplex( s.begin(), s.end(), functor.maximumValue( s ) ) );
+
+  SimplicialComplex L( simplices.begin(), simplices.end() );
+  L.sort( std::ref( functor ) );
+
+  return L;
+}
+
+void testSimple()
+{
+  ALEPH_TEST_BEGIN( "Vineyard: simple" );
+
+  std::vector<Simplex> simplices = {
+    Simplex( 0u ), Simplex( 1u ), Simplex( 2u ),
+    Simplex( {0,1} ), Simplex( {1,2} )
+  };
+
+  SimplicialComplex K( simplices.begin(), simplices.end() );
+
+  // Two minima that exchange their depth, so the essential class moves
+  // from the first to the last vertex.
+  std::vector<DataType> f = { 0, 5, 1 };
+  std::vector<DataType> g = { 2, 5, 0 };
+
+  Vineyard vineyard( K, f );
+
+  auto inf = std::numeric_limits<DataType>::infinity();
+
+  {
+    Points expected = { { {0, inf}, {1,5} } };
+    ALEPH_ASSERT_THROW( points( vineyard.diagrams() ) == expected );
+  }
+
+  auto vines = vineyard.update( g );
+
+  {
+    Points expected = { { {0, inf}, {2,5} } };
+    ALEPH_ASSERT_THROW( points( vineyard.diagrams() ) == expected );
+  }
+
+  // The maximum creates a pair of zero persistence
+  ALEPH_ASSERT_EQUAL( vines.size(), 3 );
+
+  // All vines move continuously, i.e. the essential class stays
+  // essential, even though it is created by another vertex.
+  for( auto&& vine : vines )
+  {
+    ALEPH_ASSERT_EQUAL( vine.dimension, 0 );
+
+    if( vine.from.x() == 5 )
+    {
+      ALEPH_ASSERT_EQUAL( vine.to.x(), 5 );
+      ALEPH_ASSERT_EQUAL( vine.to.y(), 5 );
+    }
+    else if( vine.from.y() == inf )
+    {
+      ALEPH_ASSERT_EQUAL( vine.from.x(), 0 );
+      ALEPH_ASSERT_EQUAL( vine.to.x(),   0 );
+      ALEPH_ASSERT_EQUAL( vine.to.y(),   inf );
+    }
+    else
+    {
+      ALEPH_ASSERT_EQUAL( vine.from.x(), 1 );
+      ALEPH_ASSERT_EQUAL( vine.from.y(), 5 );
+      ALEPH_ASSERT_EQUAL( vine.to.x(),   2 );
+      ALEPH_ASSERT_EQUAL( vine.to.y(),   5 );
+    }
+  }
+
+  ALEPH_ASSERT_THROW( vineyard.numSwitches() > 0 );
+
+  ALEPH_EXPECT_EXCEPTION( vineyard.update( { 0, 1 } ), std::runtime_error );
+  ALEPH_EXPECT_EXCEPTION( Vineyard( K, { 0, 1 } ), std::runtime_error );
+
+  ALEPH_TEST_END();
+}
+
+void testRandom()
+{
+  ALEPH_TEST_BEGIN( "Vineyard: random functions" );
+
+  std::mt19937 rng( 42 );
+
+  for( unsigned k = 0; k < 6; k++ )
+  {
+    unsigned n = 10 + 10 * k;
+
+    auto K = makeRandomComplex( rng, n, 3 * n );
+
+    // Few distinct values result in many ties
+    std::uniform_int_distribution<int> distribution( 0, k % 2 == 0 ? 5 : 1000 );
+
+    auto makeFunction = [&] ()
+    {
+      std::vector<DataType> values( n );
+
+      for( auto&& value : values )
+        value = DataType( distribution( rng ) );
+
+      return values;
+    };
+
+    auto values = makeFunction();
+
+    Vineyard vineyard( K, values );
+
+    for( unsigned step = 0; step < 10; step++ )
+    {
+      auto L        = makeLowerStarFiltration( K, values );
+      auto expected = aleph::calculatePersistenceDiagrams( L );
+
+      ALEPH_ASSERT_THROW( points( vineyard.diagrams() ) == points( expected ) );
+
+      // The pairing is unique for a given filtration, so it has to match
+      // the one of the reduced boundary matrix.
+      auto F = vineyard.filtration();
+
+      ALEPH_ASSERT_THROW( std::equal( F.begin(), F.end(), L.begin() ) );
+
+      auto pairing = aleph::calculatePersistencePairing( aleph::topology::makeBoundaryMatrix( L ) );
+
+      ALEPH_ASSERT_THROW( vineyard.pairing() == pairing );
+
+      // Every vine connects a point of the previous diagram with a point
+      // of the current diagram.
+      auto previous = vineyard.diagrams();
+
+      values     = makeFunction();
+      auto vines = vineyard.update( values );
+
+      std::vector< std::pair<std::size_t, Point> > from, to, expectedFrom, expectedTo;
+
+      for( auto&& vine : vines )
+      {
+        from.push_back( std::make_pair( vine.dimension, std::make_pair( vine.from.x(), vine.from.y() ) ) );
+        to.push_back( std::make_pair( vine.dimension, std::make_pair( vine.to.x(), vine.to.y() ) ) );
+      }
+
+      for( auto&& D : previous )
+        for( auto&& p : D )
+          expectedFrom.push_back( std::make_pair( D.dimension(), std::make_pair( p.x(), p.y() ) ) );
+
+      for( auto&& D : vineyard.diagrams() )
+        for( auto&& p : D )
+          expectedTo.push_back( std::make_pair( D.dimension(), std::make_pair( p.x(), p.y() ) ) );
+
+      std::sort( from.begin(), from.end() );
+      std::sort( to.begin(), to.end() );
+      std::sort( expectedFrom.begin(), expectedFrom.end() );
+      std::sort( expectedTo.begin(), expectedTo.end() );
+
+      ALEPH_ASSERT_THROW( from == expectedFrom );
+      ALEPH_ASSERT_THROW( to   == expectedTo );
+    }
+  }
+
+  ALEPH_TEST_END();
+}
+
+void testSmallSteps()
+{
+  ALEPH_TEST_BEGIN( "Vineyard: small steps" );
+
+  std::mt19937 rng( 23 );
+  std::normal_distribution<DataType> distribution;
+
+  unsigned n = 60;
+  auto K     = makeRandomComplex( rng, n, 4 * n );
+
+  std::vector<DataType> values( n );
+
+  for( auto&& value : values )
+    value = distribution( rng );
+
+  Vineyard vineyard( K, values );
+
+  auto inf = std::numeric_limits<DataType>::infinity();
+
+  for( unsigned step = 0; step < 50; step++ )
+  {
+    for( auto&& value : values )
+      value += 0.05 * distribution( rng );
+
+    auto vines = vineyard.update( values );
+
+    // Small steps only result in small movements of the vines, which is
+    // not the case for an arbitrary matching of the diagrams.
+    for( auto&& vine : vines )
+    {
+      ALEPH_ASSERT_THROW( std::abs( vine.from.x() - vine.to.x() ) < 1.0 );
+      ALEPH_ASSERT_THROW( ( vine.from.y() == inf ) == ( vine.to.y() == inf ) );
+
+      if( vine.from.y() != inf )
+        ALEPH_ASSERT_THROW( std::abs( vine.from.y() - vine.to.y() ) < 1.0 );
+    }
+  }
+
+  auto L = makeLowerStarFiltration( K, values );
+  ALEPH_ASSERT_THROW( points( vineyard.diagrams() ) == points( aleph::calculatePersistenceDiagrams( L ) ) );
+
+  ALEPH_TEST_END();
+}
+
+int main()
+{
+  testSimple();
+  testRandom();
+  testSmallSteps();
+}